@@ -0,0 +1,82 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include <simpletest.h>
+
+#include "KisPngEncodingBenchmark.h"
+
+#include <QBuffer>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_png_converter.h>
+#include <kis_sequential_iterator.h>
+
+namespace {
+
+KisPaintDeviceSP createNoisyDevice(const KoColorSpace *cs, const QRect &rc)
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *ptr = it.rawData();
+        for (quint32 i = 0; i < cs->pixelSize(); i++) {
+            // smooth gradients with some noise, so that every filter wins somewhere
+            ptr[i] = quint8(it.x() / 3 + it.y() / 2 + 37 * i + (it.x() * it.y() + i) % 7);
+        }
+    }
+
+    return dev;
+}
+
+}
+
+void KisPngEncodingBenchmark::benchmarkEncoding_data()
+{
+    QTest::addColumn<bool>("parallelEncoding");
+    QTest::addColumn<int>("filterStrategy");
+
+    QTest::newRow("libpng-adaptive") << false << int(KisPNGParallelEncoder::FilterAdaptive);
+    QTest::newRow("libpng-fast") << false << int(KisPNGParallelEncoder::FilterSub);
+    QTest::newRow("libpng-none") << false << int(KisPNGParallelEncoder::FilterNone);
+    QTest::newRow("parallel-adaptive") << true << int(KisPNGParallelEncoder::FilterAdaptive);
+    QTest::newRow("parallel-fast") << true << int(KisPNGParallelEncoder::FilterSub);
+    QTest::newRow("parallel-none") << true << int(KisPNGParallelEncoder::FilterNone);
+}
+
+void KisPngEncodingBenchmark::benchmarkEncoding()
+{
+    QFETCH(bool, parallelEncoding);
+    QFETCH(int, filterStrategy);
+
+    const QRect rc(0, 0, 4000, 3000);
+    KisPaintDeviceSP dev = createNoisyDevice(KoColorSpaceRegistry::instance()->rgb8(), rc);
+
+    KisPNGOptions options;
+    options.compression = 6;
+    options.tryToSaveAsIndexed = false;
+    options.parallelEncoding = parallelEncoding;
+    options.filterStrategy = KisPNGParallelEncoder::FilterStrategy(filterStrategy);
+
+    vKisAnnotationSP annotations;
+
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+
+        KisPNGConverter converter(0, true);
+        const KisImportExportErrorCode result =
+            converter.buildFile(&buffer, rc, 1.0, 1.0, dev,
+                                annotations.begin(), annotations.end(),
+                                options, 0);
+
+        QVERIFY(result.isOk());
+    }
+}
+
+SIMPLE_TEST_MAIN(KisPngEncodingBenchmark)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPNGENCODINGBENCHMARK_H
+#define KISPNGENCODINGBENCHMARK_H
+
+#include <simpletest.h>
+
+/// compares libpng's encoder with the parallel one on a big image
+class KisPngEncodingBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkEncoding_data();
+    void benchmarkEncoding();
+};
+
+#endif
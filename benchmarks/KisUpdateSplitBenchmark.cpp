@@ -0,0 +1,79 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include <simpletest.h>
+
+#include "KisUpdateSplitBenchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_image_config.h>
+#include <kis_paint_layer.h>
+#include <kis_paint_device.h>
+#include <kis_filter_mask.h>
+#include "filter/kis_filter_registry.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter.h"
+#include <KisGlobalResourcesInterface.h>
+
+void KisUpdateSplitBenchmark::benchmarkUpdate_data()
+{
+    QTest::addColumn<int>("numThreads");
+    QTest::addColumn<QString>("filterId");
+
+    Q_FOREACH (int numThreads, QVector<int>({8, 16, 64})) {
+        Q_FOREACH (const QString &filterId, QStringList({"", "invert", "blur"})) {
+            const QString name = QString("%1 threads, %2")
+                .arg(numThreads)
+                .arg(filterId.isEmpty() ? "plain layer" : filterId + " mask");
+
+            QTest::newRow(name.toLatin1()) << numThreads << filterId;
+        }
+    }
+}
+
+void KisUpdateSplitBenchmark::benchmarkUpdate()
+{
+    QFETCH(int, numThreads);
+    QFETCH(QString, filterId);
+
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, colorSpace, "update split benchmark");
+    image->setWorkingThreadsLimit(numThreads);
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "paint", OPACITY_OPAQUE_U8);
+    paintLayer->paintDevice()->fill(image->bounds(), KoColor(Qt::red, colorSpace));
+    image->addNode(paintLayer, image->rootLayer());
+
+    if (!filterId.isEmpty()) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterId);
+        QVERIFY(filter);
+        KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+        KisFilterMaskSP mask = new KisFilterMask(image, filterId + "_mask");
+        mask->initSelection(paintLayer);
+        mask->setFilter(configuration->cloneWithResourcesSnapshot());
+        image->addNode(mask, paintLayer);
+    }
+
+    image->refreshGraphAsync();
+    image->waitForDone();
+
+    // a single update as big as an update patch, so that the queue has
+    // fewer jobs than the spare threads
+    KisImageConfig cfg(true);
+    const QRect dirtyRect(0, 0, cfg.updatePatchWidth(), cfg.updatePatchHeight());
+
+    QBENCHMARK {
+        paintLayer->setDirty(dirtyRect);
+        image->waitForDone();
+    }
+}
+
+SIMPLE_TEST_MAIN(KisUpdateSplitBenchmark)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATESPLITBENCHMARK_H
+#define KISUPDATESPLITBENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures a single patch-sized update of a layer with the updater
+/// limited to a different number of threads
+class KisUpdateSplitBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkUpdate_data();
+    void benchmarkUpdate();
+};
+
+#endif
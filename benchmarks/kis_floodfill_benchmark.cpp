@@ -55,12 +55,15 @@ void KisFloodFillBenchmark::initTestCase()
     // copy to other tests
     m_deviceWithoutSelectionAsBoundary = new KisPaintDevice(m_colorSpace);
     m_deviceWithSelectionAsBoundary = new KisPaintDevice(m_colorSpace);
+    m_deviceParallelFloodFill = new KisPaintDevice(m_colorSpace);
 
 
     KisPainter::copyAreaOptimized(QPoint(), m_deviceStandardFloodFill,
                                   m_deviceWithoutSelectionAsBoundary, m_deviceWithoutSelectionAsBoundary->exactBounds());
     KisPainter::copyAreaOptimized(QPoint(), m_deviceStandardFloodFill,
                                   m_deviceWithSelectionAsBoundary, m_deviceWithSelectionAsBoundary->exactBounds());
+    KisPainter::copyAreaOptimized(QPoint(), m_deviceStandardFloodFill,
+                                  m_deviceParallelFloodFill, m_deviceParallelFloodFill->exactBounds());
 
     //m_deviceWithoutSelectionAsBoundary = m_deviceStandardFloodFill->
 
@@ -170,6 +173,67 @@ void KisFloodFillBenchmark::benchmarkFloodWithSelectionAsBoundary()
     }
 }
 
+void KisFloodFillBenchmark::benchmarkParallelFlood()
+{
+    KoColor fg(m_colorSpace);
+    fg.fromQColor(Qt::blue);
+
+    QBENCHMARK
+    {
+        KisFillPainter fillPainter(m_deviceParallelFloodFill);
+        fillPainter.setPaintColor( fg );
+
+        fillPainter.beginTransaction(kundo2_noi18n("Flood Fill"));
+
+        fillPainter.setOpacity(OPACITY_OPAQUE_U8);
+        fillPainter.setFillThreshold(15);
+        fillPainter.setCompositeOp(COMPOSITE_OVER);
+        fillPainter.setCareForSelection(true);
+        fillPainter.setWidth(GMP_IMAGE_WIDTH);
+        fillPainter.setHeight(GMP_IMAGE_HEIGHT);
+        fillPainter.setUseParallelFloodFill(true);
+
+        fillPainter.fillColor(1, 1, m_deviceParallelFloodFill);
+
+        fillPainter.deleteTransaction();
+    }
+}
+
+void KisFloodFillBenchmark::benchmarkParallelFloodSelection()
+{
+    QBENCHMARK
+    {
+        KisFillPainter fillPainter(m_deviceWithoutSelectionAsBoundary);
+
+        fillPainter.setFillThreshold(15);
+        fillPainter.setCareForSelection(true);
+        fillPainter.setWidth(GMP_IMAGE_WIDTH);
+        fillPainter.setHeight(GMP_IMAGE_HEIGHT);
+        fillPainter.setUseSelectionAsBoundary(false);
+        fillPainter.setUseCompositioning(true);
+        fillPainter.setUseParallelFloodFill(true);
+
+        fillPainter.createFloodSelection(1, 1, m_deviceWithoutSelectionAsBoundary, m_existingSelection);
+    }
+}
+
+void KisFloodFillBenchmark::benchmarkParallelFloodWithSelectionAsBoundary()
+{
+    QBENCHMARK
+    {
+        KisFillPainter fillPainter(m_deviceWithSelectionAsBoundary);
+
+        fillPainter.setFillThreshold(15);
+        fillPainter.setCareForSelection(true);
+        fillPainter.setWidth(GMP_IMAGE_WIDTH);
+        fillPainter.setHeight(GMP_IMAGE_HEIGHT);
+        fillPainter.setUseSelectionAsBoundary(true);
+        fillPainter.setUseCompositioning(true);
+        fillPainter.setUseParallelFloodFill(true);
+
+        fillPainter.createFloodSelection(1, 1, m_deviceWithSelectionAsBoundary, m_existingSelection);
+    }
+}
 
 void KisFloodFillBenchmark::cleanupTestCase()
 {
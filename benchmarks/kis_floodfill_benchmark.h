@@ -24,6 +24,7 @@ private:
     KisPaintDeviceSP m_deviceStandardFloodFill;
     KisPaintDeviceSP m_deviceWithSelectionAsBoundary;
     KisPaintDeviceSP m_deviceWithoutSelectionAsBoundary;
+    KisPaintDeviceSP m_deviceParallelFloodFill;
     KisPaintDeviceSP m_existingSelection;
     int m_startX;
     int m_startY;
@@ -36,6 +37,10 @@ private Q_SLOTS:
     void benchmarkFloodWithoutSelectionAsBoundary();
     void benchmarkFloodWithSelectionAsBoundary();
 
+    void benchmarkParallelFlood();
+    void benchmarkParallelFloodSelection();
+    void benchmarkParallelFloodWithSelectionAsBoundary();
+
     
     
     
@@ -25,6 +25,11 @@
 
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
+#include "kis_gauss_circle_mask_generator.h"
+#include "kis_gauss_rect_mask_generator.h"
+#include "kis_curve_circle_mask_generator.h"
+#include "kis_curve_rect_mask_generator.h"
+#include "kis_cubic_curve.h"
 
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
@@ -48,7 +53,7 @@ void KisMaskGeneratorBenchmark::benchmarkCircle()
 #include "krita_utils.h"
 
 
-void benchmarkSIMD(qreal fade) {
+void benchmarkApplicator(KisMaskGenerator &gen) {
     const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
     KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
     dev->setRect(QRect(0, 0, 1000, 1000));
@@ -58,8 +63,6 @@ void benchmarkSIMD(qreal fade) {
                             0.0, 1.0,
                             500, 500, 0);
 
-    KisCircleMaskGenerator gen(1000, 1.0, fade, fade, 2, false);
-
     KisBrushMaskApplicatorBase *applicator = gen.applicator();
     applicator->initializeData(&data);
 
@@ -72,6 +75,16 @@ void benchmarkSIMD(qreal fade) {
     }
 }
 
+void benchmarkSIMD(qreal fade) {
+    KisCircleMaskGenerator gen(1000, 1.0, fade, fade, 2, false);
+    benchmarkApplicator(gen);
+}
+
+KisCubicCurve softCurve()
+{
+    return KisCubicCurve(QList<QPointF>({QPointF(0.0, 1.0), QPointF(0.4, 0.8), QPointF(1.0, 0.0)}));
+}
+
 void KisMaskGeneratorBenchmark::benchmarkSIMD_SharpBrush()
 {
     benchmarkSIMD(1.0);
@@ -96,4 +109,48 @@ void KisMaskGeneratorBenchmark::benchmarkSquare()
     }
 }
 
+void KisMaskGeneratorBenchmark::benchmarkSIMD_Rect()
+{
+    KisRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, false);
+    benchmarkApplicator(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_GaussCircle()
+{
+    KisGaussCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, false);
+    benchmarkApplicator(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_GaussRect()
+{
+    KisGaussRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, false);
+    benchmarkApplicator(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_CurveCircle()
+{
+    KisCurveCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, softCurve(), false);
+    benchmarkApplicator(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkSIMD_CurveRect()
+{
+    KisCurveRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, softCurve(), false);
+    benchmarkApplicator(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkScalar_CurveCircle()
+{
+    KisCurveCircleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, softCurve(), false);
+    gen.resetMaskApplicator(true);
+    benchmarkApplicator(gen);
+}
+
+void KisMaskGeneratorBenchmark::benchmarkScalar_CurveRect()
+{
+    KisCurveRectangleMaskGenerator gen(1000, 1.0, 0.5, 0.5, 2, softCurve(), false);
+    gen.resetMaskApplicator(true);
+    benchmarkApplicator(gen);
+}
+
 SIMPLE_TEST_MAIN(KisMaskGeneratorBenchmark)
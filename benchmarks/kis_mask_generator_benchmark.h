@@ -18,6 +18,14 @@ private Q_SLOTS:
     void benchmarkSIMD_FadedBrush();
     void benchmarkSquare();
 
+    void benchmarkSIMD_Rect();
+    void benchmarkSIMD_GaussCircle();
+    void benchmarkSIMD_GaussRect();
+    void benchmarkSIMD_CurveCircle();
+    void benchmarkSIMD_CurveRect();
+    void benchmarkScalar_CurveCircle();
+    void benchmarkScalar_CurveRect();
+
 };
 
 #endif
@@ -26,12 +26,27 @@ void KisProjectionBenchmark::cleanupTestCase()
 }
 
 
+void KisProjectionBenchmark::benchmarkProjection_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("8 threads") << 8;
+    QTest::newRow("16 threads") << 16;
+    QTest::newRow("64 threads") << 64;
+}
+
 void KisProjectionBenchmark::benchmarkProjection()
 {
+    QFETCH(int, numThreads);
+
     QBENCHMARK{
         KisDocument *doc = KisPart::instance()->createDocument();
         doc->loadNativeFormat(QString(FILES_DATA_DIR) + '/' + "load_test.kra");
-        doc->image()->refreshGraph();
+        doc->image()->setWorkingThreadsLimit(numThreads);
+        // the synchronous refreshGraph() bypasses the update queue,
+        // so the threads limit would have no effect on it
+        doc->image()->refreshGraphAsync();
+        doc->image()->waitForDone();
         doc->exportDocumentSync(QString(FILES_OUTPUT_DIR) + '/' + "save_test.kra", doc->mimeType());
         delete doc;
     }
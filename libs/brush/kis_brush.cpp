@@ -227,6 +227,22 @@ QImage KisBrush::brushTipImage() const
     return d->brushTipImage;
 }
 
+qint64 KisBrush::memoryFootprint() const
+{
+    qint64 size = KoResource::memoryFootprint();
+
+    // small tips are used as the thumbnail as they are
+    if (d->brushTipImage.cacheKey() != image().cacheKey()) {
+        size += d->brushTipImage.sizeInBytes();
+    }
+
+    if (!d->brushPyramid.isNull()) {
+        size += d->brushPyramid.value(this)->memoryFootprint();
+    }
+
+    return size;
+}
+
 qint32 KisBrush::width() const
 {
     return d->width;
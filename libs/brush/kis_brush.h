@@ -128,6 +128,11 @@ public:
      */
     virtual QImage brushTipImage() const;
 
+    /**
+     * Counts the brush tip and the mipmaps if they have already been built
+     */
+    qint64 memoryFootprint() const override;
+
     /**
      * Change the spacing of the brush.
      * @param spacing a spacing of 1.0 means that strokes will be separated from one time the size
@@ -332,3 +332,12 @@ QImage KisQImagePyramid::getClosestWithoutWorkaroundBorder(QTransform transform,
                image.width() - 2 * QPAINTER_WORKAROUND_BORDER,
                image.height() - 2 * QPAINTER_WORKAROUND_BORDER);
 }
+
+qint64 KisQImagePyramid::memoryFootprint() const
+{
+    qint64 size = 0;
+    Q_FOREACH (const PyramidLevel &level, m_levels) {
+        size += level.image.sizeInBytes();
+    }
+    return size;
+}
@@ -33,6 +33,11 @@ public:
 
     QImage getClosestWithoutWorkaroundBorder(QTransform transform, qreal *scale) const;
 
+    /**
+     * @return the number of bytes taken by all the levels of the pyramid
+     */
+    qint64 memoryFootprint() const;
+
 private:
     friend class KisGbrBrushTest;
     int findNearestLevel(qreal scale, qreal *baseScale) const;
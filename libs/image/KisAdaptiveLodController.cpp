@@ -0,0 +1,90 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAdaptiveLodController.h"
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+
+namespace {
+const int numFastStrokesToStepBack = 3;
+const int maxNumReports = 256;
+}
+
+KisAdaptiveLodController::KisAdaptiveLodController()
+    : m_targetLatency(KisImageConfig(true).adaptiveLodTargetLatency())
+{
+}
+
+void KisAdaptiveLodController::setTargetLatency(qint64 msec)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(msec > 0);
+    m_targetLatency = msec;
+}
+
+qint64 KisAdaptiveLodController::targetLatency() const
+{
+    return m_targetLatency;
+}
+
+int KisAdaptiveLodController::lodOffset() const
+{
+    return m_lodOffset;
+}
+
+int KisAdaptiveLodController::levelOfDetail(int desiredLevelOfDetail, int maxLevelOfDetail) const
+{
+    return qMin(desiredLevelOfDetail + m_lodOffset, qMax(desiredLevelOfDetail, maxLevelOfDetail));
+}
+
+bool KisAdaptiveLodController::reportStroke(const QString &strokeId, int levelOfDetail, int maxLevelOfDetail, qint64 latency)
+{
+    StrokeReport report;
+    report.strokeId = strokeId;
+    report.levelOfDetail = levelOfDetail;
+    report.latency = latency;
+
+    m_reports.append(report);
+    if (m_reports.size() > maxNumReports) {
+        m_reports.removeFirst();
+    }
+
+    const int oldOffset = m_lodOffset;
+
+    if (latency > m_targetLatency) {
+        m_numFastStrokes = 0;
+
+        if (levelOfDetail < maxLevelOfDetail) {
+            m_lodOffset++;
+        }
+    } else if (latency < m_targetLatency / 4 && m_lodOffset > 0) {
+        m_numFastStrokes++;
+
+        if (m_numFastStrokes >= numFastStrokesToStepBack) {
+            m_numFastStrokes = 0;
+            m_lodOffset--;
+        }
+    } else {
+        m_numFastStrokes = 0;
+    }
+
+    dbgImage << "Adaptive LoD:" << strokeId
+             << ppVar(levelOfDetail) << ppVar(latency)
+             << "offset" << oldOffset << "->" << m_lodOffset;
+
+    return m_lodOffset != oldOffset;
+}
+
+void KisAdaptiveLodController::reset()
+{
+    m_lodOffset = 0;
+    m_numFastStrokes = 0;
+}
+
+QVector<KisAdaptiveLodController::StrokeReport> KisAdaptiveLodController::strokeReports() const
+{
+    return m_reports;
+}
@@ -0,0 +1,87 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISADAPTIVELODCONTROLLER_H
+#define KISADAPTIVELODCONTROLLER_H
+
+#include "kritaimage_export.h"
+
+#include <QString>
+#include <QVector>
+
+/**
+ * Picks the level of detail used for the instant preview depending on
+ * how well the machine keeps up with the strokes.
+ *
+ * After every instant preview stroke the strokes queue reports its
+ * latency, that is, the time between the user ending the stroke and the
+ * LodN stroke finishing all its jobs. When the latency exceeds the target,
+ * the controller steps to a coarser level of detail. Every level of detail
+ * has four times fewer pixels than the previous one, so the controller
+ * steps back to a finer level only after a few strokes that were done in
+ * less than a quarter of the target latency.
+ *
+ * Switching the level of detail makes the queue regenerate the LoD planes,
+ * which is expensive, therefore the level is never changed in the middle
+ * of a stroke.
+ *
+ * The class is not thread-safe, the access is guarded by the strokes
+ * queue's lock.
+ */
+class KRITAIMAGE_EXPORT KisAdaptiveLodController
+{
+public:
+    struct StrokeReport {
+        QString strokeId;
+        int levelOfDetail = 0;
+        qint64 latency = 0;
+    };
+
+public:
+    KisAdaptiveLodController();
+
+    void setTargetLatency(qint64 msec);
+    qint64 targetLatency() const;
+
+    /**
+     * The number of the levels the controller has added to the desired
+     * level of detail
+     */
+    int lodOffset() const;
+
+    /**
+     * \return the level of detail that should be used for the strokes
+     *         when the canvas desires \p desiredLevelOfDetail
+     */
+    int levelOfDetail(int desiredLevelOfDetail, int maxLevelOfDetail) const;
+
+    /**
+     * Reports the latency of a finished LodN stroke painted on
+     * \p levelOfDetail
+     *
+     * \return true if the offset of the level of detail has changed
+     */
+    bool reportStroke(const QString &strokeId, int levelOfDetail, int maxLevelOfDetail, qint64 latency);
+
+    /**
+     * Drops the offset and the counters, e.g. when the canvas has
+     * switched adaptive mode off
+     */
+    void reset();
+
+    /**
+     * The levels of detail chosen for the last strokes, oldest first
+     */
+    QVector<StrokeReport> strokeReports() const;
+
+private:
+    qint64 m_targetLatency;
+    int m_lodOffset = 0;
+    int m_numFastStrokes = 0;
+    QVector<StrokeReport> m_reports;
+};
+
+#endif // KISADAPTIVELODCONTROLLER_H
@@ -0,0 +1,311 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBelowLayersProjectionCache.h"
+
+#include <QGlobalStatic>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+
+#include "kis_node.h"
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_projection_leaf.h"
+#include "kis_abstract_projection_plane.h"
+#include "kis_image_config.h"
+
+namespace {
+
+struct BelowNode
+{
+    KisNodeWSP node;
+    bool visible;
+
+    bool operator==(const BelowNode &rhs) const {
+        return node == rhs.node.data() && visible == rhs.visible;
+    }
+};
+
+struct CacheKey
+{
+    KisNodeWSP filthyNode;
+    QVector<BelowNode> belowNodes;
+    const KoColorSpace *colorSpace = 0;
+    KoColor defaultPixel;
+
+    bool operator==(const CacheKey &rhs) const {
+        return filthyNode == rhs.filthyNode.data() &&
+            belowNodes == rhs.belowNodes &&
+            *colorSpace == *rhs.colorSpace &&
+            defaultPixel == rhs.defaultPixel;
+    }
+};
+
+struct CachedPlane
+{
+    CacheKey key;
+    KisPaintDeviceSP device;
+    QRegion validRegion;
+};
+
+struct RegisteredCache
+{
+    virtual ~RegisteredCache() = default;
+
+    QMutex mutex;
+    QHash<int, CachedPlane> planes;
+
+    /// guarded by the registry's mutex
+    qint64 memoryUsage = 0;
+
+    qint64 calculateMemoryUsage() const {
+        qint64 result = 0;
+
+        Q_FOREACH (const CachedPlane &plane, planes) {
+            qint64 numPixels = 0;
+            for (const QRect &rc : plane.validRegion) {
+                numPixels += qint64(rc.width()) * rc.height();
+            }
+            result += numPixels * plane.device->pixelSize();
+        }
+
+        return result;
+    }
+};
+
+/**
+ * Keeps all the caches in the order of their last use and drops the least
+ * recently used ones when they use more memory than allowed.
+ *
+ * The registry's mutex is never acquired while a cache's mutex is held. The
+ * registry only tries to lock the caches it evicts, and skips the ones busy
+ * with another walker.
+ */
+struct CacheRegistry
+{
+    CacheRegistry() {
+        KisImageConfig cfg(true);
+        memoryLimit = qint64(cfg.belowLayersCacheLimit()) * 1024 * 1024;
+    }
+
+    void registerCache(RegisteredCache *cache) {
+        QMutexLocker l(&mutex);
+        caches.prepend(cache);
+    }
+
+    void unregisterCache(RegisteredCache *cache) {
+        QMutexLocker l(&mutex);
+        caches.removeOne(cache);
+        totalMemoryUsage -= cache->memoryUsage;
+    }
+
+    void updateMemoryUsage(RegisteredCache *cache, qint64 memoryUsage, bool markAsUsed) {
+        QMutexLocker l(&mutex);
+
+        totalMemoryUsage += memoryUsage - cache->memoryUsage;
+        cache->memoryUsage = memoryUsage;
+
+        if (markAsUsed && caches.first() != cache) {
+            caches.removeOne(cache);
+            caches.prepend(cache);
+        }
+
+        evict();
+    }
+
+    void evict() {
+        /**
+         * The cache that has just been used is the last one to be
+         * dropped, so it is dropped only when it exceeds the limit alone
+         */
+        for (int i = caches.size() - 1; i >= 0 && totalMemoryUsage > memoryLimit; i--) {
+            RegisteredCache *cache = caches[i];
+            if (!cache->memoryUsage || !cache->mutex.tryLock()) continue;
+
+            cache->planes.clear();
+            cache->mutex.unlock();
+
+            totalMemoryUsage -= cache->memoryUsage;
+            cache->memoryUsage = 0;
+        }
+    }
+
+    QMutex mutex;
+    QList<RegisteredCache*> caches;
+    qint64 totalMemoryUsage = 0;
+    qint64 memoryLimit = 0;
+};
+
+Q_GLOBAL_STATIC(CacheRegistry, s_registry)
+
+}
+
+struct Q_DECL_HIDDEN KisBelowLayersProjectionCache::Private : public RegisteredCache
+{
+    void dropOtherLevelsOfDetail(int levelOfDetail);
+    void updateMemoryUsage(bool markAsUsed);
+};
+
+void KisBelowLayersProjectionCache::Private::dropOtherLevelsOfDetail(int levelOfDetail)
+{
+    /**
+     * The layers might have been changed on the other level of detail
+     * without notifying this one, so the data cached for the other
+     * levels cannot be trusted anymore.
+     */
+    for (auto it = planes.begin(); it != planes.end();) {
+        if (it.key() != levelOfDetail) {
+            it = planes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KisBelowLayersProjectionCache::Private::updateMemoryUsage(bool markAsUsed)
+{
+    qint64 memoryUsage = 0;
+
+    {
+        QMutexLocker l(&mutex);
+        memoryUsage = calculateMemoryUsage();
+    }
+
+    s_registry->updateMemoryUsage(this, memoryUsage, markAsUsed);
+}
+
+KisBelowLayersProjectionCache::KisBelowLayersProjectionCache()
+    : m_d(new Private)
+{
+    s_registry->registerCache(m_d.data());
+}
+
+KisBelowLayersProjectionCache::~KisBelowLayersProjectionCache()
+{
+    // the layers may outlive the registry on application exit
+    if (!s_registry.isDestroyed()) {
+        s_registry->unregisterCache(m_d.data());
+    }
+}
+
+void KisBelowLayersProjectionCache::fetchBelowLayers(KisProjectionLeafSP filthyLeaf,
+                                                     const QVector<KisProjectionLeafSP> &belowLeaves,
+                                                     const QRect &rect,
+                                                     int levelOfDetail,
+                                                     KisPaintDeviceSP dst)
+{
+    CacheKey key;
+    key.filthyNode = filthyLeaf->node();
+    key.colorSpace = dst->colorSpace();
+    key.defaultPixel = dst->defaultPixel();
+    Q_FOREACH (KisProjectionLeafSP leaf, belowLeaves) {
+        key.belowNodes.append({leaf->node(), leaf->visible()});
+    }
+
+    KisPaintDeviceSP device;
+    QRegion missingRegion;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        CachedPlane &plane = m_d->planes[levelOfDetail];
+
+        if (!plane.device || !(plane.key == key)) {
+            m_d->dropOtherLevelsOfDetail(levelOfDetail);
+
+            plane.key = key;
+            plane.device = new KisPaintDevice(key.colorSpace, "Below Layers Projection Cache");
+            plane.device->setDefaultPixel(key.defaultPixel);
+            plane.validRegion = QRegion();
+        }
+
+        device = plane.device;
+        missingRegion = QRegion(rect) - plane.validRegion;
+    }
+
+    /**
+     * The concurrent walkers never touch the same area, so the missing
+     * parts can be composited without holding the lock.
+     */
+    for (const QRect &rc : missingRegion) {
+        device->clear(rc);
+
+        Q_FOREACH (KisProjectionLeafSP leaf, belowLeaves) {
+            if (!leaf->visible()) continue;
+
+            KisPainter gc(device);
+            leaf->projectionPlane()->apply(&gc, rc);
+        }
+    }
+
+    if (!missingRegion.isEmpty()) {
+        QMutexLocker l(&m_d->mutex);
+
+        auto it = m_d->planes.find(levelOfDetail);
+        if (it != m_d->planes.end() && it->device == device) {
+            it->validRegion += missingRegion;
+        }
+    }
+
+    KisPainter::copyAreaOptimized(rect.topLeft(), device, dst, rect);
+
+    m_d->updateMemoryUsage(true);
+}
+
+void KisBelowLayersProjectionCache::invalidate(const QRect &rect, int levelOfDetail)
+{
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        if (m_d->planes.isEmpty()) return;
+
+        m_d->dropOtherLevelsOfDetail(levelOfDetail);
+
+        auto it = m_d->planes.find(levelOfDetail);
+        if (it != m_d->planes.end()) {
+            it->validRegion -= rect;
+        }
+    }
+
+    m_d->updateMemoryUsage(false);
+}
+
+void KisBelowLayersProjectionCache::clear()
+{
+    {
+        QMutexLocker l(&m_d->mutex);
+        if (m_d->planes.isEmpty()) return;
+
+        m_d->planes.clear();
+    }
+
+    m_d->updateMemoryUsage(false);
+}
+
+qint64 KisBelowLayersProjectionCache::memoryUsage() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->calculateMemoryUsage();
+}
+
+void KisBelowLayersProjectionCache::setMemoryLimit(qint64 value)
+{
+    QMutexLocker l(&s_registry->mutex);
+    s_registry->memoryLimit = value;
+    s_registry->evict();
+}
+
+qint64 KisBelowLayersProjectionCache::memoryLimit()
+{
+    QMutexLocker l(&s_registry->mutex);
+    return s_registry->memoryLimit;
+}
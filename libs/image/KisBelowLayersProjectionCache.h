@@ -0,0 +1,97 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBELOWLAYERSPROJECTIONCACHE_H
+#define KISBELOWLAYERSPROJECTIONCACHE_H
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include <kritaimage_export.h>
+#include <kis_types.h>
+
+class QRect;
+
+/**
+ * A cache of the merged projections of the layers lying below the
+ * currently updated layer of a group.
+ *
+ * When the user paints on a layer in the middle of a deep stack, every
+ * update of the group's original composites all the layers below the
+ * painted one, although they don't change during the stroke. The cache
+ * keeps the result of this composition, so KisAsyncMerger can just copy it
+ * into the original and composite only the filthy layer and the layers
+ * above it. The cost of the update doesn't depend on the number of the
+ * layers below the painted one anymore.
+ *
+ * The cached areas are keyed by the filthy layer and the list of the layers
+ * below it (together with their visibility). When a different layer becomes
+ * filthy, or the stack changes, the cache is reset. Areas updated by the
+ * walkers that cannot use the cache are invalidated by KisAsyncMerger.
+ *
+ * Only the plane below the filthy layer is cached. The layers above it are
+ * still composited one by one, because their premerged plane would not give
+ * bit-exact results: OVER with integer rounding is not associative.
+ *
+ * The memory used by the caches of all the groups is limited by
+ * KisImageConfig::belowLayersCacheLimit(). When the limit is exceeded, the
+ * least recently used caches are dropped. The group drops its cache when it
+ * is removed from the image, the image is resized or the level of detail is
+ * changed.
+ *
+ * The walkers running concurrently never have intersecting rects, so the
+ * cache only needs to protect its bookkeeping with a mutex.
+ */
+class KRITAIMAGE_EXPORT KisBelowLayersProjectionCache
+{
+public:
+    KisBelowLayersProjectionCache();
+    ~KisBelowLayersProjectionCache();
+
+    /**
+     * Writes the merged projections of \p belowLeaves into \p rect of
+     * \p dst. The parts of \p rect that are not cached yet are composited
+     * and stored in the cache.
+     */
+    void fetchBelowLayers(KisProjectionLeafSP filthyLeaf,
+                          const QVector<KisProjectionLeafSP> &belowLeaves,
+                          const QRect &rect,
+                          int levelOfDetail,
+                          KisPaintDeviceSP dst);
+
+    /**
+     * Marks \p rect of the cache for \p levelOfDetail as outdated. The
+     * caches for the other levels of detail are dropped.
+     */
+    void invalidate(const QRect &rect, int levelOfDetail);
+
+    /**
+     * Drops all the cached data
+     */
+    void clear();
+
+    /**
+     * @return the number of bytes of the pixel data kept in the cache
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * Sets the number of bytes all the caches may use together. The
+     * default is read from KisImageConfig.
+     */
+    static void setMemoryLimit(qint64 value);
+    static qint64 memoryLimit();
+
+    static const int minCachedLayers = 2;
+
+private:
+    Q_DISABLE_COPY(KisBelowLayersProjectionCache)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISBELOWLAYERSPROJECTIONCACHE_H
@@ -49,13 +49,15 @@ void KisBezierTransformMesh::transformPatch(const KisBezierPatch &patch, const Q
 
     {
         GridIterationTools::QImagePolygonOp polygonOp(srcImage, *dstImage, srcQImageOffset, dstQImageOffset);
+        GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp);
 
         GridIterationTools::RegularGridIndexesOp indexesOp(gridSize);
         GridIterationTools::iterateThroughGrid
-                <GridIterationTools::AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+                <GridIterationTools::AlwaysCompletePolygonPolicy>(parallelOp, indexesOp,
                                                                   gridSize,
                                                                   originalPointsLocal,
                                                                   transformedPointsLocal);
+        parallelOp.flush();
     }
 }
 
@@ -69,13 +71,16 @@ void KisBezierTransformMesh::transformPatch(const KisBezierPatch &patch, KisPain
 
     {
         GridIterationTools::PaintDevicePolygonOp polygonOp(srcDevice, dstDevice);
+        GridIterationTools::ParallelPolygonOp<GridIterationTools::PaintDevicePolygonOp>
+            parallelOp(polygonOp, QPoint(dstDevice->x(), dstDevice->y()));
 
         GridIterationTools::RegularGridIndexesOp indexesOp(gridSize);
         GridIterationTools::iterateThroughGrid
-                <GridIterationTools::AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+                <GridIterationTools::AlwaysCompletePolygonPolicy>(parallelOp, indexesOp,
                                                                   gridSize,
                                                                   originalPointsLocal,
                                                                   transformedPointsLocal);
+        parallelOp.flush();
     }
 }
 
@@ -8,6 +8,7 @@
 
 #include <krita_utils.h>
 #include <floodfill/kis_scanline_fill.h>
+#include <floodfill/KisLineartDistanceField.h>
 #include <kis_selection_filters.h>
 #include <kis_iterator_ng.h>
 #include <KoUpdater.h>
@@ -269,6 +270,16 @@ public:
                                                          KisPaintDeviceSP referenceDevice,
                                                          const KoColor &color) const;
 
+    KisPaintDeviceSP contourFillBoundary(KisPixelSelectionSP enclosingMask,
+                                         const QRect &enclosingMaskRect,
+                                         KisPaintDeviceSP referenceDevice,
+                                         KisLineartDistanceFieldSP *distanceField) const;
+    void mergeGapClosedContourMask(KisPixelSelectionSP resultMask,
+                                   KisPixelSelectionSP contourMask,
+                                   KisPixelSelectionSP enclosingMask,
+                                   const QRect &enclosingMaskRect,
+                                   KisLineartDistanceFieldSP distanceField) const;
+
     void removeContourRegions(KisPixelSelectionSP resultMask,
                               KisPixelSelectionSP enclosingMask,
                               const QRect &enclosingMaskRect) const;
@@ -935,10 +946,17 @@ void KisEncloseAndFillPainter::Private::selectRegionsFromContour(KisPixelSelecti
     if (enclosingPoints.isEmpty()) {
         return;
     }
+    // With gap closing enabled the contour regions are collected separately,
+    // since the band around the lineart should be restored only for them
+    KisLineartDistanceFieldSP distanceField;
+    KisPaintDeviceSP boundary = contourFillBoundary(enclosingMask, enclosingMaskRect, referenceDevice, &distanceField);
+    KisPixelSelectionSP contourMask =
+        distanceField ? KisPixelSelectionSP(new KisPixelSelection(new KisSelectionDefaultBounds(resultMask))) : resultMask;
     // Here we just fill all the areas from the border towards inside
     for (const QPoint &point : enclosingPoints) {
         // Continue if the region under the point was already filled
-        if (*(resultMask->pixel(point).data()) == MAX_SELECTED) {
+        if (*(resultMask->pixel(point).data()) == MAX_SELECTED ||
+            *(contourMask->pixel(point).data()) == MAX_SELECTED) {
             continue;
         }
         KisPixelSelectionSP mask = new KisPixelSelection(new KisSelectionDefaultBounds(resultMask));
@@ -947,8 +965,11 @@ void KisEncloseAndFillPainter::Private::selectRegionsFromContour(KisPixelSelecti
         gc.setOpacitySpread(q->opacitySpread());
         // Use the enclosing mask as boundary so that we don't fill
         // potentially large regions on the outside
-        gc.fillSelectionWithBoundary(mask, enclosingMask);
-        resultMask->applySelection(mask, SELECTION_ADD);
+        gc.fillSelectionWithBoundary(mask, boundary);
+        contourMask->applySelection(mask, SELECTION_ADD);
+    }
+    if (distanceField) {
+        mergeGapClosedContourMask(resultMask, contourMask, enclosingMask, enclosingMaskRect, distanceField);
     }
 }
 
@@ -972,10 +993,17 @@ void KisEncloseAndFillPainter::Private::selectRegionsFromContourUntilColor(KisPi
     if (enclosingPoints.isEmpty()) {
         return;
     }
+    // With gap closing enabled the contour regions are collected separately,
+    // since the band around the lineart should be restored only for them
+    KisLineartDistanceFieldSP distanceField;
+    KisPaintDeviceSP boundary = contourFillBoundary(enclosingMask, enclosingMaskRect, referenceDevice, &distanceField);
+    KisPixelSelectionSP contourMask =
+        distanceField ? KisPixelSelectionSP(new KisPixelSelection(new KisSelectionDefaultBounds(resultMask))) : resultMask;
     // Here we just fill all the areas from the border towards inside until the specific color
     for (const QPoint &point : enclosingPoints) {
         // Continue if the region under the point was already filled
-        if (*(resultMask->pixel(point).data()) == MAX_SELECTED) {
+        if (*(resultMask->pixel(point).data()) == MAX_SELECTED ||
+            *(contourMask->pixel(point).data()) == MAX_SELECTED) {
             continue;
         }
         KisPixelSelectionSP mask = new KisPixelSelection(new KisSelectionDefaultBounds(resultMask));
@@ -984,8 +1012,11 @@ void KisEncloseAndFillPainter::Private::selectRegionsFromContourUntilColor(KisPi
         gc.setOpacitySpread(q->opacitySpread());
         // Use the enclosing mask as boundary so that we don't fill
         // potentially large regions in the outside
-        gc.fillSelectionUntilColorWithBoundary(mask, color, enclosingMask);
-        resultMask->applySelection(mask, SELECTION_ADD);
+        gc.fillSelectionUntilColorWithBoundary(mask, color, boundary);
+        contourMask->applySelection(mask, SELECTION_ADD);
+    }
+    if (distanceField) {
+        mergeGapClosedContourMask(resultMask, contourMask, enclosingMask, enclosingMaskRect, distanceField);
     }
 }
 
@@ -1009,10 +1040,17 @@ void KisEncloseAndFillPainter::Private::selectRegionsFromContourUntilColorOrTran
     if (enclosingPoints.isEmpty()) {
         return;
     }
+    // With gap closing enabled the contour regions are collected separately,
+    // since the band around the lineart should be restored only for them
+    KisLineartDistanceFieldSP distanceField;
+    KisPaintDeviceSP boundary = contourFillBoundary(enclosingMask, enclosingMaskRect, referenceDevice, &distanceField);
+    KisPixelSelectionSP contourMask =
+        distanceField ? KisPixelSelectionSP(new KisPixelSelection(new KisSelectionDefaultBounds(resultMask))) : resultMask;
     // Here we just fill all the areas from the border towards inside until the specific color
     for (const QPoint &point : enclosingPoints) {
         // Continue if the region under the point was already filled
-        if (*(resultMask->pixel(point).data()) == MAX_SELECTED) {
+        if (*(resultMask->pixel(point).data()) == MAX_SELECTED ||
+            *(contourMask->pixel(point).data()) == MAX_SELECTED) {
             continue;
         }
         KisPixelSelectionSP mask = new KisPixelSelection(new KisSelectionDefaultBounds(resultMask));
@@ -1021,9 +1059,39 @@ void KisEncloseAndFillPainter::Private::selectRegionsFromContourUntilColorOrTran
         gc.setOpacitySpread(q->opacitySpread());
         // Use the enclosing mask as boundary so that we don't fill
         // potentially large regions in the outside
-        gc.fillSelectionUntilColorOrTransparentWithBoundary(mask, color, enclosingMask);
-        resultMask->applySelection(mask, SELECTION_ADD);
+        gc.fillSelectionUntilColorOrTransparentWithBoundary(mask, color, boundary);
+        contourMask->applySelection(mask, SELECTION_ADD);
     }
+    if (distanceField) {
+        mergeGapClosedContourMask(resultMask, contourMask, enclosingMask, enclosingMaskRect, distanceField);
+    }
+}
+
+KisPaintDeviceSP KisEncloseAndFillPainter::Private::contourFillBoundary(KisPixelSelectionSP enclosingMask,
+                                                                      const QRect &enclosingMaskRect,
+                                                                      KisPaintDeviceSP referenceDevice,
+                                                                      KisLineartDistanceFieldSP *distanceField) const
+{
+    const int gapRadius = (q->closeGap() + 1) / 2;
+    if (gapRadius <= 0) {
+        return enclosingMask;
+    }
+    // The distance field is cached, so the consecutive enclose-and-fill
+    // operations on the same reference device don't recalculate it
+    *distanceField = KisLineartDistanceField::fetch(referenceDevice, enclosingMaskRect, gapRadius);
+    return (*distanceField)->createGapClosingBoundary(enclosingMaskRect, gapRadius, enclosingMask);
+}
+
+void KisEncloseAndFillPainter::Private::mergeGapClosedContourMask(KisPixelSelectionSP resultMask,
+                                                                  KisPixelSelectionSP contourMask,
+                                                                  KisPixelSelectionSP enclosingMask,
+                                                                  const QRect &enclosingMaskRect,
+                                                                  KisLineartDistanceFieldSP distanceField) const
+{
+    const int gapRadius = (q->closeGap() + 1) / 2;
+    distanceField->restoreGapClosingBand(contourMask, enclosingMaskRect, gapRadius);
+    contourMask->applySelection(enclosingMask, SELECTION_INTERSECT);
+    resultMask->applySelection(contourMask, SELECTION_ADD);
 }
 
 void KisEncloseAndFillPainter::Private::removeContourRegions(KisPixelSelectionSP resultMask,
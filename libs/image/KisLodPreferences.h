@@ -9,7 +9,14 @@ struct KisLodPreferences
     enum PreferenceFlag {
         None = 0x0,
         LodSupported = 0x1,
-        LodPreferred = 0x2
+        LodPreferred = 0x2,
+
+        /**
+         * The queue is allowed to pick a coarser level of detail than the
+         * desired one (up to maxLevelOfDetail()) when the strokes cannot
+         * keep up with the user. See KisAdaptiveLodController.
+         */
+        LodAdaptive = 0x4
     };
     Q_DECLARE_FLAGS(PreferenceFlags, PreferenceFlag)
 
@@ -18,15 +25,25 @@ struct KisLodPreferences
     }
 
     KisLodPreferences(PreferenceFlags flags, int desiredLevelOfDetail)
-        : m_flags(flags), m_desiredLevelOfDetail(desiredLevelOfDetail)
+        : KisLodPreferences(flags, desiredLevelOfDetail, desiredLevelOfDetail)
+    {
+    }
+
+    KisLodPreferences(PreferenceFlags flags, int desiredLevelOfDetail, int maxLevelOfDetail)
+        : m_flags(flags),
+          m_desiredLevelOfDetail(desiredLevelOfDetail),
+          m_maxLevelOfDetail(qMax(desiredLevelOfDetail, maxLevelOfDetail))
     {
         KIS_SAFE_ASSERT_RECOVER(m_desiredLevelOfDetail == 0 || m_flags & LodSupported) {
             m_desiredLevelOfDetail = 0;
+            m_maxLevelOfDetail = 0;
         }
     }
 
     KisLodPreferences(int desiredLevelOfDetail)
-        : m_flags(LodSupported | LodPreferred), m_desiredLevelOfDetail(desiredLevelOfDetail)
+        : m_flags(LodSupported | LodPreferred),
+          m_desiredLevelOfDetail(desiredLevelOfDetail),
+          m_maxLevelOfDetail(desiredLevelOfDetail)
     {
     }
 
@@ -44,13 +61,22 @@ struct KisLodPreferences
         return m_flags & LodSupported;
     }
 
+    bool lodAdaptive() const {
+        return m_flags & LodAdaptive;
+    }
+
     int desiredLevelOfDetail() const {
         return m_desiredLevelOfDetail;
     }
 
+    int maxLevelOfDetail() const {
+        return m_maxLevelOfDetail;
+    }
+
 private:
     PreferenceFlags m_flags = None;
     int m_desiredLevelOfDetail = 0;
+    int m_maxLevelOfDetail = 0;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(KisLodPreferences::PreferenceFlags)
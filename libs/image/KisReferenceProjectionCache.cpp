@@ -0,0 +1,216 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisReferenceProjectionCache.h"
+
+#include <algorithm>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <KoCompositeOpRegistry.h>
+
+#include "kis_image.h"
+#include "kis_node.h"
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "KisRegion.h"
+#include "krita_utils.h"
+
+namespace {
+
+/**
+ * The number of (root, labels) combinations kept in the cache. Usually
+ * all the tools share the same set of labels.
+ */
+const int maxCachedDevices = 2;
+
+/**
+ * The dirty rects are merged when there are more of them, so that long
+ * painting sessions between two fills do not grow the list unboundedly
+ */
+const int maxDirtyRects = 64;
+const int dirtyRectsGridSize = 64;
+
+struct ReferencedNode
+{
+    KisNodeWSP node;
+    quint8 opacity;
+
+    bool operator==(const ReferencedNode &rhs) const {
+        return node == rhs.node.data() && opacity == rhs.opacity;
+    }
+};
+
+struct CachedDevice
+{
+    KisNodeWSP root;
+    QList<int> selectedLabels;
+    KisMergeLabeledLayersCommand::GroupSelectionPolicy groupSelectionPolicy;
+
+    QVector<ReferencedNode> nodes;
+    KisPaintDeviceSP device;
+    QVector<QRect> dirtyRects;
+};
+
+/**
+ * Collects the visible layers accepted by the labels, bottom to top. When
+ * a group is accepted, its projection already contains the children, so
+ * they are not visited.
+ */
+void collectReferencedNodes(KisNodeSP node,
+                            const QList<int> &selectedLabels,
+                            KisMergeLabeledLayersCommand::GroupSelectionPolicy groupSelectionPolicy,
+                            QVector<ReferencedNode> &nodes)
+{
+    for (KisNodeSP child = node->firstChild(); child; child = child->nextSibling()) {
+        if (!child->inherits("KisLayer") || !child->visible()) continue;
+
+        if (KisMergeLabeledLayersCommand::acceptNode(child, selectedLabels, groupSelectionPolicy)) {
+            nodes.append({child, child->opacity()});
+        } else {
+            collectReferencedNodes(child, selectedLabels, groupSelectionPolicy, nodes);
+        }
+    }
+}
+
+}
+
+struct Q_DECL_HIDDEN KisReferenceProjectionCache::Private
+{
+    KisImage *image;
+
+    QMutex mutex;
+    QList<CachedDevice> devices;
+
+    void updateDevice(CachedDevice &cached);
+};
+
+void KisReferenceProjectionCache::Private::updateDevice(CachedDevice &cached)
+{
+    const QRect bounds = image->bounds();
+
+    QVector<QRect> patches;
+    Q_FOREACH (const QRect &rc, KisRegion::fromOverlappingRects(cached.dirtyRects, 64).rects()) {
+        patches += KritaUtils::splitRectIntoPatches(rc & bounds, KritaUtils::optimalPatchSize());
+    }
+    cached.dirtyRects.clear();
+
+    const QVector<ReferencedNode> &nodes = cached.nodes;
+    KisPaintDeviceSP device = cached.device;
+
+    QtConcurrent::blockingMap(patches, [&nodes, device] (const QRect &patchRect) {
+        device->clear(patchRect);
+
+        KisPainter gc(device);
+        gc.setCompositeOpId(COMPOSITE_OVER);
+
+        Q_FOREACH (const ReferencedNode &ref, nodes) {
+            KisNodeSP node = ref.node;
+            if (!node) continue;
+
+            gc.setOpacity(ref.opacity);
+            gc.bitBlt(patchRect.topLeft(), node->projection(), patchRect);
+        }
+    });
+}
+
+KisReferenceProjectionCache::KisReferenceProjectionCache(KisImage *image)
+    : m_d(new Private)
+{
+    m_d->image = image;
+}
+
+KisReferenceProjectionCache::~KisReferenceProjectionCache()
+{
+}
+
+KisPaintDeviceSP KisReferenceProjectionCache::labeledLayersDevice(KisNodeSP root,
+                                                                  const QList<int> &selectedLabels,
+                                                                  KisMergeLabeledLayersCommand::GroupSelectionPolicy groupSelectionPolicy)
+{
+    QVector<ReferencedNode> nodes;
+    collectReferencedNodes(root, selectedLabels, groupSelectionPolicy, nodes);
+
+    QMutexLocker l(&m_d->mutex);
+
+    auto it = std::find_if(m_d->devices.begin(), m_d->devices.end(),
+                           [&] (const CachedDevice &cached) {
+                               return cached.root == root.data() &&
+                                   cached.selectedLabels == selectedLabels &&
+                                   cached.groupSelectionPolicy == groupSelectionPolicy;
+                           });
+
+    if (it == m_d->devices.end()) {
+        CachedDevice cached;
+        cached.root = root;
+        cached.selectedLabels = selectedLabels;
+        cached.groupSelectionPolicy = groupSelectionPolicy;
+
+        m_d->devices.prepend(cached);
+        while (m_d->devices.size() > maxCachedDevices) {
+            m_d->devices.removeLast();
+        }
+        it = m_d->devices.begin();
+    }
+
+    CachedDevice &cached = *it;
+
+    if (!cached.device ||
+        cached.nodes != nodes ||
+        !(*cached.device->colorSpace() == *m_d->image->colorSpace())) {
+
+        cached.nodes = nodes;
+        cached.device = new KisPaintDevice(m_d->image->colorSpace(), "Reference Projection Cache");
+        cached.dirtyRects = {m_d->image->bounds()};
+    }
+
+    if (!cached.dirtyRects.isEmpty()) {
+        m_d->updateDevice(cached);
+    }
+
+    return cached.device;
+}
+
+namespace {
+
+void addDirtyRectImpl(QVector<QRect> &dirtyRects, const QRect &rc)
+{
+    if (rc.isEmpty()) return;
+
+    Q_FOREACH (const QRect &dirtyRect, dirtyRects) {
+        if (dirtyRect.contains(rc)) return;
+    }
+
+    dirtyRects.append(rc);
+
+    if (dirtyRects.size() > maxDirtyRects) {
+        dirtyRects = KisRegion::fromOverlappingRects(dirtyRects, dirtyRectsGridSize).rects();
+
+        if (dirtyRects.size() > maxDirtyRects) {
+            dirtyRects = {KisRegion(dirtyRects).boundingRect()};
+        }
+    }
+}
+
+}
+
+void KisReferenceProjectionCache::addDirtyRect(const QRect &rc)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    for (auto it = m_d->devices.begin(); it != m_d->devices.end(); ++it) {
+        addDirtyRectImpl(it->dirtyRects, rc);
+    }
+}
+
+void KisReferenceProjectionCache::invalidate()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->devices.clear();
+}
@@ -0,0 +1,68 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISREFERENCEPROJECTIONCACHE_H
+#define KISREFERENCEPROJECTIONCACHE_H
+
+#include <QList>
+#include <QScopedPointer>
+
+#include <kritaimage_export.h>
+#include <kis_types.h>
+
+#include "commands_new/KisMergeLabeledLayersCommand.h"
+
+/**
+ * A persistent merged projection of the color-labeled layers of the image,
+ * used as a reference device by the fill, enclose-and-fill and selection
+ * tools.
+ *
+ * Previously every click of these tools cloned the labeled layers into a
+ * temporary image and merged them from scratch. The cache keeps the merged
+ * device between the clicks and recomposes only the areas of the image that
+ * have been updated since the last request (KisImage reports them via
+ * addDirtyRect() when the projection update is finished).
+ *
+ * The merged device is recreated from scratch only when the set of the
+ * referenced layers, their order, visibility or opacity changes.
+ *
+ * The cache reads the projections of the layers, so it should be accessed
+ * only from the exclusive jobs of strokes (or when the image is locked).
+ */
+class KRITAIMAGE_EXPORT KisReferenceProjectionCache
+{
+public:
+    KisReferenceProjectionCache(KisImage *image);
+    ~KisReferenceProjectionCache();
+
+    /**
+     * Returns a device with the merged layers of \p root tagged with any
+     * of \p selectedLabels. The returned device is owned by the cache and
+     * is updated by the next calls, so the caller should make a (shallow)
+     * copy of it if it is going to be used after the current stroke job.
+     */
+    KisPaintDeviceSP labeledLayersDevice(KisNodeSP root,
+                                         const QList<int> &selectedLabels,
+                                         KisMergeLabeledLayersCommand::GroupSelectionPolicy groupSelectionPolicy);
+
+    /**
+     * Marks \p rc of all the cached devices as outdated. Thread-safe.
+     */
+    void addDirtyRect(const QRect &rc);
+
+    /**
+     * Drops all the cached devices. Thread-safe.
+     */
+    void invalidate();
+
+private:
+    Q_DISABLE_COPY(KisReferenceProjectionCache)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISREFERENCEPROJECTIONCACHE_H
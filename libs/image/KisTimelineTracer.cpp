@@ -0,0 +1,276 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTimelineTracer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRect>
+#include <QThread>
+#include <QVector>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+
+Q_GLOBAL_STATIC(KisTimelineTracer, s_instance)
+
+namespace {
+
+struct TracedSpan
+{
+    const char *category = 0;
+    QString name;
+    QVariantMap args;
+    qint64 startTime = 0;
+    qint64 endTime = 0;
+    int trackId = 0;
+};
+
+QJsonObject argsToJson(const QVariantMap &args)
+{
+    QJsonObject result;
+
+    for (auto it = args.constBegin(); it != args.constEnd(); ++it) {
+        if (it.value().type() == QVariant::Rect) {
+            const QRect rc = it.value().toRect();
+            result[it.key()] = QJsonArray{rc.x(), rc.y(), rc.width(), rc.height()};
+        } else {
+            result[it.key()] = QJsonValue::fromVariant(it.value());
+        }
+    }
+
+    return result;
+}
+
+}
+
+struct Q_DECL_HIDDEN KisTimelineTracer::Private
+{
+    QElapsedTimer timer;
+    QString traceFile;
+
+    mutable QMutex mutex;
+
+    QVector<TracedSpan> spans;
+    int nextSpan = 0;
+    int numSpans = 0;
+
+    QHash<QThread*, int> threadTracks;
+    QHash<QString, int> namedTracks;
+    QVector<QString> trackNames;
+
+    int trackIdLocked(const QString &track);
+
+    static const int defaultCapacity = 65536;
+};
+
+int KisTimelineTracer::Private::trackIdLocked(const QString &track)
+{
+    if (!track.isEmpty()) {
+        auto it = namedTracks.find(track);
+        if (it == namedTracks.end()) {
+            it = namedTracks.insert(track, trackNames.size());
+            trackNames.append(track);
+        }
+        return *it;
+    }
+
+    QThread *thread = QThread::currentThread();
+
+    auto it = threadTracks.find(thread);
+    if (it == threadTracks.end()) {
+        const int id = trackNames.size();
+
+        QString name;
+        if (qApp && thread == qApp->thread()) {
+            name = "GUI Thread";
+        } else {
+            name = QString("%1 %2")
+                .arg(thread->objectName().isEmpty() ? "Thread" : thread->objectName())
+                .arg(id);
+        }
+
+        it = threadTracks.insert(thread, id);
+        trackNames.append(name);
+    }
+    return *it;
+}
+
+KisTimelineTracer::Span::Span(const char *category, const char *name)
+    : m_tracer(KisTimelineTracer::instance()),
+      m_category(category),
+      m_name(name),
+      m_startTime(m_tracer->isEnabled() ? m_tracer->currentTime() : -1)
+{
+}
+
+KisTimelineTracer::Span::~Span()
+{
+    if (m_startTime >= 0) {
+        m_tracer->addSpan(m_category, QString::fromLatin1(m_name), m_startTime, m_tracer->currentTime(), m_args);
+    }
+}
+
+void KisTimelineTracer::Span::setArg(const QString &key, const QVariant &value)
+{
+    if (m_startTime >= 0) {
+        m_args.insert(key, value);
+    }
+}
+
+KisTimelineTracer::KisTimelineTracer()
+    : m_d(new Private)
+{
+    m_d->timer.start();
+    m_d->spans.resize(Private::defaultCapacity);
+
+    m_d->traceFile = KisImageConfig(true).timelineTraceFile();
+    m_enabled.storeRelease(!m_d->traceFile.isEmpty());
+}
+
+KisTimelineTracer::~KisTimelineTracer()
+{
+    if (!m_d->traceFile.isEmpty()) {
+        saveChromeTrace(m_d->traceFile);
+    }
+}
+
+KisTimelineTracer *KisTimelineTracer::instance()
+{
+    return s_instance;
+}
+
+void KisTimelineTracer::setEnabled(bool value)
+{
+    m_enabled.storeRelease(value);
+}
+
+void KisTimelineTracer::setCapacity(int value)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(value > 0);
+
+    QMutexLocker l(&m_d->mutex);
+
+    m_d->spans.clear();
+    m_d->spans.resize(value);
+    m_d->nextSpan = 0;
+    m_d->numSpans = 0;
+}
+
+int KisTimelineTracer::capacity() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->spans.size();
+}
+
+qint64 KisTimelineTracer::currentTime() const
+{
+    return m_d->timer.nsecsElapsed();
+}
+
+void KisTimelineTracer::addSpan(const char *category, const QString &name,
+                                qint64 startTime, qint64 endTime,
+                                const QVariantMap &args,
+                                const QString &track)
+{
+    if (!isEnabled()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    TracedSpan &span = m_d->spans[m_d->nextSpan];
+    span.category = category;
+    span.name = name;
+    span.args = args;
+    span.startTime = startTime;
+    span.endTime = endTime;
+    span.trackId = m_d->trackIdLocked(track);
+
+    m_d->nextSpan = (m_d->nextSpan + 1) % m_d->spans.size();
+    m_d->numSpans = qMin(m_d->numSpans + 1, m_d->spans.size());
+}
+
+int KisTimelineTracer::numSpans() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->numSpans;
+}
+
+void KisTimelineTracer::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    for (auto it = m_d->spans.begin(); it != m_d->spans.end(); ++it) {
+        *it = TracedSpan();
+    }
+    m_d->nextSpan = 0;
+    m_d->numSpans = 0;
+}
+
+QByteArray KisTimelineTracer::toChromeTrace() const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    QJsonArray events;
+
+    for (int i = 0; i < m_d->trackNames.size(); i++) {
+        QJsonObject event;
+        event["name"] = "thread_name";
+        event["ph"] = "M";
+        event["pid"] = 1;
+        event["tid"] = i;
+        event["args"] = QJsonObject{{"name", m_d->trackNames[i]}};
+        events.append(event);
+    }
+
+    const int capacity = m_d->spans.size();
+    const int firstSpan = (m_d->nextSpan - m_d->numSpans + capacity) % capacity;
+
+    for (int i = 0; i < m_d->numSpans; i++) {
+        const TracedSpan &span = m_d->spans[(firstSpan + i) % capacity];
+
+        // the trace format expects the time in microseconds
+        QJsonObject event;
+        event["name"] = span.name;
+        event["cat"] = QString::fromLatin1(span.category);
+        event["ph"] = "X";
+        event["ts"] = span.startTime / 1000.0;
+        event["dur"] = (span.endTime - span.startTime) / 1000.0;
+        event["pid"] = 1;
+        event["tid"] = span.trackId;
+
+        if (!span.args.isEmpty()) {
+            event["args"] = argsToJson(span.args);
+        }
+
+        events.append(event);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool KisTimelineTracer::saveChromeTrace(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnKrita << "KisTimelineTracer: failed to open the trace file" << fileName;
+        return false;
+    }
+
+    file.write(toChromeTrace());
+    return true;
+}
@@ -0,0 +1,118 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTIMELINETRACER_H
+#define KISTIMELINETRACER_H
+
+#include "kritaimage_export.h"
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * Records the timeline of the image updates: stroke jobs, merge walkers,
+ * LOD synchronizations and canvas uploads, and which thread executed each
+ * of them. The spans are stored in a ring buffer, so only the latest
+ * events are kept, and can be dumped in Chrome trace JSON format, which
+ * is understood by chrome://tracing and Perfetto.
+ *
+ * The tracer is disabled by default. It is enabled either explicitly via
+ * setEnabled() (e.g. in benchmarks), or by setting "timelineTraceFile"
+ * in the config. In the latter case the trace is written to that file
+ * when the application exits.
+ *
+ * When the tracer is disabled, recording a span costs one atomic read.
+ */
+class KRITAIMAGE_EXPORT KisTimelineTracer
+{
+public:
+    /**
+     * A scoped span. Measures the time between its construction and
+     * destruction and records it on the track of the current thread.
+     */
+    class KRITAIMAGE_EXPORT Span
+    {
+    public:
+        Span(const char *category, const char *name);
+        ~Span();
+
+        /**
+         * Adds an argument to the span, it will be shown in
+         * the event details
+         */
+        void setArg(const QString &key, const QVariant &value);
+
+    private:
+        Q_DISABLE_COPY(Span)
+
+        KisTimelineTracer *m_tracer;
+        const char *m_category;
+        const char *m_name;
+        QVariantMap m_args;
+        qint64 m_startTime;
+    };
+
+public:
+    KisTimelineTracer();
+    ~KisTimelineTracer();
+
+    static KisTimelineTracer* instance();
+
+    inline bool isEnabled() const {
+        return m_enabled.loadAcquire();
+    }
+
+    void setEnabled(bool value);
+
+    /**
+     * Sets the maximum number of the spans stored in the ring
+     * buffer. All the recorded spans are dropped.
+     */
+    void setCapacity(int value);
+    int capacity() const;
+
+    /**
+     * \return the time in nanoseconds since the creation of the tracer
+     */
+    qint64 currentTime() const;
+
+    /**
+     * Records a span on the track of the current thread, or on the
+     * virtual track \p track, if it is not empty. The time is measured
+     * with currentTime().
+     */
+    void addSpan(const char *category, const QString &name,
+                 qint64 startTime, qint64 endTime,
+                 const QVariantMap &args = QVariantMap(),
+                 const QString &track = QString());
+
+    /**
+     * \return the number of the spans currently stored
+     */
+    int numSpans() const;
+
+    void clear();
+
+    /**
+     * \return the stored spans in Chrome trace JSON format
+     */
+    QByteArray toChromeTrace() const;
+
+    bool saveChromeTrace(const QString &fileName) const;
+
+private:
+    Q_DISABLE_COPY(KisTimelineTracer)
+
+    QAtomicInt m_enabled;
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTIMELINETRACER_H
@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDabMaskCache.h"
+
+#include <QCache>
+#include <QGlobalStatic>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <KoColorSpace.h>
+
+#include "kis_fixed_paint_device.h"
+
+Q_GLOBAL_STATIC(KisDabMaskCache, s_instance)
+
+namespace {
+
+struct CachedDab {
+    CachedDab(KisFixedPaintDeviceSP _device) : device(_device) {}
+    KisFixedPaintDeviceSP device;
+};
+
+int dabCostKiB(KisFixedPaintDeviceSP dab)
+{
+    const int bytes = dab->bounds().width() * dab->bounds().height() * dab->pixelSize();
+    return qMax(1, bytes / 1024);
+}
+
+}
+
+struct KisDabMaskCache::Private
+{
+    QMutex mutex;
+    QCache<QByteArray, CachedDab> dabs;
+    Statistics statistics;
+};
+
+KisDabMaskCache::KisDabMaskCache(int maxMemoryKiB)
+    : m_d(new Private())
+{
+    m_d->dabs.setMaxCost(maxMemoryKiB);
+}
+
+KisDabMaskCache::~KisDabMaskCache()
+{
+}
+
+KisDabMaskCache *KisDabMaskCache::instance()
+{
+    return s_instance;
+}
+
+bool KisDabMaskCache::fetch(const QByteArray &key, const KoColorSpace *colorSpace, KisFixedPaintDeviceSP dab)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    CachedDab *cached = m_d->dabs.object(key);
+
+    if (!cached || *cached->device->colorSpace() != *colorSpace) {
+        m_d->statistics.misses++;
+        return false;
+    }
+
+    *dab = *cached->device;
+    m_d->statistics.hits++;
+
+    return true;
+}
+
+void KisDabMaskCache::insert(const QByteArray &key, KisFixedPaintDeviceSP dab)
+{
+    KisFixedPaintDeviceSP copy = new KisFixedPaintDevice(*dab);
+
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.insert(key, new CachedDab(copy), dabCostKiB(copy));
+}
+
+void KisDabMaskCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.clear();
+}
+
+void KisDabMaskCache::setMaxMemory(int maxMemoryKiB)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.setMaxCost(maxMemoryKiB);
+}
+
+int KisDabMaskCache::maxMemory() const
+{
+    QMutexLocker l(&m_d->mutex);
+    return m_d->dabs.maxCost();
+}
+
+KisDabMaskCache::Statistics KisDabMaskCache::takeStatistics()
+{
+    QMutexLocker l(&m_d->mutex);
+
+    Statistics result = m_d->statistics;
+    m_d->statistics = Statistics();
+    return result;
+}
@@ -0,0 +1,84 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDABMASKCACHE_H
+#define KISDABMASKCACHE_H
+
+#include "kritaimage_export.h"
+#include <QScopedPointer>
+#include <QByteArray>
+
+#include "kis_types.h"
+
+class KoColorSpace;
+
+/**
+ * A bounded LRU cache of rendered dabs shared between the strokes.
+ *
+ * KisDabCacheBase can reuse only the previous dab of the current stroke.
+ * With repetitive stamping or textured presets the same dabs are rendered
+ * again and again in every stroke. This cache keeps the recently rendered
+ * (not post-processed) dabs under a key built from the quantized dab
+ * parameters and the identity of the brush, so the next stroke with the
+ * same preset can just copy them.
+ *
+ * The keys are built by the paintop system (see KisDabCacheBase), the cache
+ * itself treats them as opaque byte arrays. All the methods are thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisDabMaskCache
+{
+public:
+    struct Statistics {
+        qint64 hits = 0;
+        qint64 misses = 0;
+
+        qreal hitRate() const {
+            return hits + misses > 0 ? qreal(hits) / (hits + misses) : 0.0;
+        }
+    };
+
+public:
+    KisDabMaskCache(int maxMemoryKiB = defaultMaxMemoryKiB);
+    ~KisDabMaskCache();
+
+    static KisDabMaskCache* instance();
+
+    /**
+     * Copies the cached dab into \p dab if there is a dab with \p key
+     * rendered in \p colorSpace. Counts the request as a hit or a miss.
+     *
+     * \return true on a cache hit
+     */
+    bool fetch(const QByteArray &key, const KoColorSpace *colorSpace, KisFixedPaintDeviceSP dab);
+
+    /**
+     * Stores a copy of \p dab under \p key. The least recently used dabs
+     * are dropped when the memory limit is exceeded.
+     */
+    void insert(const QByteArray &key, KisFixedPaintDeviceSP dab);
+
+    void clear();
+
+    void setMaxMemory(int maxMemoryKiB);
+    int maxMemory() const;
+
+    /**
+     * \return the hits and misses counted since the last call to
+     * takeStatistics() and resets the counters
+     */
+    Statistics takeStatistics();
+
+private:
+    static const int defaultMaxMemoryKiB = 32 * 1024;
+
+private:
+    Q_DISABLE_COPY(KisDabMaskCache)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISDABMASKCACHE_H
@@ -14,6 +14,7 @@
 #include "kis_painter.h"
 #include "kis_layer.h"
 #include "KisDeleteLaterWrapper.h"
+#include "KisReferenceProjectionCache.h"
 
 
 
@@ -29,6 +30,17 @@ KisMergeLabeledLayersCommand::KisMergeLabeledLayersCommand(KisImageSP refImage,
 {
 }
 
+KisMergeLabeledLayersCommand::KisMergeLabeledLayersCommand(KisPaintDeviceSP refPaintDevice,
+                                                           KisNodeSP currentRoot, QList<int> selectedLabels,
+                                                           GroupSelectionPolicy groupSelectionPolicy)
+    : KUndo2Command(kundo2_noi18n("MERGE_LABELED_LAYERS"))
+    , m_refPaintDevice(refPaintDevice)
+    , m_currentRoot(currentRoot)
+    , m_selectedLabels(selectedLabels)
+    , m_groupSelectionPolicy(groupSelectionPolicy)
+{
+}
+
 KisMergeLabeledLayersCommand::~KisMergeLabeledLayersCommand()
 {
 }
@@ -42,6 +54,8 @@ void KisMergeLabeledLayersCommand::redo()
 {
     if (m_refImage) {
         mergeLabeledLayers();
+    } else if (m_refPaintDevice) {
+        fetchCachedLabeledLayers();
     }
     KUndo2Command::redo();
 }
@@ -114,13 +128,36 @@ void KisMergeLabeledLayersCommand::mergeLabeledLayers()
 
 }
 
+void KisMergeLabeledLayersCommand::fetchCachedLabeledLayers()
+{
+    KisImageSP image = m_currentRoot->image();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(image);
+
+    KisPaintDeviceSP cachedDevice =
+        image->referenceProjectionCache()->labeledLayersDevice(m_currentRoot, m_selectedLabels, m_groupSelectionPolicy);
+
+    // the cached device will be updated later, so share its tiles instead
+    m_refPaintDevice->makeCloneFromRough(cachedDevice, cachedDevice->extent());
+
+    // release resources: they are still owned by the caller
+    m_refPaintDevice.clear();
+    m_currentRoot.clear();
+}
+
 bool KisMergeLabeledLayersCommand::acceptNode(KisNodeSP node)
+{
+    return acceptNode(node, m_selectedLabels, m_groupSelectionPolicy);
+}
+
+bool KisMergeLabeledLayersCommand::acceptNode(KisNodeSP node,
+                                              const QList<int> &selectedLabels,
+                                              GroupSelectionPolicy groupSelectionPolicy)
 {
     if (node->inherits("KisGroupLayer") &&
-        (m_groupSelectionPolicy == GroupSelectionPolicy_NeverSelect ||
-          (m_groupSelectionPolicy == GroupSelectionPolicy_SelectIfColorLabeled &&
+        (groupSelectionPolicy == GroupSelectionPolicy_NeverSelect ||
+          (groupSelectionPolicy == GroupSelectionPolicy_SelectIfColorLabeled &&
            node->colorLabelIndex() == 0))) {
         return false;
     }
-    return m_selectedLabels.contains(node->colorLabelIndex());
+    return selectedLabels.contains(node->colorLabelIndex());
 }
@@ -35,6 +35,18 @@ public:
                                  KisNodeSP currentRoot,
                                  QList<int> selectedLabels,
                                  GroupSelectionPolicy groupSelectionPolicy = GroupSelectionPolicy_SelectAlways);
+
+    /**
+     * Fetches the merged layers from the reference projection cache of
+     * the image of \p currentRoot instead of merging them from scratch.
+     * Only the areas updated since the previous request are recomposed.
+     *
+     * \see KisReferenceProjectionCache
+     */
+    KisMergeLabeledLayersCommand(KisPaintDeviceSP refPaintDevice,
+                                 KisNodeSP currentRoot,
+                                 QList<int> selectedLabels,
+                                 GroupSelectionPolicy groupSelectionPolicy = GroupSelectionPolicy_SelectAlways);
     ~KisMergeLabeledLayersCommand() override;
 
     void undo() override;
@@ -43,8 +55,13 @@ public:
     static KisImageSP createRefImage(KisImageSP originalImage, QString name);
     static KisPaintDeviceSP createRefPaintDevice(KisImageSP originalImage, QString name);
 
+    static bool acceptNode(KisNodeSP node,
+                           const QList<int> &selectedLabels,
+                           GroupSelectionPolicy groupSelectionPolicy);
+
 private:
     void mergeLabeledLayers();
+    void fetchCachedLabeledLayers();
     bool acceptNode(KisNodeSP node);
 
 private:
@@ -0,0 +1,411 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisLineartDistanceField.h"
+
+#include <cmath>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
+#include "kis_sequential_iterator.h"
+#include "kis_global.h"
+#include "krita_utils.h"
+
+namespace {
+
+const int patchSize = 64;
+const float infiniteDistance = 1e20f;
+
+/**
+ * The number of fields kept in the cache. Usually a user works with
+ * only a couple of reference layers at a time.
+ */
+const int maxCachedFields = 4;
+
+struct FieldCache
+{
+    QMutex mutex;
+    QList<KisLineartDistanceFieldSP> fields;
+};
+
+Q_GLOBAL_STATIC(FieldCache, s_cache)
+
+/**
+ * One-dimensional squared Euclidean distance transform by
+ * Felzenszwalb and Huttenlocher, "Distance Transforms of
+ * Sampled Functions"
+ */
+void distanceTransform1D(const float *f, float *d, int n, int *v, float *z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -infiniteDistance;
+    z[1] = infiniteDistance;
+
+    for (int q = 1; q < n; q++) {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = infiniteDistance;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+class LineartDetector
+{
+public:
+    LineartDetector(const KoColorSpace *colorSpace, int threshold)
+        : m_colorSpace(colorSpace),
+          m_pixelSize(colorSpace->pixelSize()),
+          m_threshold(threshold)
+    {
+    }
+
+    bool isLineart(const quint8 *pixelPtr) {
+        if (m_pixelSize > int(sizeof(quint64))) {
+            return calculateInkness(pixelPtr) >= m_threshold;
+        }
+
+        quint64 key = 0;
+        memcpy(&key, pixelPtr, m_pixelSize);
+
+        QHash<quint64, bool>::const_iterator it = m_cache.constFind(key);
+        if (it != m_cache.constEnd()) {
+            return *it;
+        }
+
+        const bool result = calculateInkness(pixelPtr) >= m_threshold;
+        m_cache.insert(key, result);
+        return result;
+    }
+
+private:
+    int calculateInkness(const quint8 *pixelPtr) const {
+        return m_colorSpace->opacityU8(pixelPtr) * (quint8_MAX - m_colorSpace->intensity8(pixelPtr)) / quint8_MAX;
+    }
+
+private:
+    const KoColorSpace *m_colorSpace;
+    int m_pixelSize;
+    int m_threshold;
+    QHash<quint64, bool> m_cache;
+};
+
+}
+
+struct Q_DECL_HIDDEN KisLineartDistanceField::Private
+{
+    KisPaintDeviceWSP referenceDevice;
+    int sequenceNumber = -1;
+    QRect rect;
+    int maxDistance = 0;
+    int lineartThreshold = 0;
+
+    KisPaintDeviceSP distances;
+
+    void calculatePatch(KisPaintDeviceSP device, const QRect &patchRect);
+};
+
+void KisLineartDistanceField::Private::calculatePatch(KisPaintDeviceSP device, const QRect &patchRect)
+{
+    /**
+     * All the lineart pixels closer than maxDistance lie in the
+     * window, so the distances inside the patch are exact.
+     */
+    const QRect windowRect = patchRect.adjusted(-maxDistance, -maxDistance, maxDistance, maxDistance);
+    const int width = windowRect.width();
+    const int height = windowRect.height();
+    const int pixelSize = device->pixelSize();
+
+    QVector<quint8> srcBuffer(width * height * pixelSize);
+    device->readBytes(srcBuffer.data(), windowRect);
+
+    LineartDetector detector(device->colorSpace(), lineartThreshold);
+
+    QVector<float> field(width * height);
+    bool hasLineart = false;
+
+    const quint8 *srcPtr = srcBuffer.constData();
+    for (int i = 0; i < width * height; i++) {
+        const bool isLineart = detector.isLineart(srcPtr);
+        field[i] = isLineart ? 0.0f : infiniteDistance;
+        hasLineart |= isLineart;
+        srcPtr += pixelSize;
+    }
+
+    // the patch is far from any lineart, keep the default pixel
+    if (!hasLineart) return;
+
+    const int n = qMax(width, height);
+    QVector<float> f(n);
+    QVector<float> d(n);
+    QVector<int> v(n);
+    QVector<float> z(n + 1);
+
+    // columns
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            f[y] = field[y * width + x];
+        }
+        distanceTransform1D(f.constData(), d.data(), height, v.data(), z.data());
+        for (int y = 0; y < height; y++) {
+            field[y * width + x] = d[y];
+        }
+    }
+
+    // rows, only the ones intersecting the patch
+    const int offsetX = patchRect.x() - windowRect.x();
+    const int offsetY = patchRect.y() - windowRect.y();
+
+    QVector<quint8> dstBuffer(patchRect.width() * patchRect.height());
+    quint8 *dstPtr = dstBuffer.data();
+
+    const float maxSquaredDistance = maxDistance * maxDistance;
+
+    for (int y = offsetY; y < offsetY + patchRect.height(); y++) {
+        distanceTransform1D(field.constData() + y * width, d.data(), width, v.data(), z.data());
+
+        for (int x = offsetX; x < offsetX + patchRect.width(); x++) {
+            const float squaredDistance = d[x];
+            *dstPtr++ = squaredDistance > maxSquaredDistance ?
+                MAX_SELECTED : quint8(qRound(std::sqrt(squaredDistance)));
+        }
+    }
+
+    distances->writeBytes(dstBuffer.constData(), patchRect);
+}
+
+KisLineartDistanceField::KisLineartDistanceField(KisPaintDeviceSP referenceDevice,
+                                                 const QRect &rect,
+                                                 int maxDistance,
+                                                 int lineartThreshold)
+    : m_d(new Private)
+{
+    m_d->referenceDevice = referenceDevice;
+    m_d->sequenceNumber = referenceDevice->sequenceNumber();
+    m_d->rect = rect;
+    m_d->maxDistance = qBound(1, maxDistance, int(MAX_SELECTED) - 1);
+    m_d->lineartThreshold = lineartThreshold;
+
+    const KoColorSpace *alpha8 = KoColorSpaceRegistry::instance()->alpha8();
+    m_d->distances = new KisPaintDevice(alpha8);
+
+    KoColor farPixel(alpha8);
+    *farPixel.data() = MAX_SELECTED;
+    m_d->distances->setDefaultPixel(farPixel);
+
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rect, QSize(patchSize, patchSize));
+
+    QtConcurrent::blockingMap(patches, [this, referenceDevice] (const QRect &patchRect) {
+        m_d->calculatePatch(referenceDevice, patchRect);
+    });
+}
+
+KisLineartDistanceField::~KisLineartDistanceField()
+{
+}
+
+KisLineartDistanceFieldSP KisLineartDistanceField::fetch(KisPaintDeviceSP referenceDevice,
+                                                         const QRect &rect,
+                                                         int maxDistance,
+                                                         int lineartThreshold)
+{
+    FieldCache *cache = s_cache;
+
+    {
+        QMutexLocker l(&cache->mutex);
+
+        for (auto it = cache->fields.begin(); it != cache->fields.end(); ++it) {
+            if ((*it)->isValidFor(referenceDevice, rect, maxDistance, lineartThreshold)) {
+                KisLineartDistanceFieldSP field = *it;
+
+                // move to the front of the LRU list
+                cache->fields.erase(it);
+                cache->fields.prepend(field);
+                return field;
+            }
+        }
+    }
+
+    /**
+     * The field is calculated outside the lock, so concurrent fills on
+     * different reference layers don't block each other.
+     */
+    KisLineartDistanceFieldSP field(new KisLineartDistanceField(referenceDevice, rect, maxDistance, lineartThreshold));
+
+    QMutexLocker l(&cache->mutex);
+
+    // drop the outdated fields of this device and the dead ones
+    for (auto it = cache->fields.begin(); it != cache->fields.end();) {
+        KisPaintDeviceSP device = (*it)->m_d->referenceDevice;
+        if (!device || device == referenceDevice) {
+            it = cache->fields.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    cache->fields.prepend(field);
+    while (cache->fields.size() > maxCachedFields) {
+        cache->fields.removeLast();
+    }
+
+    return field;
+}
+
+void KisLineartDistanceField::clearCache()
+{
+    FieldCache *cache = s_cache;
+    QMutexLocker l(&cache->mutex);
+    cache->fields.clear();
+}
+
+bool KisLineartDistanceField::isValidFor(KisPaintDeviceSP referenceDevice,
+                                         const QRect &rect,
+                                         int maxDistance,
+                                         int lineartThreshold) const
+{
+    KisPaintDeviceSP device = m_d->referenceDevice;
+
+    return device &&
+        device == referenceDevice &&
+        m_d->sequenceNumber == referenceDevice->sequenceNumber() &&
+        m_d->rect.contains(rect) &&
+        m_d->maxDistance >= qMin(maxDistance, int(MAX_SELECTED) - 1) &&
+        m_d->lineartThreshold == lineartThreshold;
+}
+
+QRect KisLineartDistanceField::rect() const
+{
+    return m_d->rect;
+}
+
+int KisLineartDistanceField::maxDistance() const
+{
+    return m_d->maxDistance;
+}
+
+quint8 KisLineartDistanceField::distance(const QPoint &pt) const
+{
+    return *m_d->distances->pixel(pt).data();
+}
+
+KisPaintDeviceSP KisLineartDistanceField::distanceDevice() const
+{
+    return m_d->distances;
+}
+
+KisPixelSelectionSP KisLineartDistanceField::createGapClosingBoundary(const QRect &rc, int radius, KisPaintDeviceSP existingBoundary) const
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(radius <= m_d->maxDistance);
+
+    KisPixelSelectionSP boundary = new KisPixelSelection();
+
+    KisSequentialIterator dstIt(boundary, rc);
+    KisSequentialConstIterator distanceIt(m_d->distances, rc);
+
+    if (existingBoundary) {
+        KisSequentialConstIterator boundaryIt(existingBoundary, rc);
+
+        while (dstIt.nextPixel() && distanceIt.nextPixel() && boundaryIt.nextPixel()) {
+            if (*distanceIt.rawDataConst() > radius) {
+                *dstIt.rawData() = *boundaryIt.rawDataConst();
+            }
+        }
+    } else {
+        while (dstIt.nextPixel() && distanceIt.nextPixel()) {
+            if (*distanceIt.rawDataConst() > radius) {
+                *dstIt.rawData() = MAX_SELECTED;
+            }
+        }
+    }
+
+    return boundary;
+}
+
+void KisLineartDistanceField::restoreGapClosingBand(KisPixelSelectionSP mask, const QRect &rc, int radius) const
+{
+    const QRect growRect = mask->selectedExactRect().adjusted(-radius, -radius, radius, radius) & rc;
+    if (growRect.isEmpty()) return;
+
+    const int width = growRect.width();
+    const int height = growRect.height();
+
+    QVector<quint8> maskBuffer(width * height);
+    QVector<quint8> distanceBuffer(width * height);
+    mask->readBytes(maskBuffer.data(), growRect);
+    m_d->distances->readBytes(distanceBuffer.data(), growRect);
+
+    auto isExcludedBand = [&distanceBuffer, radius] (int index) {
+        const quint8 distance = distanceBuffer[index];
+        return distance > 0 && distance <= radius;
+    };
+
+    /**
+     * Walk from the filled pixels through the band pixels only, making
+     * at most radius steps. So the fill doesn't spread past the places
+     * where the color threshold has stopped it, and doesn't flow out
+     * through the gaps it has closed.
+     */
+    QVector<int> front;
+    for (int i = 0; i < width * height; i++) {
+        if (maskBuffer[i] != MIN_SELECTED) {
+            front.append(i);
+        }
+    }
+
+    bool hasChanges = false;
+
+    for (int step = 0; step < radius && !front.isEmpty(); step++) {
+        QVector<int> nextFront;
+
+        Q_FOREACH (int index, front) {
+            const int x = index % width;
+            const int y = index / width;
+
+            for (int ny = qMax(0, y - 1); ny <= qMin(height - 1, y + 1); ny++) {
+                for (int nx = qMax(0, x - 1); nx <= qMin(width - 1, x + 1); nx++) {
+                    const int neighbourIndex = ny * width + nx;
+
+                    if (maskBuffer[neighbourIndex] == MIN_SELECTED && isExcludedBand(neighbourIndex)) {
+                        maskBuffer[neighbourIndex] = maskBuffer[index];
+                        nextFront.append(neighbourIndex);
+                    }
+                }
+            }
+        }
+
+        hasChanges |= !nextFront.isEmpty();
+        front.swap(nextFront);
+    }
+
+    if (hasChanges) {
+        mask->writeBytes(maskBuffer.constData(), growRect);
+        mask->invalidateOutlineCache();
+    }
+}
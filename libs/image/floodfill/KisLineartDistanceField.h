@@ -0,0 +1,115 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISLINEARTDISTANCEFIELD_H
+#define KISLINEARTDISTANCEFIELD_H
+
+#include <QRect>
+#include <QScopedPointer>
+#include <QSharedPointer>
+
+#include <kritaimage_export.h>
+#include <kis_types.h>
+
+class KisLineartDistanceField;
+typedef QSharedPointer<KisLineartDistanceField> KisLineartDistanceFieldSP;
+
+/**
+ * Distance from every pixel of a reference device to the nearest pixel
+ * of lineart, clamped to \p maxDistance.
+ *
+ * A pixel is considered lineart when its "inkness" (opacity multiplied
+ * by darkness) is not less than \p lineartThreshold, so both the lines
+ * painted on a transparent layer and the lines of a merged projection
+ * on a white background are detected.
+ *
+ * The field is calculated once in tile-sized patches (in parallel) and is
+ * stored in an alpha8 paint device, where MAX_SELECTED means "farther than
+ * maxDistance". After that gap-closing and enclose-and-fill queries become
+ * simple per-pixel lookups instead of repeated morphological operations on
+ * the full-resolution selections.
+ *
+ * Use fetch() to get a field shared between several fill operations.
+ * The cached field is recalculated automatically when the reference device
+ * changes (its sequence number is checked on every fetch).
+ */
+class KRITAIMAGE_EXPORT KisLineartDistanceField
+{
+public:
+    static const int defaultLineartThreshold = 128;
+
+public:
+    KisLineartDistanceField(KisPaintDeviceSP referenceDevice,
+                            const QRect &rect,
+                            int maxDistance,
+                            int lineartThreshold = defaultLineartThreshold);
+    ~KisLineartDistanceField();
+
+    /**
+     * Returns a field for \p referenceDevice covering at least \p rect
+     * and \p maxDistance. The field is reused if it is still valid for
+     * the current state of the device, otherwise it is recalculated.
+     */
+    static KisLineartDistanceFieldSP fetch(KisPaintDeviceSP referenceDevice,
+                                           const QRect &rect,
+                                           int maxDistance,
+                                           int lineartThreshold = defaultLineartThreshold);
+
+    /**
+     * Drops all the cached fields
+     */
+    static void clearCache();
+
+    /**
+     * \return true if the field was calculated from the current state of
+     * \p referenceDevice and covers the requested parameters
+     */
+    bool isValidFor(KisPaintDeviceSP referenceDevice,
+                    const QRect &rect,
+                    int maxDistance,
+                    int lineartThreshold) const;
+
+    QRect rect() const;
+    int maxDistance() const;
+
+    /**
+     * \return the distance to the nearest lineart pixel, or MAX_SELECTED
+     * if the lineart is farther than maxDistance()
+     */
+    quint8 distance(const QPoint &pt) const;
+
+    /**
+     * The alpha8 device storing the distances
+     */
+    KisPaintDeviceSP distanceDevice() const;
+
+    /**
+     * Creates a boundary mask for the flood fill that closes the gaps in
+     * the lineart not wider than (2 * \p radius). The pixels farther than
+     * \p radius from the lineart are selected.
+     *
+     * If \p existingBoundary is not null, the result is intersected with it.
+     */
+    KisPixelSelectionSP createGapClosingBoundary(const QRect &rc, int radius,
+                                                 KisPaintDeviceSP existingBoundary = KisPaintDeviceSP()) const;
+
+    /**
+     * Adds back to \p mask the pixels of the band that was cut off by the
+     * gap closing boundary (0 < distance <= \p radius), as far as they are
+     * 8-connected to the filled pixels through the band within \p radius
+     * steps. The lineart pixels and the pixels farther from the lineart
+     * are never added.
+     */
+    void restoreGapClosingBand(KisPixelSelectionSP mask, const QRect &rc, int radius) const;
+
+private:
+    Q_DISABLE_COPY(KisLineartDistanceField)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISLINEARTDISTANCEFIELD_H
@@ -0,0 +1,567 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisParallelFloodFill.h"
+
+#include <algorithm>
+
+#include <QHash>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <KoAlwaysInline.h>
+#include <KoColor.h>
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
+#include "kis_global.h"
+#include "kis_assert.h"
+#include "kis_algebra_2d.h"
+
+namespace {
+
+/**
+ * Block borders are aligned to the tile grid, so that the jobs
+ * never write into the same tile concurrently
+ */
+const int tileSize = 64;
+
+/**
+ * Calculates the opacity of the fill for every pixel of the source
+ * device. The math must be kept in sync with the selection policies
+ * of KisScanlineFill.
+ */
+class OpacityCalculator
+{
+public:
+    OpacityCalculator(const KoColorSpace *colorSpace, const KoColor &srcColor, int threshold, int softness)
+        : m_colorSpace(colorSpace),
+          m_srcColor(srcColor),
+          m_srcPixelPtr(m_srcColor.data()),
+          m_pixelSize(colorSpace->pixelSize()),
+          m_threshold(threshold),
+          m_softness(softness)
+    {
+    }
+
+    ALWAYS_INLINE quint8 calculateOpacity(const quint8 *pixelPtr, quint8 selectedness) {
+        if (!selectedness) {
+            return MIN_SELECTED;
+        }
+
+        if (!m_softness) {
+            return calculateDifference(pixelPtr) <= m_threshold ? MAX_SELECTED : MIN_SELECTED;
+        }
+
+        if (m_threshold == 0) {
+            return MIN_SELECTED;
+        }
+
+        // Integer version of: (threshold - diff) / (threshold * softness)
+        const int diff = calculateDifference(pixelPtr);
+        if (diff < m_threshold) {
+            const int v = (m_threshold - diff) * MAX_SELECTED * 100 / (m_threshold * m_softness);
+            return v > MAX_SELECTED ? MAX_SELECTED : v;
+        } else {
+            return MIN_SELECTED;
+        }
+    }
+
+private:
+    ALWAYS_INLINE quint8 calculateDifference(const quint8 *pixelPtr) {
+        if (m_pixelSize > int(sizeof(quint64))) {
+            return calculateDifferenceImpl(pixelPtr);
+        }
+
+        quint64 key = 0;
+        memcpy(&key, pixelPtr, m_pixelSize);
+
+        QHash<quint64, quint8>::const_iterator it = m_differences.constFind(key);
+        if (it != m_differences.constEnd()) {
+            return *it;
+        }
+
+        const quint8 result = calculateDifferenceImpl(pixelPtr);
+        m_differences.insert(key, result);
+        return result;
+    }
+
+    ALWAYS_INLINE quint8 calculateDifferenceImpl(const quint8 *pixelPtr) {
+        if (m_threshold == 1) {
+            return memcmp(m_srcPixelPtr, pixelPtr, m_pixelSize) == 0 ? 0 : quint8_MAX;
+        }
+        return m_colorSpace->differenceA(m_srcPixelPtr, pixelPtr);
+    }
+
+private:
+    const KoColorSpace *m_colorSpace;
+    KoColor m_srcColor;
+    const quint8 *m_srcPixelPtr;
+    int m_pixelSize;
+    int m_threshold;
+    int m_softness;
+    QHash<quint64, quint8> m_differences;
+};
+
+/**
+ * A horizontal run of pixels with non-zero fill opacity. Coordinates
+ * are local to the block.
+ */
+struct Run {
+    int row;
+    int start;
+    int end;
+    int label;
+};
+
+struct Block {
+    QRect rect;
+    int numLabels = 0;
+    int globalBase = 0;
+    int seedLabel = -1;
+
+    /**
+     * Labels of the pixels lying on the block border. Zero means the
+     * pixel is not fillable, otherwise the value is (label + 1).
+     */
+    QVector<quint16> topEdge;
+    QVector<quint16> bottomEdge;
+    QVector<quint16> leftEdge;
+    QVector<quint16> rightEdge;
+
+    QVector<bool> selectedLabels;
+};
+
+int findRoot(QVector<int> &parents, int x)
+{
+    int root = x;
+    while (parents[root] != root) {
+        root = parents[root];
+    }
+
+    while (parents[x] != root) {
+        const int next = parents[x];
+        parents[x] = root;
+        x = next;
+    }
+
+    return root;
+}
+
+void unite(QVector<int> &parents, int a, int b)
+{
+    a = findRoot(parents, a);
+    b = findRoot(parents, b);
+
+    if (a != b) {
+        // keep the smaller index as a root to make the result deterministic
+        if (a < b) {
+            parents[b] = a;
+        } else {
+            parents[a] = b;
+        }
+    }
+}
+
+}
+
+struct Q_DECL_HIDDEN KisParallelFloodFill::Private
+{
+    KisPaintDeviceSP device;
+    QPoint startPoint;
+    QRect boundingRect;
+    int threshold = 0;
+    int opacitySpread = 0;
+    int blockSize = 4 * tileSize;
+
+    /**
+     * Splits the block into runs of fillable pixels, labels them with
+     * the connected component index (dense, starting from zero) and
+     * optionally stores the per-pixel opacity into \p opacityBuffer
+     */
+    int labelBlock(const QRect &rect,
+                   const quint8 *srcBuffer,
+                   const quint8 *selectionBuffer,
+                   OpacityCalculator &calculator,
+                   QVector<Run> *runs,
+                   quint8 *opacityBuffer) const;
+
+    template <typename Func>
+    void runImpl(const KoColor &srcColor, int softness,
+                 KisPaintDeviceSP boundarySelection,
+                 Func writeBlockFunc);
+};
+
+int KisParallelFloodFill::Private::labelBlock(const QRect &rect,
+                                              const quint8 *srcBuffer,
+                                              const quint8 *selectionBuffer,
+                                              OpacityCalculator &calculator,
+                                              QVector<Run> *runs,
+                                              quint8 *opacityBuffer) const
+{
+    const int pixelSize = device->pixelSize();
+    const int width = rect.width();
+    const int height = rect.height();
+
+    QVector<quint8> rowOpacity(width);
+    QVector<int> parents;
+
+    int prevRowStart = 0;
+    int prevRowEnd = 0;
+
+    for (int y = 0; y < height; y++) {
+        const quint8 *srcPtr = srcBuffer + y * width * pixelSize;
+        const quint8 *selectionPtr = selectionBuffer ? selectionBuffer + y * width : 0;
+
+        for (int x = 0; x < width; x++) {
+            rowOpacity[x] = calculator.calculateOpacity(srcPtr, selectionPtr ? *selectionPtr : MAX_SELECTED);
+            srcPtr += pixelSize;
+            if (selectionPtr) selectionPtr++;
+        }
+
+        if (opacityBuffer) {
+            memcpy(opacityBuffer + y * width, rowOpacity.constData(), width);
+        }
+
+        const int currentRowStart = runs->size();
+        int prevIndex = prevRowStart;
+
+        int x = 0;
+        while (x < width) {
+            if (!rowOpacity[x]) {
+                x++;
+                continue;
+            }
+
+            Run run;
+            run.row = y;
+            run.start = x;
+            while (x < width && rowOpacity[x]) x++;
+            run.end = x - 1;
+            run.label = parents.size();
+            parents.append(run.label);
+
+            // connect to all the overlapping runs of the previous row
+            while (prevIndex < prevRowEnd && (*runs)[prevIndex].end < run.start) {
+                prevIndex++;
+            }
+
+            for (int i = prevIndex; i < prevRowEnd && (*runs)[i].start <= run.end; i++) {
+                unite(parents, run.label, (*runs)[i].label);
+            }
+
+            runs->append(run);
+        }
+
+        prevRowStart = currentRowStart;
+        prevRowEnd = runs->size();
+    }
+
+    QVector<int> denseLabels(parents.size(), -1);
+    int numLabels = 0;
+
+    for (auto it = runs->begin(); it != runs->end(); ++it) {
+        const int root = findRoot(parents, it->label);
+        if (denseLabels[root] < 0) {
+            denseLabels[root] = numLabels++;
+        }
+        it->label = denseLabels[root];
+    }
+
+    return numLabels;
+}
+
+template <typename Func>
+void KisParallelFloodFill::Private::runImpl(const KoColor &srcColor, int softness,
+                                            KisPaintDeviceSP boundarySelection,
+                                            Func writeBlockFunc)
+{
+    const QRect rc = boundingRect;
+    if (!rc.contains(startPoint)) return;
+
+    const int pixelSize = device->pixelSize();
+
+    const int firstCol = KisAlgebra2D::divideFloor(rc.left(), blockSize);
+    const int lastCol = KisAlgebra2D::divideFloor(rc.right(), blockSize);
+    const int firstRow = KisAlgebra2D::divideFloor(rc.top(), blockSize);
+    const int lastRow = KisAlgebra2D::divideFloor(rc.bottom(), blockSize);
+    const int numCols = lastCol - firstCol + 1;
+    const int numRows = lastRow - firstRow + 1;
+
+    QVector<Block> blocks(numCols * numRows);
+
+    for (int row = 0; row < numRows; row++) {
+        for (int col = 0; col < numCols; col++) {
+            const QRect blockRect((firstCol + col) * blockSize,
+                                  (firstRow + row) * blockSize,
+                                  blockSize, blockSize);
+            blocks[row * numCols + col].rect = blockRect & rc;
+        }
+    }
+
+    auto readBlock = [this, pixelSize, boundarySelection] (const QRect &rect,
+                                                          QVector<quint8> *srcBuffer,
+                                                          QVector<quint8> *selectionBuffer) {
+        srcBuffer->resize(rect.width() * rect.height() * pixelSize);
+        device->readBytes(srcBuffer->data(), rect);
+
+        if (boundarySelection) {
+            selectionBuffer->resize(rect.width() * rect.height());
+            boundarySelection->readBytes(selectionBuffer->data(), rect);
+        }
+    };
+
+    /**
+     * 1) Label every block independently, keeping only the labels
+     *    of the border pixels
+     */
+    const QPoint seed = startPoint;
+    QtConcurrent::blockingMap(blocks, [&] (Block &block) {
+        QVector<quint8> srcBuffer;
+        QVector<quint8> selectionBuffer;
+        readBlock(block.rect, &srcBuffer, &selectionBuffer);
+
+        OpacityCalculator calculator(device->colorSpace(), srcColor, threshold, softness);
+        QVector<Run> runs;
+        block.numLabels = labelBlock(block.rect, srcBuffer.constData(),
+                                     boundarySelection ? selectionBuffer.constData() : 0,
+                                     calculator, &runs, 0);
+
+        const int width = block.rect.width();
+        const int height = block.rect.height();
+
+        block.topEdge.fill(0, width);
+        block.bottomEdge.fill(0, width);
+        block.leftEdge.fill(0, height);
+        block.rightEdge.fill(0, height);
+
+        const QPoint localSeed = seed - block.rect.topLeft();
+
+        Q_FOREACH (const Run &run, runs) {
+            if (run.row == 0) {
+                std::fill(block.topEdge.begin() + run.start, block.topEdge.begin() + run.end + 1, run.label + 1);
+            }
+            if (run.row == height - 1) {
+                std::fill(block.bottomEdge.begin() + run.start, block.bottomEdge.begin() + run.end + 1, run.label + 1);
+            }
+            if (run.start == 0) {
+                block.leftEdge[run.row] = run.label + 1;
+            }
+            if (run.end == width - 1) {
+                block.rightEdge[run.row] = run.label + 1;
+            }
+            if (run.row == localSeed.y() && run.start <= localSeed.x() && localSeed.x() <= run.end) {
+                block.seedLabel = run.label;
+            }
+        }
+    });
+
+    /**
+     * 2) Merge the labels of the neighbouring blocks
+     */
+    int totalLabels = 0;
+    int seedBlockIndex = -1;
+    for (int i = 0; i < blocks.size(); i++) {
+        blocks[i].globalBase = totalLabels;
+        totalLabels += blocks[i].numLabels;
+
+        if (blocks[i].rect.contains(seed)) {
+            seedBlockIndex = i;
+        }
+    }
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(seedBlockIndex >= 0);
+    const Block &seedBlock = blocks[seedBlockIndex];
+
+    // the seed pixel is not fillable
+    if (seedBlock.seedLabel < 0) return;
+
+    QVector<int> parents(totalLabels);
+    for (int i = 0; i < totalLabels; i++) {
+        parents[i] = i;
+    }
+
+    for (int row = 0; row < numRows; row++) {
+        for (int col = 0; col < numCols; col++) {
+            const Block &block = blocks[row * numCols + col];
+
+            if (col < numCols - 1) {
+                const Block &right = blocks[row * numCols + col + 1];
+                for (int y = 0; y < block.rightEdge.size(); y++) {
+                    if (block.rightEdge[y] && right.leftEdge[y]) {
+                        unite(parents,
+                              block.globalBase + block.rightEdge[y] - 1,
+                              right.globalBase + right.leftEdge[y] - 1);
+                    }
+                }
+            }
+
+            if (row < numRows - 1) {
+                const Block &bottom = blocks[(row + 1) * numCols + col];
+                for (int x = 0; x < block.bottomEdge.size(); x++) {
+                    if (block.bottomEdge[x] && bottom.topEdge[x]) {
+                        unite(parents,
+                              block.globalBase + block.bottomEdge[x] - 1,
+                              bottom.globalBase + bottom.topEdge[x] - 1);
+                    }
+                }
+            }
+        }
+    }
+
+    const int seedRoot = findRoot(parents, seedBlock.globalBase + seedBlock.seedLabel);
+
+    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+        it->topEdge.clear();
+        it->bottomEdge.clear();
+        it->leftEdge.clear();
+        it->rightEdge.clear();
+
+        bool hasSelectedLabels = false;
+        QVector<bool> selectedLabels(it->numLabels, false);
+        for (int i = 0; i < it->numLabels; i++) {
+            if (findRoot(parents, it->globalBase + i) == seedRoot) {
+                selectedLabels[i] = true;
+                hasSelectedLabels = true;
+            }
+        }
+
+        if (hasSelectedLabels) {
+            it->selectedLabels = selectedLabels;
+        }
+    }
+
+    parents.clear();
+
+    /**
+     * 3) Relabel the blocks touched by the seed component and write
+     *    their pixels. Labelling is deterministic, so the labels are
+     *    the same as in the first pass.
+     */
+    QtConcurrent::blockingMap(blocks, [&] (Block &block) {
+        if (block.selectedLabels.isEmpty()) return;
+
+        QVector<quint8> srcBuffer;
+        QVector<quint8> selectionBuffer;
+        readBlock(block.rect, &srcBuffer, &selectionBuffer);
+
+        OpacityCalculator calculator(device->colorSpace(), srcColor, threshold, softness);
+        QVector<Run> runs;
+        QVector<quint8> opacity(block.rect.width() * block.rect.height());
+        labelBlock(block.rect, srcBuffer.constData(),
+                   boundarySelection ? selectionBuffer.constData() : 0,
+                   calculator, &runs, opacity.data());
+
+        // clear the opacity of the pixels not belonging to the seed component
+        const int width = block.rect.width();
+        Q_FOREACH (const Run &run, runs) {
+            if (!block.selectedLabels[run.label]) {
+                memset(opacity.data() + run.row * width + run.start, 0, run.end - run.start + 1);
+            }
+        }
+
+        writeBlockFunc(block.rect, srcBuffer, opacity);
+    });
+}
+
+KisParallelFloodFill::KisParallelFloodFill(KisPaintDeviceSP device, const QPoint &startPoint, const QRect &boundingRect)
+    : m_d(new Private)
+{
+    m_d->device = device;
+    m_d->startPoint = startPoint;
+    m_d->boundingRect = boundingRect;
+}
+
+KisParallelFloodFill::~KisParallelFloodFill()
+{
+}
+
+void KisParallelFloodFill::setThreshold(int threshold)
+{
+    m_d->threshold = threshold;
+}
+
+void KisParallelFloodFill::setOpacitySpread(int opacitySpread)
+{
+    m_d->opacitySpread = opacitySpread;
+}
+
+void KisParallelFloodFill::setBlockSize(int size)
+{
+    /**
+     * Border labels are stored as quint16, so the block must not
+     * be bigger than 256x256 pixels
+     */
+    m_d->blockSize = qBound(1, (size + tileSize - 1) / tileSize, 4) * tileSize;
+}
+
+void KisParallelFloodFill::fillColor(const KoColor &originalFillColor)
+{
+    fillColor(originalFillColor, m_d->device);
+}
+
+void KisParallelFloodFill::fillColor(const KoColor &originalFillColor, KisPaintDeviceSP externalDevice)
+{
+    const KoColor srcColor(m_d->device->pixel(m_d->startPoint));
+    KoColor fillColor(originalFillColor);
+    fillColor.convertTo(m_d->device->colorSpace());
+
+    const int pixelSize = m_d->device->pixelSize();
+    KIS_SAFE_ASSERT_RECOVER_RETURN(externalDevice->pixelSize() == pixelSize);
+
+    const bool inPlace = externalDevice == m_d->device;
+
+    m_d->runImpl(srcColor, 0, 0,
+        [&] (const QRect &rect, QVector<quint8> &srcBuffer, const QVector<quint8> &opacity) {
+            QVector<quint8> externalBuffer;
+            QVector<quint8> &dstBuffer = inPlace ? srcBuffer : externalBuffer;
+
+            if (!inPlace) {
+                externalBuffer.resize(srcBuffer.size());
+                externalDevice->readBytes(externalBuffer.data(), rect);
+            }
+
+            quint8 *dstPtr = dstBuffer.data();
+            const quint8 *fillPtr = fillColor.data();
+
+            for (int i = 0; i < opacity.size(); i++) {
+                if (opacity[i] == MAX_SELECTED) {
+                    memcpy(dstPtr, fillPtr, pixelSize);
+                }
+                dstPtr += pixelSize;
+            }
+
+            externalDevice->writeBytes(dstBuffer.constData(), rect);
+        });
+}
+
+void KisParallelFloodFill::fillSelection(KisPixelSelectionSP pixelSelection)
+{
+    fillSelectionWithBoundary(pixelSelection, 0);
+}
+
+void KisParallelFloodFill::fillSelectionWithBoundary(KisPixelSelectionSP pixelSelection, KisPaintDeviceSP existingSelection)
+{
+    const KoColor srcColor(m_d->device->pixel(m_d->startPoint));
+    const int softness = 100 - m_d->opacitySpread;
+
+    m_d->runImpl(srcColor, softness, existingSelection,
+        [&] (const QRect &rect, QVector<quint8> &srcBuffer, const QVector<quint8> &opacity) {
+            Q_UNUSED(srcBuffer);
+
+            QVector<quint8> dstBuffer(opacity.size());
+            pixelSelection->readBytes(dstBuffer.data(), rect);
+
+            for (int i = 0; i < opacity.size(); i++) {
+                if (opacity[i]) {
+                    dstBuffer[i] = opacity[i];
+                }
+            }
+
+            pixelSelection->writeBytes(dstBuffer.constData(), rect);
+        });
+}
@@ -0,0 +1,83 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPARALLELFLOODFILL_H
+#define KISPARALLELFLOODFILL_H
+
+#include <QScopedPointer>
+
+#include <kritaimage_export.h>
+#include <kis_types.h>
+
+class KoColor;
+
+/**
+ * A tile-parallel alternative to KisScanlineFill for very big fill areas.
+ *
+ * The bounding rect is split into tile-aligned blocks. Every block is
+ * labelled independently (connected runs of non-transparent fill opacity),
+ * then the labels are merged across block borders with a union-find and
+ * only the blocks containing the component of the seed point are written.
+ * The first and the last passes run concurrently on the global thread pool.
+ *
+ * The result is pixel-identical to KisScanlineFill for the supported
+ * operations. Only the labels of block borders are kept between the passes,
+ * so the memory overhead is proportional to the perimeter of the blocks,
+ * not to their area.
+ */
+class KRITAIMAGE_EXPORT KisParallelFloodFill
+{
+public:
+    KisParallelFloodFill(KisPaintDeviceSP device, const QPoint &startPoint, const QRect &boundingRect);
+    ~KisParallelFloodFill();
+
+    /**
+     * Fill the source device with \p fillColor
+     */
+    void fillColor(const KoColor &fillColor);
+
+    /**
+     * Fill \p externalDevice with \p fillColor basing on the contents
+     * of the source device.
+     */
+    void fillColor(const KoColor &fillColor, KisPaintDeviceSP externalDevice);
+
+    /**
+     * Fill \p pixelSelection with the opacity of the contiguous area
+     */
+    void fillSelection(KisPixelSelectionSP pixelSelection);
+
+    /**
+     * Fill \p pixelSelection with the opacity of the contiguous area.
+     * This method uses an existing selection as boundary for the flood fill.
+     */
+    void fillSelectionWithBoundary(KisPixelSelectionSP pixelSelection, KisPaintDeviceSP existingSelection);
+
+    /**
+     * \see KisScanlineFill::setThreshold()
+     */
+    void setThreshold(int threshold);
+
+    /**
+     * \see KisScanlineFill::setOpacitySpread()
+     */
+    void setOpacitySpread(int opacitySpread);
+
+    /**
+     * Set the size of the blocks processed by a single job. The value is
+     * rounded up to the size of the tile and limited to 256 pixels.
+     * Used in unittests only.
+     */
+    void setBlockSize(int size);
+
+private:
+    Q_DISABLE_COPY(KisParallelFloodFill)
+
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISPARALLELFLOODFILL_H
@@ -15,6 +15,13 @@ KisAbstractProjectionPlane::~KisAbstractProjectionPlane()
 {
 }
 
+KisRegion KisAbstractProjectionPlane::opaqueRegion(const QRect &rect, const KoColorSpace *dstColorSpace) const
+{
+    Q_UNUSED(rect);
+    Q_UNUSED(dstColorSpace);
+    return KisRegion();
+}
+
 QRect KisDumbProjectionPlane::recalculate(const QRect& rect, KisNodeSP filthyNode)
 {
     Q_UNUSED(filthyNode);
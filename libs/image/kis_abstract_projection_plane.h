@@ -9,9 +9,11 @@
 
 #include "kis_types.h"
 #include "kis_layer.h"
+#include <KisRegion.h>
 
 class QRect;
 class KisPainter;
+class KoColorSpace;
 
 
 /**
@@ -84,6 +86,16 @@ public:
      * Returns a list of devices which should synchronize the lod cache on update
      */
     virtual KisPaintDeviceList getLodCapableDevices() const = 0;
+
+    /**
+     * Returns the part of \p rect where apply() fully overwrites
+     * the pixels of a projection with \p dstColorSpace, i.e. the plane
+     * is opaque there and is applied with the normal blending mode.
+     * KisAsyncMerger uses it to skip compositing of the layers below.
+     * The result may be smaller than the real opaque area. The default
+     * implementation returns an empty region.
+     */
+    virtual KisRegion opaqueRegion(const QRect &rect, const KoColorSpace *dstColorSpace) const;
 };
 
 /**
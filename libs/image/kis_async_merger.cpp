@@ -7,6 +7,7 @@
 
 
 #include <kis_debug.h>
+#include <QAtomicInteger>
 #include <QBitArray>
 
 #include <KoChannelInfo.h>
@@ -33,6 +34,8 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisBelowLayersProjectionCache.h"
+#include "KisTimelineTracer.h"
 
 
 //#define DEBUG_MERGER
@@ -203,6 +206,27 @@ private:
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
 
+namespace {
+
+struct CullingCounters {
+    QAtomicInteger<qint64> composites;
+    QAtomicInteger<qint64> skippedComposites;
+    QAtomicInteger<qint64> clippedComposites;
+};
+
+CullingCounters s_cullingCounters;
+
+}
+
+KisAsyncMerger::CullingStatistics KisAsyncMerger::takeCullingStatistics()
+{
+    CullingStatistics result;
+    result.composites = s_cullingCounters.composites.fetchAndStoreOrdered(0);
+    result.skippedComposites = s_cullingCounters.skippedComposites.fetchAndStoreOrdered(0);
+    result.clippedComposites = s_cullingCounters.clippedComposites.fetchAndStoreOrdered(0);
+    return result;
+}
+
 void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
     KisMergeWalker::LeafStack &leafStack = walker.leafStack();
 
@@ -246,8 +270,26 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         if (!m_currentProjection) {
             setupProjection(currentLeaf, applyRect, useTempProjections);
+
+            if (m_currentProjection) {
+                const QVector<KisBaseRectsWalker::JobItem> levelItems =
+                    collectLevelItems(item, leafStack);
+
+                m_numCachedBelowLayers =
+                    fetchBelowLayersProjection(levelItems, walker.levelOfDetail());
+                prepareOcclusionCulling(levelItems);
+            }
+        }
+
+        if (m_numCachedBelowLayers > 0) {
+            DEBUG_NODE_ACTION("Skipping", "N_BELOW_FILTHY (cached)", currentLeaf, applyRect);
+            m_numCachedBelowLayers--;
+            continue;
         }
 
+        KisTimelineTracer *tracer = KisTimelineTracer::instance();
+        const qint64 traceStartTime = tracer->isEnabled() ? tracer->currentTime() : -1;
+
         KisUpdateOriginalVisitor originalVisitor(applyRect,
                                                  m_currentProjection,
                                                  walker.cropRect());
@@ -281,6 +323,12 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         compositeWithProjection(currentLeaf, applyRect);
 
+        if (traceStartTime >= 0) {
+            tracer->addSpan("merge", currentLeaf->node()->name(),
+                            traceStartTime, tracer->currentTime(),
+                            {{"applyRect", applyRect}});
+        }
+
         if(item.m_position & KisMergeWalker::N_TOPMOST) {
             writeProjection(currentLeaf, useTempProjections, applyRect);
             resetProjection();
@@ -308,6 +356,115 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
+    m_numCachedBelowLayers = 0;
+    m_occludedRegions.clear();
+}
+
+QVector<KisBaseRectsWalker::JobItem>
+KisAsyncMerger::collectLevelItems(const KisBaseRectsWalker::JobItem &firstItem,
+                                  const KisBaseRectsWalker::LeafStack &leafStack)
+{
+    QVector<KisBaseRectsWalker::JobItem> items;
+    items.append(firstItem);
+
+    for (int i = leafStack.size() - 1;
+         i >= 0 && !(items.last().m_position & KisBaseRectsWalker::N_TOPMOST); i--) {
+
+        items.append(leafStack[i]);
+    }
+
+    return items;
+}
+
+int KisAsyncMerger::fetchBelowLayersProjection(const QVector<KisBaseRectsWalker::JobItem> &levelItems,
+                                               int levelOfDetail)
+{
+    KisProjectionLeafSP parentLeaf = levelItems.first().m_leaf->parent();
+    KisGroupLayer *group = parentLeaf ?
+        qobject_cast<KisGroupLayer*>(parentLeaf->node().data()) : 0;
+    if (!group) return 0;
+
+    KisBelowLayersProjectionCache *cache = group->belowLayersProjectionCache();
+
+    /**
+     * The cache can be used only when the current level has a single
+     * filthy layer and all the layers below it are plainly composited
+     * into the same rect. Otherwise the updated area of the level is
+     * just invalidated in the cache.
+     */
+    const QRect rect = levelItems.first().m_applyRect;
+    QRect levelRect;
+    KisProjectionLeafSP filthyLeaf;
+    QVector<KisProjectionLeafSP> belowLeaves;
+    bool canUseCache = levelItems.last().m_position & KisBaseRectsWalker::N_TOPMOST;
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, levelItems) {
+        const int position = item.m_position;
+
+        levelRect |= item.m_applyRect;
+
+        if (position & (KisBaseRectsWalker::N_FILTHY | KisBaseRectsWalker::N_FILTHY_PROJECTION)) {
+            canUseCache &= !filthyLeaf && item.m_applyRect == rect;
+            filthyLeaf = item.m_leaf;
+        } else if (!filthyLeaf) {
+            canUseCache &= position & KisBaseRectsWalker::N_BELOW_FILTHY &&
+                !(position & KisBaseRectsWalker::N_EXTRA) &&
+                !item.m_leaf->isRoot() &&
+                item.m_applyRect == rect;
+            belowLeaves.append(item.m_leaf);
+        }
+    }
+
+    if (!canUseCache || !filthyLeaf ||
+        belowLeaves.size() < KisBelowLayersProjectionCache::minCachedLayers) {
+
+        cache->invalidate(levelRect, levelOfDetail);
+        return 0;
+    }
+
+    cache->fetchBelowLayers(filthyLeaf, belowLeaves, rect, levelOfDetail, m_currentProjection);
+    return belowLeaves.size();
+}
+
+void KisAsyncMerger::prepareOcclusionCulling(const QVector<KisBaseRectsWalker::JobItem> &levelItems)
+{
+    m_occludedRegions.clear();
+
+    const KoColorSpace *dstColorSpace = m_currentProjection->colorSpace();
+    QRegion occludedRegion;
+
+    /**
+     * Walk the level from top to bottom accumulating the opaque areas of
+     * the layers. Only the layers that are not recalculated by this merge
+     * can be trusted, i.e. the ones whose projection is already final.
+     * The layers reading the projection below them (adjustment layers and
+     * the updates of N_EXTRA layers) need all the lower layers, so the
+     * culling starts from scratch below them.
+     */
+    for (auto it = levelItems.crbegin(); it != levelItems.crend(); ++it) {
+        const KisBaseRectsWalker::JobItem &item = *it;
+        KisProjectionLeafSP leaf = item.m_leaf;
+
+        if (!occludedRegion.isEmpty()) {
+            m_occludedRegions.insert(leaf.data(), occludedRegion);
+        }
+
+        if (item.m_position & KisBaseRectsWalker::N_EXTRA || leaf->dependsOnLowerNodes()) {
+            occludedRegion = QRegion();
+            continue;
+        }
+
+        const bool isRecalculated =
+            item.m_position & (KisBaseRectsWalker::N_FILTHY | KisBaseRectsWalker::N_FILTHY_PROJECTION);
+        const bool projectionIsFinal =
+            !isRecalculated ||
+            (leaf->projection() == leaf->original() &&
+             !qobject_cast<KisCloneLayer*>(leaf->node().data()));
+
+        if (leaf->visible() && projectionIsFinal) {
+            occludedRegion += leaf->projectionPlane()->opaqueRegion(item.m_applyRect, dstColorSpace).toQRegion();
+        }
+    }
 }
 
 void KisAsyncMerger::setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection) {
@@ -354,6 +511,29 @@ bool KisAsyncMerger::compositeWithProjection(KisProjectionLeafSP leaf, const QRe
     if (!m_currentProjection) return true;
     if (!leaf->visible()) return true;
 
+    s_cullingCounters.composites.ref();
+
+    auto it = m_occludedRegions.constFind(leaf.data());
+    if (it != m_occludedRegions.constEnd() && it->intersects(rect)) {
+        const QRegion visibleRegion = QRegion(rect) - *it;
+
+        if (visibleRegion.isEmpty()) {
+            s_cullingCounters.skippedComposites.ref();
+            DEBUG_NODE_ACTION("Skipping occluded projection", "", leaf, rect);
+            return true;
+        }
+
+        s_cullingCounters.clippedComposites.ref();
+
+        for (const QRect &rc : visibleRegion) {
+            KisPainter gc(m_currentProjection);
+            leaf->projectionPlane()->apply(&gc, rc);
+        }
+
+        DEBUG_NODE_ACTION("Compositing clipped projection", "", leaf, rect);
+        return true;
+    }
+
     KisPainter gc(m_currentProjection);
     leaf->projectionPlane()->apply(&gc, rect);
 
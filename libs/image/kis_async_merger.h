@@ -6,23 +6,48 @@
 #ifndef __KIS_ASYNC_MERGER_H
 #define __KIS_ASYNC_MERGER_H
 
+#include <QHash>
+#include <QRegion>
+
 #include "kritaimage_export.h"
 #include "kis_types.h"
+#include "kis_base_rects_walker.h"
 
 class QRect;
 class KisBaseRectsWalker;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
+public:
+    /**
+     * Counters of the occlusion culling, collected by all the mergers
+     */
+    struct CullingStatistics {
+        qint64 composites = 0;
+        qint64 skippedComposites = 0;
+        qint64 clippedComposites = 0;
+    };
+
 public:
     void startMerge(KisBaseRectsWalker &walker, bool notifyClones = true);
 
+    /**
+     * \return the culling counters collected since the last call
+     * to takeCullingStatistics() and resets them
+     */
+    static CullingStatistics takeCullingStatistics();
+
 private:
     inline void resetProjection();
     inline void setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection);
     inline void writeProjection(KisProjectionLeafSP topmostLeaf, bool useTempProjection, const QRect &rect);
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
+    QVector<KisBaseRectsWalker::JobItem> collectLevelItems(const KisBaseRectsWalker::JobItem &firstItem,
+                                                           const KisBaseRectsWalker::LeafStack &leafStack);
+    int fetchBelowLayersProjection(const QVector<KisBaseRectsWalker::JobItem> &levelItems,
+                                   int levelOfDetail);
+    void prepareOcclusionCulling(const QVector<KisBaseRectsWalker::JobItem> &levelItems);
 
 private:
     /**
@@ -49,6 +74,19 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    /**
+     * The number of the next layers of the current level whose
+     * projections have already been written by the below layers
+     * projection cache, so they should not be composited again
+     */
+    int m_numCachedBelowLayers = 0;
+
+    /**
+     * The areas of the current level covered by the opaque layers lying
+     * above the given leaf. The leaf is not composited there.
+     */
+    QHash<KisProjectionLeaf*, QRegion> m_occludedRegions;
 };
 
 
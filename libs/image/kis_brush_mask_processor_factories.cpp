@@ -198,7 +198,7 @@ void FastRowProcessor<KisCurveCircleMaskGenerator>::process<Vc::CurrentImplement
 
     float *bufferPointer = buffer;
 
-    qreal *curveDataPointer = d->curveData.data();
+    const float *curveDataPointer = d->vectorCurveData.constData();
 
     Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
 
@@ -455,7 +455,7 @@ void FastRowProcessor<KisCurveRectangleMaskGenerator>::process<Vc::CurrentImplem
 
     float *bufferPointer = buffer;
 
-    qreal *curveDataPointer = d->curveData.data();
+    const float *curveDataPointer = d->vectorCurveData.constData();
 
     Vc::float_v currentIndices = Vc::float_v::IndexesFromZero();
 
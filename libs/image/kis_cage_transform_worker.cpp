@@ -355,12 +355,16 @@ void KisCageTransformWorker::run(KisPaintDeviceSP srcDevice, KisPaintDeviceSP ds
     }
 
     GridIterationTools::PaintDevicePolygonOp polygonOp(srcDevice, tempDevice);
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::PaintDevicePolygonOp>
+        parallelOp(polygonOp, QPoint(tempDevice->x(), tempDevice->y()));
+
     Private::MapIndexesOp indexesOp(m_d.data());
     GridIterationTools::iterateThroughGrid
-        <GridIterationTools::IncompletePolygonPolicy>(polygonOp, indexesOp,
+        <GridIterationTools::IncompletePolygonPolicy>(parallelOp, indexesOp,
                                                       m_d->gridSize,
                                                       m_d->validPoints,
                                                       transformedPoints);
+    parallelOp.flush();
 
     QRect rect = tempDevice->extent();
     KisPainter gc(dstDevice);
@@ -417,12 +421,15 @@ QImage KisCageTransformWorker::runOnQImage(QPointF *newOffset)
     }
 
     GridIterationTools::QImagePolygonOp polygonOp(m_d->srcImage, tempImage, m_d->srcImageOffset, dstQImageOffset);
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp);
+
     Private::MapIndexesOp indexesOp(m_d.data());
     GridIterationTools::iterateThroughGrid
-        <GridIterationTools::IncompletePolygonPolicy>(polygonOp, indexesOp,
+        <GridIterationTools::IncompletePolygonPolicy>(parallelOp, indexesOp,
                                                       m_d->gridSize,
                                                       m_d->validPoints,
                                                       transformedPoints);
+    parallelOp.flush();
 
     {
         QPainter gc(&dstImage);
@@ -26,6 +26,7 @@ KisCurveCircleMaskGenerator::KisCurveCircleMaskGenerator(qreal diameter, qreal r
     // here we set resolution for the maximum size of the brush!
     d->curveResolution = qRound(qMax(width(), height()) * OVERSAMPLING);
     d->curveData = curve.floatTransfer(d->curveResolution + 2);
+    d->updateVectorCurveData();
     d->curvePoints = curve.points();
     setCurveString(curve.toString());
     d->dirty = false;
@@ -119,6 +120,7 @@ void KisCurveCircleMaskGenerator::setSoftness(qreal softness)
     d->dirty = true;
     KisMaskGenerator::setSoftness(softness);
     KisCurveCircleMaskGenerator::transformCurveForSoftness(softness,d->curvePoints, d->curveResolution+2, d->curveData);
+    d->updateVectorCurveData();
     d->dirty = false;
 }
 
@@ -7,6 +7,9 @@
 #ifndef KIS_CURVE_CIRCLE_MASK_GENERATOR_P_H
 #define KIS_CURVE_CIRCLE_MASK_GENERATOR_P_H
 
+#include <algorithm>
+#include <QVector>
+
 #include "kis_antialiasing_fade_maker.h"
 #include "kis_brush_mask_applicator_base.h"
 
@@ -22,6 +25,7 @@ struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
         ycoef(rhs.ycoef),
         curveResolution(rhs.curveResolution),
         curveData(rhs.curveData),
+        vectorCurveData(rhs.vectorCurveData),
         curvePoints(rhs.curvePoints),
         dirty(true),
         fadeMaker(rhs.fadeMaker,*this)
@@ -32,12 +36,20 @@ struct Q_DECL_HIDDEN KisCurveCircleMaskGenerator::Private
     qreal ycoef {0.0};
     qreal curveResolution {0.0};
     QVector<qreal> curveData;
+    // single-precision copy of curveData, the SIMD applicator gathers
+    // from it without converting every sample from double
+    QVector<float> vectorCurveData;
     QList<QPointF> curvePoints;
     bool dirty {false};
 
     KisAntialiasingFadeMaker1D<Private> fadeMaker;
     QScopedPointer<KisBrushMaskApplicatorBase> applicator;
 
+    void updateVectorCurveData() {
+        vectorCurveData.resize(curveData.size());
+        std::copy(curveData.constBegin(), curveData.constEnd(), vectorCurveData.begin());
+    }
+
     inline quint8 value(qreal dist) const;
 };
 
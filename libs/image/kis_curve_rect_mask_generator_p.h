@@ -7,7 +7,9 @@
 #ifndef KIS_CURVE_RECT_MASK_GENERATOR_P_H
 #define KIS_CURVE_RECT_MASK_GENERATOR_P_H
 
+#include <algorithm>
 #include <QScopedPointer>
+#include <QVector>
 
 #include "kis_antialiasing_fade_maker.h"
 #include "kis_brush_mask_applicator_base.h"
@@ -24,6 +26,7 @@ struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
         ycoeff(rhs.ycoeff),
         curveResolution(rhs.curveResolution),
         curveData(rhs.curveData),
+        vectorCurveData(rhs.vectorCurveData),
         curvePoints(rhs.curvePoints),
         dirty(rhs.dirty),
         fadeMaker(rhs.fadeMaker, *this)
@@ -34,12 +37,20 @@ struct Q_DECL_HIDDEN KisCurveRectangleMaskGenerator::Private
     qreal ycoeff {0.0};
     qreal curveResolution {0.0};
     QVector<qreal> curveData;
+    // single-precision copy of curveData, the SIMD applicator gathers
+    // from it without converting every sample from double
+    QVector<float> vectorCurveData;
     QList<QPointF> curvePoints;
     bool dirty {false};
 
     KisAntialiasingFadeMaker2D<Private> fadeMaker;
     QScopedPointer<KisBrushMaskApplicatorBase> applicator;
 
+    void updateVectorCurveData() {
+        vectorCurveData.resize(curveData.size());
+        std::copy(curveData.constBegin(), curveData.constEnd(), vectorCurveData.begin());
+    }
+
     inline quint8 value(qreal xr, qreal yr) const;
 };
 
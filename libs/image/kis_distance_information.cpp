@@ -13,6 +13,7 @@
 #include <QtCore/qmath.h>
 #include <QVector2D>
 #include <QTransform>
+#include <QAtomicInteger>
 #include "kis_algebra_2d.h"
 #include "kis_dom_utils.h"
 
@@ -26,6 +27,8 @@ const qreal MIN_TIMED_INTERVAL = 0.5;
 // Largest allowed interval when timed spacing is enabled, in milliseconds.
 const qreal MAX_TIMED_INTERVAL = LONG_TIME;
 
+static QAtomicInteger<qint64> s_numPaintedDabs;
+
 struct Q_DECL_HIDDEN KisDistanceInformation::Private {
     Private() :
         accumDistance(),
@@ -403,6 +406,7 @@ void KisDistanceInformation::registerPaintedDab(const KisPaintInformation &info,
     m_d->timing = timing;
 
     m_d->currentDabSeqNo++;
+    s_numPaintedDabs.ref();
 
     m_d->lastMaxPressure = qMax(info.pressure(), m_d->lastMaxPressure);
 }
@@ -631,3 +635,7 @@ qreal KisDistanceInformation::scalarDistanceApprox() const
     return m_d->totalDistance;
 }
 
+qint64 KisDistanceInformation::takeNumPaintedDabs()
+{
+    return s_numPaintedDabs.fetchAndStoreOrdered(0);
+}
@@ -140,6 +140,13 @@ public:
                             const KisSpacingInformation &spacing,
                             const KisTimingInformation &timing);
 
+    /**
+     * \return the number of dabs registered by all the distance information
+     * objects since the last call and resets the counter. Used by the
+     * benchmarks for measuring the dab throughput.
+     */
+    static qint64 takeNumPaintedDabs();
+
     qreal getNextPointPosition(const QPointF &start,
                                const QPointF &end,
                                qreal startTime,
@@ -41,6 +41,8 @@
 #include "kis_pixel_selection.h"
 #include <KoCompositeOpRegistry.h>
 #include <floodfill/kis_scanline_fill.h>
+#include <floodfill/KisParallelFloodFill.h>
+#include <floodfill/KisLineartDistanceField.h>
 #include "kis_selection_filters.h"
 #include <kis_perspectivetransform_worker.h>
 
@@ -73,6 +75,8 @@ void KisFillPainter::initFillPainter()
     m_opacitySpread = 0;
     m_useSelectionAsBoundary = false;
     m_antiAlias = false;
+    m_useParallelFloodFill = false;
+    m_closeGap = 0;
 }
 
 void KisFillPainter::fillSelection(const QRect &rc, const KoColor &color)
@@ -223,7 +227,7 @@ void KisFillPainter::fillRect(qint32 x1, qint32 y1, qint32 w, qint32 h, const Ki
 void KisFillPainter::fillColor(int startX, int startY, KisPaintDeviceSP sourceDevice)
 {
     if (!m_useCompositioning) {
-        if (m_sizemod || m_feather ||
+        if (m_sizemod || m_feather || m_closeGap ||
             compositeOp()->id() != COMPOSITE_OVER ||
             opacity() != MAX_SELECTED ||
             sourceDevice != device()) {
@@ -239,9 +243,15 @@ void KisFillPainter::fillColor(int startX, int startY, KisPaintDeviceSP sourceDe
 
         if (!fillBoundsRect.contains(startPoint)) return;
 
-        KisScanlineFill gc(device(), startPoint, fillBoundsRect);
-        gc.setThreshold(m_threshold);
-        gc.fillColor(paintColor());
+        if (m_useParallelFloodFill) {
+            KisParallelFloodFill gc(device(), startPoint, fillBoundsRect);
+            gc.setThreshold(m_threshold);
+            gc.fillColor(paintColor());
+        } else {
+            KisScanlineFill gc(device(), startPoint, fillBoundsRect);
+            gc.setThreshold(m_threshold);
+            gc.fillColor(paintColor());
+        }
 
     } else {
         genericFillStart(startX, startY, sourceDevice);
@@ -350,13 +360,55 @@ KisPixelSelectionSP KisFillPainter::createFloodSelection(KisPixelSelectionSP pix
         return pixelSelection;
     }
 
-    KisScanlineFill gc(sourceDevice, startPoint, fillBoundsRect);
-    gc.setThreshold(m_threshold);
-    gc.setOpacitySpread(m_useCompositioning ? m_opacitySpread : 100);
+    KisLineartDistanceFieldSP distanceField;
+    KisPaintDeviceSP boundarySelection;
+    const int gapRadius = (m_closeGap + 1) / 2;
+
     if (m_useSelectionAsBoundary && !pixelSelection.isNull()) {
-        gc.fillSelectionWithBoundary(pixelSelection, existingSelection);
+        boundarySelection = existingSelection;
+    }
+
+    if (gapRadius > 0) {
+        /**
+         * The gaps are closed by excluding the band around the lineart
+         * from the fill. The band is restored after the fill.
+         */
+        distanceField = KisLineartDistanceField::fetch(sourceDevice, fillBoundsRect, gapRadius);
+
+        /**
+         * The seed lies in the excluded band when the region is narrower
+         * than the gap (or the click is right on the lineart), the
+         * gap-closed fill would be empty then, so do a usual fill instead
+         */
+        if (distanceField->distance(startPoint) <= gapRadius) {
+            distanceField.clear();
+        } else {
+            boundarySelection = distanceField->createGapClosingBoundary(fillBoundsRect, gapRadius, boundarySelection);
+        }
+    }
+
+    if (m_useParallelFloodFill) {
+        KisParallelFloodFill gc(sourceDevice, startPoint, fillBoundsRect);
+        gc.setThreshold(m_threshold);
+        gc.setOpacitySpread(m_useCompositioning ? m_opacitySpread : 100);
+        if (boundarySelection) {
+            gc.fillSelectionWithBoundary(pixelSelection, boundarySelection);
+        } else {
+            gc.fillSelection(pixelSelection);
+        }
     } else {
-        gc.fillSelection(pixelSelection);
+        KisScanlineFill gc(sourceDevice, startPoint, fillBoundsRect);
+        gc.setThreshold(m_threshold);
+        gc.setOpacitySpread(m_useCompositioning ? m_opacitySpread : 100);
+        if (boundarySelection) {
+            gc.fillSelectionWithBoundary(pixelSelection, boundarySelection);
+        } else {
+            gc.fillSelection(pixelSelection);
+        }
+    }
+
+    if (distanceField) {
+        distanceField->restoreGapClosingBand(pixelSelection, fillBoundsRect, gapRadius);
     }
 
     if (m_useCompositioning) {
@@ -293,6 +293,37 @@ public:
         return m_useSelectionAsBoundary;
     }
 
+    /**
+     * Sets if flood fill operations should use the tile-parallel engine
+     * (KisParallelFloodFill) instead of the scanline one. The result is
+     * the same, but the parallel engine processes the whole fill bounds
+     * concurrently, so it pays off only for very big fill areas.
+     */
+    void setUseParallelFloodFill(bool useParallelFloodFill) {
+        m_useParallelFloodFill = useParallelFloodFill;
+    }
+
+    /** defines if flood fill uses the tile-parallel engine or not */
+    bool useParallelFloodFill() const {
+        return m_useParallelFloodFill;
+    }
+
+    /**
+     * Sets the size of the gaps in the lineart of the source device that
+     * should be treated as closed by the flood fill operations. Zero means
+     * no gap closing. The lineart distance field used for the gap closing
+     * is cached per source device and reused by the subsequent fills
+     * (see KisLineartDistanceField).
+     */
+    void setCloseGap(int closeGap) {
+        m_closeGap = closeGap;
+    }
+
+    /** the size of the gaps closed by the flood fill, see setCloseGap for details */
+    int closeGap() const {
+        return m_closeGap;
+    }
+
 protected:
     void setCurrentFillSelection(KisSelectionSP fillSelection)
     {
@@ -321,6 +352,8 @@ private:
     bool m_careForSelection;
     bool m_useCompositioning;
     bool m_useSelectionAsBoundary;
+    bool m_useParallelFloodFill;
+    int m_closeGap;
 };
 
 
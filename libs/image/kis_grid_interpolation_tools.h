@@ -10,13 +10,16 @@
 #include <limits>
 #include <algorithm>
 
+#include <QHash>
 #include <QImage>
+#include <QtConcurrent>
 
 #include "kis_algebra_2d.h"
 #include "kis_four_point_interpolator_forward.h"
 #include "kis_four_point_interpolator_backward.h"
 #include "kis_iterator_ng.h"
 #include "kis_random_sub_accessor.h"
+#include "kis_assert.h"
 
 //#define DEBUG_PAINTING_POLYGONS
 
@@ -172,7 +175,19 @@ struct PaintDevicePolygonOp
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
-        QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect();
+        this->operator() (srcPolygon, dstPolygon, clipDstPolygon,
+                          clipDstPolygon.boundingRect().toAlignedRect());
+    }
+
+    bool supportsParallelProcessing() const {
+        return true;
+    }
+
+    /**
+     * Processes only the part of the polygon lying inside \p dstRectLimit
+     */
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon, const QRect &dstRectLimit) {
+        QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect() & dstRectLimit;
         if (boundRect.isEmpty()) return;
 
         KisSequentialIterator dstIt(m_dstDev, boundRect);
@@ -245,6 +260,18 @@ struct QImagePolygonOp
           m_srcImageRect(m_srcImage.rect()),
           m_dstImageRect(m_dstImage.rect())
     {
+        /**
+         * QImage::setPixel() detaches the image and updates its
+         * internal counters, so it is not safe to call it from several
+         * threads. For the 32-bit ARGB formats the pixels are written
+         * directly into the (already detached) buffer.
+         */
+        if (m_dstImage.format() == QImage::Format_ARGB32 ||
+            m_dstImage.format() == QImage::Format_ARGB32_Premultiplied) {
+
+            m_dstBits = m_dstImage.bits();
+            m_dstBytesPerLine = m_dstImage.bytesPerLine();
+        }
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
@@ -252,7 +279,23 @@ struct QImagePolygonOp
     }
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
-        QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect();
+        this->operator() (srcPolygon, dstPolygon, clipDstPolygon,
+                          clipDstPolygon.boundingRect().toAlignedRect());
+    }
+
+    /**
+     * The pixels of the formats other than 32-bit ARGB are written with
+     * QImage::setPixel(), so the polygons should be processed serially
+     */
+    bool supportsParallelProcessing() const {
+        return m_dstBits != nullptr;
+    }
+
+    /**
+     * Processes only the part of the polygon lying inside \p dstRectLimit
+     */
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon, const QRect &dstRectLimit) {
+        QRect boundRect = clipDstPolygon.boundingRect().toAlignedRect() & dstRectLimit;
         KisFourPointInterpolatorBackward interp(srcPolygon, dstPolygon);
 
         for (int y = boundRect.top(); y <= boundRect.bottom(); y++) {
@@ -277,7 +320,12 @@ struct QImagePolygonOp
                     if (!m_dstImageRect.contains(srcPointI)) continue;
                     if (!m_srcImageRect.contains(dstPointI)) continue;
 
-                    m_dstImage.setPixel(srcPointI, m_srcImage.pixel(dstPointI));
+                    if (m_dstBits) {
+                        reinterpret_cast<QRgb*>(m_dstBits + srcPointI.y() * m_dstBytesPerLine)[srcPointI.x()] =
+                            m_srcImage.pixel(dstPointI);
+                    } else {
+                        m_dstImage.setPixel(srcPointI, m_srcImage.pixel(dstPointI));
+                    }
                 }
             }
         }
@@ -304,6 +352,117 @@ struct QImagePolygonOp
 
     QRect m_srcImageRect;
     QRect m_dstImageRect;
+
+    uchar *m_dstBits = nullptr;
+    int m_dstBytesPerLine = 0;
+};
+
+/**
+ * A wrapper around PaintDevicePolygonOp or QImagePolygonOp that renders
+ * the polygons in parallel.
+ *
+ * The polygons generated by the grid iteration are collected in batches.
+ * When a batch is full (or on flush()) the destination is split into
+ * chunks aligned to the tile grid of the destination device, and the
+ * chunks are rendered concurrently. Every chunk renders all the polygons
+ * touching it in the order they were generated, clipped to the chunk. So
+ * in every pixel the polygons overlap in the same order as in the serial
+ * rendering and the result is exactly the same.
+ *
+ * If the wrapped op cannot write into the destination concurrently (see
+ * supportsParallelProcessing()), the batches are rendered serially.
+ *
+ * NOTE: flush() must be called after the grid iteration is finished
+ */
+template <class PolygonOp>
+class ParallelPolygonOp
+{
+    struct Polygon {
+        QPolygonF srcPolygon;
+        QPolygonF dstPolygon;
+        QPolygonF clipDstPolygon;
+    };
+
+    static const int chunkSize = 256;
+    static const int maxBatchSize = 16384;
+
+public:
+    ParallelPolygonOp(PolygonOp &polygonOp, const QPoint &tileGridOrigin = QPoint())
+        : m_polygonOp(polygonOp),
+          m_tileGridOrigin(tileGridOrigin)
+    {
+    }
+
+    ~ParallelPolygonOp() {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(m_polygons.isEmpty());
+    }
+
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
+        this->operator() (srcPolygon, dstPolygon, dstPolygon);
+    }
+
+    void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon, const QPolygonF &clipDstPolygon) {
+        m_polygons.append({srcPolygon, dstPolygon, clipDstPolygon});
+
+        if (m_polygons.size() >= maxBatchSize) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (m_polygons.isEmpty()) return;
+
+        if (!m_polygonOp.supportsParallelProcessing()) {
+            Q_FOREACH (const Polygon &polygon, m_polygons) {
+                m_polygonOp(polygon.srcPolygon, polygon.dstPolygon, polygon.clipDstPolygon);
+            }
+            m_polygons.clear();
+            return;
+        }
+
+        auto chunkIndex = [] (int value) {
+            return value >= 0 ? value / chunkSize : -((-value + chunkSize - 1) / chunkSize);
+        };
+
+        QHash<quint64, int> chunkIndexes;
+        QVector<QPair<QRect, QVector<int>>> chunks;
+
+        for (int i = 0; i < m_polygons.size(); i++) {
+            const QRect rc = m_polygons[i].clipDstPolygon.boundingRect().toAlignedRect().translated(-m_tileGridOrigin);
+            if (rc.isEmpty()) continue;
+
+            for (int row = chunkIndex(rc.top()); row <= chunkIndex(rc.bottom()); row++) {
+                for (int col = chunkIndex(rc.left()); col <= chunkIndex(rc.right()); col++) {
+                    const quint64 key = (quint64(quint32(row)) << 32) | quint32(col);
+
+                    auto it = chunkIndexes.find(key);
+                    if (it == chunkIndexes.end()) {
+                        const QRect chunkRect(col * chunkSize, row * chunkSize, chunkSize, chunkSize);
+                        it = chunkIndexes.insert(key, chunks.size());
+                        chunks.append(qMakePair(chunkRect.translated(m_tileGridOrigin), QVector<int>()));
+                    }
+
+                    chunks[*it].second.append(i);
+                }
+            }
+        }
+
+        QtConcurrent::blockingMap(chunks, [this] (const QPair<QRect, QVector<int>> &chunk) {
+            PolygonOp polygonOp(m_polygonOp);
+
+            Q_FOREACH (int index, chunk.second) {
+                const Polygon &polygon = m_polygons[index];
+                polygonOp(polygon.srcPolygon, polygon.dstPolygon, polygon.clipDstPolygon, chunk.first);
+            }
+        });
+
+        m_polygons.clear();
+    }
+
+private:
+    PolygonOp &m_polygonOp;
+    QPoint m_tileGridOrigin;
+    QVector<Polygon> m_polygons;
 };
 
 /*************************************************************/
@@ -25,6 +25,7 @@
 #include "kis_selection_mask.h"
 #include "kis_psd_layer_style.h"
 #include "kis_layer_properties_icons.h"
+#include "KisBelowLayersProjectionCache.h"
 
 
 struct Q_DECL_HIDDEN KisGroupLayer::Private
@@ -42,6 +43,7 @@ public:
     qint32 x;
     qint32 y;
     bool passThroughMode;
+    KisBelowLayersProjectionCache belowLayersProjectionCache;
 };
 
 KisGroupLayer::KisGroupLayer(KisImageWSP image, const QString &name, quint8 opacity) :
@@ -149,6 +151,23 @@ void KisGroupLayer::setImage(KisImageWSP image)
 {
     m_d->paintDevice->setDefaultBounds(new KisDefaultBounds(image));
     KisLayer::setImage(image);
+
+    // the layer is removed from the image, but can still be kept by the undo stack
+    if (!image) {
+        m_d->belowLayersProjectionCache.clear();
+    }
+}
+
+void KisGroupLayer::childNodeChanged(KisNodeSP changedChildNode)
+{
+    m_d->belowLayersProjectionCache.clear();
+    KisLayer::childNodeChanged(changedChildNode);
+}
+
+void KisGroupLayer::syncLodCache()
+{
+    m_d->belowLayersProjectionCache.clear();
+    KisLayer::syncLodCache();
 }
 
 KisLayerSP KisGroupLayer::createMergedLayerTemplate(KisLayerSP prevLayer)
@@ -205,6 +224,8 @@ void KisGroupLayer::resetCache(const KoColorSpace *colorSpace)
 
         m_d->paintDevice->clear();
     }
+
+    m_d->belowLayersProjectionCache.clear();
 }
 
 KisLayer* KisGroupLayer::onlyMeaningfulChild() const
@@ -286,6 +307,11 @@ bool KisGroupLayer::projectionIsValid() const
     return !tryObligeChild();
 }
 
+KisBelowLayersProjectionCache* KisGroupLayer::belowLayersProjectionCache() const
+{
+    return &m_d->belowLayersProjectionCache;
+}
+
 void KisGroupLayer::setDefaultProjectionColor(KoColor color)
 {
     m_d->paintDevice->setDefaultPixel(color);
@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KoColorSpace;
+class KisBelowLayersProjectionCache;
 
 /**
  * A KisLayer that bundles child layers into a single layer.
@@ -39,6 +40,8 @@ public:
     void setSectionModelProperties(const KisBaseNode::PropertyList &properties) override;
 
     void setImage(KisImageWSP image) override;
+    void childNodeChanged(KisNodeSP changedChildNode) override;
+    void syncLodCache() override;
 
     KisLayerSP createMergedLayerTemplate(KisLayerSP prevLayer) override;
     void fillMergedLayerTemplate(KisLayerSP dstLayer, KisLayerSP prevLayer) override;
@@ -95,6 +98,12 @@ public:
 
     bool projectionIsValid() const;
 
+    /**
+     * The cache of the merged layers lying below the currently updated
+     * child, used by KisAsyncMerger
+     */
+    KisBelowLayersProjectionCache* belowLayersProjectionCache() const;
+
 protected:
     KisLayer* onlyMeaningfulChild() const;
     KisPaintDeviceSP tryObligeChild() const;
@@ -74,6 +74,7 @@
 #include "kis_wrapped_rect.h"
 #include "kis_crop_saved_extra_data.h"
 #include "kis_layer_utils.h"
+#include "KisBelowLayersProjectionCache.h"
 #include "kis_keyframe_channel.h"
 
 #include "kis_lod_transform.h"
@@ -100,6 +101,7 @@
 #include "KisRunnableStrokeJobsInterface.h"
 
 #include "KisBusyWaitBroker.h"
+#include "KisReferenceProjectionCache.h"
 
 
 // #define SANITY_CHECKS
@@ -142,6 +144,7 @@ public:
         , animationInterface(_animationInterface)
         , scheduler(_q, _q)
         , axesCenter(QPointF(0.5, 0.5))
+        , referenceProjectionCache(_q)
     {
         {
             KisImageConfig cfg(true);
@@ -253,6 +256,8 @@ public:
     QPointF axesCenter;
     bool allowMasksOnRootNode = false;
 
+    KisReferenceProjectionCache referenceProjectionCache;
+
     bool tryCancelCurrentStrokeAsync();
 
     void notifyProjectionUpdatedInPatches(const QRect &rc, QVector<KisRunnableStrokeJobData *> &jobs);
@@ -813,6 +818,14 @@ void KisImage::setSize(const QSize& size)
 {
     m_d->width = size.width();
     m_d->height = size.height();
+
+    KisLayerUtils::recursiveApplyNodes(root(),
+        [] (KisNodeSP node) {
+            KisGroupLayer *group = qobject_cast<KisGroupLayer*>(node.data());
+            if (group) {
+                group->belowLayersProjectionCache()->clear();
+            }
+        });
 }
 
 void KisImage::resizeImageImpl(const QRect& newRect, bool cropLayers)
@@ -2267,6 +2280,9 @@ void KisImage::notifyProjectionUpdated(const QRect &rc)
 {
     KisUpdateTimeMonitor::instance()->reportUpdateFinished(rc);
 
+    m_d->referenceProjectionCache.addDirtyRect(
+        !currentLevelOfDetail() ? rc : KisLodTransform::upscaledRect(rc, currentLevelOfDetail()));
+
     if (!m_d->disableUIUpdateSignals) {
         int lod = currentLevelOfDetail();
         QRect dirtyRect = !lod ? rc : KisLodTransform::upscaledRect(rc, lod);
@@ -2520,6 +2536,11 @@ KisImageAnimationInterface* KisImage::animationInterface() const
     return m_d->animationInterface;
 }
 
+KisReferenceProjectionCache* KisImage::referenceProjectionCache() const
+{
+    return &m_d->referenceProjectionCache;
+}
+
 void KisImage::setProofingConfiguration(KisProofingConfigurationSP proofingConfig)
 {
     m_d->proofingConfig = proofingConfig;
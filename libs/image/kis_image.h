@@ -29,6 +29,7 @@ class KoColorSpace;
 class KoColor;
 
 class KisCompositeProgressProxy;
+class KisReferenceProjectionCache;
 class KisUndoStore;
 class KisUndoAdapter;
 class KisImageSignalRouter;
@@ -762,6 +763,12 @@ public:
 
     KisImageAnimationInterface *animationInterface() const;
 
+    /**
+     * The cache of the merged color-labeled layers used as a reference
+     * by the fill and selection tools
+     */
+    KisReferenceProjectionCache *referenceProjectionCache() const;
+
     /**
      * @brief setProofingConfiguration, this sets the image's proofing configuration, and signals
      * the proofingConfiguration has changed.
@@ -79,6 +79,17 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+QString KisImageConfig::timelineTraceFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("timelineTraceFile", QString()) : QString();
+}
+
+void KisImageConfig::setTimelineTraceFile(const QString &value)
+{
+    m_config.writeEntry("timelineTraceFile", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
@@ -190,6 +201,20 @@ int KisImageConfig::poolLimit() const
     return totalRAM() * hp * pp;
 }
 
+int KisImageConfig::historyLimit() const
+{
+    qreal up = qreal(memoryHistoryLimitPercent()) / 100.0;
+
+    return tilesHardLimit() * up;
+}
+
+int KisImageConfig::belowLayersCacheLimit() const
+{
+    qreal cp = qreal(memoryBelowLayersCacheLimitPercent()) / 100.0;
+
+    return tilesHardLimit() * cp;
+}
+
 qreal KisImageConfig::memoryHardLimitPercent(bool requestDefault) const
 {
     return !requestDefault ?
@@ -223,6 +248,39 @@ void KisImageConfig::setMemoryPoolLimitPercent(qreal value)
     m_config.writeEntry("memoryPoolLimitPercent", value);
 }
 
+qreal KisImageConfig::memoryHistoryLimitPercent(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("memoryHistoryLimitPercent", 25.) : 25.;
+}
+
+void KisImageConfig::setMemoryHistoryLimitPercent(qreal value)
+{
+    m_config.writeEntry("memoryHistoryLimitPercent", value);
+}
+
+qreal KisImageConfig::memoryBelowLayersCacheLimitPercent(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("memoryBelowLayersCacheLimitPercent", 10.) : 10.;
+}
+
+void KisImageConfig::setMemoryBelowLayersCacheLimitPercent(qreal value)
+{
+    m_config.writeEntry("memoryBelowLayersCacheLimitPercent", value);
+}
+
+int KisImageConfig::uncompressedUndoSteps(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("uncompressedUndoSteps", 3) : 3;
+}
+
+void KisImageConfig::setUncompressedUndoSteps(int value)
+{
+    m_config.writeEntry("uncompressedUndoSteps", value);
+}
+
 QString KisImageConfig::safelyGetWritableTempLocation(const QString &suffix, const QString &configKey, bool requestDefault) const
 {
 #ifdef Q_OS_MACOS
@@ -530,6 +588,28 @@ void KisImageConfig::setUseLodForColorizeMask(bool value)
     m_config.writeEntry("useLodForColorizeMask", value);
 }
 
+bool KisImageConfig::adaptiveLevelOfDetail(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLevelOfDetail", false) : false;
+}
+
+void KisImageConfig::setAdaptiveLevelOfDetail(bool value)
+{
+    m_config.writeEntry("adaptiveLevelOfDetail", value);
+}
+
+int KisImageConfig::adaptiveLodTargetLatency(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveLodTargetLatency", 100) : 100;
+}
+
+void KisImageConfig::setAdaptiveLodTargetLatency(int value)
+{
+    m_config.writeEntry("adaptiveLodTargetLatency", value);
+}
+
 int KisImageConfig::maxNumberOfThreads(bool defaultValue) const
 {
     return (defaultValue ? QThread::idealThreadCount() : m_config.readEntry("maxNumberOfThreads", QThread::idealThreadCount()));
@@ -24,6 +24,14 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    /**
+     * When not empty, the timeline of the image updates is traced and
+     * written into this file in Chrome trace format on exit
+     * (see KisTimelineTracer)
+     */
+    QString timelineTraceFile(bool requestDefault = false) const;
+    void setTimelineTraceFile(const QString &value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
@@ -49,13 +57,28 @@ public:
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
+    int historyLimit() const; // MiB
+    int belowLayersCacheLimit() const; // MiB
 
     qreal memoryHardLimitPercent(bool requestDefault = false) const; // % of total RAM
     qreal memorySoftLimitPercent(bool requestDefault = false) const; // % of memoryHardLimitPercent() * (1 - 0.01 * memoryPoolLimitPercent())
     qreal memoryPoolLimitPercent(bool requestDefault = false) const; // % of memoryHardLimitPercent()
+    qreal memoryHistoryLimitPercent(bool requestDefault = false) const; // % of tilesHardLimit()
+    qreal memoryBelowLayersCacheLimitPercent(bool requestDefault = false) const; // % of tilesHardLimit()
     void setMemoryHardLimitPercent(qreal value);
     void setMemorySoftLimitPercent(qreal value);
     void setMemoryPoolLimitPercent(qreal value);
+    void setMemoryHistoryLimitPercent(qreal value);
+    void setMemoryBelowLayersCacheLimitPercent(qreal value);
+
+    /**
+     * The number of the most recent undo steps whose tiles are kept
+     * in memory uncompressed. The older steps are the first ones to be
+     * moved into the (compressed) swap when the history grows over
+     * historyLimit()
+     */
+    int uncompressedUndoSteps(bool requestDefault = false) const;
+    void setUncompressedUndoSteps(int value);
 
     static int totalRAM(); // MiB
 
@@ -102,6 +125,12 @@ public:
     bool useLodForColorizeMask(bool requestDefault = false) const;
     void setUseLodForColorizeMask(bool value);
 
+    bool adaptiveLevelOfDetail(bool requestDefault = false) const;
+    void setAdaptiveLevelOfDetail(bool value);
+
+    int adaptiveLodTargetLatency(bool requestDefault = false) const;
+    void setAdaptiveLodTargetLatency(int value);
+
     int maxNumberOfThreads(bool defaultValue = false) const;
     void setMaxNumberOfThreads(int value);
 
@@ -117,6 +117,28 @@ KisPaintDeviceList KisLayerProjectionPlane::getLodCapableDevices() const
     return KisPaintDeviceList() << m_d->layer->projection();
 }
 
+KisRegion KisLayerProjectionPlane::opaqueRegion(const QRect &rect, const KoColorSpace *dstColorSpace) const
+{
+    KisPaintDeviceSP device = m_d->layer->projection();
+    if (!device) return KisRegion();
+
+    if (m_d->layer->compositeOpId() != COMPOSITE_OVER ||
+        m_d->layer->projectionLeaf()->opacity() != OPACITY_OPAQUE_U8 ||
+        *device->colorSpace() != *dstColorSpace) {
+
+        return KisRegion();
+    }
+
+    // inherit alpha and disabled channels keep some of the destination
+    const QBitArray channelFlags = m_d->layer->projectionLeaf()->channelFlags();
+    if (!channelFlags.isEmpty() && channelFlags.count(true) != channelFlags.size()) {
+        return KisRegion();
+    }
+
+    // apply() doesn't touch the area outside the extent
+    return device->opaqueTilesRegion(rect & device->extent());
+}
+
 QRect KisLayerProjectionPlane::needRect(const QRect &rect, KisLayer::PositionToFilthy pos) const
 {
     return m_d->layer->needRect(rect, pos);
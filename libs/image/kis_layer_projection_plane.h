@@ -34,6 +34,8 @@ public:
 
     KisPaintDeviceList getLodCapableDevices() const override;
 
+    KisRegion opaqueRegion(const QRect &rect, const KoColorSpace *dstColorSpace) const override;
+
 private:
     void applyImpl(KisPainter *painter, const QRect &rect, KritaUtils::ThresholdMode thresholdMode);
 
@@ -398,11 +398,14 @@ void KisLiquifyTransformWorker::run(KisPaintDeviceSP srcDevice, KisPaintDeviceSP
     using namespace GridIterationTools;
 
     PaintDevicePolygonOp polygonOp(srcDevice, dstDevice);
+    ParallelPolygonOp<PaintDevicePolygonOp> parallelOp(polygonOp, QPoint(dstDevice->x(), dstDevice->y()));
+
     RegularGridIndexesOp indexesOp(m_d->gridSize);
-    iterateThroughGrid<AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+    iterateThroughGrid<AlwaysCompletePolygonPolicy>(parallelOp, indexesOp,
                                                     m_d->gridSize,
                                                     m_d->originalPoints,
                                                     m_d->transformedPoints);
+    parallelOp.flush();
 }
 
 QRect KisLiquifyTransformWorker::approxChangeRect(const QRect &rc)
@@ -505,12 +508,15 @@ QImage KisLiquifyTransformWorker::runOnQImage(const QImage &srcImage,
     dstImage.fill(0);
 
     GridIterationTools::QImagePolygonOp polygonOp(srcImage, dstImage, srcImageOffset, dstQImageOffset);
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp);
+
     GridIterationTools::RegularGridIndexesOp indexesOp(m_d->gridSize);
     GridIterationTools::iterateThroughGrid
-        <GridIterationTools::AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+        <GridIterationTools::AlwaysCompletePolygonPolicy>(parallelOp, indexesOp,
                                                           m_d->gridSize,
                                                           originalPointsLocal,
                                                           transformedPointsLocal);
+    parallelOp.flush();
     return dstImage;
 }
 
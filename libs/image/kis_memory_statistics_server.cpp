@@ -141,6 +141,7 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.totalMemorySize = tileStats.totalMemorySize;
     stats.realMemorySize = tileStats.realMemorySize;
     stats.historicalMemorySize = tileStats.historicalMemorySize;
+    stats.historicalMemoryLimit = tileStats.historicalMemoryLimit;
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
@@ -152,6 +153,11 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.tilesPoolLimit = cfg.poolLimit() * MiB;
     stats.totalMemoryLimit = stats.tilesHardLimit + stats.tilesPoolLimit;
 
+    // without a budget of its own the history is limited by the hard limit only
+    if (!stats.historicalMemoryLimit) {
+        stats.historicalMemoryLimit = stats.tilesHardLimit;
+    }
+
     return stats;
 }
 
@@ -30,6 +30,7 @@ public:
               totalMemorySize(0),
               realMemorySize(0),
               historicalMemorySize(0),
+              historicalMemoryLimit(0),
               poolSize(0),
 
               swapSize(0),
@@ -49,6 +50,7 @@ public:
         qint64 totalMemorySize;
         qint64 realMemorySize;
         qint64 historicalMemorySize;
+        qint64 historicalMemoryLimit;
         qint64 poolSize;
 
         qint64 swapSize;
@@ -13,6 +13,7 @@
 #include <QImage>
 #include <QList>
 #include <QHash>
+#include <QSet>
 #include <QIODevice>
 #include <qmath.h>
 #include <KisRegion.h>
@@ -158,6 +159,7 @@ public:
     {
 
         m_lodData.reset();
+        m_lodSyncState = LodSyncState();
         m_externalFrameData.reset();
 
         if (!m_frames.isEmpty()) {
@@ -421,6 +423,8 @@ public:
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
     KisRegion regionForLodSyncing() const;
+    KisRegion regionForLodSyncing(const LodDataStruct *dst) const;
+    bool canSyncLodIncrementally(Data *srcData, int lod, int expectedX, int expectedY) const;
 
     void updateLodDataManager(KisDataManager *srcDataManager,
                               KisDataManager *dstDataManager, const QPoint &srcOffset, const QPoint &dstOffset,
@@ -594,6 +598,19 @@ private:
 private:
     DataSP m_data;
     mutable QScopedPointer<Data> m_lodData;
+
+    /**
+     * The source of the last successful synchronization of the LoD plane.
+     * The tiles of the source and of the LoD plane track their changes
+     * themselves (see KisTile::takeLodDirty()), so while the source stays
+     * the same, only the changed tiles need to be downsampled.
+     */
+    struct LodSyncState {
+        Data *sourceData = 0;
+        KisDataManager *sourceDataManager = 0;
+        QSet<qint64> sourceTiles;
+    };
+    LodSyncState m_lodSyncState;
     mutable QScopedPointer<Data> m_externalFrameData;
     mutable QMutex m_dataSwitchLock;
 
@@ -676,46 +693,151 @@ struct KisPaintDevice::Private::StrategyPolicy {
 struct KisPaintDevice::Private::LodDataStructImpl : public KisPaintDevice::LodDataStruct {
     LodDataStructImpl(Data *_lodData) : lodData(_lodData) {}
     QScopedPointer<Data> lodData;
+
+    KisRegion syncRegion;
+    LodSyncState syncState;
+    bool isIncremental = false;
 };
 
+namespace {
+
+inline qint64 lodSyncTileKey(const QPoint &tile)
+{
+    return (qint64(tile.x()) << 32) | quint32(tile.y());
+}
+
+inline QRect lodSyncTileRect(qint64 key)
+{
+    const qint32 col = qint32(key >> 32);
+    const qint32 row = qint32(key & 0xFFFFFFFF);
+    return QRect(col * KisTileData::WIDTH, row * KisTileData::HEIGHT,
+                 KisTileData::WIDTH, KisTileData::HEIGHT);
+}
+
+}
+
 KisRegion KisPaintDevice::Private::regionForLodSyncing() const
 {
     Data *srcData = currentNonLodData();
     return srcData->dataManager()->region().translated(srcData->x(), srcData->y());
 }
 
+KisRegion KisPaintDevice::Private::regionForLodSyncing(const LodDataStruct *_dst) const
+{
+    const LodDataStructImpl *dst = dynamic_cast<const LodDataStructImpl*>(_dst);
+    KIS_SAFE_ASSERT_RECOVER(dst) { return regionForLodSyncing(); }
+
+    return dst->syncRegion;
+}
+
+bool KisPaintDevice::Private::canSyncLodIncrementally(Data *srcData, int lod, int expectedX, int expectedY) const
+{
+    return m_lodData &&
+        m_lodSyncState.sourceData == srcData &&
+        m_lodSyncState.sourceDataManager == srcData->dataManager().data() &&
+        m_lodData->levelOfDetail() == lod &&
+        m_lodData->colorSpace() == srcData->colorSpace() &&
+        m_lodData->x() == expectedX &&
+        m_lodData->y() == expectedY &&
+        !memcmp(m_lodData->dataManager()->defaultPixel(),
+                srcData->dataManager()->defaultPixel(),
+                srcData->dataManager()->pixelSize());
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::Private::createLodDataStruct(int newLod)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(newLod > 0);
 
     Data *srcData = currentNonLodData();
 
-    Data *lodData = new Data(q, srcData, false);
-    LodDataStruct *lodStruct = new LodDataStructImpl(lodData);
-
     int expectedX = KisLodTransform::coordToLodCoord(srcData->x(), newLod);
     int expectedY = KisLodTransform::coordToLodCoord(srcData->y(), newLod);
 
-    /**
-     * We compare color spaces as pure pointers, because they must be
-     * exactly the same, since they come from the common source.
-     */
-    if (lodData->levelOfDetail() != newLod ||
-        lodData->colorSpace() != srcData->colorSpace() ||
-        lodData->x() != expectedX ||
-        lodData->y() != expectedY) {
+    const bool incremental = canSyncLodIncrementally(srcData, newLod, expectedX, expectedY);
+
+    QVector<QPoint> sourceTiles;
+    QVector<QRect> dirtyRects = srcData->dataManager()->takeLodDirtyTiles(&sourceTiles);
+
+    LodDataStructImpl *lodStruct = 0;
+
+    if (incremental) {
+        /**
+         * Start from a (copy-on-write) copy of the current LoD plane, so
+         * that only the tiles changed since the last synchronization
+         * should be downsampled
+         */
+        lodStruct = new LodDataStructImpl(new Data(q, m_lodData.data(), true));
+        lodStruct->isIncremental = true;
+
+        QSet<qint64> currentTiles;
+        currentTiles.reserve(sourceTiles.size());
+        Q_FOREACH (const QPoint &tile, sourceTiles) {
+            currentTiles.insert(lodSyncTileKey(tile));
+        }
+
+        // the removed tiles should be reset to the default pixel
+        Q_FOREACH (qint64 key, m_lodSyncState.sourceTiles) {
+            if (!currentTiles.contains(key)) {
+                dirtyRects << lodSyncTileRect(key);
+            }
+        }
+
+        lodStruct->syncState.sourceTiles = currentTiles;
+
+        for (auto it = dirtyRects.begin(); it != dirtyRects.end(); ++it) {
+            it->translate(srcData->x(), srcData->y());
+        }
+
+        /**
+         * The LoD plane might have been changed by the LodN strokes
+         * without any changes in the source (e.g. when the Lod0 stroke
+         * was cancelled), these areas should be regenerated as well.
+         */
+        Q_FOREACH (const QRect &rc, m_lodData->dataManager()->takeLodDirtyTiles()) {
+            dirtyRects << KisLodTransform::upscaledRect(rc.translated(expectedX, expectedY), newLod);
+        }
+
+        lodStruct->syncRegion = KisRegion::fromOverlappingRects(dirtyRects, KisTileData::WIDTH);
+
+    } else {
+        Data *lodData = new Data(q, srcData, false);
+        lodStruct = new LodDataStructImpl(lodData);
+
+        /**
+         * We compare color spaces as pure pointers, because they must be
+         * exactly the same, since they come from the common source.
+         */
+        if (lodData->levelOfDetail() != newLod ||
+            lodData->colorSpace() != srcData->colorSpace() ||
+            lodData->x() != expectedX ||
+            lodData->y() != expectedY) {
 
 
-        lodData->prepareClone(srcData);
+            lodData->prepareClone(srcData);
 
-        lodData->setLevelOfDetail(newLod);
-        lodData->setX(expectedX);
-        lodData->setY(expectedY);
+            lodData->setLevelOfDetail(newLod);
+            lodData->setX(expectedX);
+            lodData->setY(expectedY);
+        }
+
+        Q_FOREACH (const QPoint &tile, sourceTiles) {
+            lodStruct->syncState.sourceTiles.insert(lodSyncTileKey(tile));
+        }
 
-        // FIXME: different kind of synchronization
+        lodStruct->syncRegion = regionForLodSyncing();
     }
 
-    lodData->cache()->invalidate();
+    lodStruct->syncState.sourceData = srcData;
+    lodStruct->syncState.sourceDataManager = srcData->dataManager().data();
+
+    /**
+     * The changes of the source have already been consumed, so if the
+     * struct is never uploaded, the next synchronization must be a
+     * full one.
+     */
+    m_lodSyncState = LodSyncState();
+
+    lodStruct->lodData->cache()->invalidate();
 
     return lodStruct;
 }
@@ -854,8 +976,19 @@ void KisPaintDevice::Private::uploadLodDataStruct(LodDataStruct *_dst)
 
     ensureLodDataPresent();
 
+    if (dst->isIncremental && dst->syncRegion.isEmpty()) {
+        // the plane is up to date already
+        m_lodSyncState = dst->syncState;
+        return;
+    }
+
     m_lodData->prepareClone(dst->lodData.data());
     m_lodData->dataManager()->bitBltRough(dst->lodData->dataManager(), dst->lodData->dataManager()->extent());
+
+    // the uploaded tiles are brand new, they are not changed by anyone yet
+    m_lodData->dataManager()->takeLodDirtyTiles();
+
+    m_lodSyncState = dst->syncState;
 }
 
 void KisPaintDevice::Private::transferFromData(Data *data, KisPaintDeviceSP targetDevice)
@@ -1280,6 +1413,30 @@ KisRegion KisPaintDevice::region() const
     return m_d->currentStrategy()->region();
 }
 
+KisRegion KisPaintDevice::opaqueTilesRegion(const QRect &rect) const
+{
+    if (m_d->defaultBounds->wrapAroundMode()) return KisRegion();
+
+    const KoColorSpace *cs = colorSpace();
+    const qint32 pixelSize = cs->pixelSize();
+
+    auto isOpaque = [cs, pixelSize] (const quint8 *data, qint32 numPixels) {
+        for (qint32 i = 0; i < numPixels; i++, data += pixelSize) {
+            if (cs->opacityF(data) < 1.0) return false;
+        }
+        return true;
+    };
+
+    const QPoint offset(m_d->x(), m_d->y());
+
+    QVector<QRect> rects = m_d->dataManager()->opaqueTileRects(rect.translated(-offset), isOpaque);
+    for (auto it = rects.begin(); it != rects.end(); ++it) {
+        it->translate(offset);
+    }
+
+    return KisRegion(std::move(rects));
+}
+
 QRect KisPaintDevice::nonDefaultPixelArea() const
 {
     return m_d->cache()->nonDefaultPixelArea();
@@ -2158,6 +2315,11 @@ KisRegion KisPaintDevice::regionForLodSyncing() const
     return m_d->regionForLodSyncing();
 }
 
+KisRegion KisPaintDevice::regionForLodSyncing(const LodDataStruct *dst) const
+{
+    return m_d->regionForLodSyncing(dst);
+}
+
 KisPaintDevice::LodDataStruct* KisPaintDevice::createLodDataStruct(int lod)
 {
     return m_d->createLodDataStruct(lod);
@@ -249,6 +249,14 @@ public:
      */
     KisRegion region() const;
 
+    /**
+     * Returns the part of \p rect covered by the tiles where all the
+     * pixels are fully opaque. The per-tile results are cached until
+     * the tile is written to, so the call is cheap for the devices that
+     * don't change. In wrap-around mode the region is always empty.
+     */
+    KisRegion opaqueTilesRegion(const QRect &rect) const;
+
     /**
      * The slow version of region() that searches for exact bounds of
      * each rectangle in the region
@@ -900,6 +908,16 @@ public:
     };
 
     KisRegion regionForLodSyncing() const;
+
+    /**
+     * Returns the region that should be passed to updateLodDataStruct()
+     * to synchronize \p dst. If the device hasn't changed its source data,
+     * level of detail and offset since the previous upload, the region
+     * contains only the tiles that have changed since then, otherwise it
+     * is equal to regionForLodSyncing().
+     */
+    KisRegion regionForLodSyncing(const LodDataStruct *dst) const;
+
     LodDataStruct* createLodDataStruct(int lod);
     void updateLodDataStruct(LodDataStruct *dst, const QRect &srcRect);
     void uploadLodDataStruct(LodDataStruct *dst);
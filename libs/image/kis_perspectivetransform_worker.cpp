@@ -15,6 +15,10 @@
 #include <QTransform>
 #include <QVector3D>
 #include <QPolygonF>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtConcurrent>
 
 #include <KoUpdater.h>
 #include <KoColor.h>
@@ -107,6 +111,98 @@ void KisPerspectiveTransformWorker::setForwardTransform(const QTransform &transf
 }
 
 
+namespace {
+
+const int tileSize = 64;
+
+/**
+ * Maps the points of a single row of the destination. The products that
+ * depend on the row only are calculated once per row. The rest of the
+ * operations are done in the same order as in QTransform::map(), so the
+ * result is exactly the same.
+ */
+class RowMapper
+{
+public:
+    RowMapper(const QTransform &transform, int y)
+        : m_m11(transform.m11()),
+          m_m12(transform.m12()),
+          m_m13(transform.m13()),
+          m_rowX(transform.m21() * y),
+          m_rowY(transform.m22() * y),
+          m_rowW(transform.m23() * y),
+          m_dx(transform.dx()),
+          m_dy(transform.dy()),
+          m_m33(transform.m33()),
+          m_isProjective(transform.type() == QTransform::TxProject)
+    {
+    }
+
+    inline QPointF map(int x) const {
+        qreal fx = m_m11 * x + m_rowX + m_dx;
+        qreal fy = m_m12 * x + m_rowY + m_dy;
+
+        if (m_isProjective) {
+            const qreal w = 1. / (m_m13 * x + m_rowW + m_m33);
+            fx *= w;
+            fy *= w;
+        }
+
+        return QPointF(fx, fy);
+    }
+
+private:
+    qreal m_m11;
+    qreal m_m12;
+    qreal m_m13;
+    qreal m_rowX;
+    qreal m_rowY;
+    qreal m_rowW;
+    qreal m_dx;
+    qreal m_dy;
+    qreal m_m33;
+    bool m_isProjective;
+};
+
+/**
+ * Splits the rects of the region into the pieces belonging to separate
+ * tiles of a device with the tile grid starting at \p tileGridOrigin.
+ * All the pieces of one tile are put into the same job, so the jobs
+ * never write into the same tile.
+ */
+QVector<QVector<QRect>> splitRegionIntoTileJobs(const KisRegion &region, const QPoint &tileGridOrigin)
+{
+    QHash<quint64, int> jobIndexes;
+    QVector<QVector<QRect>> jobs;
+
+    auto tileIndex = [] (int value) {
+        return value >= 0 ? value / tileSize : -((-value + tileSize - 1) / tileSize);
+    };
+
+    Q_FOREACH (const QRect &rc, region.rects()) {
+        const QRect rect = rc.translated(-tileGridOrigin);
+
+        for (int row = tileIndex(rect.top()); row <= tileIndex(rect.bottom()); row++) {
+            for (int col = tileIndex(rect.left()); col <= tileIndex(rect.right()); col++) {
+                const QRect tileRect(col * tileSize, row * tileSize, tileSize, tileSize);
+                const quint64 key = (quint64(quint32(row)) << 32) | quint32(col);
+
+                auto it = jobIndexes.find(key);
+                if (it == jobIndexes.end()) {
+                    it = jobIndexes.insert(key, jobs.size());
+                    jobs.append(QVector<QRect>());
+                }
+
+                jobs[*it].append((rect & tileRect).translated(tileGridOrigin));
+            }
+        }
+    }
+
+    return jobs;
+}
+
+}
+
 struct BilinearWrapper
 {
     using SrcAccessorSP = KisRandomSubAccessorSP;
@@ -167,26 +263,40 @@ void KisPerspectiveTransformWorker::runImpl()
 
     KIS_ASSERT_RECOVER_NOOP(!m_isIdentity);
 
-    KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, m_dstRegion.rectCount());
-
-    SrcAccessorWrapper srcAcc(cloneDevice);
-    KisRandomAccessorSP accessor = m_dev->createRandomAccessorNG();
-
-    Q_FOREACH (const QRect &rect, m_dstRegion.rects()) {
-        for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
-            for (int x = rect.x(); x < rect.x() + rect.width(); ++x) {
-
-                QPointF dstPoint(x, y);
-                QPointF srcPoint = m_backwardTransform.map(dstPoint);
-
-                if (m_srcRect.contains(srcPoint)) {
-                    accessor->moveTo(dstPoint.x(), dstPoint.y());
-                    srcAcc.samplePixel(srcPoint, accessor->rawData());
+    /**
+     * The destination is processed tile-by-tile in parallel. The source
+     * clone is only read, and every job writes into its own tile of the
+     * destination, so the jobs need no synchronization, except for the
+     * progress reporting.
+     */
+    QVector<QVector<QRect>> jobs =
+        splitRegionIntoTileJobs(m_dstRegion, QPoint(m_dev->x(), m_dev->y()));
+
+    KisProgressUpdateHelper progressHelper(m_progressUpdater, 100, jobs.size());
+    QMutex progressMutex;
+
+    QtConcurrent::blockingMap(jobs, [&] (const QVector<QRect> &rects) {
+        SrcAccessorWrapper srcAcc(cloneDevice);
+        KisRandomAccessorSP accessor = m_dev->createRandomAccessorNG();
+
+        Q_FOREACH (const QRect &rect, rects) {
+            for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
+                const RowMapper mapper(m_backwardTransform, y);
+
+                for (int x = rect.x(); x < rect.x() + rect.width(); ++x) {
+                    const QPointF srcPoint = mapper.map(x);
+
+                    if (m_srcRect.contains(srcPoint)) {
+                        accessor->moveTo(x, y);
+                        srcAcc.samplePixel(srcPoint, accessor->rawData());
+                    }
                 }
             }
         }
+
+        QMutexLocker l(&progressMutex);
         progressHelper.step();
-    }
+    });
 }
 
 void KisPerspectiveTransformWorker::run(SampleType sampleType)
@@ -219,13 +329,13 @@ void KisPerspectiveTransformWorker::runPartialDst(KisPaintDeviceSP srcDev,
         KisRandomAccessorSP accessor = dstDev->createRandomAccessorNG();
 
         for (int y = dstRect.y(); y < dstRect.y() + dstRect.height(); ++y) {
-            for (int x = dstRect.x(); x < dstRect.x() + dstRect.width(); ++x) {
+            const RowMapper mapper(m_backwardTransform, y);
 
-                QPointF dstPoint(x, y);
-                QPointF srcPoint = m_backwardTransform.map(dstPoint);
+            for (int x = dstRect.x(); x < dstRect.x() + dstRect.width(); ++x) {
+                const QPointF srcPoint = mapper.map(x);
 
                 if (srcClipRect.contains(srcPoint) || srcDev->defaultBounds()->wrapAroundMode()) {
-                    accessor->moveTo(dstPoint.x(), dstPoint.y());
+                    accessor->moveTo(x, y);
                     srcAcc->moveTo(srcPoint.x(), srcPoint.y());
                     srcAcc->sampledOldRawData(accessor->rawData());
                 }
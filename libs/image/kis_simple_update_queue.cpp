@@ -7,6 +7,7 @@
 #include "kis_simple_update_queue.h"
 
 #include <QMutexLocker>
+#include <QSet>
 #include <QVector>
 
 #include "kis_image_config.h"
@@ -79,12 +80,101 @@ void KisSimpleUpdateQueue::processQueue(KisUpdaterContext &updaterContext)
 {
     updaterContext.lock();
 
+    splitJobsForSpareThreads(updaterContext.numSpareThreads(),
+                             updaterContext.currentLevelOfDetail());
+
     while(updaterContext.hasSpareThread() &&
           processOneJob(updaterContext));
 
     updaterContext.unlock();
 }
 
+/**
+ * When the queue has fewer jobs than the spare threads, the biggest
+ * queued jobs are split in halves along the tile grid, so that the idle
+ * threads can take the pieces. Every half is a separate walker with its
+ * own need and access rects.
+ *
+ * KisUpdaterContext::isJobAllowed() never runs jobs with intersecting
+ * access rects concurrently, so a job is split only when the access
+ * rects of its halves don't intersect. That covers the plain layers and
+ * the per-pixel masks and filters. The jobs of the layers with blur-like
+ * masks or filters are never split: their halves would run one after
+ * another anyway, so such a job still occupies a single thread. There
+ * is no work stealing between the threads either, a job is split only
+ * before it is started.
+ */
+void KisSimpleUpdateQueue::splitJobsForSpareThreads(int numSpareThreads, int currentLevelOfDetail)
+{
+    QMutexLocker locker(&m_lock);
+
+    const int tileSize = 64;
+
+    auto splitPosition = [] (int start, int size) {
+        const int middle = start + size / 2;
+        const int aligned = middle - (middle % tileSize + tileSize) % tileSize;
+        return aligned - start >= minBalancedPatchSize ? aligned : middle;
+    };
+
+    QSet<KisBaseRectsWalker*> unsplittableWalkers;
+
+    while (m_updatesList.size() < numSpareThreads) {
+        KisWalkersList::iterator biggestIt = m_updatesList.end();
+        qint64 biggestArea = 0;
+
+        for (auto it = m_updatesList.begin(); it != m_updatesList.end(); ++it) {
+            KisBaseRectsWalkerSP walker = *it;
+
+            if (currentLevelOfDetail >= 0 && walker->levelOfDetail() != currentLevelOfDetail) continue;
+            if (!walker->checksumValid()) continue;
+            if (unsplittableWalkers.contains(walker.data())) continue;
+
+            const QRect rc = walker->requestedRect();
+            if (qMax(rc.width(), rc.height()) < 2 * minBalancedPatchSize) continue;
+
+            const qint64 area = qint64(rc.width()) * rc.height();
+            if (area > biggestArea) {
+                biggestArea = area;
+                biggestIt = it;
+            }
+        }
+
+        if (biggestIt == m_updatesList.end()) break;
+
+        KisBaseRectsWalkerSP walker = *biggestIt;
+        const QRect rc = walker->requestedRect();
+
+        QRect firstRect;
+        QRect secondRect;
+
+        if (rc.width() >= rc.height()) {
+            const int x = splitPosition(rc.x(), rc.width());
+            firstRect = QRect(rc.x(), rc.y(), x - rc.x(), rc.height());
+            secondRect = QRect(x, rc.y(), rc.x() + rc.width() - x, rc.height());
+        } else {
+            const int y = splitPosition(rc.y(), rc.height());
+            firstRect = QRect(rc.x(), rc.y(), rc.width(), y - rc.y());
+            secondRect = QRect(rc.x(), y, rc.width(), rc.y() + rc.height() - y);
+        }
+
+        KisBaseRectsWalkerSP firstWalker = createWalker(walker->type(), walker->cropRect());
+        KisBaseRectsWalkerSP secondWalker = createWalker(walker->type(), walker->cropRect());
+
+        m_overrideLevelOfDetail = walker->levelOfDetail();
+        firstWalker->collectRects(walker->startNode(), firstRect);
+        secondWalker->collectRects(walker->startNode(), secondRect);
+        m_overrideLevelOfDetail = -1;
+
+        if (firstWalker->accessRect().intersects(secondWalker->accessRect())) {
+            unsplittableWalkers.insert(walker.data());
+            continue;
+        }
+
+        *biggestIt = firstWalker;
+        m_updatesList.insert(biggestIt + 1, secondWalker);
+    }
+}
+
 bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 {
     QMutexLocker locker(&m_lock);
@@ -191,25 +281,10 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
     Q_FOREACH (const QRect &rc, rects) {
         if (rc.isEmpty()) continue;
 
-        KisBaseRectsWalkerSP walker;
-
         if(trySplitJob(node, rc, cropRect, levelOfDetail, type)) continue;
         if(tryMergeJob(node, rc, cropRect, levelOfDetail, type)) continue;
 
-        if (type == KisBaseRectsWalker::UPDATE) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
-        }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
-            walker = new KisFullRefreshWalker(cropRect);
-        }
-        else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
-        }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
-            walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
-        }
-        /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
-
+        KisBaseRectsWalkerSP walker = createWalker(type, cropRect);
         walker->collectRects(node, rc);
         walkers.append(walker);
     }
@@ -221,6 +296,27 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
     }
 }
 
+KisBaseRectsWalkerSP KisSimpleUpdateQueue::createWalker(KisBaseRectsWalker::UpdateType type, const QRect& cropRect)
+{
+    KisBaseRectsWalkerSP walker;
+
+    if (type == KisBaseRectsWalker::UPDATE) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
+        walker = new KisFullRefreshWalker(cropRect);
+    }
+    else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
+        walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
+    }
+    /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
+
+    return walker;
+}
+
 void KisSimpleUpdateQueue::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
 {
     QMutexLocker locker(&m_lock);
@@ -51,6 +51,9 @@ protected:
 
     bool processOneJob(KisUpdaterContext &updaterContext);
 
+    void splitJobsForSpareThreads(int numSpareThreads, int currentLevelOfDetail);
+    KisBaseRectsWalkerSP createWalker(KisBaseRectsWalker::UpdateType type, const QRect& cropRect);
+
     bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
@@ -77,6 +80,12 @@ protected:
     qint32 m_patchWidth;
     qint32 m_patchHeight;
 
+    /**
+     * When there are more spare threads than queued jobs, the biggest
+     * jobs are split in halves, but not smaller than this size
+     */
+    static const qint32 minBalancedPatchSize = 128;
+
     /**
      * Maximum coefficient of work while regular optimization()
      */
@@ -9,6 +9,8 @@
 #include <QQueue>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QHash>
 #include "kis_stroke.h"
 #include "kis_updater_context.h"
 #include "kis_stroke_job_strategy.h"
@@ -16,6 +18,8 @@
 #include "kis_undo_stores.h"
 #include "kis_post_execution_undo_adapter.h"
 #include "KisCppQuirks.h"
+#include "KisTimelineTracer.h"
+#include "KisAdaptiveLodController.h"
 
 typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
@@ -67,11 +71,15 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
           wrapAroundModeSupported(false),
           balancingRatioOverride(-1.0),
           currentStrokeLoaded(false),
+          currentStrokeStartTime(-1),
           lodNNeedsSynchronization(true),
           desiredLevelOfDetail(0),
           nextDesiredLevelOfDetail(0),
           lodNStrokesFacade(_q),
-          lodNPostExecutionUndoAdapter(&lodNUndoStore, &lodNStrokesFacade) {}
+          lodNPostExecutionUndoAdapter(&lodNUndoStore, &lodNStrokesFacade)
+    {
+        latencyTimer.start();
+    }
 
     KisStrokesQueue *q;
     StrokesQueue strokesQueue;
@@ -80,6 +88,7 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     bool wrapAroundModeSupported;
     qreal balancingRatioOverride;
     bool currentStrokeLoaded;
+    qint64 currentStrokeStartTime;
 
     bool lodNNeedsSynchronization;
     int desiredLevelOfDetail;
@@ -92,6 +101,10 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     KisPostExecutionUndoAdapter lodNPostExecutionUndoAdapter;
     KisLodPreferences lodPreferences;
 
+    KisAdaptiveLodController adaptiveLod;
+    QElapsedTimer latencyTimer;
+    QHash<KisStroke*, qint64> lodNStrokesEndTime;
+
     void cancelForgettableStrokes();
     void startLod0ToNStroke(int levelOfDetail, bool forgettable);
 
@@ -102,9 +115,14 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     bool shouldWrapInSuspendUpdatesStroke();
 
     void switchDesiredLevelOfDetail(bool forced);
+    int effectiveDesiredLevelOfDetail() const;
+    void reportLodNStrokeFinished(KisStrokeSP stroke);
     bool hasUnfinishedStrokes() const;
     void tryClearUndoOnStrokeCompletion(KisStrokeSP finishingStroke);
     void forceResetLodAndCloseCurrentLodRange();
+
+    void traceStrokeLoaded();
+    void traceStrokeFinished(KisStrokeSP stroke);
 };
 
 
@@ -377,6 +395,10 @@ void KisStrokesQueue::endStroke(KisStrokeId id)
     KisStrokeSP buddy = stroke->lodBuddy();
     if (buddy) {
         buddy->endStroke();
+
+        if (m_d->lodPreferences.lodAdaptive()) {
+            m_d->lodNStrokesEndTime.insert(buddy.data(), m_d->latencyTimer.elapsed());
+        }
     }
 }
 
@@ -556,6 +578,29 @@ void KisStrokesQueue::Private::tryClearUndoOnStrokeCompletion(KisStrokeSP finish
     }
 }
 
+/**
+ * The lifetime of the strokes is traced on a separate track, because
+ * the stroke may start and finish on different threads
+ */
+void KisStrokesQueue::Private::traceStrokeLoaded()
+{
+    KisTimelineTracer *tracer = KisTimelineTracer::instance();
+    currentStrokeStartTime = tracer->isEnabled() ? tracer->currentTime() : -1;
+}
+
+void KisStrokesQueue::Private::traceStrokeFinished(KisStrokeSP stroke)
+{
+    if (currentStrokeStartTime < 0) return;
+
+    KisTimelineTracer *tracer = KisTimelineTracer::instance();
+    tracer->addSpan("stroke", stroke->id(),
+                    currentStrokeStartTime, tracer->currentTime(),
+                    {{"levelOfDetail", stroke->worksOnLevelOfDetail()}},
+                    "Strokes");
+
+    currentStrokeStartTime = -1;
+}
+
 void KisStrokesQueue::Private::forceResetLodAndCloseCurrentLodRange()
 {
     lodNNeedsSynchronization = true;
@@ -606,7 +651,9 @@ KisLodPreferences KisStrokesQueue::lodPreferences() const
      * The desired level of detail might have not been activated due to
      * multi-stage activation process
      */
-    return KisLodPreferences(m_d->lodPreferences.flags(), m_d->desiredLevelOfDetail);
+    return KisLodPreferences(m_d->lodPreferences.flags(),
+                             m_d->desiredLevelOfDetail,
+                             m_d->lodPreferences.maxLevelOfDetail());
 }
 
 void KisStrokesQueue::setLodPreferences(const KisLodPreferences &value)
@@ -615,14 +662,52 @@ void KisStrokesQueue::setLodPreferences(const KisLodPreferences &value)
 
     m_d->lodPreferences = value;
 
-    if (m_d->lodPreferences.desiredLevelOfDetail() != m_d->nextDesiredLevelOfDetail ||
+    if (!m_d->lodPreferences.lodAdaptive()) {
+        m_d->adaptiveLod.reset();
+    }
+
+    const int lod = m_d->effectiveDesiredLevelOfDetail();
+
+    if (lod != m_d->nextDesiredLevelOfDetail ||
             (m_d->lodPreferences.lodPreferred() && m_d->lodNNeedsSynchronization)) {
 
-        m_d->nextDesiredLevelOfDetail = m_d->lodPreferences.desiredLevelOfDetail();
+        m_d->nextDesiredLevelOfDetail = lod;
         m_d->switchDesiredLevelOfDetail(false);
     }
 }
 
+QVector<KisAdaptiveLodController::StrokeReport> KisStrokesQueue::adaptiveLodReports() const
+{
+    QMutexLocker locker(&m_d->mutex);
+    return m_d->adaptiveLod.strokeReports();
+}
+
+int KisStrokesQueue::Private::effectiveDesiredLevelOfDetail() const
+{
+    return lodPreferences.lodAdaptive() ?
+        adaptiveLod.levelOfDetail(lodPreferences.desiredLevelOfDetail(),
+                                  lodPreferences.maxLevelOfDetail()) :
+        lodPreferences.desiredLevelOfDetail();
+}
+
+void KisStrokesQueue::Private::reportLodNStrokeFinished(KisStrokeSP stroke)
+{
+    auto it = lodNStrokesEndTime.find(stroke.data());
+    if (it == lodNStrokesEndTime.end()) return;
+
+    const qint64 latency = latencyTimer.elapsed() - *it;
+    lodNStrokesEndTime.erase(it);
+
+    if (stroke->isCancelled() || !lodPreferences.lodAdaptive()) return;
+
+    if (adaptiveLod.reportStroke(stroke->id(), stroke->worksOnLevelOfDetail(),
+                                 lodPreferences.maxLevelOfDetail(), latency)) {
+
+        // the switch will happen as soon as the current LoD range is closed
+        nextDesiredLevelOfDetail = effectiveDesiredLevelOfDetail();
+    }
+}
+
 bool KisStrokesQueue::isEmpty() const
 {
     QMutexLocker locker(&m_d->mutex);
@@ -771,6 +856,7 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
             m_d->wrapAroundModeSupported = stroke->supportsWrapAroundMode();
             m_d->balancingRatioOverride = stroke->balancingRatioOverride();
             m_d->currentStrokeLoaded = true;
+            m_d->traceStrokeLoaded();
         }
 
         result = true;
@@ -785,12 +871,15 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
             m_d->wrapAroundModeSupported = stroke->supportsWrapAroundMode();
             m_d->balancingRatioOverride = stroke->balancingRatioOverride();
             m_d->currentStrokeLoaded = true;
+            m_d->traceStrokeLoaded();
         }
 
         result = true;
     }
     else if(stroke->isEnded() && !hasJobs && !hasStrokeJobsRunning) {
         m_d->tryClearUndoOnStrokeCompletion(stroke);
+        m_d->traceStrokeFinished(stroke);
+        m_d->reportLodNStrokeFinished(stroke);
 
         m_d->strokesQueue.dequeue(); // deleted by shared pointer
         m_d->needsExclusiveAccess = false;
@@ -17,6 +17,7 @@
 #include "KisStrokesQueueMutatedJobInterface.h"
 #include "KisUpdaterContextSnapshotEx.h"
 #include "KisLodPreferences.h"
+#include "KisAdaptiveLodController.h"
 
 class KisUpdaterContext;
 class KisStroke;
@@ -56,6 +57,13 @@ public:
     KisLodPreferences lodPreferences() const override;
     void setLodPreferences(const KisLodPreferences &value);
     void explicitRegenerateLevelOfDetail();
+
+    /**
+     * The levels of detail chosen for the last instant preview strokes
+     * when the adaptive level of detail is enabled in the preferences
+     */
+    QVector<KisAdaptiveLodController::StrokeReport> adaptiveLodReports() const;
+
     void setLod0ToNStrokeStrategyFactory(const KisLodSyncStrokeStrategyFactory &factory);
     void setSuspendResumeUpdatesStrokeStrategyFactory(const KisSuspendResumeStrategyPairFactory &factory);
     KisPostExecutionUndoAdapter* lodNPostExecutionUndoAdapter() const;
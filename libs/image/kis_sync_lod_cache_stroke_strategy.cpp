@@ -73,17 +73,18 @@ void KisSyncLodCacheStrokeStrategy::createJobsData(QVector<KisStrokeJobData *> &
 
     KritaUtils::makeContainerUnique(deviceList);
 
-
-    KritaUtils::addJobBarrier(jobs, [sharedData, deviceList, levelOfDetail] () mutable {
-        Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-            sharedData->insert(device, toQShared(device->createLodDataStruct(levelOfDetail)));
-        }
-    });
-
-    KritaUtils::addJobSequential(jobs, [](){});
+    /**
+     * The data structs are created right here (we are called from a
+     * barrier job), because only the struct knows which parts of the
+     * device have changed since the previous synchronization. Unchanged
+     * devices get an empty region and generate no jobs.
+     */
+    Q_FOREACH (KisPaintDeviceSP device, deviceList) {
+        sharedData->insert(device, toQShared(device->createLodDataStruct(levelOfDetail)));
+    }
 
     Q_FOREACH (KisPaintDeviceSP device, deviceList) {
-        KisRegion region = device->regionForLodSyncing();
+        KisRegion region = device->regionForLodSyncing(sharedData->value(device).data());
         QVector<QRect> rects = splitRegionIntoPatches(region, optimalPatchSize());
 
         Q_FOREACH (const QRect &rc, rects) {
@@ -10,10 +10,16 @@
 
 #include "kis_transform_worker.h"
 
+#include <algorithm>
+
 #include <qmath.h>
 #include <klocalizedstring.h>
 
 #include <QTransform>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -59,6 +65,11 @@ KisTransformWorker::~KisTransformWorker()
 {
 }
 
+void KisTransformWorker::testingDisableSplittingIntoBands()
+{
+    m_splitPassesIntoBands = false;
+}
+
 QTransform KisTransformWorker::transform() const
 {
     QTransform TS = QTransform::fromTranslate(m_xshearOrigin, m_yshearOrigin);
@@ -144,6 +155,47 @@ QRect KisTransformWorker::rotate180(KisPaintDeviceSP dev,
     return QRect(- r.x() - r.width(), - r.top() - r.height(), r.width(), r.height());
 }
 
+namespace {
+
+const int tileSize = 64;
+
+/**
+ * The lines of a pass are independent from each other: every line is
+ * read into a temporary buffer and written back to the same line. So the
+ * pass can be split into bands of lines processed concurrently. The bands
+ * are aligned to the tile grid of the device to avoid two threads writing
+ * into the same tile.
+ */
+QVector<QPair<int, int>> splitIntoTileAlignedBands(int firstLine, int numLines, int tileGridOrigin)
+{
+    QVector<QPair<int, int>> bands;
+
+    const int minBandSize = tileSize;
+    const int maxBands = 4 * QThread::idealThreadCount();
+    const int bandSize =
+        qMax(minBandSize, (numLines / maxBands + tileSize - 1) / tileSize * tileSize);
+
+    const int endLine = firstLine + numLines;
+    int bandStart = firstLine;
+
+    while (bandStart < endLine) {
+        int tileOffset = (bandStart - tileGridOrigin) % tileSize;
+        if (tileOffset < 0) {
+            tileOffset += tileSize;
+        }
+
+        const int tileAlignedStart = bandStart - tileOffset;
+        const int bandEnd = qMin(endLine, tileAlignedStart + bandSize);
+
+        bands.append(qMakePair(bandStart, bandEnd - bandStart));
+        bandStart = bandEnd;
+    }
+
+    return bands;
+}
+
+}
+
 template <class iter> void calcDimensions(QRect rc, qint32 &srcStart, qint32 &srcLen, qint32 &firstLine, qint32 &numLines);
 
 template <> void calcDimensions <KisHLineIteratorSP>
@@ -165,6 +217,18 @@ template <> void calcDimensions <KisVLineIteratorSP>
 
 }
 
+template <class iter> int tileGridOrigin(KisPaintDevice *dev);
+
+template <> int tileGridOrigin <KisHLineIteratorSP>(KisPaintDevice *dev)
+{
+    return dev->y();
+}
+
+template <> int tileGridOrigin <KisVLineIteratorSP>(KisPaintDevice *dev)
+{
+    return dev->x();
+}
+
 template <class iter>
 void updateBounds(QRect &boundRect,
                   const KisFilterWeightsApplicator::LinePos &newBounds);
@@ -196,18 +260,42 @@ void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
 
     KisProgressUpdateHelper progressHelper(m_progressUpdater, portion, numLines);
     KisFilterWeightsBuffer buf(filterStrategy, qAbs(floatscale));
-    KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
+    const qreal filterSupport = filterStrategy->support(buf.weightsPositionScale().toFloat());
 
     KisFilterWeightsApplicator::LinePos dstBounds;
+    QMutex mutex;
 
-    for (int i = firstLine; i < firstLine + numLines; i++) {
-        KisFilterWeightsApplicator::LinePos dstPos;
-        KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+    /**
+     * The weights buffer is read-only, so it is shared between the bands,
+     * each band has its own applicator and iterators.
+     */
+    auto processBand = [&] (const QPair<int, int> &band) {
+        KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
+        KisFilterWeightsApplicator::LinePos bandDstBounds;
 
-        dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support(buf.weightsPositionScale().toFloat()));
-        dstBounds.unite(dstPos);
+        for (int i = band.first; i < band.first + band.second; i++) {
+            KisFilterWeightsApplicator::LinePos dstPos;
+            KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
 
-        progressHelper.step();
+            dstPos = applicator.processLine<T>(srcPos, i, &buf, filterSupport);
+            bandDstBounds.unite(dstPos);
+
+            QMutexLocker l(&mutex);
+            progressHelper.step();
+        }
+
+        QMutexLocker l(&mutex);
+        dstBounds.unite(bandDstBounds);
+    };
+
+    QVector<QPair<int, int>> bands = m_splitPassesIntoBands ?
+        splitIntoTileAlignedBands(firstLine, numLines, tileGridOrigin<T>(src)) :
+        QVector<QPair<int, int>>({qMakePair(firstLine, numLines)});
+
+    if (bands.size() > 1) {
+        QtConcurrent::blockingMap(bands, processBand);
+    } else {
+        std::for_each(bands.begin(), bands.end(), processBand);
     }
 
     updateBounds<T>(m_boundRect, dstBounds);
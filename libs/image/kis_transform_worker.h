@@ -119,6 +119,12 @@ private:
 
     friend class KisTransformWorkerTest;
 
+    /**
+     * Process every pass as a single band in the calling thread,
+     * the reference for checking the seams between the bands
+     */
+    void testingDisableSplittingIntoBands();
+
     static QRect rotateRight90(KisPaintDeviceSP dev,
                                QRect boundRect,
                                KoUpdaterPtr progressUpdater,
@@ -143,6 +149,7 @@ private:
     KoUpdaterPtr m_progressUpdater;
     KisFilterStrategy *m_filter;
     QRect m_boundRect;
+    bool m_splitPassesIntoBands = true;
 };
 
 #endif // KIS_TRANSFORM_VISITOR_H_
@@ -17,6 +17,7 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisTimelineTracer.h"
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -97,7 +98,16 @@ private:
                     }
 #endif
 
+                    KisTimelineTracer *tracer = KisTimelineTracer::instance();
+                    const qint64 startTime = tracer->isEnabled() ? tracer->currentTime() : -1;
+
                     m_runnableJob->run();
+
+                    if (startTime >= 0) {
+                        tracer->addSpan(m_atomicType == Type::STROKE ? "stroke" : "spontaneous",
+                                        m_runnableJob->debugName(),
+                                        startTime, tracer->currentTime());
+                    }
                 }
             }
 
@@ -132,7 +142,13 @@ public:
 
 #endif
 
-        m_merger.startMerge(*m_walker);
+        {
+            KisTimelineTracer::Span span("merge", "merge walker");
+            span.setArg("changeRect", m_walker->changeRect());
+            span.setArg("levelOfDetail", m_walker->levelOfDetail());
+
+            m_merger.startMerge(*m_walker);
+        }
 
         QRect changeRect = m_walker->changeRect();
         m_updaterContext->continueUpdate(changeRect);
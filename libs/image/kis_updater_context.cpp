@@ -100,6 +100,18 @@ bool KisUpdaterContext::hasSpareThread()
     return found;
 }
 
+int KisUpdaterContext::numSpareThreads()
+{
+    int numSpareThreads = 0;
+
+    Q_FOREACH (const KisUpdateJobItem *item, m_jobs) {
+        if(!item->isRunning()) {
+            numSpareThreads++;
+        }
+    }
+    return numSpareThreads;
+}
+
 bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
 {
     int lod = this->currentLevelOfDetail();
@@ -56,6 +56,11 @@ public:
      */
     bool hasSpareThread();
 
+    /**
+     * \return the number of the threads not running any job
+     */
+    int numSpareThreads();
+
     /**
      * Checks whether the walker intersects with any
      * of currently executing walkers. If it does,
@@ -246,8 +246,12 @@ void KisWarpTransformWorker::run(KisPaintDeviceSP srcDev, KisPaintDeviceSP dstDe
 
     FunctionTransformOp functionOp(m_warpMathFunction, m_origPoint, m_transfPoint, m_alpha);
     GridIterationTools::PaintDevicePolygonOp polygonOp(srcDev, dstDev);
-    GridIterationTools::processGrid(polygonOp, functionOp,
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::PaintDevicePolygonOp>
+        parallelOp(polygonOp, QPoint(dstDev->x(), dstDev->y()));
+
+    GridIterationTools::processGrid(parallelOp, functionOp,
                                     srcBounds, pixelPrecision);
+    parallelOp.flush();
 }
 
 #include "krita_utils.h"
@@ -347,7 +351,10 @@ QImage KisWarpTransformWorker::transformQImage(WarpType warpType,
 
     const int pixelPrecision = 32;
     GridIterationTools::QImagePolygonOp polygonOp(srcImage, dstImage, srcQImageOffset, dstQImageOffset);
-    GridIterationTools::processGrid(polygonOp, functionOp, srcBounds.toAlignedRect(), pixelPrecision);
+    GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp);
+
+    GridIterationTools::processGrid(parallelOp, functionOp, srcBounds.toAlignedRect(), pixelPrecision);
+    parallelOp.flush();
 
     return dstImage;
 }
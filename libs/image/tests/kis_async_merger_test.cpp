@@ -16,6 +16,7 @@
 #include "kis_image.h"
 #include "kis_paint_layer.h"
 #include "kis_group_layer.h"
+#include "KisBelowLayersProjectionCache.h"
 #include "kis_clone_layer.h"
 #include "kis_adjustment_layer.h"
 #include "kis_filter_mask.h"
@@ -496,6 +497,240 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
                                   "async_merger_test", "mask_on_adj", "initial", 3));
 }
 
+/*
+  +--------------+
+  |root          |
+  | paint5       |
+  | paint4       |
+  | paint3       |
+  | paint2       |
+  | paint1       |
+  +--------------+
+ */
+
+void KisAsyncMergerTest::testBelowLayersProjectionCache()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 128, 128, colorSpace, "below layers cache test");
+
+    auto createLayer = [&] (const QString &name, const QRect &rc, const QColor &color, quint8 opacity) {
+        KisPaintDeviceSP device = new KisPaintDevice(colorSpace);
+        device->fill(rc, KoColor(color, colorSpace));
+        KisLayerSP layer = new KisPaintLayer(image, name, opacity, device);
+        image->addNode(layer, image->rootLayer());
+        return layer;
+    };
+
+    createLayer("paint1", image->bounds(), Qt::white, OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer2 = createLayer("paint2", QRect(0, 0, 64, 128), Qt::red, 128);
+    createLayer("paint3", QRect(32, 32, 64, 64), Qt::blue, 200);
+    KisLayerSP paintLayer4 = createLayer("paint4", QRect(), Qt::black, 150);
+    createLayer("paint5", QRect(16, 64, 96, 32), Qt::green, 100);
+
+    image->initialRefreshGraph();
+
+    const QRect cropRect(image->bounds());
+    KisAsyncMerger merger;
+
+    auto paintRect = [&] (KisLayerSP layer, const QRect &rc, const QColor &color) {
+        layer->paintDevice()->fill(rc, KoColor(color, colorSpace));
+
+        KisMergeWalker walker(cropRect);
+        walker.collectRects(layer, rc);
+        merger.startMerge(walker);
+    };
+
+    auto checkAgainstFullRefresh = [&] () {
+        const QImage result = image->projection()->convertToQImage(0);
+        image->refreshGraph();
+        const QImage reference = image->projection()->convertToQImage(0);
+        QCOMPARE(result, reference);
+    };
+
+    // overlapping updates of a layer in the middle of the stack
+    for (int i = 0; i < 8; i++) {
+        paintRect(paintLayer4, QRect(8 * i, 4 * i, 40, 40), QColor(30 * i, 0, 255 - 30 * i));
+    }
+    checkAgainstFullRefresh();
+
+    // a change below the cached plane resets the cache
+    paintRect(paintLayer2, QRect(20, 20, 60, 60), Qt::yellow);
+    paintRect(paintLayer4, QRect(10, 10, 50, 50), Qt::cyan);
+    checkAgainstFullRefresh();
+
+    // the full refresh above invalidated the cached area
+    paintLayer2->paintDevice()->fill(QRect(0, 0, 128, 128), KoColor(Qt::magenta, colorSpace));
+    image->refreshGraph();
+    paintRect(paintLayer4, QRect(20, 20, 50, 50), Qt::black);
+    checkAgainstFullRefresh();
+}
+
+/*
+  +----------------+
+  |root            |
+  | group2         |
+  |  paint23       |
+  |  paint22       |
+  |  paint21       |
+  | group1         |
+  |  paint13       |
+  |  paint12       |
+  |  paint11       |
+  +----------------+
+ */
+
+void KisAsyncMergerTest::testBelowLayersProjectionCacheMemoryLimit()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 128, 128, colorSpace, "below layers cache limit test");
+
+    auto createGroup = [&] (const QString &name) {
+        KisGroupLayerSP group = new KisGroupLayer(image, name, OPACITY_OPAQUE_U8);
+        image->addNode(group, image->rootLayer());
+
+        KisLayerSP topmostLayer;
+        for (int i = 1; i <= 3; i++) {
+            KisPaintDeviceSP device = new KisPaintDevice(colorSpace);
+            device->fill(QRect(0, 0, 32 * i, 128), KoColor(QColor(80 * i, 0, 0), colorSpace));
+            topmostLayer = new KisPaintLayer(image, QString("%1%2").arg(name).arg(i), 128, device);
+            image->addNode(topmostLayer, group);
+        }
+
+        return qMakePair(group, topmostLayer);
+    };
+
+    auto group1 = createGroup("paint1");
+    auto group2 = createGroup("paint2");
+
+    image->initialRefreshGraph();
+
+    KisBelowLayersProjectionCache *cache1 = group1.first->belowLayersProjectionCache();
+    KisBelowLayersProjectionCache *cache2 = group2.first->belowLayersProjectionCache();
+
+    const QRect cropRect(image->bounds());
+    KisAsyncMerger merger;
+
+    auto paintRect = [&] (KisLayerSP layer, const QRect &rc) {
+        layer->paintDevice()->fill(rc, KoColor(Qt::blue, colorSpace));
+
+        KisMergeWalker walker(cropRect);
+        walker.collectRects(layer, rc);
+        merger.startMerge(walker);
+    };
+
+    const qint64 planeSize = 40 * 40 * colorSpace->pixelSize();
+
+    const qint64 oldMemoryLimit = KisBelowLayersProjectionCache::memoryLimit();
+    KisBelowLayersProjectionCache::setMemoryLimit(planeSize * 3 / 2);
+
+    paintRect(group1.second, QRect(10, 10, 40, 40));
+    QCOMPARE(cache1->memoryUsage(), planeSize);
+    QCOMPARE(cache2->memoryUsage(), 0);
+
+    // the least recently used cache is dropped
+    paintRect(group2.second, QRect(10, 10, 40, 40));
+    QCOMPARE(cache1->memoryUsage(), 0);
+    QCOMPARE(cache2->memoryUsage(), planeSize);
+
+    const QImage result = image->projection()->convertToQImage(0);
+    image->refreshGraph();
+    QCOMPARE(result, image->projection()->convertToQImage(0));
+
+    // the cache of a removed group is dropped
+    paintRect(group2.second, QRect(10, 10, 40, 40));
+    QVERIFY(cache2->memoryUsage() > 0);
+    image->removeNode(group2.first);
+    QCOMPARE(cache2->memoryUsage(), 0);
+
+    KisBelowLayersProjectionCache::setMemoryLimit(oldMemoryLimit);
+}
+
+/*
+  +--------------+
+  |root          |
+  | paint4       |
+  | paint3       |  <-- opaque in the left half
+  | paint2       |  <-- updated
+  | paint1       |
+  +--------------+
+ */
+
+void KisAsyncMergerTest::testOcclusionCulling()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 256, 256, colorSpace, "occlusion culling test");
+
+    QVector<KisLayerSP> layers;
+
+    auto createLayer = [&] (const QString &name, const QRect &rc, const QColor &color, quint8 opacity) {
+        KisPaintDeviceSP device = new KisPaintDevice(colorSpace);
+        device->fill(rc, KoColor(color, colorSpace));
+        KisLayerSP layer = new KisPaintLayer(image, name, opacity, device);
+        image->addNode(layer, image->rootLayer());
+        layers << layer;
+        return layer;
+    };
+
+    createLayer("paint1", image->bounds(), Qt::white, OPACITY_OPAQUE_U8);
+    KisLayerSP paintLayer2 = createLayer("paint2", QRect(32, 32, 192, 192), Qt::red, 128);
+    KisLayerSP paintLayer3 = createLayer("paint3", QRect(0, 0, 128, 256), Qt::blue, OPACITY_OPAQUE_U8);
+    createLayer("paint4", QRect(64, 64, 128, 128), Qt::black, 150);
+
+    image->initialRefreshGraph();
+
+    auto checkProjection = [&] () {
+        KisPaintDeviceSP reference = new KisPaintDevice(colorSpace);
+
+        Q_FOREACH (KisLayerSP layer, layers) {
+            KisPainter gc(reference);
+            gc.setOpacity(layer->opacity());
+            gc.bitBlt(QPoint(), layer->projection(), image->bounds());
+        }
+
+        QCOMPARE(image->projection()->convertToQImage(0, image->bounds()),
+                 reference->convertToQImage(0, image->bounds()));
+    };
+
+    KisAsyncMerger::takeCullingStatistics();
+
+    const QRect cropRect(image->bounds());
+    KisAsyncMerger merger;
+
+    // fully inside the opaque half: paint1 and paint2 are skipped
+    QRect rc(10, 10, 50, 50);
+    paintLayer2->paintDevice()->fill(rc, KoColor(Qt::green, colorSpace));
+    {
+        KisMergeWalker walker(cropRect);
+        walker.collectRects(paintLayer2, rc);
+        merger.startMerge(walker);
+    }
+    checkProjection();
+
+    KisAsyncMerger::CullingStatistics stats = KisAsyncMerger::takeCullingStatistics();
+    QCOMPARE(stats.skippedComposites, qint64(2));
+
+    // crosses the border of the opaque half: paint1 and paint2 are clipped
+    rc = QRect(100, 100, 100, 50);
+    paintLayer2->paintDevice()->fill(rc, KoColor(Qt::green, colorSpace));
+    {
+        KisMergeWalker walker(cropRect);
+        walker.collectRects(paintLayer2, rc);
+        merger.startMerge(walker);
+    }
+    checkProjection();
+
+    stats = KisAsyncMerger::takeCullingStatistics();
+    QCOMPARE(stats.clippedComposites, qint64(2));
+
+    // the occluder is not opaque anymore
+    paintLayer3->setOpacity(200);
+    image->refreshGraph();
+    checkProjection();
+
+    stats = KisAsyncMerger::takeCullingStatistics();
+    QCOMPARE(stats.skippedComposites, qint64(0));
+    QCOMPARE(stats.clippedComposites, qint64(0));
+}
 
 SIMPLE_TEST_MAIN(KisAsyncMergerTest)
 
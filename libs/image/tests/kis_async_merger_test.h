@@ -29,6 +29,10 @@ private Q_SLOTS:
 
     void testFilterMaskOnFilterLayer();
 
+    void testBelowLayersProjectionCache();
+    void testBelowLayersProjectionCacheMemoryLimit();
+    void testOcclusionCulling();
+
 };
 
 #endif /* KIS_ASYNC_MERGER_TEST_H */
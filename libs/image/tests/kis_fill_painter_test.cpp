@@ -12,6 +12,8 @@
 #include "kis_fill_painter.h"
 
 #include <floodfill/kis_scanline_fill.h>
+#include <floodfill/KisLineartDistanceField.h>
+#include "kis_pixel_selection.h"
 
 #define THRESHOLD 10
 
@@ -192,5 +194,109 @@ void KisFillPainterTest::testPatternFill()
 
 }
 
+void KisFillPainterTest::testLineartDistanceField()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(50, 0, 1, 100), KoColor(Qt::black, cs));
+
+    const QRect rc(0, 0, 200, 100);
+
+    KisLineartDistanceFieldSP field = KisLineartDistanceField::fetch(dev, rc, 10);
+
+    QCOMPARE(field->distance(QPoint(50, 10)), quint8(0));
+    QCOMPARE(field->distance(QPoint(55, 10)), quint8(5));
+    QCOMPARE(field->distance(QPoint(40, 10)), quint8(10));
+    QCOMPARE(field->distance(QPoint(70, 10)), MAX_SELECTED);
+    QCOMPARE(field->distance(QPoint(150, 10)), MAX_SELECTED);
+
+    // the field is reused while the device is unchanged
+    QCOMPARE(KisLineartDistanceField::fetch(dev, rc, 8), field);
+
+    // ... and recalculated after the change
+    dev->fill(QRect(150, 0, 1, 100), KoColor(Qt::black, cs));
+    KisLineartDistanceFieldSP newField = KisLineartDistanceField::fetch(dev, rc, 10);
+    QVERIFY(newField != field);
+    QCOMPARE(newField->distance(QPoint(150, 10)), quint8(0));
+    QCOMPARE(newField->distance(QPoint(147, 10)), quint8(3));
+
+    KisLineartDistanceField::clearCache();
+}
+
+void KisFillPainterTest::testCloseGapFill()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    // a square outline with a 5px gap in the top side
+    const KoColor black(Qt::black, cs);
+    dev->fill(QRect(20, 20, 40, 2), black);
+    dev->fill(QRect(65, 20, 35, 2), black);
+    dev->fill(QRect(20, 98, 80, 2), black);
+    dev->fill(QRect(20, 20, 2, 80), black);
+    dev->fill(QRect(98, 20, 2, 80), black);
+
+    // a light square inside, it stops the fill by the color threshold
+    dev->fill(QRect(70, 70, 15, 15), KoColor(QColor(200, 200, 200), cs));
+
+    const QPoint inside(60, 60);
+    const QPoint outside(150, 150);
+
+    auto fillSelection = [dev] (const QPoint &seed, int closeGap) {
+        KisFillPainter painter(dev);
+        painter.setWidth(200);
+        painter.setHeight(200);
+        painter.setFillThreshold(THRESHOLD);
+        painter.setCloseGap(closeGap);
+        return painter.createFloodSelection(seed.x(), seed.y(), dev, 0);
+    };
+
+    KisPixelSelectionSP leaking = fillSelection(inside, 0);
+    QCOMPARE(leaking->pixel(outside).opacityU8(), OPACITY_OPAQUE_U8);
+
+    KisPixelSelectionSP closed = fillSelection(inside, 6);
+    QCOMPARE(closed->pixel(inside).opacityU8(), OPACITY_OPAQUE_U8);
+    QCOMPARE(closed->pixel(outside).opacityU8(), OPACITY_TRANSPARENT_U8);
+
+    // the band near the lineart is restored, but the lineart is not filled
+    QCOMPARE(closed->pixel(QPoint(23, 60)).opacityU8(), OPACITY_OPAQUE_U8);
+    QCOMPARE(closed->pixel(QPoint(21, 60)).opacityU8(), OPACITY_TRANSPARENT_U8);
+
+    // the fill doesn't spread past the color threshold, far from the lineart
+    QCOMPARE(closed->pixel(QPoint(70, 70)).opacityU8(), OPACITY_TRANSPARENT_U8);
+    QCOMPARE(closed->pixel(QPoint(72, 77)).opacityU8(), OPACITY_TRANSPARENT_U8);
+
+    // ...and doesn't flow out through the closed gap
+    QCOMPARE(closed->pixel(QPoint(62, 18)).opacityU8(), OPACITY_TRANSPARENT_U8);
+    QCOMPARE(closed->pixel(QPoint(40, 18)).opacityU8(), OPACITY_TRANSPARENT_U8);
+
+    KisLineartDistanceField::clearCache();
+}
+
+void KisFillPainterTest::testCloseGapFillNarrowRegion()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    // a 4px wide corridor, narrower than the closed gap
+    const KoColor black(Qt::black, cs);
+    dev->fill(QRect(0, 80, 200, 2), black);
+    dev->fill(QRect(0, 86, 200, 2), black);
+
+    KisFillPainter painter(dev);
+    painter.setWidth(200);
+    painter.setHeight(200);
+    painter.setFillThreshold(THRESHOLD);
+    painter.setCloseGap(6);
+
+    // the usual fill is done instead of an empty one
+    KisPixelSelectionSP selection = painter.createFloodSelection(100, 83, dev, 0);
+    QCOMPARE(selection->pixel(QPoint(100, 83)).opacityU8(), OPACITY_OPAQUE_U8);
+    QCOMPARE(selection->pixel(QPoint(10, 84)).opacityU8(), OPACITY_OPAQUE_U8);
+    QCOMPARE(selection->pixel(QPoint(100, 81)).opacityU8(), OPACITY_TRANSPARENT_U8);
+    QCOMPARE(selection->pixel(QPoint(100, 50)).opacityU8(), OPACITY_TRANSPARENT_U8);
+
+    KisLineartDistanceField::clearCache();
+}
 
 SIMPLE_TEST_MAIN(KisFillPainterTest)
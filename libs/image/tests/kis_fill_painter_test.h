@@ -26,6 +26,10 @@ private Q_SLOTS:
     void benchmarkFillingScanlineSelection();
 
     void testPatternFill();
+
+    void testLineartDistanceField();
+    void testCloseGapFill();
+    void testCloseGapFillNarrowRegion();
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include <testimage.h>
 #include "kis_transaction.h"
 #include "kis_image.h"
+#include "brushengine/KisDabMaskCache.h"
 
 void KisFixedPaintDeviceTest::testCreation()
 {
@@ -356,4 +357,45 @@ void KisFixedPaintDeviceTest::testMirroring()
     }
 }
 
+void KisFixedPaintDeviceTest::testDabMaskCache()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // 64x64 rgb8 dab takes 16 KiB, so only two of them fit
+    KisDabMaskCache cache(40);
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, 64, 64));
+    dab->initialize();
+    dab->fill(dab->bounds(), KoColor(Qt::red, cs));
+
+    KisFixedPaintDeviceSP result = new KisFixedPaintDevice(cs);
+
+    QVERIFY(!cache.fetch("dab1", cs, result));
+
+    cache.insert("dab1", dab);
+    QVERIFY(cache.fetch("dab1", cs, result));
+    QCOMPARE(result->bounds(), dab->bounds());
+    QVERIFY(memcmp(result->data(), dab->data(), 64 * 64 * cs->pixelSize()) == 0);
+
+    // the dab rendered in a different color space is not reused
+    QVERIFY(!cache.fetch("dab1", KoColorSpaceRegistry::instance()->rgb16(), result));
+
+    KisDabMaskCache::Statistics stats = cache.takeStatistics();
+    QCOMPARE(stats.hits, qint64(1));
+    QCOMPARE(stats.misses, qint64(2));
+    QCOMPARE(cache.takeStatistics().hits, qint64(0));
+
+    // dab1 is the least recently used one
+    cache.insert("dab2", dab);
+    cache.insert("dab3", dab);
+
+    QVERIFY(!cache.fetch("dab1", cs, result));
+    QVERIFY(cache.fetch("dab2", cs, result));
+    QVERIFY(cache.fetch("dab3", cs, result));
+
+    cache.clear();
+    QVERIFY(!cache.fetch("dab3", cs, result));
+}
+
 SIMPLE_TEST_MAIN(KisFixedPaintDeviceTest)
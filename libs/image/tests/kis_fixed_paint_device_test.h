@@ -27,6 +27,7 @@ private Q_SLOTS:
     void testBltPerformance();
     void testMirroring_data();
     void testMirroring();
+    void testDabMaskCache();
 };
 
 #endif
@@ -1296,4 +1296,47 @@ void KisImageTest::testPaintOverlayMask()
     KIS_DUMP_DEVICE_2(p.image->projection(), refRect, "03_deactivated", "dd");
 }
 
+#include "KisReferenceProjectionCache.h"
+
+void KisImageTest::testReferenceProjectionCache()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, IMAGE_WIDTH, IMAGE_WIDTH, cs, "reference cache test");
+
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "layer1", OPACITY_OPAQUE_U8);
+    layer1->setColorLabelIndex(1);
+    layer1->paintDevice()->fill(QRect(0, 0, 50, 50), KoColor(Qt::red, cs));
+    image->addNode(layer1);
+
+    KisPaintLayerSP layer2 = new KisPaintLayer(image, "layer2", OPACITY_OPAQUE_U8);
+    layer2->setColorLabelIndex(2);
+    layer2->paintDevice()->fill(QRect(50, 50, 50, 50), KoColor(Qt::blue, cs));
+    image->addNode(layer2);
+
+    image->initialRefreshGraph();
+
+    const QList<int> labels({1});
+    KisReferenceProjectionCache *cache = image->referenceProjectionCache();
+
+    KisPaintDeviceSP device = cache->labeledLayersDevice(image->root(), labels, KisMergeLabeledLayersCommand::GroupSelectionPolicy_SelectIfColorLabeled);
+    QCOMPARE(device->pixel(QPoint(10, 10)), KoColor(Qt::red, cs));
+    QCOMPARE(device->pixel(QPoint(60, 60)).opacityU8(), OPACITY_TRANSPARENT_U8);
+
+    // the updated area is recomposed in the same device
+    layer1->paintDevice()->fill(QRect(0, 0, 20, 20), KoColor(Qt::green, cs));
+    layer1->setDirty(QRect(0, 0, 20, 20));
+    image->waitForDone();
+
+    QCOMPARE(cache->labeledLayersDevice(image->root(), labels, KisMergeLabeledLayersCommand::GroupSelectionPolicy_SelectIfColorLabeled), device);
+    QCOMPARE(device->pixel(QPoint(10, 10)), KoColor(Qt::green, cs));
+    QCOMPARE(device->pixel(QPoint(30, 30)), KoColor(Qt::red, cs));
+
+    // the set of the referenced layers has changed
+    layer2->setColorLabelIndex(1);
+
+    KisPaintDeviceSP newDevice = cache->labeledLayersDevice(image->root(), labels, KisMergeLabeledLayersCommand::GroupSelectionPolicy_SelectIfColorLabeled);
+    QVERIFY(newDevice != device);
+    QCOMPARE(newDevice->pixel(QPoint(60, 60)), KoColor(Qt::blue, cs));
+}
+
 KISTEST_MAIN(KisImageTest)
@@ -47,6 +47,8 @@ private Q_SLOTS:
     void testMergePassThroughOverPaintLayer();
 
     void testPaintOverlayMask();
+
+    void testReferenceProjectionCache();
 };
 
 #endif
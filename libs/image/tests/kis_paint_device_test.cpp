@@ -1528,6 +1528,77 @@ void KisPaintDeviceTest::testLodDevice()
                                   "lod", "lod1-offset-6-14"));
 }
 
+KisRegion syncLodCacheIncrementally(KisPaintDeviceSP dev, int levelOfDetail)
+{
+    QScopedPointer<KisPaintDevice::LodDataStruct> s(dev->createLodDataStruct(levelOfDetail));
+
+    const KisRegion region = dev->regionForLodSyncing(s.data());
+    Q_FOREACH(QRect rect, KritaUtils::splitRegionIntoPatches(region, KritaUtils::optimalPatchSize())) {
+        dev->updateLodDataStruct(s.data(), rect);
+    }
+
+    dev->uploadLodDataStruct(s.data());
+
+    return region;
+}
+
+void KisPaintDeviceTest::testLodIncrementalSync()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0,0,512,512);
+
+    TestingLodDefaultBounds *bounds = new TestingLodDefaultBounds(imageRect);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(bounds);
+    fillGradientDevice(dev, imageRect);
+
+    KisPaintDeviceSP ref = new KisPaintDevice(cs);
+    ref->setDefaultBounds(bounds);
+    fillGradientDevice(ref, imageRect);
+
+    auto checkSameAsFullSync = [&] () {
+        syncLodCache(ref, 1);
+        QCOMPARE(dev->convertToQImage(0, 0, 0, 256, 256),
+                 ref->convertToQImage(0, 0, 0, 256, 256));
+    };
+
+    // the first sync is always a full one
+    bounds->testingSetLevelOfDetail(1);
+    QCOMPARE(syncLodCacheIncrementally(dev, 1).boundingRect(), imageRect);
+    checkSameAsFullSync();
+
+    // nothing has changed
+    QVERIFY(syncLodCacheIncrementally(dev, 1).isEmpty());
+
+    // only the changed tile is synced
+    bounds->testingSetLevelOfDetail(0);
+    dev->fill(QRect(100,100,10,10), KoColor(Qt::blue, cs));
+    ref->fill(QRect(100,100,10,10), KoColor(Qt::blue, cs));
+
+    bounds->testingSetLevelOfDetail(1);
+    QCOMPARE(syncLodCacheIncrementally(dev, 1).boundingRect(), QRect(64,64,64,64));
+    checkSameAsFullSync();
+
+    // the changes in the LoD plane itself are reverted
+    dev->fill(QRect(10,10,5,5), KoColor(Qt::green, cs));
+    QCOMPARE(syncLodCacheIncrementally(dev, 1).boundingRect(), QRect(0,0,128,128));
+    checkSameAsFullSync();
+
+    // the removed tiles are reset to the default pixel
+    bounds->testingSetLevelOfDetail(0);
+    dev->clear(QRect(256,256,256,256));
+    ref->clear(QRect(256,256,256,256));
+
+    bounds->testingSetLevelOfDetail(1);
+    QCOMPARE(syncLodCacheIncrementally(dev, 1).boundingRect(), QRect(256,256,256,256));
+    checkSameAsFullSync();
+
+    // a different level of detail needs a full sync
+    bounds->testingSetLevelOfDetail(2);
+    QCOMPARE(syncLodCacheIncrementally(dev, 2), dev->regionForLodSyncing());
+}
+
 void KisPaintDeviceTest::benchmarkLod1Generation()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -2371,4 +2442,34 @@ void KisPaintDeviceTest::stressTestMemoryFragmentation()
     undoStack.clear();
 }
 
+void KisPaintDeviceTest::testOpaqueTilesRegion()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setX(10);
+    dev->setY(5);
+
+    const QRect opaqueRect(10, 5, 128, 128);
+    const QRect requestRect(0, 0, 200, 200);
+
+    QVERIFY(dev->opaqueTilesRegion(requestRect).isEmpty());
+
+    dev->fill(opaqueRect, KoColor(Qt::red, cs));
+    QCOMPARE(dev->opaqueTilesRegion(requestRect).toQRegion(), QRegion(opaqueRect));
+
+    // the request is clipped
+    QCOMPARE(dev->opaqueTilesRegion(QRect(20, 20, 10, 10)).toQRegion(), QRegion(QRect(20, 20, 10, 10)));
+
+    // a single translucent pixel drops the cached opacity of its tile
+    KoColor translucent(Qt::red, cs);
+    translucent.setOpacity(quint8(200));
+    dev->setPixel(20, 10, translucent);
+
+    QCOMPARE(dev->opaqueTilesRegion(requestRect).toQRegion(),
+             QRegion(opaqueRect) - QRegion(QRect(10, 5, 64, 64)));
+
+    dev->fill(QRect(10, 5, 64, 64), KoColor(Qt::green, cs));
+    QCOMPARE(dev->opaqueTilesRegion(requestRect).toQRegion(), QRegion(opaqueRect));
+}
+
 KISTEST_MAIN(KisPaintDeviceTest)
@@ -53,6 +53,7 @@ private Q_SLOTS:
 
     void testLodTransform();
     void testLodDevice();
+    void testLodIncrementalSync();
     void benchmarkLod1Generation();
     void benchmarkLod2Generation();
     void benchmarkLod3Generation();
@@ -68,6 +69,8 @@ private Q_SLOTS:
 
     void testCompositionAssociativity();
 
+    void testOpaqueTilesRegion();
+
     void stressTestMemoryFragmentation();
 };
 
@@ -8,6 +8,9 @@
 
 #include <simpletest.h>
 
+#include <QThreadPool>
+#include <KoColorSpaceRegistry.h>
+
 #include <testutil.h>
 
 #define USE_DOCUMENT 0
@@ -60,4 +63,74 @@ void KisPerspectiveTransformWorkerTest::testSimpleTransform()
     t.checkLayer("simple_transform");
 }
 
+namespace {
+KisPaintDeviceSP createNoiseDevice(const QRect &rc)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    QImage image(rc.size(), QImage::Format_ARGB32);
+    quint32 *pixel = reinterpret_cast<quint32*>(image.bits());
+    for (int i = 0; i < rc.width() * rc.height(); i++) {
+        *pixel++ = 0xff000000 | ((i * 2654435761u) & 0xffffff);
+    }
+
+    dev->convertFromQImage(image, 0, rc.x(), rc.y());
+    return dev;
+}
+
+QTransform testPerspectiveTransform()
+{
+    QTransform transform;
+    transform.setMatrix(0.9, 0.1, 0.0002,
+                        -0.2, 1.1, 0.0001,
+                        30, -20, 1.0);
+    return transform;
+}
+}
+
+void KisPerspectiveTransformWorkerTest::testMultithreadedRun()
+{
+    const QRect rc(-37, 21, 700, 500);
+
+    auto transformDevice = [&] () {
+        KisPaintDeviceSP dev = createNoiseDevice(rc);
+        KisPerspectiveTransformWorker worker(dev, testPerspectiveTransform(), false, 0);
+        worker.run();
+        return dev;
+    };
+
+    const int oldMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    KisPaintDeviceSP singleThreaded = transformDevice();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(4, oldMaxThreadCount));
+    KisPaintDeviceSP multiThreaded = transformDevice();
+
+    QThreadPool::globalInstance()->setMaxThreadCount(oldMaxThreadCount);
+
+    const QRect bounds = singleThreaded->exactBounds();
+    QCOMPARE(multiThreaded->exactBounds(), bounds);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  singleThreaded->convertToQImage(0, bounds),
+                                  multiThreaded->convertToQImage(0, bounds))) {
+        QFAIL(QString("Multithreaded transformation differs, first different pixel: %1,%2 ")
+              .arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisPerspectiveTransformWorkerTest::benchmarkRun()
+{
+    KisPaintDeviceSP source = createNoiseDevice(QRect(0, 0, 4096, 4096));
+
+    QBENCHMARK {
+        KisPaintDeviceSP dev = new KisPaintDevice(*source);
+        KisPerspectiveTransformWorker worker(dev, testPerspectiveTransform(), false, 0);
+        worker.run();
+    }
+}
+
 SIMPLE_TEST_MAIN(KisPerspectiveTransformWorkerTest)
@@ -12,12 +12,15 @@
 #include <floodfill/kis_scanline_fill.h>
 #include <floodfill/kis_fill_interval.h>
 #include <floodfill/kis_fill_interval_map.h>
+#include <floodfill/KisParallelFloodFill.h>
 
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include "kis_types.h"
 #include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_pixel_selection.h"
 
 
 void KisScanlineFillTest::testFillGeneral(const QVector<KisFillInterval> &initialBackwardIntervals,
@@ -283,4 +286,111 @@ void KisScanlineFillTest::testExternalFill()
     QCOMPARE(c, QColor(Qt::blue));
 }
 
+KisPaintDeviceSP createParallelFillTestDevice(const QRect &rc)
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->fill(rc, KoColor(QColor(250, 250, 250), dev->colorSpace()));
+
+    // random dark ellipses on a light background, cut by 3px wide vertical
+    // black bars every 37px, so that the regions span multiple blocks
+    KisPainter painter(dev);
+    painter.setFillStyle(KisPainter::FillStyleForegroundColor);
+
+    srand(31524744);
+    for (int i = 0; i < 60; i++) {
+        const int x = rc.x() + rand() % rc.width();
+        const int y = rc.y() + rand() % rc.height();
+        painter.setPaintColor(KoColor(QColor(rand() % 60, rand() % 60, 0), dev->colorSpace()));
+        painter.paintEllipse(x, y, 20 + rand() % 60, 20 + rand() % 60);
+    }
+
+    for (int i = 0; i < rc.width(); i += 37) {
+        painter.setPaintColor(KoColor(Qt::black, dev->colorSpace()));
+        painter.paintRect(QRectF(rc.x() + i, rc.y() + (i * 7) % rc.height(), 3, rc.height() / 2));
+    }
+
+    return dev;
+}
+
+void KisScanlineFillTest::testParallelFillSelection_data()
+{
+    QTest::addColumn<int>("threshold");
+    QTest::addColumn<int>("opacitySpread");
+    QTest::addColumn<bool>("useBoundary");
+
+    QTest::newRow("hard") << 15 << 100 << false;
+    QTest::newRow("hard-exact") << 1 << 100 << false;
+    QTest::newRow("soft") << 60 << 30 << false;
+    QTest::newRow("hard-boundary") << 15 << 100 << true;
+    QTest::newRow("soft-boundary") << 60 << 30 << true;
+}
+
+void KisScanlineFillTest::testParallelFillSelection()
+{
+    QFETCH(int, threshold);
+    QFETCH(int, opacitySpread);
+    QFETCH(bool, useBoundary);
+
+    const QRect boundingRect(0, 0, 700, 500);
+    const QPoint seed(5, 5);
+    KisPaintDeviceSP dev = createParallelFillTestDevice(boundingRect);
+
+    KisPaintDeviceSP boundary = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    boundary->fill(QRect(0, 0, 450, 420), KoColor(Qt::white, boundary->colorSpace()));
+
+    KisPixelSelectionSP expected = new KisPixelSelection();
+    KisScanlineFill scanlineFill(dev, seed, boundingRect);
+    scanlineFill.setThreshold(threshold);
+    scanlineFill.setOpacitySpread(opacitySpread);
+
+    KisPixelSelectionSP result = new KisPixelSelection();
+    KisParallelFloodFill parallelFill(dev, seed, boundingRect);
+    parallelFill.setThreshold(threshold);
+    parallelFill.setOpacitySpread(opacitySpread);
+    parallelFill.setBlockSize(64);
+
+    if (useBoundary) {
+        scanlineFill.fillSelectionWithBoundary(expected, boundary);
+        parallelFill.fillSelectionWithBoundary(result, boundary);
+    } else {
+        scanlineFill.fillSelection(expected);
+        parallelFill.fillSelection(result);
+    }
+
+    QVERIFY(!expected->selectedExactRect().isEmpty());
+    QCOMPARE(result->selectedExactRect(), expected->selectedExactRect());
+
+    QVector<quint8> expectedBytes(boundingRect.width() * boundingRect.height());
+    QVector<quint8> resultBytes(boundingRect.width() * boundingRect.height());
+    expected->readBytes(expectedBytes.data(), boundingRect);
+    result->readBytes(resultBytes.data(), boundingRect);
+
+    QVERIFY(expectedBytes == resultBytes);
+}
+
+void KisScanlineFillTest::testParallelFillColor()
+{
+    const QRect boundingRect(0, 0, 700, 500);
+    const QPoint seed(5, 5);
+    const KoColor fillColor(Qt::blue, KoColorSpaceRegistry::instance()->rgb8());
+
+    KisPaintDeviceSP expected = createParallelFillTestDevice(boundingRect);
+    KisPaintDeviceSP result = createParallelFillTestDevice(boundingRect);
+
+    KisScanlineFill scanlineFill(expected, seed, boundingRect);
+    scanlineFill.setThreshold(15);
+    scanlineFill.fillColor(fillColor);
+
+    KisParallelFloodFill parallelFill(result, seed, boundingRect);
+    parallelFill.setThreshold(15);
+    parallelFill.setBlockSize(64);
+    parallelFill.fillColor(fillColor);
+
+    QImage expectedImage = expected->convertToQImage(0, boundingRect);
+    QImage resultImage = result->convertToQImage(0, boundingRect);
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::compareQImages(errorPoint, expectedImage, resultImage));
+}
+
 SIMPLE_TEST_MAIN(KisScanlineFillTest)
@@ -27,6 +27,10 @@ private Q_SLOTS:
     void testClearNonZeroComponent();
     void testExternalFill();
 
+    void testParallelFillSelection_data();
+    void testParallelFillSelection();
+    void testParallelFillColor();
+
 private:
     void testFillGeneral(const QVector<KisFillInterval> &initialBackwardIntervals,
                          const QVector<QColor> &expectedResult,
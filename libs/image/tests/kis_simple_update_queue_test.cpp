@@ -15,6 +15,7 @@
 #include "kis_group_layer.h"
 #include "kis_paint_layer.h"
 #include "kis_adjustment_layer.h"
+#include "kis_filter_mask.h"
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
@@ -234,6 +235,120 @@ void KisSimpleUpdateQueueTest::testMixingTypes()
     QCOMPARE(walkersList[3]->type(), KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY);
 }
 
+void KisSimpleUpdateQueueTest::testSplitForSpareThreads()
+{
+    QRect imageRect(0,0,512,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QVector<KisUpdateJobItem*> jobs;
+    KisTestableUpdaterContext context(4);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, QRect(0,0,512,256), imageRect, 0);
+    QCOMPARE(walkersList.size(), 1);
+
+    /**
+     * A single big job is split into pieces aligned to the tile
+     * grid, so that every spare thread gets one of them
+     */
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QCOMPARE(jobs.size(), 4);
+
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,128,256)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(128,0,128,256)));
+    QVERIFY(checkWalker(jobs[2]->walker(), QRect(256,0,128,256)));
+    QVERIFY(checkWalker(jobs[3]->walker(), QRect(384,0,128,256)));
+
+    QVERIFY(walkersList.isEmpty());
+
+    /**
+     * Small jobs are not split
+     */
+    context.clear();
+
+    queue.addUpdateJob(paintLayer, QRect(0,0,200,200), imageRect, 0);
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,200,200)));
+    QCOMPARE(jobs[1]->isRunning(), false);
+}
+
+void KisSimpleUpdateQueueTest::testSplitForSpareThreadsWithFilterMask()
+{
+    QRect imageRect(0,0,512,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    auto createFilterMask = [&] (const QString &filterId) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterId);
+        KIS_ASSERT(filter);
+        KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+        KisFilterMaskSP mask = new KisFilterMask(image, filterId + "_mask");
+        mask->initSelection(paintLayer);
+        mask->setFilter(configuration->cloneWithResourcesSnapshot());
+        return mask;
+    };
+
+    KisFilterMaskSP invertMask = createFilterMask("invert");
+    KisFilterMaskSP blurMask = createFilterMask("blur");
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->addNode(invertMask, paintLayer);
+    image->unlock();
+
+    QVector<KisUpdateJobItem*> jobs;
+    KisTestableUpdaterContext context(2);
+
+    KisTestableSimpleUpdateQueue queue;
+
+    /**
+     * A per-pixel filter doesn't extend the access rects, so the
+     * halves of the job can run concurrently
+     */
+    queue.addUpdateJob(paintLayer, QRect(0,0,512,256), imageRect, 0);
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,256,256)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(256,0,256,256)));
+
+    /**
+     * The access rects of the halves of a blurred layer intersect, so
+     * they would be executed one after another. The job is not split.
+     */
+    context.clear();
+
+    image->barrierLock();
+    image->removeNode(invertMask);
+    image->addNode(blurMask, paintLayer);
+    image->unlock();
+
+    queue.addUpdateJob(paintLayer, QRect(0,0,512,256), imageRect, 0);
+    queue.processQueue(context);
+
+    jobs = context.getJobs();
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,512,256)));
+    QCOMPARE(jobs[1]->isRunning(), false);
+}
+
 void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
 {
     KisTestableSimpleUpdateQueue queue;
@@ -23,6 +23,8 @@ private Q_SLOTS:
     void testSplitFullRefresh();
     void testChecksum();
     void testMixingTypes();
+    void testSplitForSpareThreads();
+    void testSplitForSpareThreadsWithFilterMask();
     void testSpontaneousJobsCompression();
 };
 
@@ -14,6 +14,7 @@
 #include "kis_updater_context.h"
 #include "kis_update_job_item.h"
 #include "kis_merge_walker.h"
+#include "KisAdaptiveLodController.h"
 
 
 void KisStrokesQueueTest::testSequentialJobs()
@@ -1126,5 +1127,52 @@ void KisStrokesQueueTest::testUniquelyConcurrentJobs()
     queue.endStroke(id1);
 }
 
+void KisStrokesQueueTest::testAdaptiveLodController()
+{
+    KisAdaptiveLodController controller;
+    controller.setTargetLatency(100);
+
+    QCOMPARE(controller.levelOfDetail(1, 3), 1);
+
+    // a slow stroke steps to a coarser level
+    QVERIFY(controller.reportStroke("s1", 1, 3, 150));
+    QCOMPARE(controller.lodOffset(), 1);
+    QCOMPARE(controller.levelOfDetail(1, 3), 2);
+
+    QVERIFY(controller.reportStroke("s2", 2, 3, 150));
+    QCOMPARE(controller.levelOfDetail(1, 3), 3);
+
+    // the offset never goes beyond the max level of detail
+    QVERIFY(!controller.reportStroke("s3", 3, 3, 150));
+    QCOMPARE(controller.levelOfDetail(1, 3), 3);
+
+    // strokes that are just in time keep the level
+    QVERIFY(!controller.reportStroke("s4", 3, 3, 50));
+    QVERIFY(!controller.reportStroke("s5", 3, 3, 50));
+    QVERIFY(!controller.reportStroke("s6", 3, 3, 50));
+    QCOMPARE(controller.levelOfDetail(1, 3), 3);
+
+    // a few fast strokes in a row step back to a finer level
+    QVERIFY(!controller.reportStroke("s7", 3, 3, 10));
+    QVERIFY(!controller.reportStroke("s8", 3, 3, 10));
+    QVERIFY(controller.reportStroke("s9", 3, 3, 10));
+    QCOMPARE(controller.levelOfDetail(1, 3), 2);
+
+    // the desired level of detail is never made finer
+    QCOMPARE(controller.levelOfDetail(3, 3), 3);
+
+    const QVector<KisAdaptiveLodController::StrokeReport> reports =
+        controller.strokeReports();
+
+    QCOMPARE(reports.size(), 9);
+    QCOMPARE(reports.first().strokeId, QString("s1"));
+    QCOMPARE(reports.first().levelOfDetail, 1);
+    QCOMPARE(reports.first().latency, qint64(150));
+    QCOMPARE(reports.last().levelOfDetail, 3);
+
+    controller.reset();
+    QCOMPARE(controller.levelOfDetail(1, 3), 1);
+}
+
 
 KISTEST_MAIN(KisStrokesQueueTest)
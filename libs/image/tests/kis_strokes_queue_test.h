@@ -35,6 +35,7 @@ private Q_SLOTS:
     void testLodUndoBase2();
     void testMutatedJobs();
     void testUniquelyConcurrentJobs();
+    void testAdaptiveLodController();
 
 private:
     struct LodStrokesQueueTester;
@@ -11,6 +11,8 @@
 #include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
+#include <QThread>
+#include <QThreadPool>
 #include <QTransform>
 #include <QVector>
 
@@ -916,6 +918,31 @@ void KisTransformWorkerTest::benchmarkScaleRotateShear()
     }
 }
 
+void KisTransformWorkerTest::benchmarkScaleRotateShearThreads_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("4") << 4;
+    QTest::newRow("8") << 8;
+    QTest::newRow("ideal") << QThread::idealThreadCount();
+}
+
+void KisTransformWorkerTest::benchmarkScaleRotateShearThreads()
+{
+    QFETCH(int, numThreads);
+
+    const int oldMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        generateTestImage("hakonepa.png", 1.379,M_PI/6.0,0.479,new KisBicubicFilterStrategy(), false);
+    }
+
+    QThreadPool::globalInstance()->setMaxThreadCount(oldMaxThreadCount);
+}
+
 void KisTransformWorkerTest::generateTestImages()
 {
     QList<KisFilterStrategy*> filters;
@@ -1021,4 +1048,49 @@ void KisTransformWorkerTest::testXScaleUpPixelAlignment()
 
     QCOMPARE(dev->exactBounds().width(), newSize);
 }
+
+void KisTransformWorkerTest::testMultithreadedPasses()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    QImage image(TestUtil::fetchDataFileLazy("hakonepa.png"));
+
+    auto transformDevice = [&] (bool splitIntoBands) {
+        KisPaintDeviceSP dev = new KisPaintDevice(cs);
+        dev->convertFromQImage(image, 0);
+        dev->moveTo(-17, 33);
+
+        KisFilterStrategy * filter = new KisBicubicFilterStrategy();
+        KisTransformWorker tw(dev, 1.379, 0.83,
+                              0.479, 0.0,
+                              0.0, 0.0,
+                              M_PI / 6.0,
+                              10, 15, 0, filter);
+        if (!splitIntoBands) {
+            tw.testingDisableSplittingIntoBands();
+        }
+        tw.run();
+        delete filter;
+
+        return dev;
+    };
+
+    // the reference is a usual pass over all the lines, without any bands
+    KisPaintDeviceSP singleThreaded = transformDevice(false);
+
+    const int oldMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(4, oldMaxThreadCount));
+    KisPaintDeviceSP multiThreaded = transformDevice(true);
+    QThreadPool::globalInstance()->setMaxThreadCount(oldMaxThreadCount);
+
+    const QRect bounds = singleThreaded->exactBounds();
+    QCOMPARE(multiThreaded->exactBounds(), bounds);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  singleThreaded->convertToQImage(0, bounds),
+                                  multiThreaded->convertToQImage(0, bounds))) {
+        QFAIL(QString("Multithreaded transformation differs, first different pixel: %1,%2 ")
+              .arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
 KISTEST_MAIN(KisTransformWorkerTest)
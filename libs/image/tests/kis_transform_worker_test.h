@@ -49,12 +49,16 @@ private Q_SLOTS:
     void benchmarkRotate1Q();
     void benchmarkShear();
     void benchmarkScaleRotateShear();
+    void benchmarkScaleRotateShearThreads_data();
+    void benchmarkScaleRotateShearThreads();
 
     void testPartialProcessing();
 
     void testXScaleUpPixelAlignment_data();
     void testXScaleUpPixelAlignment();
 
+    void testMultithreadedPasses();
+
 private:
     void generateTestImages();
 };
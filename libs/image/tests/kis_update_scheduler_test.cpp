@@ -169,10 +169,15 @@ void KisUpdateSchedulerTest::testLocking()
 
     scheduler.updateProjection(paintLayer1, imageRect, imageRect);
 
+    /**
+     * The second thread is idle, so the update is split
+     * in halves along the tile grid
+     */
     jobs = context->getJobs();
     QCOMPARE(jobs[0]->isRunning(), true);
-    QCOMPARE(jobs[1]->isRunning(), false);
-    QVERIFY(checkWalker(jobs[0]->walker(), imageRect));
+    QCOMPARE(jobs[1]->isRunning(), true);
+    QVERIFY(checkWalker(jobs[0]->walker(), QRect(0,0,320,441)));
+    QVERIFY(checkWalker(jobs[1]->walker(), QRect(320,0,320,441)));
 
     context->clear();
 
@@ -400,6 +405,79 @@ void KisUpdateSchedulerTest::testTimeMonitor()
     KisUpdateTimeMonitor::instance()->endStrokeMeasure();
 }
 
+#include "KisTimelineTracer.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+void KisUpdateSchedulerTest::testTimelineTracer()
+{
+    KisImageSP image = buildTestingImage();
+    KisNodeSP rootLayer = image->rootLayer();
+    KisNodeSP paintLayer1 = rootLayer->firstChild();
+    image->waitForDone();
+
+    KisTimelineTracer *tracer = KisTimelineTracer::instance();
+    tracer->clear();
+    tracer->setEnabled(true);
+
+    KisUpdateScheduler scheduler(image.data());
+    scheduler.updateProjection(paintLayer1, QRect(0,0,100,100), image->bounds());
+    scheduler.waitForDone();
+
+    tracer->setEnabled(false);
+
+    QVERIFY(tracer->numSpans() > 0);
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(tracer->toChromeTrace(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    int numMergeSpans = 0;
+    int numThreadNames = 0;
+
+    Q_FOREACH (const QJsonValue &value, doc.object()["traceEvents"].toArray()) {
+        const QJsonObject event = value.toObject();
+
+        if (event["ph"].toString() == "M") {
+            numThreadNames++;
+        } else if (event["cat"].toString() == "merge" &&
+                   event["name"].toString() == "merge walker") {
+            numMergeSpans++;
+            QVERIFY(event["dur"].toDouble() >= 0.0);
+            QCOMPARE(event["args"].toObject()["changeRect"].toArray().size(), 4);
+        }
+    }
+
+    QVERIFY(numMergeSpans > 0);
+    QVERIFY(numThreadNames > 0);
+
+    /**
+     * The ring buffer keeps only the latest spans
+     */
+    const int oldCapacity = tracer->capacity();
+
+    tracer->setCapacity(2);
+    tracer->setEnabled(true);
+    tracer->addSpan("test", "first", 0, 1);
+    tracer->addSpan("test", "second", 1, 2);
+    tracer->addSpan("test", "third", 2, 3);
+    tracer->setEnabled(false);
+
+    QCOMPARE(tracer->numSpans(), 2);
+
+    QStringList names;
+    doc = QJsonDocument::fromJson(tracer->toChromeTrace());
+    Q_FOREACH (const QJsonValue &value, doc.object()["traceEvents"].toArray()) {
+        if (value.toObject()["cat"].toString() == "test") {
+            names << value.toObject()["name"].toString();
+        }
+    }
+    QCOMPARE(names, QStringList({"second", "third"}));
+
+    tracer->setCapacity(oldCapacity);
+}
+
 void KisUpdateSchedulerTest::testLodSync()
 {
     KisImageSP image = buildTestingImage();
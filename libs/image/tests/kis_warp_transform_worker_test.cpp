@@ -336,5 +336,121 @@ void KisWarpTransformWorkerTest::testNeedChangeRects()
     QCOMPARE(worker.approxChangeRect(d.bounds.toAlignedRect()), QRect(-44,-44, 982,986));
 }
 
+namespace {
+
+/**
+ * A transformation that folds the grid over itself, so that the
+ * destination polygons overlap and the order of their rendering
+ * matters.
+ */
+struct FoldingTransformOp
+{
+    FoldingTransformOp(const QRectF &bounds)
+        : m_center(bounds.center()),
+          m_radius(0.5 * qMax(bounds.width(), bounds.height()))
+    {
+    }
+
+    QPointF operator() (const QPointF &pt) const {
+        const QPointF diff = pt - m_center;
+        const qreal dist = KisAlgebra2D::norm(diff);
+        const qreal angle = 2.5 * M_PI * qMax(0.0, 1.0 - dist / m_radius);
+
+        const qreal c = std::cos(angle);
+        const qreal s = std::sin(angle);
+
+        return m_center + QPointF(c * diff.x() - s * diff.y(),
+                                  s * diff.x() + c * diff.y()) +
+            QPointF(0.3 * diff.y(), 0.0);
+    }
+
+    QPointF m_center;
+    qreal m_radius;
+};
+
+}
+
+void KisWarpTransformWorkerTest::testParallelPolygonOp()
+{
+    WarpTransforWorkerData d;
+    d.dev->moveTo(-13, 27);
+
+    const QRect srcBounds = d.dev->exactBounds();
+    FoldingTransformOp transformOp(srcBounds);
+
+    KisPaintDeviceSP serialDev = new KisPaintDevice(d.dev->colorSpace());
+    KisPaintDeviceSP parallelDev = new KisPaintDevice(d.dev->colorSpace());
+    parallelDev->moveTo(5, 3);
+
+    {
+        GridIterationTools::PaintDevicePolygonOp polygonOp(d.dev, serialDev);
+        GridIterationTools::processGrid(polygonOp, transformOp, srcBounds, 8);
+    }
+
+    {
+        GridIterationTools::PaintDevicePolygonOp polygonOp(d.dev, parallelDev);
+        GridIterationTools::ParallelPolygonOp<GridIterationTools::PaintDevicePolygonOp>
+            parallelOp(polygonOp, QPoint(parallelDev->x(), parallelDev->y()));
+
+        GridIterationTools::processGrid(parallelOp, transformOp, srcBounds, 8);
+        parallelOp.flush();
+    }
+
+    const QRect bounds = serialDev->exactBounds();
+    QCOMPARE(parallelDev->exactBounds(), bounds);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  serialDev->convertToQImage(0, bounds),
+                                  parallelDev->convertToQImage(0, bounds))) {
+        QFAIL(QString("Parallel rendering differs, first different pixel: %1,%2 ")
+              .arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisWarpTransformWorkerTest::testParallelPolygonOpQImage_data()
+{
+    QTest::addColumn<int>("formatId");
+
+    QTest::newRow("argb32") << int(QImage::Format_ARGB32);
+    QTest::newRow("argb32-premultiplied") << int(QImage::Format_ARGB32_Premultiplied);
+
+    // rendered serially, QImage::setPixel() is not thread-safe
+    QTest::newRow("rgb888") << int(QImage::Format_RGB888);
+}
+
+void KisWarpTransformWorkerTest::testParallelPolygonOpQImage()
+{
+    QFETCH(int, formatId);
+    const QImage::Format format = QImage::Format(formatId);
+
+    QImage image(TestUtil::fetchDataFileLazy("test_transform_quality_second.png"));
+    image = image.convertToFormat(format);
+
+    const QRect srcBounds = image.rect();
+    FoldingTransformOp transformOp(srcBounds);
+
+    const QPointF dstOffset(-200, -200);
+
+    QImage serialImage(image.size() + QSize(400, 400), format);
+    serialImage.fill(0);
+    QImage parallelImage(serialImage.copy());
+
+    {
+        GridIterationTools::QImagePolygonOp polygonOp(image, serialImage, QPointF(), dstOffset);
+        GridIterationTools::processGrid(polygonOp, transformOp, srcBounds, 8);
+    }
+
+    {
+        GridIterationTools::QImagePolygonOp polygonOp(image, parallelImage, QPointF(), dstOffset);
+        GridIterationTools::ParallelPolygonOp<GridIterationTools::QImagePolygonOp> parallelOp(polygonOp);
+        QCOMPARE(polygonOp.supportsParallelProcessing(), format != QImage::Format_RGB888);
+
+        GridIterationTools::processGrid(parallelOp, transformOp, srcBounds, 8);
+        parallelOp.flush();
+    }
+
+    QCOMPARE(parallelImage, serialImage);
+}
 
 SIMPLE_TEST_MAIN(KisWarpTransformWorkerTest)
@@ -24,6 +24,10 @@ private Q_SLOTS:
     void testBackwardInterpolatorExtrapolation();
 
     void testNeedChangeRects();
+
+    void testParallelPolygonOp();
+    void testParallelPolygonOpQImage_data();
+    void testParallelPolygonOpQImage();
 };
 
 #endif /* __KIS_WARP_TRANSFORM_WORKER_TEST_H */
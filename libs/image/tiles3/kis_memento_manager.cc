@@ -201,6 +201,17 @@ void KisMementoManager::commit()
     hItem.memento = m_currentMemento.data();
     m_revisions.append(hItem);
 
+    /**
+     * The undo data of the revision that has just left the window
+     * of the latest steps becomes the first candidate for swapping.
+     * The swapper compresses it in the background and rollback()
+     * gets it back transparently when accessing the tiles.
+     */
+    const int uncompressedSteps = KisTileDataStore::instance()->uncompressedUndoSteps();
+    if (m_revisions.size() > uncompressedSteps) {
+        markRevisionHistoryOld(m_revisions[m_revisions.size() - 1 - uncompressedSteps].itemList);
+    }
+
     m_currentMemento = 0;
     KIS_ASSERT(m_index.isEmpty());
 
@@ -396,6 +407,24 @@ void KisMementoManager::resetRevisionHistory(KisMementoItemList list)
     }
 }
 
+void KisMementoManager::markRevisionHistoryOld(const KisMementoItemList &list)
+{
+    KisMementoItemSP parentMI;
+    KisMementoItemSP mi;
+
+    Q_FOREACH (mi, list) {
+        parentMI = mi->parent();
+        if (!parentMI) continue;
+
+        KisTileData *td = parentMI->tileData();
+
+        // the tiles still used by the device itself are not touched
+        if (td && td->historical() && !td->age()) {
+            td->markOld();
+        }
+    }
+}
+
 void KisMementoManager::setDefaultTileData(KisTileData *defaultTileData)
 {
     m_headsHashTable.setDefaultTileData(defaultTileData);
@@ -116,6 +116,7 @@ public:
 protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
+    void markRevisionHistoryOld(const KisMementoItemList &list);
 
 protected:
     /**
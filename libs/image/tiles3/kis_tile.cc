@@ -26,6 +26,8 @@ void KisTile::init(qint32 col, qint32 row,
     m_tileData = defaultTileData;
     m_tileData->acquire();
 
+    m_lodDirty.storeRelease(1);
+
     if (mm) {
         mm->registerTileChange(this);
     }
@@ -257,11 +259,20 @@ void KisTile::lockForWrite()
 #endif
     }
 
+    m_tileData->resetOpacityState();
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
 void KisTile::unlockForWrite()
 {
+    /**
+     * The opacity state might have been recalculated while the tile
+     * was being written to, so drop it once again
+     */
+    m_tileData->resetOpacityState();
+    markLodDirty();
+
     unblockSwapping();
     DEBUG_LOG_ACTION("unlock [W]");
 
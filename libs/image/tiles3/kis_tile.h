@@ -87,6 +87,7 @@ public:
     }
     inline void setData(const quint8 *data) {
         m_tileData->setData(data);
+        markLodDirty();
     }
 
     inline qint32 row() const {
@@ -119,6 +120,15 @@ public:
         return m_tileData;
     }
 
+    /**
+     * Returns true if the tile has been created or written to since
+     * the previous call, and resets the state. It is used for
+     * incremental synchronization of the LoD planes.
+     */
+    inline bool takeLodDirty() {
+        return m_lodDirty.fetchAndStoreOrdered(0);
+    }
+
 private:
     void init(qint32 col, qint32 row,
               KisTileData *defaultTileData, KisMementoManager* mm);
@@ -128,6 +138,12 @@ private:
 
     inline void safeReleaseOldTileData(KisTileData *td);
 
+    inline void markLodDirty() {
+        if (!m_lodDirty.loadAcquire()) {
+            m_lodDirty.storeRelease(1);
+        }
+    }
+
 private:
     KisTileData *m_tileData;
     mutable QStack<KisTileData*> m_oldTileData;
@@ -148,6 +164,12 @@ private:
 
     QAtomicPointer<KisMementoManager> m_mementoManager;
 
+    /**
+     * Set when the tile is created or written to, reset by
+     * takeLodDirty()
+     */
+    QAtomicInt m_lodDirty;
+
     /**
      * This is a special mutex for guarding copy-on-write
      * operations. We do not use lockless way here as it'll
@@ -57,7 +57,8 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(pixelSize),
-      m_store(store)
+      m_store(store),
+      m_opacityState(OPACITY_UNKNOWN)
 {
     if (checkFreeMemory) {
         m_store->checkFreeMemory();
@@ -86,7 +87,8 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(rhs.m_pixelSize),
-      m_store(rhs.m_store)
+      m_store(rhs.m_store),
+      m_opacityState(rhs.m_opacityState.loadAcquire())
 {
     if (checkFreeMemory) {
         m_store->checkFreeMemory();
@@ -104,6 +106,8 @@ KisTileData::~KisTileData()
 
 void KisTileData::fillWithPixel(const quint8 *defPixel)
 {
+    resetOpacityState();
+
     quint8 *it = m_data;
 
     for (int i = 0; i < WIDTH * HEIGHT; i++, it += m_pixelSize) {
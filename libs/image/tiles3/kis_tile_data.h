@@ -26,6 +26,7 @@ inline quint8* KisTileData::data() const {
 void KisTileData::setData(const quint8 *data) {
     Q_ASSERT(m_data);
     memcpy(m_data, data, m_pixelSize*WIDTH*HEIGHT);
+    resetOpacityState();
 }
 
 inline quint32 KisTileData::pixelSize() const {
@@ -107,6 +108,29 @@ inline bool KisTileData::historical() const {
     return mementoed() && numUsers() <= 1;
 }
 
+inline KisTileData::EnumOpacityState KisTileData::opacityState(quint32 *generation) const {
+    const quint32 value = m_opacityState.loadAcquire();
+
+    if (generation) {
+        *generation = value & ~OPACITY_STATE_MASK;
+    }
+    return EnumOpacityState(value & OPACITY_STATE_MASK);
+}
+
+inline bool KisTileData::setOpacityState(EnumOpacityState state, quint32 generation) const {
+    return m_opacityState.testAndSetOrdered(generation | OPACITY_UNKNOWN, generation | state);
+}
+
+inline void KisTileData::resetOpacityState() {
+    quint32 value;
+    quint32 nextGeneration;
+
+    do {
+        value = m_opacityState.loadAcquire();
+        nextGeneration = (value & ~OPACITY_STATE_MASK) + OPACITY_STATE_MASK + 1;
+    } while (!m_opacityState.testAndSetOrdered(value, nextGeneration | OPACITY_UNKNOWN));
+}
+
 inline int KisTileData::age() const {
     return m_age;
 }
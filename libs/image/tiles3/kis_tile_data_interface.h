@@ -102,6 +102,12 @@ public:
         SWAPPED
     };
 
+    enum EnumOpacityState {
+        OPACITY_UNKNOWN = 0,
+        OPACITY_OPAQUE,
+        OPACITY_NOT_OPAQUE
+    };
+
     /**
      * Information about data stored
      */
@@ -180,6 +186,21 @@ public:
      */
     inline bool historical() const;
 
+    /**
+     * The cached result of the check whether all the pixels of the
+     * tile data are fully opaque (see KisTiledDataManager::opaqueTileRects()).
+     * The state is reset every time the tile is locked for writing.
+     *
+     * The readers check the opacity without excluding the writers, so
+     * every reset also increments the write generation of the tile
+     * data. The reader fetches the generation together with the state,
+     * and setOpacityState() stores the calculated state only if the tile
+     * data hasn't been reset since then.
+     */
+    inline EnumOpacityState opacityState(quint32 *generation = nullptr) const;
+    inline bool setOpacityState(EnumOpacityState state, quint32 generation) const;
+    inline void resetOpacityState();
+
     /**
      * Used for swapping purposes only.
      * Frees the memory occupied by the tile data.
@@ -305,6 +326,13 @@ private:
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
+
+    /**
+     * Stores EnumOpacityState in the lower bits and the write
+     * generation in the rest of them
+     */
+    static const quint32 OPACITY_STATE_MASK = 0x3;
+    mutable QAtomicInteger<quint32> m_opacityState;
     static SimpleCache m_cache;
 
 public:
@@ -200,6 +200,7 @@ void KisTileDataPooler::run()
         m_lastPoolMemoryMetric = memoryOccupied;
         m_lastRealMemoryMetric = statRealMemory;
         m_lastHistoricalMemoryMetric = statHistoricalMemory;
+        m_memoryStatsRevision.ref();
 
         m_store->endIteration(iter);
 
@@ -229,6 +230,7 @@ void KisTileDataPooler::forceUpdateMemoryStats()
     m_lastPoolMemoryMetric = memoryOccupied;
     m_lastRealMemoryMetric = statRealMemory;
     m_lastHistoricalMemoryMetric = statHistoricalMemory;
+    m_memoryStatsRevision.ref();
 
     m_store->endIteration(iter);
 }
@@ -248,6 +250,11 @@ qint64 KisTileDataPooler::lastHistoricalMemoryMetric() const
     return m_lastHistoricalMemoryMetric;
 }
 
+int KisTileDataPooler::memoryStatsRevision() const
+{
+    return m_memoryStatsRevision.loadAcquire();
+}
+
 inline int KisTileDataPooler::clonesMetric(KisTileData *td, int numClones) {
     return numClones * td->pixelSize();
 }
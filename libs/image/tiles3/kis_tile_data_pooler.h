@@ -34,6 +34,11 @@ public:
     qint64 lastRealMemoryMetric() const;
     qint64 lastHistoricalMemoryMetric() const;
 
+    /**
+     * Is incremented every time the memory statistics are
+     * recalculated, so the users can notice a fresh value
+     */
+    int memoryStatsRevision() const;
 
     /**
      * Is case the pooler thread is not running, the user might force
@@ -83,6 +88,7 @@ protected:
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
+    QAtomicInt m_memoryStatsRevision;
 };
 
 
@@ -94,6 +94,7 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 
     stats.realMemorySize = m_pooler.lastRealMemoryMetric() * metricCoeff;
     stats.historicalMemorySize = m_pooler.lastHistoricalMemoryMetric() * metricCoeff;
+    stats.historicalMemoryLimit = m_swapper.historyLimitMetric() * metricCoeff;
     stats.poolSize = m_pooler.lastPoolMemoryMetric() * metricCoeff;
 
     stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
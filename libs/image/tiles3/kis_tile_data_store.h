@@ -38,6 +38,7 @@ public:
         qint64 totalMemorySize;
         qint64 realMemorySize;
         qint64 historicalMemorySize;
+        qint64 historicalMemoryLimit;
 
         qint64 poolSize;
 
@@ -77,6 +78,18 @@ public:
         return m_memoryMetric.loadAcquire();
     }
 
+    /**
+     * The metric of the historical tiles present in memory, as
+     * counted by the pooler in its last cycle. \p revision is set to
+     * KisTileDataPooler::memoryStatsRevision(), or to -1 when the
+     * pooler is not running and the value is not updated.
+     */
+    inline qint64 lastHistoricalMemoryMetric(int *revision) const
+    {
+        *revision = m_pooler.isRunning() ? m_pooler.memoryStatsRevision() : -1;
+        return m_pooler.lastHistoricalMemoryMetric();
+    }
+
     KisTileDataStoreIterator* beginIteration();
     void endIteration(KisTileDataStoreIterator* iterator);
 
@@ -100,6 +113,15 @@ public:
         m_swapper.kick();
     }
 
+    /**
+     * The number of the latest undo steps of a paint device
+     * whose memento tiles should stay in memory uncompressed
+     */
+    inline int uncompressedUndoSteps() const
+    {
+        return m_swapper.uncompressedUndoSteps();
+    }
+
     /**
      * Try swap out the tile data.
      * It may fail in case the tile is being accessed
@@ -675,6 +675,77 @@ KisRegion KisTiledDataManager::region() const
     return KisRegion(std::move(rects));
 }
 
+QVector<QRect> KisTiledDataManager::takeLodDirtyTiles(QVector<QPoint> *existingTiles)
+{
+    QVector<QRect> rects;
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        if (tile->takeLodDirty()) {
+            rects << tile->extent();
+        }
+
+        if (existingTiles) {
+            existingTiles->append(QPoint(tile->col(), tile->row()));
+        }
+
+        iter.next();
+    }
+
+    return rects;
+}
+
+QVector<QRect> KisTiledDataManager::opaqueTileRects(const QRect &rect,
+                                                    const std::function<bool(const quint8*, qint32)> &isOpaque)
+{
+    QVector<QRect> rects;
+    if (rect.isEmpty()) return rects;
+
+    QReadLocker locker(&m_lock);
+
+    const qint32 firstCol = xToCol(rect.left());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastCol = xToCol(rect.right());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 col = firstCol; col <= lastCol; col++) {
+            bool existingTile;
+            KisTileSP tile = getReadOnlyTileLazy(col, row, existingTile);
+
+            tile->lockForRead();
+
+            KisTileData *tileData = tile->tileData();
+
+            quint32 generation = 0;
+            KisTileData::EnumOpacityState state = tileData->opacityState(&generation);
+
+            if (state == KisTileData::OPACITY_UNKNOWN) {
+                state = isOpaque(tileData->data(), KisTileData::WIDTH * KisTileData::HEIGHT) ?
+                    KisTileData::OPACITY_OPAQUE : KisTileData::OPACITY_NOT_OPAQUE;
+
+                /**
+                 * The tile has been written to while we were checking it,
+                 * so the result cannot be trusted
+                 */
+                if (!tileData->setOpacityState(state, generation)) {
+                    state = KisTileData::OPACITY_NOT_OPAQUE;
+                }
+            }
+
+            tile->unlockForRead();
+
+            if (state == KisTileData::OPACITY_OPAQUE) {
+                rects << (tile->extent() & rect);
+            }
+        }
+    }
+
+    return rects;
+}
+
 void KisTiledDataManager::setPixel(qint32 x, qint32 y, const quint8 * data)
 {
     KisTileDataWrapper tw(this, x, y, KisTileDataWrapper::WRITE);
@@ -7,6 +7,8 @@
 #ifndef KIS_TILEDDATAMANAGER_H_
 #define KIS_TILEDDATAMANAGER_H_
 
+#include <functional>
+
 #include <QtGlobal>
 #include <QVector>
 #include <KisRegion.h>
@@ -216,6 +218,25 @@ public:
 
     KisRegion region() const;
 
+    /**
+     * Returns the extents of the tiles that have been created or written
+     * to since the previous call and resets their state. The indexes of
+     * all the tiles present in the data manager are written into
+     * \p existingTiles, if it is not null. Used for incremental
+     * synchronization of the LoD planes.
+     */
+    QVector<QRect> takeLodDirtyTiles(QVector<QPoint> *existingTiles = 0);
+
+    /**
+     * Returns the parts of \p rect covered by the tiles whose pixels are
+     * all opaque. \p isOpaque is called for the tiles whose opacity
+     * hasn't been checked since the last write into them; it gets the
+     * pixels of the tile and their number. The result is cached in the
+     * tile data.
+     */
+    QVector<QRect> opaqueTileRects(const QRect &rect,
+                                   const std::function<bool(const quint8*, qint32)> &isOpaque);
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
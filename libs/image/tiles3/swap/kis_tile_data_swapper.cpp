@@ -40,6 +40,13 @@ public:
     KisTileDataStore *store;
     KisStoreLimits limits;
     QMutex cycleLock;
+
+    /**
+     * The history swapped out since the pooler's last count,
+     * see historicalMemoryMetric()
+     */
+    int historyStatsRevision = -1;
+    qint64 historySwappedOut = 0;
 };
 
 KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
@@ -95,6 +102,54 @@ void KisTileDataSwapper::checkFreeMemory()
         doJob();
 }
 
+qint64 KisTileDataSwapper::historyLimitMetric() const
+{
+    return m_d->limits.historyLimitThreshold();
+}
+
+int KisTileDataSwapper::uncompressedUndoSteps() const
+{
+    return m_d->limits.uncompressedUndoSteps();
+}
+
+qint64 KisTileDataSwapper::historicalMemoryMetric()
+{
+    /**
+     * The pooler counts the history in every cycle anyway, and it is
+     * kicked together with the swapper, so we reuse its value instead
+     * of walking through all the tiles. Its value doesn't know what we
+     * have swapped out after the count, so we subtract that ourselves.
+     */
+    int revision = -1;
+    qint64 metric = m_d->store->lastHistoricalMemoryMetric(&revision);
+
+    if (revision >= 0) {
+        if (revision != m_d->historyStatsRevision) {
+            m_d->historyStatsRevision = revision;
+            m_d->historySwappedOut = 0;
+        }
+
+        return qMax(qint64(0), metric - m_d->historySwappedOut);
+    }
+
+    // the pooler is disabled, so count the history ourselves
+    metric = 0;
+
+    KisTileDataStoreIterator *iter = m_d->store->beginIteration();
+
+    while (iter->hasNext()) {
+        KisTileData *item = iter->next();
+
+        if (item->historical()) {
+            metric += item->pixelSize();
+        }
+    }
+
+    m_d->store->endIteration(iter);
+
+    return metric;
+}
+
 void KisTileDataSwapper::doJob()
 {
     /**
@@ -112,6 +167,40 @@ void KisTileDataSwapper::doJob()
 
     DEBUG_VALUE(m_d->limits.softLimitThreshold());
     DEBUG_VALUE(m_d->limits.hardLimitThreshold());
+    DEBUG_VALUE(m_d->limits.historyLimitThreshold());
+
+    /**
+     * The history cannot be bigger than all the tiles in memory,
+     * so we can skip counting it in most of the cases
+     */
+    if (m_d->limits.historyLimitThreshold() > 0 &&
+        memoryMetric > m_d->limits.historyLimitThreshold()) {
+
+        qint64 historicalMetric = historicalMemoryMetric();
+        DEBUG_VALUE(historicalMetric);
+
+        if (historicalMetric > m_d->limits.historyLimitThreshold()) {
+            qint64 historyFree = historicalMetric - m_d->limits.historyLimit();
+            DEBUG_VALUE(historyFree);
+            DEBUG_ACTION("\t history pass");
+            const qint64 freed = pass<SoftSwapStrategy>(historyFree);
+            memoryMetric -= freed;
+            DEBUG_VALUE(memoryMetric);
+
+            /**
+             * Fetch the revision after the pass: a count that finished
+             * while we were waiting for the iteration lock doesn't know
+             * about the swapped out tiles either
+             */
+            int revision = -1;
+            m_d->store->lastHistoricalMemoryMetric(&revision);
+            if (revision != m_d->historyStatsRevision) {
+                m_d->historyStatsRevision = revision;
+                m_d->historySwappedOut = 0;
+            }
+            m_d->historySwappedOut += freed;
+        }
+    }
 
 
     if(memoryMetric > m_d->limits.softLimitThreshold()) {
@@ -28,6 +28,12 @@ public:
     void terminateSwapper();
     void checkFreeMemory();
 
+    /**
+     * \see KisStoreLimits
+     */
+    qint64 historyLimitMetric() const;
+    int uncompressedUndoSteps() const;
+
     void testingRereadConfig();
 
 private:
@@ -35,6 +41,7 @@ private:
     void run() override;
 
     void doJob();
+    qint64 historicalMemoryMetric();
     template<class strategy> qint64 pass(qint64 needToFreeMetric);
 
 private:
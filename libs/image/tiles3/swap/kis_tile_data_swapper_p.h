@@ -41,6 +41,17 @@
   |                        |
   +------------------------+  <-- 0 MiB
 
+  Independently of the limits above, the memento tiles kept in
+  memory are bounded by their own budget:
+
+  |= historyLimitThreshold=|  <-- the swapper starts swapping out
+  |........................|      memento tiles, the ones older than
+  |........................|      uncompressedUndoSteps() go first
+  |=====  historyLimit  ===|  <-- the swapper stops swapping
+  |                        |      out memento tiles
+
+  The history budget is disabled when historyLimitThreshold is 0.
+
  */
 
 
@@ -57,6 +68,11 @@ public:
 
         m_softLimitThreshold = qBound(0, MiB_TO_METRIC(config.tilesSoftLimit()), m_hardLimitThreshold);
         m_softLimit = m_softLimitThreshold - m_softLimitThreshold / 8;
+
+        m_historyLimitThreshold = qBound(0, MiB_TO_METRIC(config.historyLimit()), m_hardLimitThreshold);
+        m_historyLimit = m_historyLimitThreshold - m_historyLimitThreshold / 8;
+
+        m_uncompressedUndoSteps = qMax(0, config.uncompressedUndoSteps());
     }
 
     /**
@@ -83,12 +99,31 @@ public:
         return m_softLimit;
     }
 
+    inline qint32 historyLimitThreshold() {
+        return m_historyLimitThreshold;
+    }
+
+    inline qint32 historyLimit() {
+        return m_historyLimit;
+    }
+
+    /**
+     * The number of the latest revisions of a paint device, whose
+     * memento tiles are not swapped out in the first place
+     */
+    inline qint32 uncompressedUndoSteps() {
+        return m_uncompressedUndoSteps;
+    }
+
 private:
     qint32 m_emergencyThreshold;
     qint32 m_hardLimitThreshold;
     qint32 m_hardLimit;
     qint32 m_softLimitThreshold;
     qint32 m_softLimit;
+    qint32 m_historyLimitThreshold;
+    qint32 m_historyLimit;
+    qint32 m_uncompressedUndoSteps;
 };
 
 
@@ -18,6 +18,8 @@ void KisStoreLimitsTest::testLimits()
     config.setMemoryHardLimitPercent(50);
     config.setMemorySoftLimitPercent(25);
     config.setMemoryPoolLimitPercent(10);
+    config.setMemoryHistoryLimitPercent(20);
+    config.setUncompressedUndoSteps(5);
 
     int emergencyThreshold = MiB_TO_METRIC(config.tilesHardLimit());
 
@@ -27,6 +29,9 @@ void KisStoreLimitsTest::testLimits()
     int softLimitThreshold = qBound(0, MiB_TO_METRIC(config.tilesSoftLimit()), hardLimitThreshold);
     int softLimit = softLimitThreshold - softLimitThreshold / 8;
 
+    int historyLimitThreshold = qBound(0, MiB_TO_METRIC(config.historyLimit()), hardLimitThreshold);
+    int historyLimit = historyLimitThreshold - historyLimitThreshold / 8;
+
     KisStoreLimits limits;
 
     QCOMPARE(limits.emergencyThreshold(), emergencyThreshold);
@@ -34,6 +39,9 @@ void KisStoreLimitsTest::testLimits()
     QCOMPARE(limits.hardLimit(), hardLimit);
     QCOMPARE(limits.softLimitThreshold(), softLimitThreshold);
     QCOMPARE(limits.softLimit(), softLimit);
+    QCOMPARE(limits.historyLimitThreshold(), historyLimitThreshold);
+    QCOMPARE(limits.historyLimit(), historyLimit);
+    QCOMPARE(limits.uncompressedUndoSteps(), 5);
 }
 
 SIMPLE_TEST_MAIN(KisStoreLimitsTest)
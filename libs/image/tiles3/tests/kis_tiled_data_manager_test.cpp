@@ -7,7 +7,12 @@
 #include "kis_tiled_data_manager_test.h"
 #include <simpletest.h>
 
+#include <algorithm>
+
+
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_image_config.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -462,6 +467,97 @@ void KisTiledDataManagerTest::testPurgeHistory()
     dm.purgeHistory(memento4);
 }
 
+void KisTiledDataManagerTest::testOpacityStateWrittenWhileChecked()
+{
+    const quint8 defaultPixel = 0;
+    const quint8 opaquePixel = 255;
+    const QRect tileRect(0, 0, 64, 64);
+
+    KisTiledDataManager dm(1, &defaultPixel);
+    dm.clear(tileRect, opaquePixel);
+
+    int numChecks = 0;
+
+    auto isOpaque = [&numChecks] (const quint8 *pixels, qint32 numPixels) {
+        numChecks++;
+        return std::all_of(pixels, pixels + numPixels,
+                           [] (quint8 value) { return value == 255; });
+    };
+
+    /**
+     * Write into the tile while its opacity is being checked. The check
+     * started before the write, so its result must not be cached.
+     */
+    auto isOpaqueWithWrite = [&] (const quint8 *pixels, qint32 numPixels) {
+        const bool result = isOpaque(pixels, numPixels);
+        dm.setPixel(10, 10, &defaultPixel);
+        return result;
+    };
+
+    QVERIFY(dm.opaqueTileRects(tileRect, isOpaqueWithWrite).isEmpty());
+    QCOMPARE(numChecks, 1);
+
+    QVERIFY(dm.opaqueTileRects(tileRect, isOpaque).isEmpty());
+    QCOMPARE(numChecks, 2);
+
+    dm.setPixel(10, 10, &opaquePixel);
+
+    QCOMPARE(dm.opaqueTileRects(tileRect, isOpaque), QVector<QRect>({tileRect}));
+    QCOMPARE(numChecks, 3);
+
+    // the state is cached now
+    QCOMPARE(dm.opaqueTileRects(tileRect, isOpaque), QVector<QRect>({tileRect}));
+    QCOMPARE(numChecks, 3);
+}
+
+void KisTiledDataManagerTest::testUncompressedUndoSteps()
+{
+    KisImageConfig config(false);
+    config.setUncompressedUndoSteps(1);
+    KisTileDataStore::instance()->testingRereadConfig();
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+    quint8 oddPixel3 = 130;
+
+    KisMementoSP memento1 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, &oddPixel1);
+    dm.commit();
+
+    KisMementoSP memento2 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, &oddPixel2);
+
+    KisTileSP oldTile00 = dm.getOldTile(0, 0);
+    QVERIFY(memoryIsFilled(oddPixel1, oldTile00->data(), TILESIZE));
+    KisTileData *undoData2 = oldTile00->tileData();
+    oldTile00 = 0;
+
+    dm.commit();
+
+    // the undo data of the latest step is kept as it is
+    QCOMPARE(undoData2->age(), 0);
+
+    KisMementoSP memento3 = dm.getMemento();
+    dm.clear(0, 0, 64, 64, &oddPixel3);
+    dm.commit();
+
+    // ...and becomes a candidate for swapping as soon as it gets older
+    QVERIFY(undoData2->age() > 0);
+
+    dm.rollback(memento3);
+    dm.rollback(memento2);
+
+    KisTileSP tile00 = dm.getTile(0, 0, false);
+    QVERIFY(memoryIsFilled(oddPixel1, tile00->data(), TILESIZE));
+    tile00 = 0;
+
+    config.setUncompressedUndoSteps(config.uncompressedUndoSteps(true));
+    KisTileDataStore::instance()->testingRereadConfig();
+}
+
 void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 {
     quint8 defaultPixel = 0;
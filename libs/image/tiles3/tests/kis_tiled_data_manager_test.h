@@ -39,6 +39,8 @@ private Q_SLOTS:
     void testBitBltRough();
     void testTransactions();
     void testPurgeHistory();
+    void testUncompressedUndoSteps();
+    void testOpacityStateWrittenWhileChecked();
     void testUndoSetDefaultPixel();
 
     void benchmarkReadOnlyTileLazy();
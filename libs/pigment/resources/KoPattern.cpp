@@ -356,6 +356,18 @@ QImage KoPattern::pattern() const
     return m_pattern;
 }
 
+qint64 KoPattern::memoryFootprint() const
+{
+    qint64 size = KoResource::memoryFootprint();
+
+    // the pattern image is usually shared with the thumbnail
+    if (m_pattern.cacheKey() != image().cacheKey()) {
+        size += m_pattern.sizeInBytes();
+    }
+
+    return size;
+}
+
 void KoPattern::checkForAlpha(const QImage& image) {
     m_hasAlpha = false;
     for (int y = 0; y < image.height(); y++) {
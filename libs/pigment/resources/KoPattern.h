@@ -57,6 +57,8 @@ public:
 
     QString defaultFileExtension() const override;
 
+    qint64 memoryFootprint() const override;
+
     QPair<QString, QString> resourceType() const override {
         return QPair<QString, QString>(ResourceType::Patterns, "");
     }
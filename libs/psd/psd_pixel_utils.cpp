@@ -9,6 +9,7 @@
 
 #include <QIODevice>
 #include <QMap>
+#include <QtConcurrent>
 #include <QtEndian>
 #include <QtGlobal>
 
@@ -18,6 +19,7 @@
 #include <colorspaces/KoAlphaColorSpace.h>
 #include <kis_global.h>
 #include <kis_iterator_ng.h>
+#include <kis_sequential_iterator.h>
 
 #include <asl/kis_asl_reader_utils.h>
 #include <asl/kis_asl_writer_utils.h>
@@ -298,37 +300,111 @@ void readAlphaMaskPixelCommon(int channelSize, const QMap<quint16, QByteArray> &
     }
 }
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice &io, QVector<ChannelInfo *> channelInfoRecords, int row, int width, int channelSize, bool processMasks)
+/**
+ * The channels of the layer are stored one after another, so the rows of
+ * RLE-compressed and uncompressed channels are read in bands: the packed
+ * data of a band is read sequentially from the device, then the rows of
+ * all the channels are unpacked in parallel.
+ */
+const int rowsPerReadBand = 256;
+const int rowsPerPackJob = 32;
+
+struct ChannelBand {
+    ChannelInfo *info = 0;
+    QByteArray packedBytes;
+    QVector<int> rowOffsets;
+    QVector<QByteArray> rows;
+};
+
+struct UnpackRowsJob {
+    const ChannelBand *band = 0;
+    QByteArray *rows = 0;
+    int firstRow = 0;
+    int numRows = 0;
+};
+
+QVector<ChannelBand> fetchChannelsBand(QIODevice &io, QVector<ChannelInfo *> channelInfoRecords, int firstRow, int numRows, int width, int channelSize, bool processMasks)
 {
     const int uncompressedLength = width * channelSize;
 
-    QMap<quint16, QByteArray> channelBytes;
+    QVector<ChannelBand> bands;
 
     Q_FOREACH (ChannelInfo *channelInfo, channelInfoRecords) {
         // user supplied masks are ignored here
         if (!processMasks && channelInfo->channelId < -1)
             continue;
 
-        io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
-
-        if (channelInfo->compressionType == psd_compression_type::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io.read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
-        } else if (channelInfo->compressionType == psd_compression_type::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io.read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
-            channelBytes.insert(channelInfo->channelId, uncompressedBytes);
-            channelInfo->channelOffset += rleLength;
-        } else {
+        if (channelInfo->compressionType != psd_compression_type::Uncompressed && channelInfo->compressionType != psd_compression_type::RLE) {
             QString error = QString("Unsupported Compression mode: %1")
                                 .arg(static_cast<std::uint16_t>(channelInfo->compressionType));
-            dbgFile << "ERROR: fetchChannelsBytes:" << error;
+            dbgFile << "ERROR: fetchChannelsBand:" << error;
             throw KisAslReaderUtils::ASLParseException(error);
         }
+
+        ChannelBand band;
+        band.info = channelInfo;
+        band.rowOffsets.reserve(numRows + 1);
+
+        int bandLength = 0;
+        for (int row = firstRow; row < firstRow + numRows; row++) {
+            band.rowOffsets.append(bandLength);
+            bandLength += channelInfo->compressionType == psd_compression_type::RLE ? static_cast<int>(channelInfo->rleRowLengths[row]) : uncompressedLength;
+        }
+        band.rowOffsets.append(bandLength);
+
+        io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+        band.packedBytes = io.read(bandLength);
+        channelInfo->channelOffset += bandLength;
+
+        band.rows.resize(numRows);
+        bands.append(band);
     }
 
-    return channelBytes;
+    return bands;
+}
+
+void unpackChannelsBand(QVector<ChannelBand> &bands, int numRows, int width, int channelSize)
+{
+    const int uncompressedLength = width * channelSize;
+
+    QVector<UnpackRowsJob> jobs;
+
+    for (ChannelBand &band : bands) {
+        QByteArray *rows = band.rows.data();
+
+        for (int row = 0; row < numRows; row += rowsPerPackJob) {
+            UnpackRowsJob job;
+            job.band = &band;
+            job.rows = rows;
+            job.firstRow = row;
+            job.numRows = qMin(rowsPerPackJob, numRows - row);
+            jobs.append(job);
+        }
+    }
+
+    auto unpackRows = [uncompressedLength](const UnpackRowsJob &job) {
+        const ChannelBand *band = job.band;
+        const int packedSize = band->packedBytes.size();
+
+        for (int row = job.firstRow; row < job.firstRow + job.numRows; row++) {
+            // the device might have returned less data than requested
+            const int offset = qMin(band->rowOffsets[row], packedSize);
+            const int length = qMin(band->rowOffsets[row + 1], packedSize) - offset;
+            const char *packedRow = band->packedBytes.constData() + offset;
+
+            if (band->info->compressionType == psd_compression_type::RLE) {
+                job.rows[row] = Compression::uncompress(uncompressedLength, QByteArray::fromRawData(packedRow, length), psd_compression_type::RLE);
+            } else {
+                job.rows[row] = QByteArray(packedRow, length);
+            }
+        }
+    };
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, unpackRows);
+    } else {
+        std::for_each(jobs.begin(), jobs.end(), unpackRows);
+    }
 }
 
 using PixelFunc = std::function<void(int, const QMap<quint16, QByteArray> &, int, quint8 *)>;
@@ -350,17 +426,43 @@ void readCommon(KisPaintDeviceSP dev,
 
     if (infoRecords.first()->compressionType == psd_compression_type::ZIP || infoRecords.first()->compressionType == psd_compression_type::ZIPWithPrediction) {
         const int numPixels = channelSize * layerRect.width() * layerRect.height();
+        const psd_compression_type compressionType = infoRecords.first()->compressionType;
 
-        QMap<quint16, QByteArray> channelBytes;
+        struct UnzipJob {
+            ChannelInfo *info = 0;
+            QByteArray compressedBytes;
+            QByteArray uncompressedBytes;
+        };
+
+        QVector<UnzipJob> jobs;
 
         Q_FOREACH (ChannelInfo *info, infoRecords) {
             io.seek(info->channelDataStart);
-            QByteArray compressedBytes = io.read(info->channelDataLength);
-            QByteArray uncompressedBytes;
 
-            uncompressedBytes = Compression::uncompress(numPixels, compressedBytes, infoRecords.first()->compressionType, layerRect.width(), channelSize * 8);
+            UnzipJob job;
+            job.info = info;
+            job.compressedBytes = io.read(info->channelDataLength);
+            jobs.append(job);
+        }
+
+        // zlib streams are independent, so the channels are inflated in parallel
+        auto unzipChannel = [numPixels, compressionType, layerRect, channelSize](UnzipJob &job) {
+            job.uncompressedBytes = Compression::uncompress(numPixels, job.compressedBytes, compressionType, layerRect.width(), channelSize * 8);
+            job.compressedBytes.clear();
+        };
 
-            if (uncompressedBytes.size() != numPixels) {
+        if (jobs.size() > 1) {
+            QtConcurrent::blockingMap(jobs, unzipChannel);
+        } else {
+            std::for_each(jobs.begin(), jobs.end(), unzipChannel);
+        }
+
+        QMap<quint16, QByteArray> channelBytes;
+
+        for (const UnzipJob &job : jobs) {
+            ChannelInfo *info = job.info;
+
+            if (job.uncompressedBytes.size() != numPixels) {
                 QString error = QString("Failed to unzip channel data: id = %1, compression = %2")
                                     .arg(info->channelId)
                                     .arg(static_cast<std::uint16_t>(info->compressionType));
@@ -372,7 +474,7 @@ void readCommon(KisPaintDeviceSP dev,
                 throw KisAslReaderUtils::ASLParseException(error);
             }
 
-            channelBytes.insert(info->channelId, uncompressedBytes);
+            channelBytes.insert(info->channelId, job.uncompressedBytes);
         }
 
         KisSequentialIterator it(dev, layerRect);
@@ -384,16 +486,25 @@ void readCommon(KisPaintDeviceSP dev,
 
     } else {
         KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0; i < layerRect.height(); i++) {
-            QMap<quint16, QByteArray> channelBytes;
+        for (int firstRow = 0; firstRow < layerRect.height(); firstRow += rowsPerReadBand) {
+            const int numRows = qMin(rowsPerReadBand, layerRect.height() - firstRow);
 
-            channelBytes = fetchChannelsBytes(io, infoRecords, i, layerRect.width(), channelSize, processMasks);
+            QVector<ChannelBand> bands = fetchChannelsBand(io, infoRecords, firstRow, numRows, layerRect.width(), channelSize, processMasks);
+            unpackChannelsBand(bands, numRows, layerRect.width(), channelSize);
 
-            for (int col = 0; col < layerRect.width(); col++) {
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
-                it->nextPixel();
+            for (int i = 0; i < numRows; i++) {
+                QMap<quint16, QByteArray> channelBytes;
+
+                for (const ChannelBand &band : bands) {
+                    channelBytes.insert(band.info->channelId, band.rows[i]);
+                }
+
+                for (int col = 0; col < layerRect.width(); col++) {
+                    pixelFunc(channelSize, channelBytes, col, it->rawData());
+                    it->nextPixel();
+                }
+                it->nextRow();
             }
-            it->nextRow();
         }
     }
 }
@@ -468,9 +579,64 @@ void readAlphaMaskChannels(QIODevice &io,
     }
 }
 
+/**
+ * The channels are written to the device one after another, but the
+ * pixels are fetched from the paint device in strips of rows, so the
+ * memory needed for exporting is bounded by the size of a strip instead
+ * of the size of the layer.
+ */
+const int rowsPerWriteStrip = 256;
+
+/**
+ * Returns the pointer to the pixels of \p stripRect of the written channel,
+ * the data should stay valid until the next call
+ */
+using FetchStripFunc = std::function<const quint8 *(const QRect &)>;
+
+/**
+ * Packs the rows of the strip in parallel. The packed rows are written
+ * to the device afterwards in their original order, so the resulting
+ * file is the same as the one written by a sequential encoder.
+ */
+QVector<QByteArray> compressRowsRLE(const quint8 *plane, const int channelSize, const QRect &rc)
+{
+    struct PackRowsJob {
+        int firstRow = 0;
+        int numRows = 0;
+    };
+
+    QVector<QByteArray> result(rc.height());
+    QByteArray *rows = result.data();
+    QVector<PackRowsJob> jobs;
+
+    for (int row = 0; row < rc.height(); row += rowsPerPackJob) {
+        PackRowsJob job;
+        job.firstRow = row;
+        job.numRows = qMin(rowsPerPackJob, rc.height() - row);
+        jobs.append(job);
+    }
+
+    const int stride = channelSize * rc.width();
+
+    auto packRows = [plane, rows, stride](const PackRowsJob &job) {
+        for (int row = job.firstRow; row < job.firstRow + job.numRows; row++) {
+            QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
+            rows[row] = Compression::compress(uncompressed, psd_compression_type::RLE);
+        }
+    };
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, packRows);
+    } else {
+        std::for_each(jobs.begin(), jobs.end(), packRows);
+    }
+
+    return result;
+}
+
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
 void writeChannelDataRLEImpl(QIODevice &io,
-                             const quint8 *plane,
+                             FetchStripFunc fetchStrip,
                              const int channelSize,
                              const QRect &rc,
                              const qint64 sizeFieldOffset,
@@ -508,15 +674,18 @@ void writeChannelDataRLEImpl(QIODevice &io,
         }
     }
 
-    const int stride = channelSize * rc.width();
-    for (qint32 row = 0; row < rc.height(); ++row) {
-        QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, psd_compression_type::RLE);
+    for (int firstRow = 0; firstRow < rc.height(); firstRow += rowsPerWriteStrip) {
+        const QRect stripRect(rc.x(), rc.y() + firstRow, rc.width(), qMin(rowsPerWriteStrip, rc.height() - firstRow));
+        const QVector<QByteArray> compressedRows = compressRowsRLE(fetchStrip(stripRect), channelSize, stripRect);
+
+        for (qint32 row = 0; row < compressedRows.size(); ++row) {
+            const QByteArray &compressed = compressedRows[row];
 
-        KisAslWriterUtils::OffsetStreamPusher<quint16, byteOrder> rleExternalTag(io, 0, channelRLESizePos + row * static_cast<qint64>(sizeof(quint16)));
+            KisAslWriterUtils::OffsetStreamPusher<quint16, byteOrder> rleExternalTag(io, 0, channelRLESizePos + (firstRow + row) * static_cast<qint64>(sizeof(quint16)));
 
-        if (io.write(compressed) != compressed.size()) {
-            throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
+            if (io.write(compressed) != compressed.size()) {
+                throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
+            }
         }
     }
 }
@@ -539,7 +708,7 @@ void writeChannelDataZIPImpl(QIODevice &io,
         SAFE_WRITE_EX(byteOrder, io, static_cast<quint16>(psd_compression_type::ZIP));
     }
 
-    QByteArray uncompressed(reinterpret_cast<const char *>(plane), rc.width() * rc.height() * channelSize);
+    QByteArray uncompressed = QByteArray::fromRawData(reinterpret_cast<const char *>(plane), rc.width() * rc.height() * channelSize);
     QByteArray compressed(Compression::compress(uncompressed, psd_compression_type::ZIP));
 
     if (compressed.size() == 0 || io.write(compressed) != compressed.size()) {
@@ -556,11 +725,17 @@ void writeChannelDataRLE(QIODevice &io,
                          const bool writeCompressionType,
                          psd_byte_order byteOrder)
 {
+    const int stride = channelSize * rc.width();
+
+    FetchStripFunc fetchStrip = [plane, stride, rc](const QRect &stripRect) {
+        return plane + (stripRect.y() - rc.y()) * stride;
+    };
+
     switch (byteOrder) {
     case psd_byte_order::psdLittleEndian:
-        return writeChannelDataRLEImpl<psd_byte_order::psdLittleEndian>(io, plane, channelSize, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
+        return writeChannelDataRLEImpl<psd_byte_order::psdLittleEndian>(io, fetchStrip, channelSize, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
     default:
-        return writeChannelDataRLEImpl(io, plane, channelSize, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
+        return writeChannelDataRLEImpl(io, fetchStrip, channelSize, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
     }
 }
 
@@ -604,6 +779,38 @@ inline void preparePixelForWrite(quint8 *dataPlane, int numPixels, int channelSi
     }
 }
 
+template<typename T>
+void readChannelPixelsImpl(KisPaintDeviceSP dev, const QRect &rc, int channelOffset, quint8 *dstPlane)
+{
+    T *dstPtr = reinterpret_cast<T *>(dstPlane);
+
+    KisSequentialConstIterator it(dev, rc);
+    while (it.nextPixel()) {
+        *dstPtr++ = *reinterpret_cast<const T *>(it.rawDataConst() + channelOffset);
+    }
+}
+
+/**
+ * Copies a single channel of \p rc into \p dstPlane, which must be
+ * able to hold rc.width() * rc.height() * channelSize bytes
+ */
+void readChannelPixels(KisPaintDeviceSP dev, const QRect &rc, int channelOffset, int channelSize, quint8 *dstPlane)
+{
+    switch (channelSize) {
+    case 1:
+        readChannelPixelsImpl<quint8>(dev, rc, channelOffset, dstPlane);
+        break;
+    case 2:
+        readChannelPixelsImpl<quint16>(dev, rc, channelOffset, dstPlane);
+        break;
+    case 4:
+        readChannelPixelsImpl<quint32>(dev, rc, channelOffset, dstPlane);
+        break;
+    default:
+        KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "unsupported channel size");
+    }
+}
+
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
 void writePixelDataCommonImpl(QIODevice &io,
                               KisPaintDeviceSP dev,
@@ -618,46 +825,44 @@ void writePixelDataCommonImpl(QIODevice &io,
     // Empty rects must be processed separately on a higher level!
     KIS_ASSERT_RECOVER_RETURN(!rc.isEmpty());
 
-    QVector<quint8 *> tmp = dev->readPlanarBytes(rc.x() - dev->x(), rc.y() - dev->y(), rc.width(), rc.height());
     const KoColorSpace *colorSpace = dev->colorSpace();
 
-    QVector<quint8 *> planes;
+    // the offsets of the channels in the pixel, in the order they are written
+    QVector<int> channelOffsets;
 
-    { // prepare 'planes' array
-
-        quint8 *alphaPlanePtr = 0;
+    {
+        int alphaChannelOffset = -1;
 
         QList<KoChannelInfo *> origChannels = colorSpace->channels();
         Q_FOREACH (KoChannelInfo *ch, KoChannelInfo::displayOrderSorted(origChannels)) {
             int channelIndex = KoChannelInfo::displayPositionToChannelIndex(ch->displayPosition(), origChannels);
-
-            quint8 *holder = 0;
-            std::swap(holder, tmp[channelIndex]);
+            const int channelOffset = origChannels[channelIndex]->pos();
 
             if (ch->channelType() == KoChannelInfo::ALPHA) {
-                std::swap(holder, alphaPlanePtr);
+                alphaChannelOffset = channelOffset;
             } else {
-                planes.append(holder);
+                channelOffsets.append(channelOffset);
             }
         }
 
-        if (alphaPlanePtr) {
+        if (alphaChannelOffset >= 0) {
             if (alphaFirst) {
-                planes.insert(0, alphaPlanePtr);
+                channelOffsets.insert(0, alphaChannelOffset);
                 KIS_ASSERT_RECOVER_NOOP(writingInfoList.first().channelId == -1);
             } else {
-                planes.append(alphaPlanePtr);
-                KIS_ASSERT_RECOVER_NOOP((writingInfoList.size() == planes.size() - 1) || (writingInfoList.last().channelId == -1));
+                channelOffsets.append(alphaChannelOffset);
+                KIS_ASSERT_RECOVER_NOOP((writingInfoList.size() == channelOffsets.size() - 1) || (writingInfoList.last().channelId == -1));
             }
         }
-
-        // now planes are holding pointers to quint8 arrays
-        tmp.clear();
     }
 
-    KIS_ASSERT_RECOVER_RETURN(planes.size() >= writingInfoList.size());
+    KIS_ASSERT_RECOVER_RETURN(channelOffsets.size() >= writingInfoList.size());
+
+    const bool useZip = compressionType == psd_compression_type::ZIP || compressionType == psd_compression_type::ZIPWithPrediction;
 
-    const int numPixels = rc.width() * rc.height();
+    // the whole channel for ZIP, a strip of rows for RLE
+    const int bufferRows = useZip ? rc.height() : qMin(rowsPerWriteStrip, rc.height());
+    QByteArray buffer(rc.width() * bufferRows * channelSize, 0);
 
     // write down the planes
 
@@ -666,39 +871,28 @@ void writePixelDataCommonImpl(QIODevice &io,
             const ChannelWritingInfo &info = writingInfoList[i];
 
             dbgFile << "\tWriting channel" << i << "psd channel id" << info.channelId;
+            dbgFile << "\t\tchannel start" << ppVar(io.pos()) << ", compression type" << compressionType;
 
-            // WARNING: Pixel data is ALWAYS in big endian!!!
-            preparePixelForWrite<psd_byte_order::psdBigEndian>(planes[i], numPixels, channelSize, info.channelId, colorMode);
+            FetchStripFunc fetchStrip = [&](const QRect &stripRect) {
+                quint8 *stripPtr = reinterpret_cast<quint8 *>(buffer.data());
+                readChannelPixels(dev, stripRect, channelOffsets[i], channelSize, stripPtr);
 
-            dbgFile << "\t\tchannel start" << ppVar(io.pos()) << ", compression type" << compressionType;
+                // WARNING: Pixel data is ALWAYS in big endian!!!
+                preparePixelForWrite<psd_byte_order::psdBigEndian>(stripPtr, stripRect.width() * stripRect.height(), channelSize, info.channelId, colorMode);
 
-            switch (compressionType) {
-            case psd_compression_type::ZIP:
-            case psd_compression_type::ZIPWithPrediction: {
-                writeChannelDataZIPImpl<byteOrder>(io, planes[i], channelSize, rc, info.sizeFieldOffset, writeCompressionType);
-                break;
-            }
-            case psd_compression_type::RLE:
-            default: {
-                writeChannelDataRLEImpl<byteOrder>(io, planes[i], channelSize, rc, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
-                break;
-            }
+                return static_cast<const quint8 *>(stripPtr);
+            };
+
+            if (useZip) {
+                writeChannelDataZIPImpl<byteOrder>(io, fetchStrip(rc), channelSize, rc, info.sizeFieldOffset, writeCompressionType);
+            } else {
+                writeChannelDataRLEImpl<byteOrder>(io, fetchStrip, channelSize, rc, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
             }
         }
 
     } catch (KisAslWriterUtils::ASLWriteException &e) {
-        Q_FOREACH (quint8 *plane, planes) {
-            delete[] plane;
-        }
-        planes.clear();
-
         throw KisAslWriterUtils::ASLWriteException(PREPEND_METHOD(e.what()));
     }
-
-    Q_FOREACH (quint8 *plane, planes) {
-        delete[] plane;
-    }
-    planes.clear();
 }
 
 void writePixelDataCommon(QIODevice &io,
@@ -11,6 +11,7 @@
 
 #include <QBuffer>
 #include <QtEndian>
+#include <cstring>
 #include <zlib.h>
 
 #include <kis_debug.h>
@@ -23,11 +24,10 @@ int compress(const QByteArray &src, QByteArray &dst)
 {
     int length = src.size();
     dst.resize(length * 2);
-    dst.fill(0, length * 2);
 
     int remaining = length;
-    quint8 i, j;
-    quint32 dest_ptr = 0;
+    quint8 i;
+    char *out = dst.data();
     const char *start = src.constData();
 
     length = 0;
@@ -39,8 +39,8 @@ int compress(const QByteArray &src, QByteArray &dst)
 
         if (i > 1) /* Match found */
         {
-            dst[dest_ptr++] = static_cast<char>(-(i - 1));
-            dst[dest_ptr++] = *start;
+            *out++ = static_cast<char>(-(i - 1));
+            *out++ = *start;
 
             start += i;
             remaining -= i;
@@ -59,10 +59,9 @@ int compress(const QByteArray &src, QByteArray &dst)
 
             if (i > 0) /* Some distinct ones found */
             {
-                dst[dest_ptr++] = static_cast<char>(i - 1U);
-                for (j = 0; j < i; j++) {
-                    dst[dest_ptr++] = start[j];
-                }
+                *out++ = static_cast<char>(i - 1U);
+                memcpy(out, start, i);
+                out += i;
                 start += i;
                 remaining -= i;
                 length += i + 1;
@@ -123,13 +122,10 @@ int decompress(const QByteArray &input, QByteArray &output, int unpacked_len)
                 error_code = 2;
             }
             dat = *src;
-            for (; n > 0; --n) {
-                if (!unpack_left)
-                    break;
-                *dst = dat;
-                dst++;
-                unpack_left--;
-            }
+            n = qMin(n, unpack_left);
+            memset(dst, dat, static_cast<size_t>(n));
+            dst += n;
+            unpack_left -= n;
             if (unpack_left) {
                 src++;
                 pack_left--;
@@ -137,32 +133,28 @@ int decompress(const QByteArray &input, QByteArray &output, int unpacked_len)
         } else /* copy next n+1 gchars literally */
         {
             n++;
-            for (; n > 0; --n) {
+            const int count = qMin(n, qMin(pack_left, unpack_left));
+            memcpy(dst, src, static_cast<size_t>(count));
+            dst += count;
+            unpack_left -= count;
+            src += count;
+            pack_left -= count;
+
+            if (count < n) {
                 if (!pack_left) {
                     dbgFile << "Input buffer exhausted in copy";
                     error_code = 3;
-                    break;
-                }
-                if (!unpack_left) {
+                } else {
                     dbgFile << "Output buffer exhausted in copy";
                     error_code = 4;
-                    break;
                 }
-                *dst = *src;
-                dst++;
-                unpack_left--;
-                src++;
-                pack_left--;
             }
         }
     }
 
     if (unpack_left > 0) {
         /* Pad with zeros to end of output buffer */
-        for (n = 0; n < pack_left; ++n) {
-            *dst = 0;
-            dst++;
-        }
+        memset(dst, 0, static_cast<size_t>(unpack_left));
     }
 
     if (unpack_left) {
@@ -41,6 +41,35 @@ void CompressionTest::testCompressionRLE()
     QVERIFY(qstrcmp(ba, uncompressed) == 0);
 }
 
+void CompressionTest::testCompressionRLEOutput()
+{
+    // the packed data must stay the same as the one written by older versions
+    QByteArray ba("Twee eeee aaaaa asdasda47892347981    wwwwwwwwwwwwWWWWWWWWWW");
+    QCOMPARE(Compression::compress(ba, psd_compression_type::RLE).toHex(), QByteArray("045477656520fd650020fc611220617364617364613437383932333437393831fd20f577f757"));
+
+    ba = QByteArray(300, 'a');
+    for (int i = 130; i < 140; i++) {
+        ba[i] = static_cast<char>(i);
+    }
+    QCOMPARE(Compression::compress(ba, psd_compression_type::RLE).toHex(), QByteArray("8161ff610982838485868788898a8b8161e161"));
+    QCOMPARE(Compression::uncompress(ba.size(), Compression::compress(ba, psd_compression_type::RLE), psd_compression_type::RLE), ba);
+}
+
+void CompressionTest::testDecompressionRLEMalformed()
+{
+    // a pad byte at the end of the packed data is allowed
+    QCOMPARE(Compression::uncompress(2, QByteArray::fromHex("01616200"), psd_compression_type::RLE), QByteArray("ab"));
+
+    // the literal run is longer than the packed data
+    QVERIFY(Compression::uncompress(4, QByteArray::fromHex("03616263"), psd_compression_type::RLE).isEmpty());
+
+    // the literal run is longer than the unpacked data
+    QVERIFY(Compression::uncompress(2, QByteArray::fromHex("03616263"), psd_compression_type::RLE).isEmpty());
+
+    // the replicate run has no data byte
+    QVERIFY(Compression::uncompress(4, QByteArray::fromHex("fd"), psd_compression_type::RLE).isEmpty());
+}
+
 void CompressionTest::testCompressionZIP()
 {
     QByteArray ba("Twee eeee aaaaa asdasda47892347981    wwwwwwwwwwwwWWWWWWWWWW");
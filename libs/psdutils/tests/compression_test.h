@@ -15,6 +15,8 @@ class CompressionTest : public QObject
 private Q_SLOTS:
 
     void testCompressionRLE();
+    void testCompressionRLEOutput();
+    void testDecompressionRLEMalformed();
     void testCompressionZIP();
     void testCompressionUncompressed();
 };
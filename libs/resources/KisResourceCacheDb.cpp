@@ -14,8 +14,10 @@
 #include <QDataStream>
 #include <QByteArray>
 #include <QMessageBox>
+#include <QtConcurrent>
 
 #include <KritaVersionWrapper.h>
+#include <KisMimeDatabase.h>
 
 #include <klocalizedstring.h>
 #include <kbackup.h>
@@ -33,7 +35,7 @@ const QString dbDriver = "QSQLITE";
 
 const QString KisResourceCacheDb::dbLocationKey { "ResourceCacheDbDirectory" };
 const QString KisResourceCacheDb::resourceCacheDbFilename { "resourcecache.sqlite" };
-const QString KisResourceCacheDb::databaseVersion { "0.0.16" };
+const QString KisResourceCacheDb::databaseVersion { "0.0.18" };
 QStringList KisResourceCacheDb::storageTypes { QStringList() };
 QStringList KisResourceCacheDb::disabledBundles { QStringList() << "Krita_3_Default_Resources.bundle" };
 
@@ -59,6 +61,20 @@ QString changeToEmptyIfNull(QString s)
     return s.isNull() ? QString("") : s;
 }
 
+// the size of the file of a bundle or an Adobe library, -1 for the storages
+// which are not backed by a single file
+qint64 storageFileSize(KisResourceStorageSP storage)
+{
+    switch (storage->type()) {
+    case KisResourceStorage::StorageType::Bundle:
+    case KisResourceStorage::StorageType::AdobeBrushLibrary:
+    case KisResourceStorage::StorageType::AdobeStyleLibrary:
+        return QFileInfo(storage->location()).size();
+    default:
+        return -1;
+    }
+}
+
 bool updateSchemaVersion()
 {
     QFile f(":/fill_version_information.sql");
@@ -121,6 +137,7 @@ QSqlError createDatabase(const QString &location)
                                        << "storages"
                                        << "tags"
                                        << "resources"
+                                       << "thumbnails"
                                        << "versioned_resources"
                                        << "resource_tags"
                                        << "metadata"
@@ -174,12 +191,14 @@ QSqlError createDatabase(const QString &location)
                 schemaIsOutDated = true;
                 KBackup::numberedBackupFile(location + "/" + KisResourceCacheDb::resourceCacheDbFilename);
 
-                if (newSchemaVersionNumber == QVersionNumber::fromString("0.0.16")
+                if (newSchemaVersionNumber == QVersionNumber::fromString("0.0.18")
                         && QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.14")) > 0
-                        && QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.16")) < 0) {
+                        && QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.18")) < 0) {
                     bool from14to15 = oldSchemaVersionNumber == QVersionNumber::fromString("0.0.14");
                     bool from15to16 = oldSchemaVersionNumber == QVersionNumber::fromString("0.0.14")
                             || oldSchemaVersionNumber == QVersionNumber::fromString("0.0.15");
+                    bool from16to17 = QVersionNumber::compare(oldSchemaVersionNumber, QVersionNumber::fromString("0.0.17")) < 0;
+                    bool from17to18 = true;
 
                     bool success = true;
                     if (from14to15) {
@@ -216,6 +235,46 @@ QSqlError createDatabase(const QString &location)
                             }
                         }
                     }
+                    if (from16to17) {
+                        qWarning() << "Going to update storages table";
+
+                        QSqlQuery q;
+                        q.prepare("ALTER TABLE  storages\n"
+                                  "ADD   COLUMN file_size INTEGER NOT NULL DEFAULT -1");
+                        if (!q.exec()) {
+                            qWarning() << "Could not update the storages table." << q.lastError();
+                            success = false;
+                        }
+                        else {
+                            qWarning() << "Updated table storages: success.";
+                        }
+                    }
+                    if (from17to18) {
+                        qWarning() << "Going to move the thumbnails into the thumbnails table";
+
+                        QFile f(":/create_thumbnails.sql");
+                        if (!f.open(QFile::ReadOnly)) {
+                            return QSqlError("Error executing SQL", QString("Could not find SQL file create_thumbnails.sql"), QSqlError::StatementError);
+                        }
+
+                        QSqlQuery q;
+                        if (!q.exec(f.readAll())) {
+                            qWarning() << "Could not create the thumbnails table." << q.lastError();
+                            success = false;
+                        }
+                        else if (!q.exec("INSERT OR IGNORE INTO thumbnails (md5sum, thumbnail)\n"
+                                         "SELECT md5sum, thumbnail\n"
+                                         "FROM   resources\n"
+                                         "WHERE  md5sum IS NOT NULL\n"
+                                         "AND    thumbnail IS NOT NULL")
+                                 || !q.exec("UPDATE resources SET thumbnail = NULL")) {
+                            qWarning() << "Could not move the thumbnails." << q.lastError();
+                            success = false;
+                        }
+                        else {
+                            qWarning() << "Updated table thumbnails: success.";
+                        }
+                    }
 
                     if (success) {
                         if (!updateSchemaVersion()) {
@@ -712,7 +771,6 @@ bool KisResourceCacheDb::makeResourceTheCurrentVersion(int resourceId, KoResourc
                   "SET name    = :name\n"
                   ", filename  = :filename\n"
                   ", tooltip   = :tooltip\n"
-                  ", thumbnail = :thumbnail\n"
                   ", status    = 1\n"
                   ", md5sum    = :md5sum\n"
                   "WHERE id    = :id");
@@ -725,22 +783,97 @@ bool KisResourceCacheDb::makeResourceTheCurrentVersion(int resourceId, KoResourc
     q.bindValue(":filename", resource->filename());
     q.bindValue(":tooltip", i18n(resource->name().toUtf8()));
     q.bindValue(":md5sum", resource->md5Sum());
-
-    QBuffer buf;
-    buf.open(QBuffer::WriteOnly);
-    resource->thumbnail().save(&buf, "PNG");
-    buf.close();
-    q.bindValue(":thumbnail", buf.data());
     q.bindValue(":id", resourceId);
 
     r = q.exec();
     if (!r) {
         qWarning() << "Could not update resource" << q.boundValues() << q.lastError();
+        return r;
     }
 
     return r;
 }
 
+bool KisResourceCacheDb::addThumbnail(const QString &md5sum, const QImage &thumbnail)
+{
+    if (md5sum.isEmpty()) return false;
+
+    {
+        QSqlQuery q;
+        if (!q.prepare("SELECT 1\n"
+                       "FROM   thumbnails\n"
+                       "WHERE  md5sum = :md5sum")) {
+            qWarning() << "Could not prepare hasThumbnail statement" << q.lastError();
+            return false;
+        }
+
+        q.bindValue(":md5sum", md5sum);
+
+        // a resource with exactly the same content has been added already
+        if (q.exec() && q.first()) {
+            return true;
+        }
+    }
+
+    QBuffer buf;
+    buf.open(QBuffer::WriteOnly);
+    thumbnail.save(&buf, "PNG");
+    buf.close();
+
+    QSqlQuery q;
+    if (!q.prepare("INSERT INTO thumbnails\n"
+                   "(md5sum, thumbnail)\n"
+                   "VALUES\n"
+                   "(:md5sum, :thumbnail)")) {
+        qWarning() << "Could not prepare addThumbnail statement" << q.lastError();
+        return false;
+    }
+
+    q.bindValue(":md5sum", md5sum);
+    q.bindValue(":thumbnail", buf.data());
+
+    if (!q.exec()) {
+        qWarning() << "Could not add thumbnail" << md5sum << q.lastError();
+        return false;
+    }
+
+    return true;
+}
+
+QByteArray KisResourceCacheDb::thumbnailData(const QString &md5sum)
+{
+    QSqlQuery q;
+    if (!q.prepare("SELECT thumbnail\n"
+                   "FROM   thumbnails\n"
+                   "WHERE  md5sum = :md5sum")) {
+        qWarning() << "Could not prepare thumbnailData statement" << q.lastError();
+        return QByteArray();
+    }
+
+    q.bindValue(":md5sum", md5sum);
+
+    if (!q.exec()) {
+        qWarning() << "Could not fetch thumbnail" << md5sum << q.lastError();
+        return QByteArray();
+    }
+
+    return q.first() ? q.value(0).toByteArray() : QByteArray();
+}
+
+bool KisResourceCacheDb::removeUnusedThumbnails()
+{
+    QSqlQuery q;
+    if (!q.exec("DELETE FROM thumbnails\n"
+                "WHERE  md5sum NOT IN (SELECT md5sum\n"
+                "                      FROM   resources\n"
+                "                      WHERE  md5sum IS NOT NULL)")) {
+        qWarning() << "Could not remove unused thumbnails" << q.lastError();
+        return false;
+    }
+
+    return true;
+}
+
 bool KisResourceCacheDb::removeResourceCompletely(int resourceId)
 {
     bool r = false;
@@ -928,7 +1061,7 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
 
     QSqlQuery q;
     r = q.prepare("INSERT INTO resources \n"
-                  "(storage_id, resource_type_id, name, filename, tooltip, thumbnail, status, temporary, md5sum) \n"
+                  "(storage_id, resource_type_id, name, filename, tooltip, status, temporary, md5sum) \n"
                   "VALUES \n"
                   "((SELECT  id "
                   "  FROM    storages "
@@ -939,7 +1072,6 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
                   ", :name\n"
                   ", :filename\n"
                   ", :tooltip\n"
-                  ", :thumbnail\n"
                   ", :status\n"
                   ", :temporary\n"
                   ", :md5sum)");
@@ -981,12 +1113,6 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
         q.bindValue(":tooltip", translatedName);
     }
 
-    QBuffer buf;
-    buf.open(QBuffer::WriteOnly);
-    resource->image().save(&buf, "PNG");
-    buf.close();
-    q.bindValue(":thumbnail", buf.data());
-
     q.bindValue(":status", resource->active());
     q.bindValue(":temporary", (temporary ? 1 : 0));
     q.bindValue(":md5sum", resource->md5Sum());
@@ -1385,6 +1511,23 @@ bool KisResourceCacheDb::addTags(KisResourceStorageSP storage, QString resourceT
 }
 
 bool KisResourceCacheDb::addStorage(KisResourceStorageSP storage, bool preinstalled)
+{
+    bool r = addStorageEntry(storage, preinstalled);
+    if (!r) {
+        return r;
+    }
+
+    Q_FOREACH(const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
+        if (!KisResourceCacheDb::addResources(storage, resourceType)) {
+            qWarning() << "Failed to add all resources for storage" << storage;
+            r = false;
+        }
+    }
+
+    return r;
+}
+
+bool KisResourceCacheDb::addStorageEntry(KisResourceStorageSP storage, bool preinstalled)
 {
     bool r = true;
 
@@ -1413,9 +1556,9 @@ bool KisResourceCacheDb::addStorage(KisResourceStorageSP storage, bool preinstal
         QSqlQuery q;
 
         r = q.prepare("INSERT INTO storages\n "
-                      "(storage_type_id, location, timestamp, pre_installed, active, thumbnail)\n"
+                      "(storage_type_id, location, timestamp, file_size, pre_installed, active, thumbnail)\n"
                       "VALUES\n"
-                      "(:storage_type_id, :location, :timestamp, :pre_installed, :active, :thumbnail);");
+                      "(:storage_type_id, :location, :timestamp, :file_size, :pre_installed, :active, :thumbnail);");
 
         if (!r) {
             qWarning() << "Could not prepare query" << q.lastError();
@@ -1425,6 +1568,7 @@ bool KisResourceCacheDb::addStorage(KisResourceStorageSP storage, bool preinstal
         q.bindValue(":storage_type_id", static_cast<int>(storage->type()));
         q.bindValue(":location", changeToEmptyIfNull(KisResourceLocator::instance()->makeStorageLocationRelative(storage->location())));
         q.bindValue(":timestamp", storage->timestamp().toSecsSinceEpoch());
+        q.bindValue(":file_size", storageFileSize(storage));
         q.bindValue(":pre_installed", preinstalled ? 1 : 0);
         q.bindValue(":active", !disabledBundles.contains(storage->name()));
 
@@ -1468,13 +1612,6 @@ bool KisResourceCacheDb::addStorage(KisResourceStorageSP storage, bool preinstal
         }
     }
 
-    Q_FOREACH(const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
-        if (!KisResourceCacheDb::addResources(storage, resourceType)) {
-            qWarning() << "Failed to add all resources for storage" << storage;
-            r = false;
-        }
-    }
-
     return r;
 }
 
@@ -1619,72 +1756,64 @@ QDebug operator<<(QDebug dbg, const ResourceVersion &ver)
 
     return dbg.space();
 }
-}
 
-bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
+struct ScannedResourceVersion
 {
-    QElapsedTimer t;
-    t.start();
-
-    QSqlDatabase::database().transaction();
+    QString url;
+    QString filename;
+    QString type;
+    int version = -1;
+    QDateTime timestamp;
+};
 
-    if (!s_valid) {
-        qWarning() << "KisResourceCacheDb::addResource: The database is not valid";
-        return false;
-    }
+/// All the versions of one resource found in the storage
+using ScannedResource = QVector<ScannedResourceVersion>;
 
-    bool success = true;
+struct StorageSynchronizationJob
+{
+    KisResourceStorageSP storage;
+    QString relativeLocation;
+    bool isNew = false;
 
-    // Find the storage in the database
-    QSqlQuery q;
-    if (!q.prepare("SELECT id\n"
-                   ",      timestamp\n"
-                   ",      pre_installed\n"
-                   "FROM   storages\n"
-                   "WHERE  location = :location\n")) {
-        qWarning() << "Could not prepare storage timestamp statement" << q.lastError();
-    }
+    /// The filenames of the resource versions present in the database, per resource type
+    QHash<QString, QSet<QString>> knownFilenames;
 
-    q.bindValue(":location", changeToEmptyIfNull(KisResourceLocator::instance()->makeStorageLocationRelative(storage->location())));
-    if (!q.exec()) {
-        qWarning() << "Could not execute storage timestamp statement" << q.boundValues() << q.lastError();
-    }
+    /// Filled in by the thread pool
+    QHash<QString, QVector<ScannedResource>> scannedResources;
+    QHash<QString, KoResourceSP> loadedResources;
+    qint64 scanTime = 0;
+};
 
-    if (!q.first()) {
-        // This is a new storage, the user must have dropped it in the path before restarting Krita, so add it.
-        debugResource << "Adding storage to the database:" << storage;
-        if (!addStorage(storage, false)) {
-            qWarning() << "Could not add new storage" << storage->name() << "to the database";
-            success = false;
-        }
-        return true;
+KoResourceSP loadResourceVersion(KisResourceStorageSP storage, const QString &url, int version)
+{
+    KoResourceSP res = storage->resource(url);
+    if (res) {
+        res->setVersion(version);
+        res->setMD5Sum(storage->resourceMd5(url));
     }
+    return res;
+}
 
-    storage->setStorageId(q.value("id").toInt());
-
-    /// We compare resource versions one-by-one because the storage may have multiple
-    /// versions of them
+/**
+ * Lists the resources of the storage without touching the database. The
+ * versions the database doesn't know about yet are loaded right away, since
+ * loading the resources and calculating their md5 sums is the most expensive
+ * part of the synchronization.
+ */
+void scanStorage(StorageSynchronizationJob &job)
+{
+    QElapsedTimer t;
+    t.start();
 
     Q_FOREACH(const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
+        const QSet<QString> knownFilenames = job.knownFilenames.value(resourceType);
+        QVector<ScannedResource> &resources = job.scannedResources[resourceType];
 
-        /// Firstly, fetch information about the existing resources
-        /// in the storage
-
-        QVector<ResourceVersion> resourcesInStorage;
-
-        /// A fake resourceId to group resources which are not yet present
-        /// in the database. This value is always negative, therefore it
-        /// cannot overlap with normal ids.
-
-        int nextInexistentResourceId = std::numeric_limits<int>::min();
-
-        QSharedPointer<KisResourceStorage::ResourceIterator> iter = storage->resources(resourceType);
+        QSharedPointer<KisResourceStorage::ResourceIterator> iter = job.storage->resources(resourceType);
         while (iter->hasNext()) {
             iter->next();
 
-            const int firstResourceVersionPosition = resourcesInStorage.size();
-
-            int detectedResourceId = nextInexistentResourceId;
+            ScannedResource resource;
             QSharedPointer<KisResourceStorage::ResourceIterator> verIt =
                     iter->versions();
 
@@ -1697,200 +1826,426 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
                 // so it cannot just use QFileInfo(verIt->url()).fileName() here.
                 QString path = QDir::fromNativeSeparators(verIt->url()); // make sure it uses Unix separators
                 int folderEndIdx = path.indexOf("/");
-                QString properFilenameWithSubfolders = path.right(path.length() - folderEndIdx - 1);
-                int id = resourceIdForResource(properFilenameWithSubfolders,
-                                               verIt->type(),
-                                               KisResourceLocator::instance()->makeStorageLocationRelative(storage->location()));
 
-                ResourceVersion item;
+                ScannedResourceVersion item;
                 item.url = verIt->url();
+                item.filename = path.right(path.length() - folderEndIdx - 1);
+                item.type = verIt->type();
                 item.version = verIt->guessedVersion();
 
                 // we use lower precision than the normal QDateTime
                 item.timestamp = QDateTime::fromSecsSinceEpoch(verIt->lastModified().toSecsSinceEpoch());
 
-                item.resourceId = id;
-
-                if (detectedResourceId < 0 && id >= 0) {
-                    detectedResourceId = id;
+                if (!knownFilenames.contains(item.filename)) {
+                    KoResourceSP res = loadResourceVersion(job.storage, item.url, item.version);
+                    if (res) {
+                        job.loadedResources.insert(item.url, res);
+                    }
                 }
 
-                resourcesInStorage.append(item);
+                resource.append(item);
             }
 
-            /// Assign the detected resource id to all the versions of
-            /// this resource (if they are not present in the database).
-            /// If no id has been detected, then a fake one will be assigned.
+            resources.append(resource);
+        }
+    }
 
-            for (int i = firstResourceVersionPosition; i < resourcesInStorage.size(); i++) {
-                if (resourcesInStorage[i].resourceId < 0) {
-                    resourcesInStorage[i].resourceId = detectedResourceId;
-                }
-            }
+    job.scanTime = t.elapsed();
+}
+}
 
-            nextInexistentResourceId++;
-        }
+bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
+{
+    QStringList failedStorages;
+    return synchronizeStorages({storage}, false, failedStorages);
+}
 
+bool KisResourceCacheDb::synchronizeStorages(const QList<KisResourceStorageSP> &storages, bool skipUnchanged, QStringList &failedStorages)
+{
+    if (!s_valid) {
+        qWarning() << "KisResourceCacheDb::synchronizeStorages: The database is not valid";
+        return false;
+    }
+
+    QElapsedTimer totalTimer;
+    totalTimer.start();
 
-        /// Secondly, fetch the resources present in the database
+    int numSkippedStorages = 0;
 
-        QVector<ResourceVersion> resourcesInDatabase;
+    /// Firstly, find the storages in the database and decide which of them
+    /// should be scanned at all
+
+    QVector<StorageSynchronizationJob> jobs;
+
+    Q_FOREACH(KisResourceStorageSP storage, storages) {
+        StorageSynchronizationJob job;
+        job.storage = storage;
+        job.relativeLocation = KisResourceLocator::instance()->makeStorageLocationRelative(storage->location());
 
         QSqlQuery q;
-        q.setForwardOnly(true);
-        if (!q.prepare("SELECT versioned_resources.resource_id, versioned_resources.filename, versioned_resources.version, versioned_resources.timestamp\n"
+        if (!q.prepare("SELECT id\n"
+                       ",      timestamp\n"
+                       ",      file_size\n"
+                       "FROM   storages\n"
+                       "WHERE  location = :location\n")) {
+            qWarning() << "Could not prepare storage timestamp statement" << q.lastError();
+        }
+
+        q.bindValue(":location", changeToEmptyIfNull(job.relativeLocation));
+        if (!q.exec()) {
+            qWarning() << "Could not execute storage timestamp statement" << q.boundValues() << q.lastError();
+        }
+
+        if (!q.first()) {
+            // This is a new storage, the user must have dropped it in the path before restarting Krita, so add it.
+            job.isNew = true;
+            jobs.append(job);
+            continue;
+        }
+
+        storage->setStorageId(q.value("id").toInt());
+
+        /// The resources modified by the user are saved next to the bundle,
+        /// so the bundle itself stays the same when they change
+        const qint64 fileSize = storageFileSize(storage);
+        if (skipUnchanged
+                && fileSize >= 0
+                && q.value("file_size").toLongLong() == fileSize
+                && q.value("timestamp").toLongLong() == storage->timestamp().toSecsSinceEpoch()
+                && !QFileInfo(storage->location() + "_modified").exists()) {
+
+            debugResource << "Skipping unchanged storage" << storage->location();
+            numSkippedStorages++;
+            continue;
+        }
+
+        q.finish();
+
+        if (!q.prepare("SELECT resource_types.name\n"
+                       ",      versioned_resources.filename\n"
                        "FROM   versioned_resources\n"
-                       ",      resource_types\n"
                        ",      resources\n"
-                       "WHERE  resources.resource_type_id = resource_types.id\n"
-                       "AND    resources.id = versioned_resources.resource_id\n"
-                       "AND    resource_types.name = :resource_type\n"
-                       "AND    versioned_resources.storage_id == :storage_id")) {
-            qWarning() << "Could not prepare resource by type query" << q.lastError();
-            success = false;
-            continue;
+                       ",      resource_types\n"
+                       "WHERE  resources.id = versioned_resources.resource_id\n"
+                       "AND    resource_types.id = resources.resource_type_id\n"
+                       "AND    versioned_resources.storage_id = :storage_id")) {
+            qWarning() << "Could not prepare known resources query" << q.lastError();
         }
 
-        q.bindValue(":resource_type", resourceType);
         q.bindValue(":storage_id", int(storage->storageId()));
-
         if (!q.exec()) {
-            qWarning() << "Could not exec resource by type query" << q.boundValues() << q.lastError();
-            success = false;
-            continue;
+            qWarning() << "Could not exec known resources query" << q.boundValues() << q.lastError();
         }
 
         while (q.next()) {
-            ResourceVersion item;
-            item.url = resourceType + "/" + q.value(1).toString();
-            item.version = q.value(2).toInt();
-            item.timestamp = QDateTime::fromSecsSinceEpoch(q.value(3).toInt());
-            item.resourceId = q.value(0).toInt();
+            job.knownFilenames[q.value(0).toString()].insert(q.value(1).toString());
+        }
+
+        jobs.append(job);
+    }
+
+    /// Secondly, scan the storages on the thread pool and apply the changes to
+    /// the database. All the newly loaded resources of a batch are kept in memory
+    /// until they are written, so the batches are not bigger than the pool.
 
-            resourcesInDatabase.append(item);
+    bool success = true;
+
+    const int batchSize = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+
+    // KisMimeDatabase fills its tables lazily, make sure it doesn't happen on the thread pool
+    KisMimeDatabase::mimeTypeForSuffix(QString());
+
+    for (int batchStart = 0; batchStart < jobs.size(); batchStart += batchSize) {
+        auto batchBegin = jobs.begin() + batchStart;
+        auto batchEnd = jobs.begin() + qMin(batchStart + batchSize, jobs.size());
+
+        if (std::distance(batchBegin, batchEnd) > 1) {
+            QtConcurrent::blockingMap(batchBegin, batchEnd, scanStorage);
+        } else {
+            std::for_each(batchBegin, batchEnd, scanStorage);
         }
 
-        QSet<int> resourceIdForUpdate;
+        for (auto jobIt = batchBegin; jobIt != batchEnd; ++jobIt) {
+            StorageSynchronizationJob &job = *jobIt;
+            KisResourceStorageSP storage = job.storage;
 
-        std::sort(resourcesInStorage.begin(), resourcesInStorage.end());
-        std::sort(resourcesInDatabase.begin(), resourcesInDatabase.end());
+            QElapsedTimer t;
+            t.start();
 
-        auto itA = resourcesInStorage.begin();
-        auto endA = resourcesInStorage.end();
+            bool storageSuccess = true;
 
-        auto itB = resourcesInDatabase.begin();
-        auto endB = resourcesInDatabase.end();
+            QSqlDatabase::database().transaction();
 
-        /// The head of itA array contains some resources with fake
-        /// (negative) resourceId. These resources are obviously new
-        /// resources and should be added to the cache database.
+            if (job.isNew) {
+                debugResource << "Adding storage to the database:" << storage;
 
-        while (itA != endA) {
-            if (itA->resourceId >= 0) break;
+                QSqlQuery q;
+                bool added = addStorageEntry(storage, false);
+                if (added) {
+                    added = q.prepare("SELECT id FROM storages WHERE location = :location");
+                    q.bindValue(":location", changeToEmptyIfNull(job.relativeLocation));
+                    added = added && q.exec() && q.first();
+                }
 
-            KoResourceSP res = storage->resource(itA->url);
+                if (!added) {
+                    qWarning() << "Could not add new storage" << storage->name() << "to the database";
+                    QSqlDatabase::database().rollback();
+                    failedStorages << storage->location();
+                    success = false;
+                    job = StorageSynchronizationJob();
+                    continue;
+                }
 
-            if (!res) {
-                KisUsageLogger::log("Could not load resource " + itA->url);
-                ++itA;
-                continue;
+                storage->setStorageId(q.value("id").toInt());
             }
 
-            res->setVersion(itA->version);
-            res->setMD5Sum(storage->resourceMd5(itA->url));
-            if (!res->valid()) {
-                KisUsageLogger::log("Could not retrieve md5 for resource " + itA->url);
-                ++itA;
-                continue;
-            }
+            auto takeResource = [&job] (const ResourceVersion &item) {
+                KoResourceSP res = job.loadedResources.take(item.url);
+                return res ? res : loadResourceVersion(job.storage, item.url, item.version);
+            };
 
-            const bool retval = addResource(storage, itA->timestamp, res, resourceType);
-            if (!retval) {
-                KisUsageLogger::log("Could not add resource " + itA->url);
-                ++itA;
-                continue;
-            }
+            /// We compare resource versions one-by-one because the storage may have multiple
+            /// versions of them
 
-            const int resourceId = res->resourceId();
-            KIS_SAFE_ASSERT_RECOVER(resourceId >= 0) {
-                KisUsageLogger::log("Could not get id for resource " + itA->url);
-                ++itA;
-                continue;
-            }
+            Q_FOREACH(const QString &resourceType, KisResourceLoaderRegistry::instance()->resourceTypes()) {
 
-            auto nextResource = std::upper_bound(itA, endA, *itA, ResourceVersion::CompareByResourceId());
-            for (auto it = std::next(itA); it != nextResource; ++it) {
-                KoResourceSP res = storage->resource(it->url);
-                res->setVersion(it->version);
-                res->setMD5Sum(storage->resourceMd5(it->url));
-                if (!res->valid()) {
+                /// Firstly, fetch information about the existing resources
+                /// in the storage
+
+                QVector<ResourceVersion> resourcesInStorage;
+
+                /// A fake resourceId to group resources which are not yet present
+                /// in the database. This value is always negative, therefore it
+                /// cannot overlap with normal ids.
+
+                int nextInexistentResourceId = std::numeric_limits<int>::min();
+
+                Q_FOREACH(const ScannedResource &resource, job.scannedResources.value(resourceType)) {
+                    const int firstResourceVersionPosition = resourcesInStorage.size();
+
+                    int detectedResourceId = nextInexistentResourceId;
+
+                    Q_FOREACH(const ScannedResourceVersion &version, resource) {
+                        const int id = job.isNew ? -1 :
+                            resourceIdForResource(version.filename, version.type, job.relativeLocation);
+
+                        ResourceVersion item;
+                        item.url = version.url;
+                        item.version = version.version;
+                        item.timestamp = version.timestamp;
+                        item.resourceId = id;
+
+                        if (detectedResourceId < 0 && id >= 0) {
+                            detectedResourceId = id;
+                        }
+
+                        resourcesInStorage.append(item);
+                    }
+
+                    /// Assign the detected resource id to all the versions of
+                    /// this resource (if they are not present in the database).
+                    /// If no id has been detected, then a fake one will be assigned.
+
+                    for (int i = firstResourceVersionPosition; i < resourcesInStorage.size(); i++) {
+                        if (resourcesInStorage[i].resourceId < 0) {
+                            resourcesInStorage[i].resourceId = detectedResourceId;
+                        }
+                    }
+
+                    nextInexistentResourceId++;
+                }
+
+
+                /// Secondly, fetch the resources present in the database
+
+                QVector<ResourceVersion> resourcesInDatabase;
+
+                QSqlQuery q;
+                q.setForwardOnly(true);
+                if (!q.prepare("SELECT versioned_resources.resource_id, versioned_resources.filename, versioned_resources.version, versioned_resources.timestamp\n"
+                               "FROM   versioned_resources\n"
+                               ",      resource_types\n"
+                               ",      resources\n"
+                               "WHERE  resources.resource_type_id = resource_types.id\n"
+                               "AND    resources.id = versioned_resources.resource_id\n"
+                               "AND    resource_types.name = :resource_type\n"
+                               "AND    versioned_resources.storage_id == :storage_id")) {
+                    qWarning() << "Could not prepare resource by type query" << q.lastError();
+                    storageSuccess = false;
                     continue;
                 }
 
-                const bool retval = addResourceVersion(resourceId, it->timestamp, storage, res);
-                KIS_SAFE_ASSERT_RECOVER(retval) {
-                    KisUsageLogger::log("Could not add version for resource " + itA->url);
+                q.bindValue(":resource_type", resourceType);
+                q.bindValue(":storage_id", int(storage->storageId()));
+
+                if (!q.exec()) {
+                    qWarning() << "Could not exec resource by type query" << q.boundValues() << q.lastError();
+                    storageSuccess = false;
                     continue;
                 }
-            }
 
-            itA = nextResource;
-        }
+                while (q.next()) {
+                    ResourceVersion item;
+                    item.url = resourceType + "/" + q.value(1).toString();
+                    item.version = q.value(2).toInt();
+                    item.timestamp = QDateTime::fromSecsSinceEpoch(q.value(3).toInt());
+                    item.resourceId = q.value(0).toInt();
 
-        /// Now both arrays are sorted in resourceId/version/timestamp
-        /// order. It lets us easily find the resources that are unique
-        /// to the storage or database. If *itA < *itB, then the resource
-        /// is present in the storage only and should be added to the
-        /// database. If *itA > *itB, then the resource is present in
-        /// the database only and should be removed (because it has been
-        /// removed from the storage);
+                    resourcesInDatabase.append(item);
+                }
 
-        while (itA != endA || itB != endB) {
-            if ((itA != endA && itB != endB && *itA < *itB) ||
-                    itB == endB) {
+                QSet<int> resourceIdForUpdate;
 
-                // add a version to the database
+                std::sort(resourcesInStorage.begin(), resourcesInStorage.end());
+                std::sort(resourcesInDatabase.begin(), resourcesInDatabase.end());
 
-                KoResourceSP res = storage->resource(itA->url);
-                if (res) {
-                    res->setVersion(itA->version);
-                    res->setMD5Sum(storage->resourceMd5(itA->url));
+                auto itA = resourcesInStorage.begin();
+                auto endA = resourcesInStorage.end();
 
-                    const bool result = addResourceVersionImpl(itA->resourceId, itA->timestamp, storage, res);
-                    KIS_SAFE_ASSERT_RECOVER_NOOP(result);
+                auto itB = resourcesInDatabase.begin();
+                auto endB = resourcesInDatabase.end();
 
-                    resourceIdForUpdate.insert(itA->resourceId);
+                /// The head of itA array contains some resources with fake
+                /// (negative) resourceId. These resources are obviously new
+                /// resources and should be added to the cache database.
+
+                while (itA != endA) {
+                    if (itA->resourceId >= 0) break;
+
+                    KoResourceSP res = takeResource(*itA);
+
+                    if (!res) {
+                        KisUsageLogger::log("Could not load resource " + itA->url);
+                        ++itA;
+                        continue;
+                    }
+
+                    if (!res->valid()) {
+                        KisUsageLogger::log("Could not retrieve md5 for resource " + itA->url);
+                        ++itA;
+                        continue;
+                    }
+
+                    const bool retval = addResource(storage, itA->timestamp, res, resourceType);
+                    if (!retval) {
+                        KisUsageLogger::log("Could not add resource " + itA->url);
+                        ++itA;
+                        continue;
+                    }
+
+                    const int resourceId = res->resourceId();
+                    KIS_SAFE_ASSERT_RECOVER(resourceId >= 0) {
+                        KisUsageLogger::log("Could not get id for resource " + itA->url);
+                        ++itA;
+                        continue;
+                    }
+
+                    auto nextResource = std::upper_bound(itA, endA, *itA, ResourceVersion::CompareByResourceId());
+                    for (auto it = std::next(itA); it != nextResource; ++it) {
+                        KoResourceSP res = takeResource(*it);
+                        if (!res || !res->valid()) {
+                            continue;
+                        }
+
+                        const bool retval = addResourceVersion(resourceId, it->timestamp, storage, res);
+                        KIS_SAFE_ASSERT_RECOVER(retval) {
+                            KisUsageLogger::log("Could not add version for resource " + itA->url);
+                            continue;
+                        }
+                    }
+
+                    itA = nextResource;
                 }
-                ++itA;
 
-            } else if ((itA != endA && itB != endB && *itA > *itB) ||
-                       itA == endA) {
+                /// Now both arrays are sorted in resourceId/version/timestamp
+                /// order. It lets us easily find the resources that are unique
+                /// to the storage or database. If *itA < *itB, then the resource
+                /// is present in the storage only and should be added to the
+                /// database. If *itA > *itB, then the resource is present in
+                /// the database only and should be removed (because it has been
+                /// removed from the storage);
+
+                while (itA != endA || itB != endB) {
+                    if ((itA != endA && itB != endB && *itA < *itB) ||
+                            itB == endB) {
 
-                // remove a version from the database
-                const bool result = removeResourceVersionImpl(itB->resourceId, itB->version, storage);
-                KIS_SAFE_ASSERT_RECOVER_NOOP(result);
-                resourceIdForUpdate.insert(itB->resourceId);
-                ++itB;
+                        // add a version to the database
 
-            } else {
-                // resources are equal, just skip them
-                ++itA;
-                ++itB;
+                        KoResourceSP res = takeResource(*itA);
+                        if (res) {
+                            const bool result = addResourceVersionImpl(itA->resourceId, itA->timestamp, storage, res);
+                            KIS_SAFE_ASSERT_RECOVER_NOOP(result);
+
+                            resourceIdForUpdate.insert(itA->resourceId);
+                        }
+                        ++itA;
+
+                    } else if ((itA != endA && itB != endB && *itA > *itB) ||
+                               itA == endA) {
+
+                        // remove a version from the database
+                        const bool result = removeResourceVersionImpl(itB->resourceId, itB->version, storage);
+                        KIS_SAFE_ASSERT_RECOVER_NOOP(result);
+                        resourceIdForUpdate.insert(itB->resourceId);
+                        ++itB;
+
+                    } else {
+                        // resources are equal, just skip them
+                        ++itA;
+                        ++itB;
+                    }
+                }
+
+
+                /// In the main loop we modified the versioned_resource table only,
+                /// now we should update the head resources table with the latest
+                /// version of the resource
+
+                for (auto it = resourceIdForUpdate.begin(); it != resourceIdForUpdate.end(); ++it) {
+                    updateResourceTableForResourceIfNeeded(*it, resourceType, storage);
+                }
             }
-        }
 
+            /// Remember the state of the file, so that the next start can skip it
+
+            if (storageSuccess && !job.isNew) {
+                QSqlQuery q;
+                if (!q.prepare("UPDATE storages\n"
+                               "SET    timestamp = :timestamp\n"
+                               ",      file_size = :file_size\n"
+                               "WHERE  id = :storage_id\n")) {
+                    qWarning() << "Could not prepare update storage timestamp statement" << q.lastError();
+                }
+
+                q.bindValue(":timestamp", storage->timestamp().toSecsSinceEpoch());
+                q.bindValue(":file_size", storageFileSize(storage));
+                q.bindValue(":storage_id", int(storage->storageId()));
 
-        /// In the main loop we modified the versioned_resource table only,
-        /// now we should update the head resources table with the latest
-        /// version of the resource (and upload the thumbnail as well)
+                if (!q.exec()) {
+                    qWarning() << "Could not update storage timestamp" << q.boundValues() << q.lastError();
+                }
+            }
+
+            QSqlDatabase::database().commit();
 
-        for (auto it = resourceIdForUpdate.begin(); it != resourceIdForUpdate.end(); ++it) {
-            updateResourceTableForResourceIfNeeded(*it, resourceType, storage);
+            if (!storageSuccess) {
+                failedStorages << storage->location();
+                success = false;
+            }
+
+            debugResource << "Synchronized storage" << storage->location()
+                          << "scanning took" << job.scanTime << "ms,"
+                          << "updating the database took" << t.elapsed() << "ms";
+
+            // release the resources loaded for the storage
+            job = StorageSynchronizationJob();
         }
     }
 
-    QSqlDatabase::database().commit();
-    debugResource << "Synchronizing the storages took" << t.elapsed() << "milliseconds for" << storage->location();
+    KisUsageLogger::log(QString("Synchronizing %1 storages took %2 ms, %3 unchanged storages were skipped")
+                        .arg(storages.size())
+                        .arg(totalTimer.elapsed())
+                        .arg(numSkippedStorages));
 
     return success;
 }
@@ -94,6 +94,21 @@ private:
 
     static bool updateResourceTableForResourceIfNeeded(int resourceId, const QString &resourceType, KisResourceStorageSP storage);
     static bool makeResourceTheCurrentVersion(int resourceId, KoResourceSP resource);
+
+    /**
+     * Stores the thumbnail of the resource version with \p md5sum. The
+     * resources with the same content share it.
+     *
+     * The synchronization doesn't store the thumbnails, KisResourceLocator
+     * generates them from the storage the first time they are requested.
+     */
+    static bool addThumbnail(const QString &md5sum, const QImage &thumbnail);
+
+    /// @return the PNG data of the thumbnail for \p md5sum, or an empty array if there is none
+    static QByteArray thumbnailData(const QString &md5sum);
+
+    /// Removes the thumbnails of the resource versions that are no longer current anywhere
+    static bool removeUnusedThumbnails();
     static bool removeResourceCompletely(int resourceId);
 
     /// The function will find the resource only if it is the latest version
@@ -116,6 +131,9 @@ private:
     static bool addTags(KisResourceStorageSP storage, QString resourceType);
 
     static bool addStorage(KisResourceStorageSP storage, bool preinstalled);
+
+    /// Add the storage and its metadata to the database, but not its resources
+    static bool addStorageEntry(KisResourceStorageSP storage, bool preinstalled);
     static bool addStorageTags(KisResourceStorageSP storage);
 
     /// Actually delete the storage and all its resources from the database (i.e., nothing is set to inactive, it's deleted)
@@ -125,6 +143,20 @@ private:
     static bool deleteStorage(QString location);
     static bool synchronizeStorage(KisResourceStorageSP storage);
 
+    /**
+     * @brief synchronizeStorages synchronizes several storages with the database
+     *
+     * The storages are scanned on the global thread pool: the resources they contain
+     * are listed, and the resources unknown to the database are loaded and their md5
+     * sums calculated. All the database writes happen on the calling thread afterwards.
+     *
+     * @param skipUnchanged if true, a bundle or Adobe library whose modification time
+     *  and size are the same as at the last synchronization will not be scanned at all
+     * @param failedStorages the locations of the storages that could not be synchronized
+     * @return true if all the storages were synchronized
+     */
+    static bool synchronizeStorages(const QList<KisResourceStorageSP> &storages, bool skipUnchanged, QStringList &failedStorages);
+
     /**
      * @brief metaDataForId
      * @param id
@@ -18,6 +18,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QBuffer>
+#include <QtConcurrent>
 
 #include <kconfig.h>
 #include <kconfiggroup.h>
@@ -43,21 +44,45 @@
 #include "ResourceDebug.h"
 
 const QString KisResourceLocator::resourceLocationKey {"ResourceDirectory"};
+const QString KisResourceLocator::resourceCacheMemoryLimitKey {"ResourceCacheMemoryLimit"};
+
+namespace {
+qint64 resourceCacheMemoryLimitFromConfig()
+{
+    KConfigGroup cfg(KSharedConfig::openConfig(), "");
+    return cfg.readEntry(KisResourceLocator::resourceCacheMemoryLimitKey, 256) * 1024 * 1024;
+}
+}
 
 class KisResourceLocator::Private {
 public:
     QString resourceLocation;
     QMap<QString, KisResourceStorageSP> storages;
-    QHash<QPair<QString, QString>, KoResourceSP> resourceCache;
+    KisResourceLruCache resourceCache {resourceCacheMemoryLimitFromConfig()};
     QMap<QPair<QString, QString>, QImage> thumbnailCache;
+    /// the thumbnails scaled down for the choosers, see KisResourceThumbnailLoader
+    QMap<QPair<QString, QString>, QImage> previewCache;
+    KisResourceThumbnailLoader thumbnailLoader;
     QMap<QPair<QString, QString>, KisTagSP> tagCache;
     QStringList errorMessages;
+
+    void setThumbnail(const QPair<QString, QString> &key, const QImage &image) {
+        thumbnailCache[key] = image;
+        previewCache.remove(key);
+    }
+
+    void removeThumbnail(const QPair<QString, QString> &key) {
+        thumbnailCache.remove(key);
+        previewCache.remove(key);
+    }
 };
 
 KisResourceLocator::KisResourceLocator(QObject *parent)
     : QObject(parent)
     , d(new Private())
 {
+    connect(&d->thumbnailLoader, &KisResourceThumbnailLoader::thumbnailsLoaded,
+            this, &KisResourceLocator::slotThumbnailsLoaded);
 }
 
 KisResourceLocator *KisResourceLocator::instance()
@@ -115,6 +140,10 @@ KisResourceLocator::LocatorError KisResourceLocator::initialize(const QString &i
         }
     }
 
+    // After an update the storages may contain resource types unknown to the
+    // previous version, so every storage should be scanned once
+    const bool skipUnchangedStorages = initializationStatus == InitializationStatus::Initialized;
+
     if (initializationStatus != InitializationStatus::Initialized) {
         KisResourceLocator::LocatorError res = firstTimeInstallation(initializationStatus, installationResourcesLocation);
         if (res != LocatorError::Ok) {
@@ -123,7 +152,7 @@ KisResourceLocator::LocatorError KisResourceLocator::initialize(const QString &i
         initializationStatus = InitializationStatus::Initialized;
     }
 
-    if (!synchronizeDb()) {
+    if (!synchronizeDb(skipUnchangedStorages)) {
         return LocatorError::CannotSynchronizeDb;
     }
 
@@ -153,7 +182,7 @@ void KisResourceLocator::cacheThumbnail(QString storageLocation, const QString &
     storageLocation = makeStorageLocationAbsolute(storageLocation);
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + filename);
 
-    d->thumbnailCache[key] = img;
+    d->setThumbnail(key, img);
 }
 
 QImage KisResourceLocator::thumbnailCached(QString storageLocation, const QString &resourceType, const QString &filename)
@@ -166,6 +195,98 @@ QImage KisResourceLocator::thumbnailCached(QString storageLocation, const QStrin
     return QImage();
 }
 
+QImage KisResourceLocator::thumbnail(QString storageLocation, const QString &resourceType, const QString &filename,
+                                     const QString &md5sum, int resourceId)
+{
+    storageLocation = makeStorageLocationAbsolute(storageLocation);
+    QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + filename);
+
+    // the choosers get a scaled down copy, everybody else the full thumbnail
+    const bool asynchronous = KisResourceThumbnailLoader::asynchronousLoadingAllowed();
+
+    if (asynchronous) {
+        auto previewIt = d->previewCache.constFind(key);
+        if (previewIt != d->previewCache.constEnd()) {
+            return *previewIt;
+        }
+    }
+
+    auto it = d->thumbnailCache.constFind(key);
+    if (it != d->thumbnailCache.constEnd()) {
+        if (!asynchronous) {
+            return *it;
+        }
+
+        QImage preview = KisResourceThumbnailLoader::scaledPreview(*it);
+        d->previewCache[key] = preview;
+        return preview;
+    }
+
+    if (asynchronous && d->thumbnailLoader.isPending(key)) {
+        return QImage();
+    }
+
+    const QByteArray data = KisResourceCacheDb::thumbnailData(md5sum);
+
+    if (data.isEmpty()) {
+        /**
+         * The thumbnail is generated the first time it is requested. The
+         * storages are not thread-safe, so the resource is loaded right here
+         * even inside an asynchronous scope. It is not put into the resource
+         * cache, since it is usually only displayed in a chooser.
+         */
+        KisResourceStorageSP storage = d->storages.value(storageLocation);
+        KoResourceSP resource = storage ? storage->resource(resourceType + "/" + filename) : KoResourceSP();
+
+        QImage img = resource ? resource->thumbnail() : QImage();
+        if (!img.isNull()) {
+            KisResourceCacheDb::addThumbnail(md5sum, img);
+        }
+
+        d->thumbnailCache[key] = img;
+
+        if (asynchronous) {
+            QImage preview = KisResourceThumbnailLoader::scaledPreview(img);
+            d->previewCache[key] = preview;
+            return preview;
+        }
+
+        return img;
+    }
+
+    if (asynchronous) {
+        KisResourceThumbnailLoader::Request request;
+        request.key = key;
+        request.resourceType = resourceType;
+        request.resourceId = resourceId;
+        request.data = data;
+
+        d->thumbnailLoader.enqueue(request);
+        return QImage();
+    }
+
+    QImage img = KisResourceThumbnailLoader::decode(data);
+    d->thumbnailCache[key] = img;
+    return img;
+}
+
+void KisResourceLocator::slotThumbnailsLoaded(const QVector<KisResourceThumbnailLoader::Request> &requests)
+{
+    QMap<QString, QVector<int>> loadedResources;
+
+    Q_FOREACH (const KisResourceThumbnailLoader::Request &request, requests) {
+        // the resource has been loaded or updated in the meantime
+        if (!d->thumbnailCache.contains(request.key) && !d->previewCache.contains(request.key)) {
+            d->previewCache[request.key] = request.image;
+        }
+        loadedResources[request.resourceType].append(request.resourceId);
+    }
+
+    for (auto it = loadedResources.constBegin(); it != loadedResources.constEnd(); ++it) {
+        Q_EMIT resourceThumbnailsLoaded(it.key(), it.value());
+    }
+}
+
 void KisResourceLocator::loadRequiredResources(KoResourceSP resource)
 {
     QList<KoResourceLoadResult> requiredResources = resource->requiredResources(KisGlobalResourcesInterface::instance());
@@ -328,11 +449,8 @@ KoResourceSP KisResourceLocator::resource(QString storageLocation, const QString
 
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + filename);
 
-    KoResourceSP resource;
-    if (d->resourceCache.contains(key)) {
-        resource = d->resourceCache[key];
-    }
-    else {
+    KoResourceSP resource = d->resourceCache.resource(key);
+    if (!resource) {
         KisResourceStorageSP storage = d->storages[storageLocation];
         if (!storage) {
             qWarning() << "Could not find storage" << storageLocation;
@@ -342,7 +460,7 @@ KoResourceSP KisResourceLocator::resource(QString storageLocation, const QString
         resource = storage->resource(resourceType + "/" + filename);
 
         if (resource) {
-            d->resourceCache[key] = resource;
+            d->resourceCache.insert(key, resource);
             // load all the embedded resources into temporary "memory" storage
             loadRequiredResources(resource);
             resource->updateLinkedResourcesMetaData(KisGlobalResourcesInterface::instance());
@@ -428,8 +546,8 @@ bool KisResourceLocator::setResourceActive(int resourceId, bool active)
     QPair<QString, QString> key = QPair<QString, QString> (rs.storageLocation, rs.resourceType + "/" + rs.resourceFileName);
 
     d->resourceCache.remove(key);
-    if (!active && d->thumbnailCache.contains(key)) {
-        d->thumbnailCache.remove(key);
+    if (!active) {
+        d->removeThumbnail(key);
     }
 
     bool result = KisResourceCacheDb::setResourceActive(resourceId, active);
@@ -594,8 +712,8 @@ KoResourceSP KisResourceLocator::importResource(const QString &resourceType, con
         const QString absoluteStorageLocation = makeStorageLocationAbsolute(resource->storageLocation());
         const QPair<QString, QString> key = {absoluteStorageLocation, resourceType + "/" + resource->filename()};
         // Add to the cache
-        d->resourceCache[key] = resource;
-        d->thumbnailCache[key] = resource->thumbnail();
+        d->resourceCache.insert(key, resource);
+        d->setThumbnail(key, resource->thumbnail());
 
         return resource;
     }
@@ -650,7 +768,7 @@ bool KisResourceLocator::addResource(const QString &resourceType, const KoResour
     resource->setDirty(false);
     resource->updateLinkedResourcesMetaData(KisGlobalResourcesInterface::instance());
 
-    d->resourceCache[QPair<QString, QString>(storageLocation, resourceType + "/" + resource->filename())] = resource;
+    d->resourceCache.insert(QPair<QString, QString>(storageLocation, resourceType + "/" + resource->filename()), resource);
 
     // And the database
     const bool result = KisResourceCacheDb::addResource(storage,
@@ -675,7 +793,7 @@ bool KisResourceLocator::updateResource(const QString &resourceType, const KoRes
     if (!storage->supportsVersioning()) return false;
 
     // remove older version
-    d->thumbnailCache.remove(QPair<QString, QString> (storageLocation, resourceType + "/" + resource->filename()));
+    d->removeThumbnail(QPair<QString, QString> (storageLocation, resourceType + "/" + resource->filename()));
 
     resource->updateThumbnail();
     resource->setVersion(resource->version() + 1);
@@ -703,8 +821,8 @@ bool KisResourceLocator::updateResource(const QString &resourceType, const KoRes
 
     // Update the resource in the cache
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + resource->filename());
-    d->resourceCache[key] = resource;
-    d->thumbnailCache[key] = resource->thumbnail();
+    d->resourceCache.insert(key, resource);
+    d->setThumbnail(key, resource->thumbnail());
 
     return true;
 }
@@ -728,9 +846,10 @@ bool KisResourceLocator::reloadResource(const QString &resourceType, const KoRes
     resource->setDirty(false);
     resource->updateLinkedResourcesMetaData(KisGlobalResourcesInterface::instance());
 
-    // We haven't changed the version of the resource, so the cache must be still valid
+    // We haven't changed the version of the resource, so the cache must be still valid,
+    // though the cache may have already evicted the resource
     QPair<QString, QString> key = QPair<QString, QString> (storageLocation, resourceType + "/" + resource->filename());
-    Q_ASSERT(d->resourceCache[key] == resource);
+    Q_ASSERT(!d->resourceCache.contains(key) || d->resourceCache.resource(key) == resource);
 
     return true;
 }
@@ -775,14 +894,36 @@ void KisResourceLocator::setMetaDataForStorage(const QString &storageLocation, Q
 
 void KisResourceLocator::purge(const QString &storageLocation)
 {
-    Q_FOREACH(const auto key, d->resourceCache.keys()) {
-        if (key.first == storageLocation) {
-            d->resourceCache.take(key);
-            d->thumbnailCache.take(key);
+    d->resourceCache.removeStorage(storageLocation);
+    d->thumbnailLoader.cancel(storageLocation);
+
+    for (auto it = d->thumbnailCache.begin(); it != d->thumbnailCache.end();) {
+        if (it.key().first == storageLocation) {
+            it = d->thumbnailCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = d->previewCache.begin(); it != d->previewCache.end();) {
+        if (it.key().first == storageLocation) {
+            it = d->previewCache.erase(it);
+        } else {
+            ++it;
         }
     }
 }
 
+void KisResourceLocator::setResourceCacheMemoryLimit(qint64 bytes)
+{
+    d->resourceCache.setMemoryLimit(bytes);
+}
+
+KisResourceLruCache::Statistics KisResourceLocator::resourceCacheStatistics() const
+{
+    return d->resourceCache.statistics();
+}
+
 bool KisResourceLocator::addStorage(const QString &storageLocation, KisResourceStorageSP storage)
 {
     if (d->storages.contains(storageLocation)) {
@@ -1041,9 +1182,27 @@ void KisResourceLocator::findStorages()
     // And add bundles and adobe libraries
     QStringList filters = QStringList() << "*.bundle" << "*.abr" << "*.asl";
     QDirIterator iter(d->resourceLocation, filters, QDir::Files, QDirIterator::Subdirectories);
+
+    QVector<QPair<QString, KisResourceStorageSP>> fileStorages;
     while (iter.hasNext()) {
         iter.next();
-        KisResourceStorageSP storage = QSharedPointer<KisResourceStorage>::create(iter.filePath());
+        fileStorages.append(qMakePair(iter.filePath(), KisResourceStorageSP()));
+    }
+
+    // opening a bundle reads its manifest and an Adobe library may be read
+    // completely, so open them all in parallel
+    auto openStorage = [] (QPair<QString, KisResourceStorageSP> &fileStorage) {
+        fileStorage.second = QSharedPointer<KisResourceStorage>::create(fileStorage.first);
+    };
+
+    if (fileStorages.size() > 1) {
+        QtConcurrent::blockingMap(fileStorages, openStorage);
+    } else {
+        std::for_each(fileStorages.begin(), fileStorages.end(), openStorage);
+    }
+
+    for (auto it = fileStorages.begin(); it != fileStorages.end(); ++it) {
+        KisResourceStorageSP storage = it->second;
         if (!storage->valid()) {
             // we still add the storage to the list and try to read whatever possible
             qWarning() << "KisResourceLocator::findStorages: the storage is invalid" << storage->location();
@@ -1146,7 +1305,7 @@ QString KisResourceLocator::makeStorageLocationAbsolute(QString storageLocation)
     return storageLocation;
 }
 
-bool KisResourceLocator::synchronizeDb()
+bool KisResourceLocator::synchronizeDb(bool skipUnchangedStorages)
 {
     d->errorMessages.clear();
 
@@ -1157,10 +1316,11 @@ bool KisResourceLocator::synchronizeDb()
 
 
     findStorages();
-    Q_FOREACH(const KisResourceStorageSP storage, d->storages) {
-        if (!KisResourceCacheDb::synchronizeStorage(storage)) {
-            d->errorMessages.append(i18n("Could not synchronize %1 with the database", storage->location()));
-        }
+
+    QStringList failedStorages;
+    KisResourceCacheDb::synchronizeStorages(d->storages.values(), skipUnchangedStorages, failedStorages);
+    Q_FOREACH(const QString &location, failedStorages) {
+        d->errorMessages.append(i18n("Could not synchronize %1 with the database", location));
     }
 
     Q_FOREACH(const KisResourceStorageSP storage, d->storages) {
@@ -1191,6 +1351,7 @@ bool KisResourceLocator::synchronizeDb()
         }
     }
 
+    KisResourceCacheDb::removeUnusedThumbnails();
 
     d->resourceCache.clear();
     return d->errorMessages.isEmpty();
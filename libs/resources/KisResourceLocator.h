@@ -15,6 +15,8 @@
 #include "kritaresources_export.h"
 
 #include <KisResourceStorage.h>
+#include <KisResourceLruCache.h>
+#include <KisResourceThumbnailLoader.h>
 
 
 /**
@@ -40,6 +42,10 @@ public:
     // can be changed.
     static const QString resourceLocationKey;
 
+    // The configuration key that holds the memory budget, in MiB,
+    // of the cache of the loaded resources
+    static const QString resourceCacheMemoryLimitKey;
+
     static KisResourceLocator *instance();
 
     ~KisResourceLocator();
@@ -78,6 +84,16 @@ public:
      */
     void purge(const QString &storageLocation);
 
+    /**
+     * @brief setResourceCacheMemoryLimit sets the memory budget of the cache
+     * of the loaded resources. The least recently used resources are dropped
+     * from the cache when it grows over the budget.
+     */
+    void setResourceCacheMemoryLimit(qint64 bytes);
+
+    /// @return the statistics of the cache of the loaded resources, for the memory reporting
+    KisResourceLruCache::Statistics resourceCacheStatistics() const;
+
     /**
      * @brief addStorage Adds a new resource storage to the database. The storage is
      * will be marked as not pre-installed. If there is already a storage with the
@@ -139,6 +155,13 @@ Q_SIGNALS:
     /// Emitted when a resource changes its active state
     void resourceActiveStateChanged(const QString &resourceType, int resourceId);
 
+    /// Emitted when the thumbnails decoded in the background are ready
+    void resourceThumbnailsLoaded(const QString &resourceType, const QVector<int> &resourceIds);
+
+private Q_SLOTS:
+
+    void slotThumbnailsLoaded(const QVector<KisResourceThumbnailLoader::Request> &requests);
+
 private:
 
     friend class KisAllTagsModel;
@@ -163,6 +186,19 @@ private:
     /// @return a valid image if the thumbnail is present in the cache, an invalid image otherwise
     QImage thumbnailCached(QString storageLocation, const QString &resourceType, const QString &filename);
 
+    /**
+     * @return the thumbnail of the current version of the resource, loading it
+     * from the database if needed. Inside KisResourceThumbnailLoader::AsynchronousScope
+     * a thumbnail that isn't cached yet is decoded in the background and a null
+     * image is returned, resourceThumbnailsLoaded() is emitted when it is ready.
+     *
+     * If the database has no thumbnail for \p md5sum yet, the resource is
+     * loaded from its storage, and its thumbnail is stored in the database
+     * and returned right away.
+     */
+    QImage thumbnail(QString storageLocation, const QString &resourceType, const QString &filename,
+                     const QString &md5sum, int resourceId);
+
     /**
      * @brief resource finds a physical resource in one of the storages
      * @param storageLocation the storage containing the resource. If empty,
@@ -324,7 +360,8 @@ private:
     bool initializeDb();
 
     // Synchronize on restarting Krita to see whether the user has added any storages or resources to the resources location
-    bool synchronizeDb();
+    // If skipUnchangedStorages is true, the bundles and libraries that have not changed since the last synchronization are not scanned
+    bool synchronizeDb(bool skipUnchangedStorages = false);
 
     void findStorages();
     QList<KisResourceStorageSP> storages() const;
@@ -0,0 +1,165 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisResourceLruCache.h"
+
+#include <QWeakPointer>
+
+#include <kis_assert.h>
+
+#include "ResourceDebug.h"
+
+KisResourceLruCache::KisResourceLruCache(qint64 memoryLimit)
+    : m_memoryLimit(memoryLimit)
+{
+}
+
+void KisResourceLruCache::setMemoryLimit(qint64 memoryLimit)
+{
+    m_memoryLimit = memoryLimit;
+    evict();
+}
+
+qint64 KisResourceLruCache::memoryLimit() const
+{
+    return m_memoryLimit;
+}
+
+bool KisResourceLruCache::contains(const Key &key) const
+{
+    return m_entries.contains(key);
+}
+
+KoResourceSP KisResourceLruCache::resource(const Key &key)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_hits++;
+
+        KoResourceSP resource = it->resource;
+        touch(*it);
+        updateSize(*it);
+        evict();
+
+        return resource;
+    }
+
+    m_misses++;
+    return KoResourceSP();
+}
+
+void KisResourceLruCache::insert(const Key &key, KoResourceSP resource)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(resource);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        m_order.push_front(key);
+
+        Entry entry;
+        entry.position = m_order.begin();
+        it = m_entries.insert(key, entry);
+    } else {
+        touch(*it);
+    }
+
+    it->resource = resource;
+    updateSize(*it);
+
+    evict();
+}
+
+void KisResourceLruCache::remove(const Key &key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+
+    m_memorySize -= it->size;
+    m_order.erase(it->position);
+    m_entries.erase(it);
+}
+
+void KisResourceLruCache::removeStorage(const QString &storageLocation)
+{
+    Q_FOREACH (const Key &key, m_entries.keys()) {
+        if (key.first == storageLocation) {
+            remove(key);
+        }
+    }
+}
+
+void KisResourceLruCache::clear()
+{
+    m_order.clear();
+    m_entries.clear();
+    m_memorySize = 0;
+}
+
+KisResourceLruCache::Statistics KisResourceLruCache::statistics() const
+{
+    Statistics stats;
+    stats.memorySize = m_memorySize;
+    stats.memoryLimit = m_memoryLimit;
+    stats.numResources = m_entries.size();
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+
+    Q_FOREACH (const Entry &entry, m_entries) {
+        if (entry.resource->isDirty() || entry.inUse) {
+            stats.numPinned++;
+        }
+    }
+
+    return stats;
+}
+
+void KisResourceLruCache::touch(Entry &entry)
+{
+    m_order.splice(m_order.begin(), m_order, entry.position);
+}
+
+void KisResourceLruCache::updateSize(Entry &entry)
+{
+    const qint64 size = entry.resource->memoryFootprint();
+    m_memorySize += size - entry.size;
+    entry.size = size;
+}
+
+void KisResourceLruCache::evict()
+{
+    auto orderIt = m_order.end();
+
+    while (m_memorySize > m_memoryLimit && orderIt != m_order.begin()) {
+        --orderIt;
+
+        auto it = m_entries.find(*orderIt);
+        KIS_SAFE_ASSERT_RECOVER(it != m_entries.end()) { break; }
+
+        // the user has changed the resource, but hasn't saved it yet
+        if (it->resource->isDirty()) continue;
+
+        /**
+         * QSharedPointer doesn't expose its reference count, so drop our
+         * reference and check if the resource is still alive. If somebody
+         * else holds it, take it back and keep it in the cache.
+         */
+        QWeakPointer<KoResource> weakResource = it->resource.toWeakRef();
+        it->resource.reset();
+
+        it->resource = weakResource.toStrongRef();
+        it->inUse = bool(it->resource);
+        if (it->inUse) continue;
+
+        debugResource << "Evicting resource from the cache" << it.key() << it->size;
+
+        m_memorySize -= it->size;
+        m_evictions++;
+
+        m_entries.erase(it);
+        orderIt = m_order.erase(orderIt);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISRESOURCELRUCACHE_H
+#define KISRESOURCELRUCACHE_H
+
+#include "kritaresources_export.h"
+
+#include <list>
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+#include <KoResource.h>
+
+/**
+ * The cache of the resources loaded by KisResourceLocator.
+ *
+ * The cache keeps the resources within a memory budget, the least recently
+ * used ones are dropped first. The size of every resource is estimated with
+ * KoResource::memoryFootprint() and updated whenever the resource is
+ * fetched from the cache, since e.g. the brushes build their mipmaps lazily.
+ *
+ * Some resources are never dropped:
+ *
+ * - the dirty resources, otherwise the changes the user has made to a
+ *   preset would be lost when switching to another one
+ *
+ * - the resources that are still used somewhere else. Dropping them would
+ *   free no memory, and the resource would be loaded the second time on
+ *   the next request. Two copies of one resource diverge as soon as one of
+ *   them is changed, and the changes to the evicted copy would be lost as
+ *   soon as its last user releases it.
+ *
+ * The cache is not thread-safe, just like the resource locator itself.
+ */
+class KRITARESOURCES_EXPORT KisResourceLruCache
+{
+public:
+    using Key = QPair<QString, QString>;
+
+    struct Statistics {
+        qint64 memorySize = 0;   ///< the estimated size of the resources owned by the cache
+        qint64 memoryLimit = 0;
+        int numResources = 0;    ///< the resources owned by the cache
+        int numPinned = 0;       ///< the dirty resources and the ones the last eviction found still in use
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+    };
+
+public:
+    explicit KisResourceLruCache(qint64 memoryLimit);
+
+    void setMemoryLimit(qint64 memoryLimit);
+    qint64 memoryLimit() const;
+
+    /**
+     * @return true if the resource is loaded
+     */
+    bool contains(const Key &key) const;
+
+    /**
+     * @return the resource for \p key and marks it as the most recently
+     *         used one, or a null pointer if the resource is not loaded
+     */
+    KoResourceSP resource(const Key &key);
+
+    /**
+     * Adds or replaces the resource for \p key and evicts the least
+     * recently used resources if the cache has grown over its limit
+     */
+    void insert(const Key &key, KoResourceSP resource);
+
+    void remove(const Key &key);
+
+    /**
+     * Removes all the resources that belong to \p storageLocation
+     */
+    void removeStorage(const QString &storageLocation);
+
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    struct Entry {
+        KoResourceSP resource;
+        qint64 size = 0;
+        std::list<Key>::iterator position;
+        bool inUse = false;
+    };
+
+    void touch(Entry &entry);
+    void updateSize(Entry &entry);
+    void evict();
+
+private:
+    qint64 m_memoryLimit;
+    qint64 m_memorySize = 0;
+
+    /// the most recently used resource is at the front
+    std::list<Key> m_order;
+    QHash<Key, Entry> m_entries;
+
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+    qint64 m_evictions = 0;
+};
+
+#endif // KISRESOURCELRUCACHE_H
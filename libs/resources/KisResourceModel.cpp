@@ -48,6 +48,7 @@ KisAllResourcesModel::KisAllResourcesModel(const QString &resourceType, QObject
     connect(KisResourceLocator::instance(), SIGNAL(beginExternalResourceRemove(QString, QVector<int>)), this, SLOT(beginExternalResourceRemove(QString, QVector<int>)));
     connect(KisResourceLocator::instance(), SIGNAL(endExternalResourceRemove(QString)), this, SLOT(endExternalResourceRemove(QString)));
     connect(KisResourceLocator::instance(), SIGNAL(resourceActiveStateChanged(QString, int)), this, SLOT(slotResourceActiveStateChanged(QString, int)));
+    connect(KisResourceLocator::instance(), SIGNAL(resourceThumbnailsLoaded(QString, QVector<int>)), this, SLOT(slotResourceThumbnailsLoaded(QString, QVector<int>)));
 
     d->resourceType = resourceType;
 
@@ -56,7 +57,6 @@ KisAllResourcesModel::KisAllResourcesModel(const QString &resourceType, QObject
                                        ",      resources.name\n"
                                        ",      resources.filename\n"
                                        ",      resources.tooltip\n"
-                                       ",      resources.thumbnail\n"
                                        ",      resources.status\n"
                                        ",      resources.md5sum\n"
                                        ",      storages.location\n"
@@ -671,6 +671,30 @@ void KisAllResourcesModel::slotResourceActiveStateChanged(const QString &resourc
     }
 }
 
+void KisAllResourcesModel::slotResourceThumbnailsLoaded(const QString &resourceType, const QVector<int> &resourceIds)
+{
+    if (resourceType != d->resourceType) return;
+    if (!d->resourcesQuery.first()) return;
+
+    QSet<int> ids;
+    Q_FOREACH (int resourceId, resourceIds) {
+        ids.insert(resourceId);
+    }
+
+    // collect the rows first, the views will seek the query in dataChanged()
+    QVector<int> rows;
+    do {
+        if (ids.contains(d->resourcesQuery.value("id").toInt())) {
+            rows << d->resourcesQuery.at();
+        }
+    } while (d->resourcesQuery.next());
+
+    Q_FOREACH (int row, rows) {
+        Q_EMIT dataChanged(index(row, 0), index(row, Thumbnail),
+                           {Qt::DecorationRole, Qt::UserRole + KisAbstractResourceModel::Thumbnail});
+    }
+}
+
 struct KisResourceModel::Private
 {
     ResourceFilter resourceFilter {ShowActiveResources};
@@ -305,6 +305,12 @@ private Q_SLOTS:
      */
     void slotResourceActiveStateChanged(const QString &resourceType, int resourceId);
 
+    /**
+     * A slot that is called by KisResourceLocator when the thumbnails
+     * decoded in the background are ready
+     */
+    void slotResourceThumbnailsLoaded(const QString &resourceType, const QVector<int> &resourceIds);
+
 public:
 
     KoResourceSP resourceForId(int id) const;
@@ -8,7 +8,6 @@
 #include <QVariant>
 #include <QImage>
 #include <QByteArray>
-#include <QBuffer>
 #include <QDebug>
 #include <QSqlError>
 
@@ -25,17 +24,10 @@ QImage KisResourceQueryMapper::getThumbnailFromQuery(const QSqlQuery &query, boo
     QString resourceType = query.value("resource_type").toString();
     QString filename = query.value(useResourcePrefix ? "resource_filename" : "filename").toString();
 
-    QImage img = KisResourceLocator::instance()->thumbnailCached(storageLocation, resourceType, filename);
-    if (!img.isNull()) {
-        return img;
-    } else {
-        QByteArray ba = query.value(useResourcePrefix ? "resource_thumbnail" : "thumbnail").toByteArray();
-        QBuffer buf(&ba);
-        buf.open(QBuffer::ReadOnly);
-        img.load(&buf, "PNG");
-        KisResourceLocator::instance()->cacheThumbnail(storageLocation, resourceType, filename, img);
-        return img;
-    }
+    QString md5sum = query.value(useResourcePrefix ? "resource_md5sum" : "md5sum").toString();
+    int resourceId = query.value(useResourcePrefix ? "resource_id" : "id").toInt();
+
+    return KisResourceLocator::instance()->thumbnail(storageLocation, resourceType, filename, md5sum, resourceId);
 }
 
 QVariant KisResourceQueryMapper::variantFromResourceQuery(const QSqlQuery &query, int column, int role, bool useResourcePrefix)
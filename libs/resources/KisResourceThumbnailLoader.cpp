@@ -0,0 +1,130 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisResourceThumbnailLoader.h"
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <kis_assert.h>
+
+namespace {
+// the scopes are created by the item delegates, so on the GUI thread only
+int s_asynchronousScopes = 0;
+
+// the views are updated with all the thumbnails decoded within this time
+const int deliveryInterval = 50;
+}
+
+KisResourceThumbnailLoader::AsynchronousScope::AsynchronousScope()
+{
+    s_asynchronousScopes++;
+}
+
+KisResourceThumbnailLoader::AsynchronousScope::~AsynchronousScope()
+{
+    s_asynchronousScopes--;
+}
+
+KisResourceThumbnailLoader::KisResourceThumbnailLoader(QObject *parent)
+    : QObject(parent)
+{
+    // leave some cores to the strokes, which use the global pool
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+    m_deliveryTimer.setSingleShot(true);
+    m_deliveryTimer.setInterval(deliveryInterval);
+    connect(&m_deliveryTimer, SIGNAL(timeout()), SLOT(slotDeliverThumbnails()));
+}
+
+KisResourceThumbnailLoader::~KisResourceThumbnailLoader()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+bool KisResourceThumbnailLoader::asynchronousLoadingAllowed()
+{
+    return s_asynchronousScopes > 0 && qApp && QThread::currentThread() == qApp->thread();
+}
+
+QImage KisResourceThumbnailLoader::decode(const QByteArray &data)
+{
+    QImage image;
+    image.loadFromData(data, "PNG");
+    return image;
+}
+
+QImage KisResourceThumbnailLoader::scaledPreview(const QImage &image)
+{
+    if (image.width() <= maxPreviewSize && image.height() <= maxPreviewSize) {
+        return image;
+    }
+
+    return image.scaled(maxPreviewSize, maxPreviewSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+bool KisResourceThumbnailLoader::isPending(const Key &key) const
+{
+    return m_pending.contains(key);
+}
+
+void KisResourceThumbnailLoader::enqueue(const Request &request)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_pending.contains(request.key));
+
+    m_pending.insert(request.key);
+
+    QtConcurrent::run(&m_pool, [this, request] () mutable {
+        request.image = scaledPreview(decode(request.data));
+        request.data.clear();
+
+        QMutexLocker locker(&m_finishedLock);
+        m_finished.append(request);
+
+        // the timer is already running otherwise
+        if (m_finished.size() == 1) {
+            QMetaObject::invokeMethod(&m_deliveryTimer, "start", Qt::QueuedConnection);
+        }
+    });
+}
+
+void KisResourceThumbnailLoader::cancel(const QString &storageLocation)
+{
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->first == storageLocation) {
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KisResourceThumbnailLoader::slotDeliverThumbnails()
+{
+    QVector<Request> finished;
+
+    {
+        QMutexLocker locker(&m_finishedLock);
+        std::swap(finished, m_finished);
+    }
+
+    QVector<Request> delivered;
+    delivered.reserve(finished.size());
+
+    Q_FOREACH (const Request &request, finished) {
+        // the request has been cancelled
+        if (!m_pending.remove(request.key)) continue;
+
+        delivered.append(request);
+    }
+
+    if (!delivered.isEmpty()) {
+        emit thumbnailsLoaded(delivered);
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISRESOURCETHUMBNAILLOADER_H
+#define KISRESOURCETHUMBNAILLOADER_H
+
+#include "kritaresources_export.h"
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * Decodes the thumbnails stored in the resource cache database on a pool
+ * of background threads.
+ *
+ * The models return the thumbnails that are not decoded yet as null images
+ * only while an AsynchronousScope object exists, that is, while an item
+ * delegate paints the chooser. The model emits dataChanged() as soon as the
+ * thumbnail is ready. Everybody else, e.g. the scripts or the bundle creator,
+ * still gets the thumbnail synchronously.
+ *
+ * The finished thumbnails are delivered in batches, so that the views are
+ * not updated for every single item.
+ *
+ * The choosers never show the thumbnails bigger than maxPreviewSize, so the
+ * decoded images are scaled down to it. The database keeps them at full
+ * size for everybody else.
+ */
+class KRITARESOURCES_EXPORT KisResourceThumbnailLoader : public QObject
+{
+    Q_OBJECT
+public:
+    using Key = QPair<QString, QString>;
+
+    struct Request {
+        Key key;            ///< the key of the thumbnail in the locator's thumbnail cache
+        QString resourceType;
+        int resourceId = -1;
+        QByteArray data;    ///< the PNG data from the database
+        QImage image;       ///< the decoded and scaled thumbnail, filled in by the worker thread
+    };
+
+    /**
+     * Allows the models to return null images for the thumbnails that are
+     * still being decoded. Create it on the stack in the delegate's paint().
+     */
+    class KRITARESOURCES_EXPORT AsynchronousScope
+    {
+    public:
+        AsynchronousScope();
+        ~AsynchronousScope();
+    };
+
+public:
+    explicit KisResourceThumbnailLoader(QObject *parent = nullptr);
+    ~KisResourceThumbnailLoader() override;
+
+    /// @return true if the caller can handle a thumbnail that is not ready yet
+    static bool asynchronousLoadingAllowed();
+
+    static const int maxPreviewSize = 256;
+
+    static QImage decode(const QByteArray &data);
+
+    /// @return \p image scaled down to fit maxPreviewSize
+    static QImage scaledPreview(const QImage &image);
+
+    bool isPending(const Key &key) const;
+
+    /**
+     * Starts decoding the thumbnail in the background, the result is
+     * delivered with thumbnailsLoaded()
+     */
+    void enqueue(const Request &request);
+
+    /**
+     * Drops the results of the pending requests for \p storageLocation,
+     * the threads that are already decoding them are not interrupted
+     */
+    void cancel(const QString &storageLocation);
+
+Q_SIGNALS:
+    void thumbnailsLoaded(const QVector<KisResourceThumbnailLoader::Request> &requests);
+
+private Q_SLOTS:
+    void slotDeliverThumbnails();
+
+private:
+    QSet<Key> m_pending;
+
+    QMutex m_finishedLock;
+    QVector<Request> m_finished;
+
+    QTimer m_deliveryTimer;
+    QThreadPool m_pool;
+};
+
+#endif // KISRESOURCETHUMBNAILLOADER_H
@@ -35,6 +35,7 @@ KisAllTagResourceModel::KisAllTagResourceModel(const QString &resourceType, QObj
     connect(KisStorageModel::instance(), SIGNAL(storageEnabled(const QString&)), this, SLOT(addStorage(const QString&)));
     connect(KisStorageModel::instance(), SIGNAL(storageDisabled(const QString&)), this, SLOT(removeStorage(const QString&)));
     connect(KisResourceLocator::instance(), SIGNAL(resourceActiveStateChanged(const QString&, int)), this, SLOT(slotResourceActiveStateChanged(const QString&, int)));
+    connect(KisResourceLocator::instance(), SIGNAL(resourceThumbnailsLoaded(const QString&, const QVector<int>&)), this, SLOT(slotResourceThumbnailsLoaded(const QString&, const QVector<int>&)));
 
     /**
      * TODO: connect to beginExternalResourceImport() and beginExternalResourceRemove
@@ -541,6 +542,32 @@ void KisAllTagResourceModel::slotResourceActiveStateChanged(const QString &resou
     }
 }
 
+void KisAllTagResourceModel::slotResourceThumbnailsLoaded(const QString &resourceType, const QVector<int> &resourceIds)
+{
+    if (resourceType != d->resourceType) return;
+    if (!d->query.first()) return;
+
+    QSet<int> ids;
+    Q_FOREACH (int resourceId, resourceIds) {
+        ids.insert(resourceId);
+    }
+
+    /// The model has multiple rows for every resource, one row per tag,
+    /// and the views will seek the query in dataChanged(), so collect
+    /// the rows first
+    QVector<int> rows;
+    do {
+        if (ids.contains(d->query.value("resource_id").toInt())) {
+            rows << d->query.at();
+        }
+    } while (d->query.next());
+
+    Q_FOREACH (int row, rows) {
+        const QModelIndex idx = this->index(row, 0);
+        Q_EMIT dataChanged(idx, idx, {Qt::DecorationRole, Qt::UserRole + KisAbstractResourceModel::Thumbnail});
+    }
+}
+
 QString KisAllTagResourceModel::createQuery(bool onlyActive, bool returnADbIndexToo)
 {
     QString query = QString("WITH initial_selection AS (\n"
@@ -579,7 +606,6 @@ QString KisAllTagResourceModel::createQuery(bool onlyActive, bool returnADbIndex
                             ",      tags.comment                   as tag_comment"
                             ",      resources.status               as resource_active\n"
                             ",      resources.tooltip              as resource_tooltip\n"
-                            ",      resources.thumbnail            as resource_thumbnail\n"
                             ",      resources.status               as resource_active\n"
                             ",      resources.storage_id           as storage_id\n"
                             ",      storages.active                as resource_storage_active\n"
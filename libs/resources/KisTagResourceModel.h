@@ -82,6 +82,7 @@ private Q_SLOTS:
     void removeStorage(const QString &location);
 
     void slotResourceActiveStateChanged(const QString &resourceType, int resourceId);
+    void slotResourceThumbnailsLoaded(const QString &resourceType, const QVector<int> &resourceIds);
 
 private:
 
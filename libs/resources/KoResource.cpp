@@ -136,6 +136,19 @@ QImage KoResource::thumbnail() const
     return image();
 }
 
+qint64 KoResource::memoryFootprint() const
+{
+    qint64 size = sizeof(*this) + sizeof(Private) + d->image.sizeInBytes();
+
+    size += (d->name.size() + d->filename.size() +
+             d->storageLocation.size() + d->md5sum.size()) * sizeof(QChar);
+
+    // a rough guess, most of the metadata values are short strings
+    size += d->metadata.size() * 128;
+
+    return size;
+}
+
 QString KoResource::thumbnailPath() const
 {
     return QString();
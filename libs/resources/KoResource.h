@@ -121,6 +121,14 @@ public:
      */
     virtual QString thumbnailPath() const;
 
+    /**
+     * @return the estimated number of bytes the resource occupies in memory.
+     * KisResourceLocator keeps the loaded resources within a memory budget
+     * using this estimation. Reimplement if the resource holds big data
+     * besides the image set with setImage().
+     */
+    virtual qint64 memoryFootprint() const;
+
     /**
      * @param generateIfEmpty: if the resource does not have an md5sum set,
      * if this is true, the resource saves itself into a buffer and calculates
@@ -5,7 +5,7 @@ CREATE TABLE IF NOT EXISTS resources (
 ,   name TEXT NOT NULL       /* the untranslatable name of the resource */
 ,   filename TEXT NOT NULL   /* the filename of the resource RELATIVE to the storage path and resource type */
 ,   tooltip TEXT             /* a translated text that can be shown in the UI */
-,   thumbnail BLOB           /* the image representing the resource visually*/
+,   thumbnail BLOB           /* unused, the thumbnails are stored in the thumbnails table keyed by md5sum */
 ,   status INTEGER           /* active resources are visible in the UI, inactive resources are considered "deleted" */
 ,   temporary INTEGER        /* temporary resources are removed from the database on startup */
 ,   md5sum TEXT              /* the original md5sum of the first version of this resource */
@@ -3,6 +3,7 @@ CREATE TABLE IF NOT EXISTS storages (
 ,   storage_type_id INTEGER
 ,   location TEXT
 ,   timestamp INTEGER
+,   file_size INTEGER NOT NULL DEFAULT -1  /* the size of the storage's file at the last synchronization, -1 for folders */
 ,   pre_installed INTEGER
 ,   active INTEGER
 ,   thumbnail BLOB           /* the image representing the storage visually*/
@@ -0,0 +1,4 @@
+CREATE TABLE IF NOT EXISTS thumbnails (
+    md5sum TEXT PRIMARY KEY  /* the md5sum of the resource version the thumbnail was made from */
+,   thumbnail BLOB           /* the image representing the resource visually, at full size */
+);
@@ -38,6 +38,7 @@ void TestResourceCacheDb::testCreateDatabase()
                                        << "storages"
                                        << "tags"
                                        << "resources"
+                                       << "thumbnails"
                                        << "versioned_resources"
                                        << "resource_tags";
     QStringList dbTables = sqlDb.tables();
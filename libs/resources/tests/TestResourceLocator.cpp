@@ -117,6 +117,50 @@ void TestResourceLocator::testLocatorSynchronization()
     }
 }
 
+void TestResourceLocator::testSkipUnchangedStorages()
+{
+    const QString bundleCondition =
+            "versioned_resources.storage_id IN (SELECT id FROM storages WHERE storage_type_id = "
+            + QString::number(static_cast<int>(KisResourceStorage::StorageType::Bundle)) + ")";
+
+    auto countBundleResources = [bundleCondition] () {
+        QSqlQuery q;
+        if (!q.exec("SELECT COUNT(*) FROM versioned_resources WHERE " + bundleCondition)) {
+            return -1;
+        }
+        q.first();
+        return q.value(0).toInt();
+    };
+
+    auto removeBundleResource = [bundleCondition] () {
+        QSqlQuery q;
+        return q.exec("DELETE FROM versioned_resources\n"
+                      "WHERE id = (SELECT MAX(id) FROM versioned_resources WHERE " + bundleCondition + ")");
+    };
+
+    const int numBundleResources = countBundleResources();
+    QVERIFY(numBundleResources > 0);
+
+    // the bundles have not changed since the last synchronization, so the database is not checked
+    QVERIFY(removeBundleResource());
+    QVERIFY(m_locator->synchronizeDb(true));
+    QCOMPARE(countBundleResources(), numBundleResources - 1);
+
+    // a full synchronization finds the missing resource
+    QVERIFY(m_locator->synchronizeDb(false));
+    QCOMPARE(countBundleResources(), numBundleResources);
+
+    // a bundle with a different size is scanned again
+    QVERIFY(removeBundleResource());
+    {
+        QSqlQuery q;
+        QVERIFY(q.exec("UPDATE storages SET file_size = file_size + 1 WHERE storage_type_id = "
+                       + QString::number(static_cast<int>(KisResourceStorage::StorageType::Bundle))));
+    }
+    QVERIFY(m_locator->synchronizeDb(true));
+    QCOMPARE(countBundleResources(), numBundleResources);
+}
+
 void TestResourceLocator::testResourceLocationBase()
 {
     QCOMPARE(m_locator->resourceLocationBase(), QString(FILES_DEST_DIR));
@@ -137,6 +181,38 @@ void TestResourceLocator::testResourceForId()
     QCOMPARE(res, res2);
 }
 
+void TestResourceLocator::testThumbnails()
+{
+    int resourceId = KisResourceCacheDb::resourceIdForResource("test1.kpp", ResourceType::PaintOpPresets, "");
+    QVERIFY(resourceId > -1);
+
+    QSqlQuery q;
+    QVERIFY(q.prepare("SELECT md5sum FROM resources WHERE id = :id"));
+    q.bindValue(":id", resourceId);
+    QVERIFY(q.exec());
+    QVERIFY(q.first());
+    const QString md5sum = q.value(0).toString();
+
+    // the synchronization doesn't generate the thumbnails
+    QVERIFY(KisResourceCacheDb::thumbnailData(md5sum).isEmpty());
+
+    // without an asynchronous scope the full thumbnail is returned right away
+    QImage thumbnail = m_locator->thumbnail("", ResourceType::PaintOpPresets, "test1.kpp", md5sum, resourceId);
+    QVERIFY(!thumbnail.isNull());
+
+    // the database keeps the generated thumbnail at full size
+    const QImage stored = QImage::fromData(KisResourceCacheDb::thumbnailData(md5sum), "PNG");
+    QVERIFY(!stored.isNull());
+
+    KoResourceSP res = m_locator->resourceForId(resourceId);
+    QVERIFY(res);
+    QCOMPARE(stored.size(), res->thumbnail().size());
+    QCOMPARE(thumbnail.size(), stored.size());
+
+    QVERIFY(KisResourceCacheDb::removeUnusedThumbnails());
+    QVERIFY(!KisResourceCacheDb::thumbnailData(md5sum).isEmpty());
+}
+
 void TestResourceLocator::testDocumentStorage()
 {
     const QString &documentName("document");
@@ -20,10 +20,12 @@ private Q_SLOTS:
     void testLocatorInitialization();
     void testStorageInitialization();
     void testLocatorSynchronization();
+    void testSkipUnchangedStorages();
 
     void testResourceLocationBase();
     void testResource();
     void testResourceForId();
+    void testThumbnails();
     void testDocumentStorage();
 
     void cleanupTestCase();
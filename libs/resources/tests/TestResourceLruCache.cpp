@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestResourceLruCache.h"
+#include <simpletest.h>
+
+#include <KisResourceLruCache.h>
+
+#include "DummyResource.h"
+
+namespace {
+
+// every dummy resource has a 512x512 RGB32 image, so the cache
+// holds three of them
+const qint64 memoryLimit = 3 * 1024 * 1024 + 512 * 1024;
+
+KisResourceLruCache::Key keyFor(int i, const QString &storage = "storage")
+{
+    return KisResourceLruCache::Key(storage, QString("paintoppresets/test%1.kpp").arg(i));
+}
+
+void insertResources(KisResourceLruCache &cache, int first, int last)
+{
+    for (int i = first; i <= last; i++) {
+        cache.insert(keyFor(i), KoResourceSP(new DummyResource(keyFor(i).second)));
+    }
+}
+
+}
+
+void TestResourceLruCache::testEviction()
+{
+    KisResourceLruCache cache(memoryLimit);
+    insertResources(cache, 1, 5);
+
+    QVERIFY(!cache.contains(keyFor(1)));
+    QVERIFY(!cache.contains(keyFor(2)));
+    QVERIFY(cache.contains(keyFor(3)));
+    QVERIFY(cache.contains(keyFor(4)));
+    QVERIFY(cache.contains(keyFor(5)));
+
+    KisResourceLruCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.numResources, 3);
+    QCOMPARE(stats.evictions, 2);
+    QVERIFY(stats.memorySize <= memoryLimit);
+    QVERIFY(stats.memorySize > 3 * 512 * 512 * 4);
+
+    QVERIFY(!cache.resource(keyFor(1)));
+    QVERIFY(cache.resource(keyFor(3)));
+
+    stats = cache.statistics();
+    QCOMPARE(stats.hits, 1);
+    QCOMPARE(stats.misses, 1);
+}
+
+void TestResourceLruCache::testLeastRecentlyUsedOrder()
+{
+    KisResourceLruCache cache(memoryLimit);
+    insertResources(cache, 1, 3);
+
+    QVERIFY(cache.resource(keyFor(1)));
+    insertResources(cache, 4, 4);
+
+    QVERIFY(cache.contains(keyFor(1)));
+    QVERIFY(!cache.contains(keyFor(2)));
+    QVERIFY(cache.contains(keyFor(3)));
+    QVERIFY(cache.contains(keyFor(4)));
+}
+
+void TestResourceLruCache::testDirtyResourcesArePinned()
+{
+    KisResourceLruCache cache(memoryLimit);
+    insertResources(cache, 1, 1);
+    cache.resource(keyFor(1))->setDirty(true);
+
+    insertResources(cache, 2, 6);
+
+    QVERIFY(cache.contains(keyFor(1)));
+    QVERIFY(cache.resource(keyFor(1))->isDirty());
+    QCOMPARE(cache.statistics().numPinned, 1);
+    QCOMPARE(cache.statistics().numResources, 3);
+}
+
+void TestResourceLruCache::testEvictedResourceInUse()
+{
+    KisResourceLruCache cache(memoryLimit);
+    insertResources(cache, 1, 1);
+
+    KoResourceSP resource = cache.resource(keyFor(1));
+    insertResources(cache, 2, 6);
+
+    // the resource is still alive, so it is not evicted
+    QVERIFY(cache.contains(keyFor(1)));
+    QCOMPARE(cache.resource(keyFor(1)), resource);
+    QCOMPARE(cache.statistics().numResources, 3);
+    QCOMPARE(cache.statistics().numPinned, 1);
+
+    // ...until it is released
+    resource.clear();
+    insertResources(cache, 7, 9);
+    QVERIFY(!cache.contains(keyFor(1)));
+    QCOMPARE(cache.statistics().numPinned, 0);
+}
+
+void TestResourceLruCache::testChangesToResourceInUseAreKept()
+{
+    KisResourceLruCache cache(memoryLimit);
+    insertResources(cache, 1, 1);
+
+    KoResourceSP resource = cache.resource(keyFor(1));
+    insertResources(cache, 2, 6);
+
+    resource->setDirty(true);
+    resource.clear();
+    insertResources(cache, 7, 9);
+
+    // the last reference is gone, but the changes are still in the cache
+    QVERIFY(cache.contains(keyFor(1)));
+    QVERIFY(cache.resource(keyFor(1))->isDirty());
+}
+
+void TestResourceLruCache::testRemoveStorage()
+{
+    KisResourceLruCache cache(memoryLimit);
+    insertResources(cache, 1, 2);
+    cache.insert(keyFor(3, "other"), KoResourceSP(new DummyResource(keyFor(3).second)));
+
+    cache.removeStorage("storage");
+
+    QVERIFY(!cache.contains(keyFor(1)));
+    QVERIFY(!cache.contains(keyFor(2)));
+    QVERIFY(cache.contains(keyFor(3, "other")));
+    QCOMPARE(cache.statistics().numResources, 1);
+}
+
+SIMPLE_TEST_MAIN(TestResourceLruCache)
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTRESOURCELRUCACHE_H
+#define TESTRESOURCELRUCACHE_H
+
+#include <QObject>
+
+class TestResourceLruCache : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEviction();
+    void testLeastRecentlyUsedOrder();
+    void testDirtyResourcesArePinned();
+    void testEvictedResourceInUse();
+    void testChangesToResourceInUseAreKept();
+    void testRemoveStorage();
+};
+
+#endif
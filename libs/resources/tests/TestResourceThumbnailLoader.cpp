@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestResourceThumbnailLoader.h"
+#include <simpletest.h>
+
+#include <QBuffer>
+
+#include <KisResourceThumbnailLoader.h>
+
+namespace {
+
+QByteArray pngData(const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    image.fill(Qt::green);
+
+    QBuffer buf;
+    buf.open(QBuffer::WriteOnly);
+    image.save(&buf, "PNG");
+    buf.close();
+
+    return buf.data();
+}
+
+KisResourceThumbnailLoader::Request requestFor(const QString &storage, int resourceId, const QSize &size)
+{
+    KisResourceThumbnailLoader::Request request;
+    request.key = KisResourceThumbnailLoader::Key(storage, QString("patterns/test%1.pat").arg(resourceId));
+    request.resourceType = "patterns";
+    request.resourceId = resourceId;
+    request.data = pngData(size);
+    return request;
+}
+
+}
+
+void TestResourceThumbnailLoader::testAsynchronousScope()
+{
+    QVERIFY(!KisResourceThumbnailLoader::asynchronousLoadingAllowed());
+
+    {
+        KisResourceThumbnailLoader::AsynchronousScope scope;
+        QVERIFY(KisResourceThumbnailLoader::asynchronousLoadingAllowed());
+    }
+
+    QVERIFY(!KisResourceThumbnailLoader::asynchronousLoadingAllowed());
+}
+
+void TestResourceThumbnailLoader::testDecodeInBackground()
+{
+    KisResourceThumbnailLoader loader;
+
+    QVector<KisResourceThumbnailLoader::Request> loaded;
+    connect(&loader, &KisResourceThumbnailLoader::thumbnailsLoaded,
+            [&loaded] (const QVector<KisResourceThumbnailLoader::Request> &requests) {
+        loaded += requests;
+    });
+
+    for (int i = 0; i < 4; i++) {
+        loader.enqueue(requestFor("storage", i, QSize(64, 32 + i)));
+    }
+
+    QVERIFY(loader.isPending(requestFor("storage", 0, QSize()).key));
+
+    QTRY_COMPARE(loaded.size(), 4);
+
+    Q_FOREACH (const KisResourceThumbnailLoader::Request &request, loaded) {
+        QCOMPARE(request.image.size(), QSize(64, 32 + request.resourceId));
+        QVERIFY(request.data.isEmpty());
+        QVERIFY(!loader.isPending(request.key));
+    }
+}
+
+void TestResourceThumbnailLoader::testScaledPreview()
+{
+    QImage small(64, 32, QImage::Format_ARGB32);
+    QCOMPARE(KisResourceThumbnailLoader::scaledPreview(small).size(), QSize(64, 32));
+
+    KisResourceThumbnailLoader loader;
+
+    QVector<KisResourceThumbnailLoader::Request> loaded;
+    connect(&loader, &KisResourceThumbnailLoader::thumbnailsLoaded,
+            [&loaded] (const QVector<KisResourceThumbnailLoader::Request> &requests) {
+        loaded += requests;
+    });
+
+    loader.enqueue(requestFor("storage", 0, QSize(1024, 512)));
+
+    QTRY_COMPARE(loaded.size(), 1);
+    QCOMPARE(loaded.first().image.size(), QSize(256, 128));
+}
+
+void TestResourceThumbnailLoader::testCancel()
+{
+    KisResourceThumbnailLoader loader;
+
+    QVector<KisResourceThumbnailLoader::Request> loaded;
+    connect(&loader, &KisResourceThumbnailLoader::thumbnailsLoaded,
+            [&loaded] (const QVector<KisResourceThumbnailLoader::Request> &requests) {
+        loaded += requests;
+    });
+
+    loader.enqueue(requestFor("removed", 1, QSize(256, 256)));
+    loader.enqueue(requestFor("kept", 2, QSize(256, 256)));
+
+    loader.cancel("removed");
+    QVERIFY(!loader.isPending(requestFor("removed", 1, QSize()).key));
+
+    QTRY_COMPARE(loaded.size(), 1);
+    QCOMPARE(loaded.first().key.first, QString("kept"));
+
+    // the cancelled request may still be in flight, give it a chance to be dropped
+    QTest::qWait(200);
+    QCOMPARE(loaded.size(), 1);
+}
+
+SIMPLE_TEST_MAIN(TestResourceThumbnailLoader)
@@ -0,0 +1,22 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTRESOURCETHUMBNAILLOADER_H
+#define TESTRESOURCETHUMBNAILLOADER_H
+
+#include <QObject>
+
+class TestResourceThumbnailLoader : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testAsynchronousScope();
+    void testDecodeInBackground();
+    void testScaledPreview();
+    void testCancel();
+};
+
+#endif
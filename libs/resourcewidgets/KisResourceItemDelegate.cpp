@@ -11,6 +11,7 @@
 #include <QDebug>
 
 #include "KisResourceModel.h"
+#include "KisResourceThumbnailLoader.h"
 
 KisResourceItemDelegate::KisResourceItemDelegate(QObject *parent)
     : QAbstractItemDelegate(parent)
@@ -22,6 +23,9 @@ void KisResourceItemDelegate::paint(QPainter *painter, const QStyleOptionViewIte
 {
     if (!index.isValid()) return;
 
+    // the view is updated when the thumbnails that are not ready yet are decoded
+    KisResourceThumbnailLoader::AsynchronousScope asynchronousThumbnails;
+
     painter->save();
 
     m_thumbnailPainter.paint(painter, index, option.rect, option.palette, option.state & QStyle::State_Selected, true);
@@ -70,9 +70,11 @@ void KisResourceThumbnailPainter::paint(QPainter *painter, QImage thumbnail, QSt
         if (!thumbnail.isNull() && (imageSize.height() > innerRect.height() || imageSize.width() > innerRect.width())) {
             thumbnail = thumbnail.scaled(innerRect.size()*devicePixelRatioF, Qt::KeepAspectRatio, Qt::SmoothTransformation);
         }
-        QBrush patternBrush(thumbnail);
-        patternBrush.setTransform(QTransform::fromTranslate(innerRect.x(), innerRect.y()));
-        painter->fillRect(innerRect, patternBrush);
+        if (!thumbnail.isNull()) {
+            QBrush patternBrush(thumbnail);
+            patternBrush.setTransform(QTransform::fromTranslate(innerRect.x(), innerRect.y()));
+            painter->fillRect(innerRect, patternBrush);
+        }
     }
     else if (resourceType == ResourceType::Workspaces || resourceType == ResourceType::WindowLayouts) {
         // TODO: thumbnails for workspaces and window layouts?
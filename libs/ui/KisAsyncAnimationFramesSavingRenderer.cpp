@@ -6,6 +6,14 @@
 
 #include "KisAsyncAnimationFramesSavingRenderer.h"
 
+#include <QFile>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "kis_image.h"
 #include "kis_paint_device.h"
 #include "KisImportExportFilter.h"
@@ -13,15 +21,39 @@
 #include "KisDocument.h"
 #include "kis_time_span.h"
 #include "kis_paint_layer.h"
+#include "animation/KisAnimationFrameStreamWriter.h"
+
+namespace {
 
+/**
+ * Creates a hard link to the already saved frame, which costs neither
+ * time nor disk space. The file systems that have no hard links (or
+ * links across the volumes) get a usual copy.
+ */
+bool linkOrCopyFrameFile(const QString &source, const QString &destination)
+{
+#ifdef Q_OS_WIN
+    const bool linked = CreateHardLinkW(reinterpret_cast<LPCWSTR>(destination.utf16()),
+                                        reinterpret_cast<LPCWSTR>(source.utf16()),
+                                        nullptr);
+#else
+    const bool linked = !::link(QFile::encodeName(source).constData(),
+                                QFile::encodeName(destination).constData());
+#endif
+
+    return linked || QFile::copy(source, destination);
+}
+
+}
 
 struct KisAsyncAnimationFramesSavingRenderer::Private
 {
-    Private(KisImageSP image, const KisTimeSpan &_range, int _sequenceNumberingOffset, bool _onlyNeedsUniqueFrames, KisPropertiesConfigurationSP _exportConfiguration)
+    Private(KisImageSP image, const KisTimeSpan &_range, int _sequenceNumberingOffset, bool _onlyNeedsUniqueFrames, bool _linkIdenticalFrames, KisPropertiesConfigurationSP _exportConfiguration)
         : savingDoc(KisPart::instance()->createDocument()),
           range(_range),
           sequenceNumberingOffset(_sequenceNumberingOffset),
           onlyNeedsUniqueFrames(_onlyNeedsUniqueFrames),
+          linkIdenticalFrames(_linkIdenticalFrames),
           exportConfiguration(_exportConfiguration)
     {
 
@@ -50,12 +82,15 @@ struct KisAsyncAnimationFramesSavingRenderer::Private
     int sequenceNumberingOffset = 0;
 
     bool onlyNeedsUniqueFrames;
+    bool linkIdenticalFrames;
 
     QString filenamePrefix;
     QString filenameSuffix;
 
     QByteArray outputMimeType;
     KisPropertiesConfigurationSP exportConfiguration;
+
+    KisAnimationFrameStreamWriter *frameStream = nullptr;
 };
 
 KisAsyncAnimationFramesSavingRenderer::KisAsyncAnimationFramesSavingRenderer(KisImageSP image,
@@ -65,8 +100,9 @@ KisAsyncAnimationFramesSavingRenderer::KisAsyncAnimationFramesSavingRenderer(Kis
                                                                              const KisTimeSpan &range,
                                                                              const int sequenceNumberingOffset,
                                                                              const bool onlyNeedsUniqueFrames,
+                                                                             const bool linkIdenticalFrames,
                                                                              KisPropertiesConfigurationSP exportConfiguration)
-    : m_d(new Private(image, range, sequenceNumberingOffset, onlyNeedsUniqueFrames, exportConfiguration))
+    : m_d(new Private(image, range, sequenceNumberingOffset, onlyNeedsUniqueFrames, linkIdenticalFrames, exportConfiguration))
 {
     m_d->filenamePrefix = fileNamePrefix;
     m_d->filenameSuffix = fileNameSuffix;
@@ -83,6 +119,11 @@ KisAsyncAnimationFramesSavingRenderer::~KisAsyncAnimationFramesSavingRenderer()
 {
 }
 
+void KisAsyncAnimationFramesSavingRenderer::setFrameStream(KisAnimationFrameStreamWriter *frameStream)
+{
+    m_d->frameStream = frameStream;
+}
+
 void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, const KisRegion &requestedRegion)
 {
     KisImageSP image = requestedImage();
@@ -93,6 +134,25 @@ void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, co
         return;
     }
 
+    if (m_d->frameStream) {
+        KisTimeSpan identicals = KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
+        identicals &= m_d->range;
+
+        const bool forceSRGB = m_d->exportConfiguration && m_d->exportConfiguration->getBool("forceSRGB", false);
+
+        // NOTE: may block until the encoder has taken the preceding frames
+        const bool result =
+            m_d->frameStream->addFrame(frame, identicals,
+                                       KisAnimationFrameStreamWriter::frameData(image->projection(), image->bounds(), forceSRGB));
+
+        if (result) {
+            emit sigCompleteRegenerationInternal(frame);
+        } else {
+            emit sigCancelRegenerationInternal(frame, KisAsyncAnimationRendererBase::RenderingFailed);
+        }
+        return;
+    }
+
     m_d->savingDevice->makeCloneFromRough(image->projection(), image->bounds());
 
     KisImportExportErrorCode status = ImportExportCodes::OK;
@@ -104,25 +164,27 @@ void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, co
         status = ImportExportCodes::InternalError;
     }
 
-    //Get all identical frames to this one and either copy or symlink based on settings.
+    //Get all identical frames to this one and either copy or hard-link based on settings.
     KisTimeSpan identicals = KisTimeSpan::calculateIdenticalFramesRecursive(image->root(), frame);
     identicals &= m_d->range;
-    if( !m_d->onlyNeedsUniqueFrames && identicals.start() < identicals.end() ) {
+    if (status.isOk() && !m_d->onlyNeedsUniqueFrames && identicals.start() < identicals.end()) {
         for (int identicalFrame = (identicals.start() + 1); identicalFrame <= identicals.end(); identicalFrame++) {
             QString identicalFrameNumber = QString("%1").arg(identicalFrame + m_d->sequenceNumberingOffset, 4, 10, QChar('0'));
             QString identicalFrameName = m_d->filenamePrefix + identicalFrameNumber + m_d->filenameSuffix;
 
-            QFile::copy(filename, identicalFrameName);
-
-            /*  This would be nice to do but sym-linking on windows isn't possible without
-             *  way more other work to be done. This works on linux though!
-             *
-             *  if (m_d->linkRedundantFrames) {
-             *      QFile::link(filename, identicalFrameName);
-             *  } else {
-             *      QFile::copy(filename, identicalFrameName);
-             *  }
+            /**
+             * The hard links share the file contents, so they are used only
+             * when the caller removes the frames after encoding them, the
+             * user may want to edit the kept frames one by one.
              */
+            const bool result = m_d->linkIdenticalFrames ?
+                linkOrCopyFrameFile(filename, identicalFrameName) :
+                QFile::copy(filename, identicalFrameName);
+
+            if (!result) {
+                status = ImportExportCodes::CannotCreateFile;
+                break;
+            }
         }
     }
 
@@ -135,6 +197,11 @@ void KisAsyncAnimationFramesSavingRenderer::frameCompletedCallback(int frame, co
 
 void KisAsyncAnimationFramesSavingRenderer::frameCancelledCallback(int frame, CancelReason cancelReason)
 {
+    // the other renderers may be waiting for this frame in the stream
+    if (m_d->frameStream) {
+        m_d->frameStream->cancel();
+    }
+
     notifyFrameCancelled(frame, cancelReason);
 }
 
@@ -11,6 +11,7 @@
 
 class KisDocument;
 class KisTimeSpan;
+class KisAnimationFrameStreamWriter;
 
 class KisAsyncAnimationFramesSavingRenderer : public KisAsyncAnimationRendererBase
 {
@@ -23,9 +24,16 @@ public:
                                           const KisTimeSpan &range,
                                           const int sequenceNumberingOffset,
                                           const bool onlyNeedsUniqueFrames,
+                                          const bool linkIdenticalFrames,
                                           KisPropertiesConfigurationSP exportConfiguration);
     ~KisAsyncAnimationFramesSavingRenderer();
 
+    /**
+     * Pass the rendered frames to \p frameStream instead of saving them
+     * into the files
+     */
+    void setFrameStream(KisAnimationFrameStreamWriter *frameStream);
+
 protected:
     void frameCompletedCallback(int frame, const KisRegion &requestedRegion) override;
     void frameCancelledCallback(int frame, CancelReason cancelReason) override;
@@ -0,0 +1,343 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPNGParallelEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <png.h>
+#include <zlib.h>
+
+#include <QIODevice>
+#include <QVector>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <kis_assert.h>
+
+namespace {
+
+const int rawBytesPerJob = 256 * 1024;
+const int dictionarySize = 32 * 1024;
+const int idatChunkSize = 64 * 1024;
+
+enum RowFilter {
+    RowFilterNone = 0,
+    RowFilterSub,
+    RowFilterUp,
+    RowFilterAverage,
+    RowFilterPaeth,
+    NumRowFilters
+};
+
+struct EncodingJob {
+    int firstRow = 0;
+    int numRows = 0;
+    bool isLast = false;
+    const EncodingJob *previous = nullptr;
+
+    QByteArray filteredBytes;
+    QByteArray compressedBytes;
+    uLong adler = 0;
+    bool failed = false;
+};
+
+inline quint8 paethPredictor(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = qAbs(p - a);
+    const int pb = qAbs(p - b);
+    const int pc = qAbs(p - c);
+
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/**
+ * Writes the filter type byte and the filtered \p row into \p dst.
+ * For the first row of the image \p prev should point to zeroes.
+ */
+void filterRow(RowFilter filter, const quint8 *row, const quint8 *prev,
+               int rowBytes, int bpp, quint8 *dst)
+{
+    *dst++ = quint8(filter);
+
+    switch (filter) {
+    case RowFilterNone:
+        memcpy(dst, row, rowBytes);
+        break;
+    case RowFilterSub:
+        memcpy(dst, row, bpp);
+        for (int i = bpp; i < rowBytes; i++) {
+            dst[i] = row[i] - row[i - bpp];
+        }
+        break;
+    case RowFilterUp:
+        for (int i = 0; i < rowBytes; i++) {
+            dst[i] = row[i] - prev[i];
+        }
+        break;
+    case RowFilterAverage:
+        for (int i = 0; i < bpp; i++) {
+            dst[i] = row[i] - (prev[i] >> 1);
+        }
+        for (int i = bpp; i < rowBytes; i++) {
+            dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+        }
+        break;
+    case RowFilterPaeth:
+        for (int i = 0; i < bpp; i++) {
+            dst[i] = row[i] - prev[i];
+        }
+        for (int i = bpp; i < rowBytes; i++) {
+            dst[i] = row[i] - paethPredictor(row[i - bpp], prev[i], prev[i - bpp]);
+        }
+        break;
+    case NumRowFilters:
+        KIS_ASSERT(0 && "invalid row filter");
+    }
+}
+
+/**
+ * The heuristic libpng uses to choose the filter: the sum of the absolute
+ * values of the filtered bytes taken as signed
+ */
+quint64 filteredRowCost(const quint8 *filtered, int rowBytes)
+{
+    quint64 sum = 0;
+    for (int i = 0; i < rowBytes; i++) {
+        const int value = filtered[i];
+        sum += value < 128 ? value : 256 - value;
+    }
+    return sum;
+}
+
+template <typename Func>
+void runJobs(QVector<EncodingJob> &jobs, Func func)
+{
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, func);
+    } else {
+        std::for_each(jobs.begin(), jobs.end(), func);
+    }
+}
+
+}
+
+KisPNGParallelEncoder::KisPNGParallelEncoder(int width, int bitsPerPixel, int compressionLevel,
+                                             FilterStrategy filterStrategy, bool swapBytes)
+    : m_rowBytes((width * bitsPerPixel + 7) / 8)
+    , m_bytesPerPixel(qMax(1, bitsPerPixel / 8))
+    , m_compressionLevel(compressionLevel < 0 ? 6 : qMin(compressionLevel, 9))
+    , m_filterStrategy(filterStrategy)
+    , m_swapBytes(swapBytes)
+{
+}
+
+QByteArray KisPNGParallelEncoder::encode(quint8 *const *rows, int numRows) const
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(numRows > 0 && m_rowBytes > 0, QByteArray());
+
+    const int rowsPerJob = qMax(1, rawBytesPerJob / m_rowBytes);
+
+    QVector<EncodingJob> jobs;
+    for (int row = 0; row < numRows; row += rowsPerJob) {
+        EncodingJob job;
+        job.firstRow = row;
+        job.numRows = qMin(rowsPerJob, numRows - row);
+        jobs.append(job);
+    }
+
+    jobs.last().isLast = true;
+    for (int i = 1; i < jobs.size(); i++) {
+        jobs[i].previous = &jobs[i - 1];
+    }
+
+    /**
+     * The filters of the first row of every job look at the last row of
+     * the previous one, so all the rows should be swapped before any job
+     * starts filtering.
+     */
+    if (m_swapBytes) {
+        runJobs(jobs, [rows, this] (EncodingJob &job) {
+            for (int row = job.firstRow; row < job.firstRow + job.numRows; row++) {
+                quint16 *samples = reinterpret_cast<quint16*>(rows[row]);
+                for (int i = 0; i < m_rowBytes / 2; i++) {
+                    samples[i] = qbswap(samples[i]);
+                }
+            }
+        });
+    }
+
+    runJobs(jobs, [rows, this] (EncodingJob &job) {
+        const QByteArray zeroRow(m_rowBytes, 0);
+        const int filteredRowBytes = m_rowBytes + 1;
+
+        QByteArray candidates;
+        if (m_filterStrategy == FilterAdaptive) {
+            candidates.resize(NumRowFilters * filteredRowBytes);
+        }
+
+        job.filteredBytes.resize(job.numRows * filteredRowBytes);
+        quint8 *dst = reinterpret_cast<quint8*>(job.filteredBytes.data());
+
+        for (int row = job.firstRow; row < job.firstRow + job.numRows; row++) {
+            const quint8 *src = rows[row];
+            const quint8 *prev = row > 0 ? rows[row - 1] : reinterpret_cast<const quint8*>(zeroRow.constData());
+
+            if (m_filterStrategy == FilterNone) {
+                filterRow(RowFilterNone, src, prev, m_rowBytes, m_bytesPerPixel, dst);
+            } else if (m_filterStrategy == FilterSub) {
+                filterRow(RowFilterSub, src, prev, m_rowBytes, m_bytesPerPixel, dst);
+            } else {
+                quint8 *candidate = reinterpret_cast<quint8*>(candidates.data());
+                const quint8 *bestCandidate = nullptr;
+                quint64 bestCost = 0;
+
+                for (int filter = RowFilterNone; filter < NumRowFilters; filter++) {
+                    filterRow(RowFilter(filter), src, prev, m_rowBytes, m_bytesPerPixel, candidate);
+
+                    const quint64 cost = filteredRowCost(candidate + 1, m_rowBytes);
+                    if (!bestCandidate || cost < bestCost) {
+                        bestCandidate = candidate;
+                        bestCost = cost;
+                    }
+
+                    candidate += filteredRowBytes;
+                }
+
+                memcpy(dst, bestCandidate, filteredRowBytes);
+            }
+
+            dst += filteredRowBytes;
+        }
+    });
+
+    runJobs(jobs, [this] (EncodingJob &job) {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+
+        // raw deflate, the zlib header and the checksum are written when stitching
+        if (deflateInit2(&stream, m_compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            job.failed = true;
+            return;
+        }
+
+        if (job.previous) {
+            const QByteArray &dictionary = job.previous->filteredBytes;
+            const int size = qMin(dictionarySize, dictionary.size());
+            deflateSetDictionary(&stream,
+                                 reinterpret_cast<const Bytef*>(dictionary.constData() + dictionary.size() - size),
+                                 size);
+        }
+
+        const QByteArray &src = job.filteredBytes;
+
+        // the sync flush adds an empty stored block that deflateBound() doesn't count
+        job.compressedBytes.resize(int(deflateBound(&stream, src.size())) + 16);
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src.constData()));
+        stream.avail_in = src.size();
+        stream.next_out = reinterpret_cast<Bytef*>(job.compressedBytes.data());
+        stream.avail_out = job.compressedBytes.size();
+
+        const int flush = job.isLast ? Z_FINISH : Z_SYNC_FLUSH;
+        int result = Z_OK;
+
+        forever {
+            result = deflate(&stream, flush);
+            if (result == Z_STREAM_ERROR || result == Z_STREAM_END || stream.avail_out != 0) break;
+
+            const int used = int(stream.total_out);
+            job.compressedBytes.resize(2 * job.compressedBytes.size());
+            stream.next_out = reinterpret_cast<Bytef*>(job.compressedBytes.data() + used);
+            stream.avail_out = job.compressedBytes.size() - used;
+        }
+
+        job.failed = result == Z_STREAM_ERROR ||
+            stream.avail_in != 0 ||
+            (job.isLast && result != Z_STREAM_END);
+
+        job.compressedBytes.resize(int(stream.total_out));
+        deflateEnd(&stream);
+
+        job.adler = adler32(adler32(0L, Z_NULL, 0),
+                            reinterpret_cast<const Bytef*>(src.constData()), src.size());
+    });
+
+    int compressedSize = 0;
+    Q_FOREACH (const EncodingJob &job, jobs) {
+        if (job.failed) return QByteArray();
+        compressedSize += job.compressedBytes.size();
+    }
+
+    QByteArray result;
+    result.reserve(compressedSize + 6);
+
+    // the same header zlib's deflate() writes for the 32 KiB window
+    const int levelFlags =
+        m_compressionLevel < 2 ? 0 :
+        m_compressionLevel < 6 ? 1 :
+        m_compressionLevel == 6 ? 2 : 3;
+
+    quint16 header = (0x78 << 8) | (levelFlags << 6);
+    header += 31 - header % 31;
+    header = qToBigEndian(header);
+    result.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+    Q_FOREACH (const EncodingJob &job, jobs) {
+        result.append(job.compressedBytes);
+        adler = adler32_combine(adler, job.adler, job.filteredBytes.size());
+    }
+
+    const quint32 checksum = qToBigEndian(quint32(adler));
+    result.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    return result;
+}
+
+bool KisPNGParallelEncoder::writeImageData(QIODevice *io, const QByteArray &imageData)
+{
+    if (imageData.isEmpty()) return false;
+
+    auto writeChunk = [io] (const char *type, const char *data, int size) {
+        uLong crc = crc32(0L, Z_NULL, 0);
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(type), 4);
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data), size);
+
+        const quint32 length = qToBigEndian(quint32(size));
+        const quint32 checksum = qToBigEndian(quint32(crc));
+
+        return io->write(reinterpret_cast<const char*>(&length), 4) == 4 &&
+            io->write(type, 4) == 4 &&
+            io->write(data, size) == size &&
+            io->write(reinterpret_cast<const char*>(&checksum), 4) == 4;
+    };
+
+    for (int offset = 0; offset < imageData.size(); offset += idatChunkSize) {
+        const int size = qMin(idatChunkSize, imageData.size() - offset);
+        if (!writeChunk("IDAT", imageData.constData() + offset, size)) {
+            return false;
+        }
+    }
+
+    return writeChunk("IEND", "", 0);
+}
+
+int KisPNGParallelEncoder::pngFilterFlags(FilterStrategy strategy)
+{
+    switch (strategy) {
+    case FilterSub:
+        return PNG_FILTER_SUB;
+    case FilterNone:
+        return PNG_FILTER_NONE;
+    case FilterAdaptive:
+        break;
+    }
+
+    return PNG_ALL_FILTERS;
+}
@@ -0,0 +1,73 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPNGPARALLELENCODER_H
+#define KISPNGPARALLELENCODER_H
+
+#include "kritaui_export.h"
+
+#include <QByteArray>
+
+class QIODevice;
+
+/**
+ * Encodes the image data of a PNG file on all the available cores.
+ *
+ * The rows are split into chunks of about 256 KiB that are filtered and
+ * deflated independently, the same way pigz compresses gzip files. Every
+ * chunk but the last one is ended with a sync flush, so the compressed
+ * chunks concatenate into a single valid zlib stream. The last 32 KiB of
+ * the previous chunk are used as the dictionary of the next one, therefore
+ * the files are only a tiny bit bigger than the ones written by libpng.
+ *
+ * The encoder handles non-interlaced images only.
+ */
+class KRITAUI_EXPORT KisPNGParallelEncoder
+{
+public:
+    enum FilterStrategy {
+        FilterAdaptive = 0, ///< picks the best of the five filters for every row, like libpng does
+        FilterSub,          ///< fast, still gives reasonable files for photos and paintings
+        FilterNone          ///< the fastest, the biggest files
+    };
+
+public:
+    /**
+     * \p bitsPerPixel the number of bits of one pixel in the rows
+     * \p swapBytes the 16-bit samples of the rows are little endian and
+     *              should be swapped before filtering
+     */
+    KisPNGParallelEncoder(int width, int bitsPerPixel, int compressionLevel,
+                          FilterStrategy filterStrategy, bool swapBytes);
+
+    /**
+     * \return the zlib stream with the filtered \p rows, that is, the
+     *         content of the IDAT chunks
+     *
+     * The rows are byte swapped in place when the encoder was asked to.
+     */
+    QByteArray encode(quint8 *const *rows, int numRows) const;
+
+    /**
+     * Writes \p imageData as a sequence of IDAT chunks followed by
+     * the IEND chunk
+     */
+    static bool writeImageData(QIODevice *io, const QByteArray &imageData);
+
+    /**
+     * \return the libpng filter flags that match \p strategy
+     */
+    static int pngFilterFlags(FilterStrategy strategy);
+
+private:
+    int m_rowBytes;
+    int m_bytesPerPixel;
+    int m_compressionLevel;
+    FilterStrategy m_filterStrategy;
+    bool m_swapBytes;
+};
+
+#endif // KISPNGPARALLELENCODER_H
@@ -0,0 +1,254 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisAnimationFrameStreamWriter.h"
+
+#include <QIODevice>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorConversionTransformation.h>
+
+#include "kis_paint_device.h"
+#include "kis_time_span.h"
+#include "kis_debug.h"
+
+namespace {
+// how many raw frames may wait in the pipe until the encoder reads them
+const int maxFramesInPipe = 2;
+}
+
+struct KisAnimationFrameStreamWriter::Private
+{
+    struct Frame {
+        KisTimeSpan identicalFrames;
+        QByteArray data;
+    };
+
+    QIODevice *device = nullptr;
+    KisTimeSpan range;
+    int maxBufferedFrames = 1;
+
+    mutable QMutex lock;
+    QWaitCondition bufferNotFull;
+    QMap<int, Frame> bufferedFrames;
+    int nextFrame = 0;
+    int writtenFrames = 0;
+    bool isCancelled = false;
+    bool hasFailed = false;
+
+    // the frame being written, it is repeated for the whole hold
+    QByteArray currentFrameData;
+    int currentFrameRepeats = 0;
+
+    // QIODevice::bytesWritten() may come while we are writing
+    bool isWriting = false;
+    bool finishedReported = false;
+
+    bool isCompleteUnlocked() const {
+        return !hasFailed && nextFrame > range.end() && currentFrameRepeats <= 0;
+    }
+};
+
+KisAnimationFrameStreamWriter::KisAnimationFrameStreamWriter(QIODevice *device,
+                                                             const KisTimeSpan &range,
+                                                             int maxBufferedFrames,
+                                                             QObject *parent)
+    : QObject(parent),
+      m_d(new Private())
+{
+    m_d->device = device;
+    m_d->range = range;
+    m_d->maxBufferedFrames = qMax(1, maxBufferedFrames);
+    m_d->nextFrame = range.start();
+
+    connect(device, &QIODevice::bytesWritten, this, &KisAnimationFrameStreamWriter::slotWriteFrames);
+}
+
+KisAnimationFrameStreamWriter::~KisAnimationFrameStreamWriter()
+{
+    cancel();
+}
+
+QString KisAnimationFrameStreamWriter::pixelFormat()
+{
+    // KoBgrU8Traits keep the channels in BGRA order in memory
+    return "bgra";
+}
+
+QByteArray KisAnimationFrameStreamWriter::frameData(KisPaintDeviceSP projection, const QRect &bounds, bool forceSRGB)
+{
+    const KoColorSpace *srcColorSpace = projection->colorSpace();
+    const KoColorSpace *dstColorSpace = KoColorSpaceRegistry::instance()->rgb8();
+
+    const int numPixels = bounds.width() * bounds.height();
+    QByteArray data(numPixels * dstColorSpace->pixelSize(), Qt::Uninitialized);
+
+    /**
+     * The same as the PNG export does: the 8-bit RGBA images are saved
+     * as they are, everything else is converted into sRGB
+     */
+    const bool keepPixelValues =
+        srcColorSpace->colorModelId() == RGBAColorModelID &&
+        srcColorSpace->colorDepthId() == Integer8BitsColorDepthID &&
+        !forceSRGB;
+
+    if (keepPixelValues || *srcColorSpace == *dstColorSpace) {
+        projection->readBytes(reinterpret_cast<quint8*>(data.data()), bounds);
+    } else {
+        QVector<quint8> pixels(numPixels * srcColorSpace->pixelSize());
+        projection->readBytes(pixels.data(), bounds);
+
+        srcColorSpace->convertPixelsTo(pixels.constData(),
+                                       reinterpret_cast<quint8*>(data.data()),
+                                       dstColorSpace,
+                                       numPixels,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+    }
+
+    return data;
+}
+
+bool KisAnimationFrameStreamWriter::addFrame(int frame, const KisTimeSpan &identicalFrames, const QByteArray &data)
+{
+    QMutexLocker locker(&m_d->lock);
+
+    while (!m_d->isCancelled &&
+           frame != m_d->nextFrame &&
+           m_d->bufferedFrames.size() >= m_d->maxBufferedFrames) {
+
+        m_d->bufferNotFull.wait(&m_d->lock);
+    }
+
+    if (m_d->isCancelled) return false;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(frame >= m_d->nextFrame, false);
+
+    m_d->bufferedFrames.insert(frame, {identicalFrames, data});
+
+    if (frame == m_d->nextFrame) {
+        QMetaObject::invokeMethod(this, "slotWriteFrames", Qt::QueuedConnection);
+    }
+
+    return true;
+}
+
+void KisAnimationFrameStreamWriter::cancel()
+{
+    QMutexLocker locker(&m_d->lock);
+
+    m_d->isCancelled = true;
+    m_d->bufferedFrames.clear();
+    m_d->currentFrameRepeats = 0;
+    m_d->bufferNotFull.wakeAll();
+}
+
+void KisAnimationFrameStreamWriter::flush()
+{
+    slotWriteFrames();
+}
+
+bool KisAnimationFrameStreamWriter::isComplete() const
+{
+    QMutexLocker locker(&m_d->lock);
+    return m_d->isCompleteUnlocked();
+}
+
+bool KisAnimationFrameStreamWriter::hasFailed() const
+{
+    QMutexLocker locker(&m_d->lock);
+    return m_d->hasFailed;
+}
+
+int KisAnimationFrameStreamWriter::writtenFramesCount() const
+{
+    QMutexLocker locker(&m_d->lock);
+    return m_d->writtenFrames;
+}
+
+void KisAnimationFrameStreamWriter::slotWriteFrames()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(QThread::currentThread() == thread());
+
+    if (m_d->isWriting) return;
+    m_d->isWriting = true;
+
+    bool result = true;
+
+    while (true) {
+        {
+            QMutexLocker locker(&m_d->lock);
+
+            if (m_d->isCancelled) break;
+
+            if (m_d->currentFrameRepeats <= 0) {
+                auto it = m_d->bufferedFrames.find(m_d->nextFrame);
+                if (it == m_d->bufferedFrames.end()) break;
+
+                const KisTimeSpan identicalFrames = it.value().identicalFrames;
+                m_d->currentFrameData = it.value().data;
+                m_d->bufferedFrames.erase(it);
+
+                const int lastFrame = qBound(m_d->nextFrame, identicalFrames.end(), m_d->range.end());
+                m_d->currentFrameRepeats = lastFrame - m_d->nextFrame + 1;
+                m_d->nextFrame = lastFrame + 1;
+
+                m_d->bufferNotFull.wakeAll();
+            }
+        }
+
+        /**
+         * Let the encoder take the frames that are already in the pipe,
+         * we will be called again from bytesWritten()
+         */
+        if (m_d->device->bytesToWrite() > maxFramesInPipe * m_d->currentFrameData.size()) break;
+
+        result = m_d->device->write(m_d->currentFrameData) == m_d->currentFrameData.size();
+        if (!result) break;
+
+        QMutexLocker locker(&m_d->lock);
+        m_d->writtenFrames++;
+        m_d->currentFrameRepeats--;
+    }
+
+    m_d->isWriting = false;
+
+    bool isFinished = false;
+
+    {
+        QMutexLocker locker(&m_d->lock);
+
+        if (!result) {
+            warnFile << "Failed to write a frame into the video encoder:" << m_d->device->errorString();
+
+            m_d->hasFailed = true;
+            m_d->isCancelled = true;
+            m_d->bufferedFrames.clear();
+            m_d->currentFrameRepeats = 0;
+            m_d->bufferNotFull.wakeAll();
+        }
+
+        if (m_d->currentFrameRepeats <= 0) {
+            m_d->currentFrameData.clear();
+        }
+
+        if ((m_d->hasFailed || m_d->isCompleteUnlocked()) && !m_d->finishedReported) {
+            m_d->finishedReported = true;
+            isFinished = true;
+        }
+    }
+
+    if (isFinished) {
+        emit sigFinished();
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISANIMATIONFRAMESTREAMWRITER_H
+#define KISANIMATIONFRAMESTREAMWRITER_H
+
+#include <QObject>
+#include <QScopedPointer>
+
+#include "kis_types.h"
+#include "kritaui_export.h"
+
+class QIODevice;
+class KisTimeSpan;
+
+/**
+ * Writes the rendered frames of an animation as raw pixels into the
+ * standard input of the video encoder, so that no image sequence is
+ * saved to the disk.
+ *
+ * The frames are rendered by several image clones at once, so they are
+ * completed in random order. The writer keeps them until all the
+ * preceding frames have been written. The frames of a hold are rendered
+ * only once and written as many times as the hold lasts.
+ *
+ * The memory used by the frames waiting to be written is bounded: the
+ * renderers that complete their frames too early are blocked in
+ * addFrame() until the encoder catches up. The frame the encoder waits
+ * for is never blocked, so the renderers cannot wait for each other.
+ *
+ * addFrame() can be called from any thread, the device is written to
+ * from the thread of the writer only. The writer never waits for the
+ * encoder: it keeps a couple of frames in the device's buffer and
+ * writes the next ones on QIODevice::bytesWritten(), so a slow encoder
+ * only slows the renderers down.
+ */
+class KRITAUI_EXPORT KisAnimationFrameStreamWriter : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param device the standard input of the encoder
+     * @param range the frames to be written, in order
+     * @param maxBufferedFrames the number of frames kept in memory
+     *        while waiting for the preceding ones
+     */
+    KisAnimationFrameStreamWriter(QIODevice *device,
+                                  const KisTimeSpan &range,
+                                  int maxBufferedFrames,
+                                  QObject *parent = nullptr);
+    ~KisAnimationFrameStreamWriter() override;
+
+    /**
+     * The pixel format of the frame data in ffmpeg notation
+     */
+    static QString pixelFormat();
+
+    /**
+     * @return the pixels of \p projection within \p bounds in the format
+     *         expected by the encoder, converted to sRGB unless the
+     *         image is already 8-bit RGBA and \p forceSRGB is false
+     */
+    static QByteArray frameData(KisPaintDeviceSP projection, const QRect &bounds, bool forceSRGB);
+
+    /**
+     * Queues \p data for \p frame and all the frames of \p identicalFrames.
+     * Blocks while too many frames are waiting to be written.
+     *
+     * @return false if the stream has been cancelled or has failed
+     */
+    bool addFrame(int frame, const KisTimeSpan &identicalFrames, const QByteArray &data);
+
+    /**
+     * Drops all the queued frames and releases the blocked renderers
+     */
+    void cancel();
+
+    /**
+     * Writes the queued frames that are ready to be written, as long
+     * as the device has room for them
+     */
+    void flush();
+
+    /**
+     * @return true if all the frames of the range have been written
+     *         into the device
+     */
+    bool isComplete() const;
+
+    /**
+     * @return true if writing into the device has failed, e.g. because
+     *         the encoder has exited
+     */
+    bool hasFailed() const;
+
+    int writtenFramesCount() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the stream becomes complete or fails
+     */
+    void sigFinished();
+
+private Q_SLOTS:
+    void slotWriteFrames();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISANIMATIONFRAMESTREAMWRITER_H
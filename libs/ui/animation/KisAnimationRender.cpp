@@ -50,6 +50,14 @@ void KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
     }
 
     const bool batchMode = false; // TODO: fetch correctly!
+
+    if (encoderOptions.renderMode() == KisAnimationRenderingOptions::RENDER_VIDEO_ONLY &&
+        KisAnimationVideoSaver::supportsFrameStreaming(doc->image(), encoderOptions)) {
+
+        renderWithFrameStream(doc, viewManager, encoderOptions, batchMode);
+        return;
+    }
+
     KisAsyncAnimationFramesSaveDialog exporter(doc->image(),
                                                KisTimeSpan::fromTimeToTime(encoderOptions.firstFrame,
                                                                       encoderOptions.lastFrame),
@@ -58,6 +66,8 @@ void KisAnimationRender::render(KisDocument *doc, KisViewManager *viewManager, K
                                                encoderOptions.wantsOnlyUniqueFrameSequence && !encoderOptions.shouldEncodeVideo,
                                                encoderOptions.frameExportConfig);
     exporter.setBatchMode(batchMode);
+    // the frames are only temporaries for the encoder, so nobody edits them
+    exporter.setLinkIdenticalFrames(encoderOptions.shouldEncodeVideo && encoderOptions.shouldDeleteSequence);
 
 
     KisAsyncAnimationFramesSaveDialog::Result result =
@@ -163,3 +173,52 @@ bool KisAnimationRender::hasEvenDimensions(int width, int height)
 {
     return !((width & 0x1) || (height & 0x1));
 }
+
+void KisAnimationRender::renderWithFrameStream(KisDocument *doc, KisViewManager *viewManager, const KisAnimationRenderingOptions &encoderOptions, bool batchMode)
+{
+    const QString resultFile = encoderOptions.resolveAbsoluteVideoFilePath();
+    KIS_SAFE_ASSERT_RECOVER_NOOP(QFileInfo(resultFile).isAbsolute());
+
+    {
+        const QFileInfo info(resultFile);
+        QDir dir(info.absolutePath());
+
+        if (!dir.exists()) {
+            dir.mkpath(info.absolutePath());
+        }
+        KIS_SAFE_ASSERT_RECOVER_NOOP(dir.exists());
+    }
+
+    KisAnimationVideoSaver encoder(doc, batchMode);
+    KisImportExportErrorCode res = encoder.startFrameStream(encoderOptions);
+
+    KisAsyncAnimationFramesSaveDialog::Result result = KisAsyncAnimationFramesSaveDialog::RenderFailed;
+
+    if (res.isOk()) {
+        // the frames are not saved, so they need no file name
+        KisAsyncAnimationFramesSaveDialog exporter(doc->image(),
+                                                   KisTimeSpan::fromTimeToTime(encoderOptions.firstFrame,
+                                                                               encoderOptions.lastFrame),
+                                                   QString(),
+                                                   encoderOptions.sequenceStart,
+                                                   false,
+                                                   encoderOptions.frameExportConfig);
+        exporter.setBatchMode(batchMode);
+        exporter.setFrameStream(encoder.frameStream());
+
+        result = exporter.regenerateRange(viewManager ? viewManager->mainWindow()->viewManager() : nullptr);
+
+        res = encoder.finishFrameStream(result == KisAsyncAnimationFramesSaveDialog::RenderComplete);
+    }
+
+    if (result == KisAsyncAnimationFramesSaveDialog::RenderTimedOut) {
+        QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Rendering error"), i18n("Animation frame rendering has timed out. Output files are incomplete.\nTry to increase \"Frame Rendering Timeout\" or reduce \"Frame Rendering Clones Limit\" in Krita settings"));
+    } else if (result == KisAsyncAnimationFramesSaveDialog::RenderCancelled) {
+        // the user knows what has happened
+    } else if (res.isCancelled()) {
+        // the encoder has been stopped, because the frames failed to render
+        QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Rendering error"), i18n("Failed to render animation frames! Output files are incomplete."));
+    } else if (!res.isOk()) {
+        QMessageBox::critical(qApp->activeWindow(), i18nc("@title:window", "Krita"), i18n("Could not render animation:\n%1", res.errorMessage()));
+    }
+}
@@ -18,6 +18,12 @@ namespace KisAnimationRender {
 
     KRITAUI_EXPORT void render(KisDocument *doc, KisViewManager* viewManager, KisAnimationRenderingOptions encoderOptions);
 
+    /**
+     * Renders the video without saving the frames, they are fed into
+     * ffmpeg as raw pixels right when they are ready
+     */
+    void renderWithFrameStream(KisDocument *doc, KisViewManager* viewManager, const KisAnimationRenderingOptions &encoderOptions, bool batchMode);
+
     QString getNameForFrame(const QString &basename, const QString &extension, int sequenceStart, int frame);
 
     QStringList getNamesForFrames(const QString &basename, const QString &extension, int sequenceStart, const QList<int> &frames);
@@ -83,6 +83,7 @@ KisPropertiesConfigurationSP KisAnimationRenderingOptions::toProperties() const
     config->setProperty("encode_video", shouldEncodeVideo);
     config->setProperty("delete_sequence", shouldDeleteSequence);
     config->setProperty("only_unique_frames", wantsOnlyUniqueFrameSequence);
+    config->setProperty("stream_frames", streamFramesToEncoder);
 
     config->setProperty("ffmpeg_path", ffmpegPath);
     config->setProperty("framerate", frameRate);
@@ -111,6 +112,7 @@ void KisAnimationRenderingOptions::fromProperties(KisPropertiesConfigurationSP c
     shouldEncodeVideo = config->getPropertyLazy("encode_video", false);
     shouldDeleteSequence = config->getPropertyLazy("delete_sequence", false);
     wantsOnlyUniqueFrameSequence = config->getPropertyLazy("only_unique_frames", false);
+    streamFramesToEncoder = config->getPropertyLazy("stream_frames", false);
 
     ffmpegPath = config->getPropertyLazy("ffmpeg_path", "");
     frameRate = config->getPropertyLazy("framerate", 25);
@@ -32,6 +32,13 @@ public:
     bool includeAudio = false;
     bool wantsOnlyUniqueFrameSequence = false;
 
+    /**
+     * When only the video is rendered, feed the raw frames directly
+     * into ffmpeg instead of saving them into the frames directory.
+     * Has no UI yet, so it is off unless set in the config.
+     */
+    bool streamFramesToEncoder = false;
+
     QString ffmpegPath;
     int frameRate = 25;
     int width = 0;
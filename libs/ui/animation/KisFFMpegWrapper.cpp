@@ -167,6 +167,23 @@ KisImportExportErrorCode KisFFMpegWrapper::start(const KisFFMpegWrapperSettings
     }
 }
 
+bool KisFFMpegWrapper::waitForStarted(int msecs)
+{
+    return m_process && m_process->waitForStarted(msecs);
+}
+
+QIODevice *KisFFMpegWrapper::inputDevice() const
+{
+    return m_process.data();
+}
+
+void KisFFMpegWrapper::closeInputChannel()
+{
+    if (!m_process) return;
+
+    m_process->closeWriteChannel();
+}
+
 void KisFFMpegWrapper::waitForFinished(int msecs)
 {
     if (!m_process) return;
@@ -16,6 +16,7 @@
 
 #include <kritaui_export.h>
 
+class QIODevice;
 class QProcess;
 
 struct KRITAUI_EXPORT KisFFMpegWrapperSettings
@@ -52,9 +53,21 @@ public:
 
     void startNonBlocking(const KisFFMpegWrapperSettings &settings);
     KisImportExportErrorCode start(const KisFFMpegWrapperSettings &settings);
+    bool waitForStarted(int msecs = FFMPEG_TIMEOUT);
     void waitForFinished(int msecs = FFMPEG_TIMEOUT);
     void reset();
 
+    /**
+     * The standard input of the running process. Remove "-nostdin" from
+     * the prepended arguments when feeding the input this way.
+     */
+    QIODevice* inputDevice() const;
+
+    /**
+     * Tells the process that the input is over
+     */
+    void closeInputChannel();
+
     static QJsonObject findProcessPath(const QString &processName, const QString &customLocation, bool processInfo);
     static QJsonObject findFFMpeg(const QString &customLocation);
     static QJsonObject findFFProbe(const QString &customLocation);
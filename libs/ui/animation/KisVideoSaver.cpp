@@ -27,6 +27,7 @@
 #include "kis_config.h"
 #include "KisAnimationRenderingOptions.h"
 #include "animation/KisFFMpegWrapper.h"
+#include "animation/KisAnimationFrameStreamWriter.h"
 
 #include "KisPart.h"
 
@@ -46,6 +47,44 @@ KisImageSP KisAnimationVideoSaver::image()
     return m_image;
 }
 
+namespace {
+
+QString scaleFilterArgs(const KisAnimationRenderingOptions &options)
+{
+    // export dimensions could be off a little bit, so the last force option tweaks the pixels for the export to work
+    return QString("scale=w=")
+            .append(QString::number(options.width))
+            .append(":h=")
+            .append(QString::number(options.height))
+            .append(":flags=")
+            .append(options.scaleFilter);
+            //.append(":force_original_aspect_ratio=decrease"); HOTFIX for even:odd dimension images.
+}
+
+/**
+ * Removes \p option and its value from \p options
+ * @return the value of the option or an empty string if there is no such option
+ */
+QString takeOptionValue(QStringList &options, const QString &option)
+{
+    QString value;
+
+    const int optionIndex = options.indexOf(option);
+
+    if (optionIndex != -1 && optionIndex + 1 < options.size()) {
+        value = options.takeAt(optionIndex + 1);
+        options.removeAt(optionIndex);
+    }
+
+    return value;
+}
+
+// the frames waiting for the encoder shouldn't take more than that
+const qint64 frameStreamBufferSize = 256 * 1024 * 1024;
+const int maxFrameStreamBufferedFrames = 16;
+
+}
+
 KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFilesMask, const KisAnimationRenderingOptions &options)
 {
     if (!QFileInfo(options.ffmpegPath).exists()) {
@@ -55,22 +94,10 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
 
     KisImportExportErrorCode resultOuter = ImportExportCodes::OK;
 
-    KisImageAnimationInterface *animation = m_image->animationInterface();
-
     const int sequenceNumberingOffset = options.sequenceStart;
     const KisTimeSpan clipRange = KisTimeSpan::fromTimeToTime(sequenceNumberingOffset + options.firstFrame,
                                                         sequenceNumberingOffset + options.lastFrame);
 
-     // export dimensions could be off a little bit, so the last force option tweaks the pixels for the export to work
-    const QString exportDimensions =
-        QString("scale=w=")
-            .append(QString::number(options.width))
-            .append(":h=")
-            .append(QString::number(options.height))
-            .append(":flags=")
-            .append(options.scaleFilter);
-            //.append(":force_original_aspect_ratio=decrease"); HOTFIX for even:odd dimension images.
-
     const QString resultFile = options.resolveAbsoluteVideoFilePath();
     const QFileInfo resultFileInfo(resultFile);  
     const QDir videoDir(resultFileInfo.absolutePath());
@@ -84,7 +111,6 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
     {
         
         QStringList paletteArgs;
-        QStringList simpleFilterArgs;
         QStringList complexFilterArgs;
         QStringList args;
         
@@ -92,12 +118,10 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
              << "-start_number" << QString::number(clipRange.start())
              << "-i" << savedFilesMask;        
 
-        const int lavfiOptionsIndex = additionalOptionsList.indexOf("-lavfi");
-
-        if ( lavfiOptionsIndex != -1 ) {
-            complexFilterArgs << additionalOptionsList.takeAt(lavfiOptionsIndex + 1);
+        const QString lavfiOptions = takeOptionValue(additionalOptionsList, "-lavfi");
 
-            additionalOptionsList.removeAt( lavfiOptionsIndex );
+        if ( !lavfiOptions.isEmpty() ) {
+            complexFilterArgs << lavfiOptions;
         }                  
       
         if ( suffix == "gif" ) {
@@ -105,17 +129,14 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
                         << "-start_number" << QString::number(clipRange.start())
                         << "-i" << savedFilesMask;
             
-            const int paletteOptionsIndex = additionalOptionsList.indexOf("-palettegen");
-            QString pallettegenString = "palettegen";
-            
-            if ( paletteOptionsIndex != -1 ) {
-                pallettegenString = additionalOptionsList.takeAt(paletteOptionsIndex + 1);
+            QString pallettegenString = takeOptionValue(additionalOptionsList, "-palettegen");
 
-                additionalOptionsList.removeAt( paletteOptionsIndex );
+            if ( pallettegenString.isEmpty() ) {
+                pallettegenString = "palettegen";
             }
                         
             if (m_image->width() != options.width || m_image->height() != options.height) {
-                paletteArgs << "-vf" << (exportDimensions + "," + pallettegenString );
+                paletteArgs << "-vf" << (scaleFilterArgs(options) + "," + pallettegenString );
             } else {
                 paletteArgs << "-vf" << pallettegenString;
             }
@@ -143,7 +164,7 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
                 return result;
             }
             
-            if (lavfiOptionsIndex == -1) {
+            if (lavfiOptions.isEmpty()) {
                 complexFilterArgs << "[0:v][1:v] paletteuse";
             }
             
@@ -152,34 +173,8 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
             // We need to kill the process so we can reuse it later down the chain. BUG:446320
             ffmpegWrapper->reset();
         }
-        
-        QFileInfo audioFileInfo = animation->audioChannelFileName();
-        if (options.includeAudio && audioFileInfo.exists()) {
-            const int msecStart = clipRange.start() * 1000 / animation->framerate();
-            const int msecDuration = clipRange.duration() * 1000 / animation->framerate();
-
-            const QTime startTime = QTime::fromMSecsSinceStartOfDay(msecStart);
-            const QTime durationTime = QTime::fromMSecsSinceStartOfDay(msecDuration);
-            const QString ffmpegTimeFormat = QStringLiteral("H:m:s.zzz");
-
-            args << "-ss" << QLocale::c().toString(startTime, ffmpegTimeFormat);
-            args << "-t" << QLocale::c().toString(durationTime, ffmpegTimeFormat);
-            args << "-i" << audioFileInfo.absoluteFilePath();
-        }
-      
-        // if we are exporting out at a different image size, we apply scaling filter
-        // export options HAVE to go after input options, so make sure this is after the audio import
-        if (m_image->width() != options.width || m_image->height() != options.height) {
-            simpleFilterArgs << exportDimensions;
-        }
 
-        if ( !complexFilterArgs.isEmpty() ) { 
-            args << "-lavfi" << (!simpleFilterArgs.isEmpty() ? simpleFilterArgs.join(",").append("[0:v];"):"") + complexFilterArgs.join(";");
-        } else if ( !simpleFilterArgs.isEmpty() ) {
-            args << "-vf" << simpleFilterArgs.join(",");
-        }
-        
-        args << additionalOptionsList;
+        appendEncoderArgs(args, complexFilterArgs, additionalOptionsList, clipRange, options);
 
         dbgFile << "savedFilesMask" << savedFilesMask 
                 << "start" << QString::number(clipRange.start()) 
@@ -202,6 +197,181 @@ KisImportExportErrorCode KisAnimationVideoSaver::encode(const QString &savedFile
     return resultOuter;
 }
 
+void KisAnimationVideoSaver::appendEncoderArgs(QStringList &args,
+                                               const QStringList &complexFilterArgs,
+                                               const QStringList &additionalOptionsList,
+                                               const KisTimeSpan &clipRange,
+                                               const KisAnimationRenderingOptions &options)
+{
+    KisImageAnimationInterface *animation = m_image->animationInterface();
+
+    QStringList simpleFilterArgs;
+
+    QFileInfo audioFileInfo = animation->audioChannelFileName();
+    if (options.includeAudio && audioFileInfo.exists()) {
+        const int msecStart = clipRange.start() * 1000 / animation->framerate();
+        const int msecDuration = clipRange.duration() * 1000 / animation->framerate();
+
+        const QTime startTime = QTime::fromMSecsSinceStartOfDay(msecStart);
+        const QTime durationTime = QTime::fromMSecsSinceStartOfDay(msecDuration);
+        const QString ffmpegTimeFormat = QStringLiteral("H:m:s.zzz");
+
+        args << "-ss" << QLocale::c().toString(startTime, ffmpegTimeFormat);
+        args << "-t" << QLocale::c().toString(durationTime, ffmpegTimeFormat);
+        args << "-i" << audioFileInfo.absoluteFilePath();
+    }
+
+    // if we are exporting out at a different image size, we apply scaling filter
+    // export options HAVE to go after input options, so make sure this is after the audio import
+    if (m_image->width() != options.width || m_image->height() != options.height) {
+        simpleFilterArgs << scaleFilterArgs(options);
+    }
+
+    if ( !complexFilterArgs.isEmpty() ) { 
+        args << "-lavfi" << (!simpleFilterArgs.isEmpty() ? simpleFilterArgs.join(",").append("[0:v];"):"") + complexFilterArgs.join(";");
+    } else if ( !simpleFilterArgs.isEmpty() ) {
+        args << "-vf" << simpleFilterArgs.join(",");
+    }
+
+    args << additionalOptionsList;
+}
+
+bool KisAnimationVideoSaver::supportsFrameStreaming(KisImageSP image, const KisAnimationRenderingOptions &options)
+{
+    // the palette for a gif is generated in a separate pass over the frames
+    const bool isGif = QFileInfo(options.resolveAbsoluteVideoFilePath()).suffix().toLower() == "gif";
+
+    // the raw frames are 8-bit only, the deeper images keep their
+    // precision in the image sequence
+    const bool isHDR = options.frameExportConfig && options.frameExportConfig->getBool("saveAsHDR", false);
+    const bool isHighBitDepth = image->colorSpace()->colorDepthId() != Integer8BitsColorDepthID;
+
+    return options.streamFramesToEncoder && !isGif && !isHDR && !isHighBitDepth;
+}
+
+KisImportExportErrorCode KisAnimationVideoSaver::startFrameStream(const KisAnimationRenderingOptions &options)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_encoder, ImportExportCodes::InternalError);
+
+    if (!QFileInfo(options.ffmpegPath).exists()) {
+        m_doc->setErrorMessage(i18n("ffmpeg could not be found at %1", options.ffmpegPath));
+        return ImportExportCodes::Failure;
+    }
+
+    const int sequenceNumberingOffset = options.sequenceStart;
+    const KisTimeSpan clipRange = KisTimeSpan::fromTimeToTime(sequenceNumberingOffset + options.firstFrame,
+                                                        sequenceNumberingOffset + options.lastFrame);
+
+    const QSize frameSize = m_image->bounds().size();
+
+    QStringList additionalOptionsList = options.customFFMpegOptions.split(' ', QString::SkipEmptyParts);
+
+    QStringList complexFilterArgs;
+    const QString lavfiOptions = takeOptionValue(additionalOptionsList, "-lavfi");
+    if (!lavfiOptions.isEmpty()) {
+        complexFilterArgs << lavfiOptions;
+    }
+
+    QStringList args;
+    args << "-f" << "rawvideo"
+         << "-pix_fmt" << KisAnimationFrameStreamWriter::pixelFormat()
+         << "-s" << QString("%1x%2").arg(frameSize.width()).arg(frameSize.height())
+         << "-r" << QString::number(options.frameRate)
+         << "-i" << "pipe:0";
+
+    appendEncoderArgs(args, complexFilterArgs, additionalOptionsList, clipRange, options);
+
+    KisFFMpegWrapperSettings ffmpegSettings;
+    ffmpegSettings.processPath = options.ffmpegPath;
+    ffmpegSettings.args = args;
+    ffmpegSettings.outputFile = options.resolveAbsoluteVideoFilePath();
+    ffmpegSettings.totalFrames = clipRange.duration();
+    ffmpegSettings.logPath = QDir::tempPath() + QDir::separator() + "krita" + QDir::separator() + "ffmpeg.log";
+    // the frames are fed through stdin
+    ffmpegSettings.defaultPrependArgs = {"-hide_banner", "-y"};
+    // the progress is shown by the frames rendering dialog
+    ffmpegSettings.batchMode = true;
+
+    m_encoder.reset(new KisFFMpegWrapper(this));
+    m_encoderFinished = false;
+    m_encoderFailed = false;
+
+    connect(m_encoder.data(), &KisFFMpegWrapper::sigFinished, this, [this] () {
+        m_encoderFinished = true;
+    });
+
+    connect(m_encoder.data(), &KisFFMpegWrapper::sigFinishedWithError, this, [this] (const QString &message) {
+        Q_UNUSED(message);
+        m_encoderFinished = true;
+        m_encoderFailed = true;
+    });
+
+    m_encoder->startNonBlocking(ffmpegSettings);
+
+    if (!m_encoder->waitForStarted()) {
+        m_encoder->reset();
+        m_encoder.reset();
+        return ImportExportCodes::Failure;
+    }
+
+    const qint64 frameBytes = qMax(qint64(1), qint64(frameSize.width()) * frameSize.height() * 4);
+    const int maxBufferedFrames = qBound(qint64(1), frameStreamBufferSize / frameBytes, qint64(maxFrameStreamBufferedFrames));
+
+    m_frameStream.reset(new KisAnimationFrameStreamWriter(m_encoder->inputDevice(),
+                                                          KisTimeSpan::fromTimeToTime(options.firstFrame, options.lastFrame),
+                                                          maxBufferedFrames));
+
+    return ImportExportCodes::OK;
+}
+
+KisAnimationFrameStreamWriter *KisAnimationVideoSaver::frameStream() const
+{
+    return m_frameStream.data();
+}
+
+KisImportExportErrorCode KisAnimationVideoSaver::finishFrameStream(bool renderingComplete)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_encoder && m_frameStream, ImportExportCodes::InternalError);
+
+    if (renderingComplete) {
+        // write the frames that have been completed right before the dialog has closed
+        m_frameStream->flush();
+
+        // the encoder may still be busy with the last frames
+        if (!m_frameStream->isComplete() && !m_frameStream->hasFailed() && !m_encoderFinished) {
+            QEventLoop loop;
+            connect(m_frameStream.data(), &KisAnimationFrameStreamWriter::sigFinished, &loop, &QEventLoop::quit);
+            connect(m_encoder.data(), &KisFFMpegWrapper::sigFinished, &loop, &QEventLoop::quit);
+            connect(m_encoder.data(), &KisFFMpegWrapper::sigFinishedWithError, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+    }
+
+    KisImportExportErrorCode result = ImportExportCodes::OK;
+
+    if (!renderingComplete || !m_frameStream->isComplete()) {
+        m_frameStream->cancel();
+        m_encoder->reset();
+
+        result = renderingComplete ? ImportExportCodes::Failure : ImportExportCodes::Cancelled;
+    } else {
+        m_encoder->closeInputChannel();
+        m_encoder->waitForFinished(FFMPEG_TIMEOUT);
+
+        if (!m_encoderFinished) {
+            m_encoder->reset();
+        }
+
+        result = m_encoderFinished && !m_encoderFailed ?
+            ImportExportCodes::OK : ImportExportCodes::Failure;
+    }
+
+    m_frameStream.reset();
+    m_encoder.reset();
+
+    return result;
+}
+
 KisImportExportErrorCode KisAnimationVideoSaver::convert(KisDocument *document, const QString &savedFilesMask, const KisAnimationRenderingOptions &options, bool batchMode)
 {
     KisAnimationVideoSaver videoSaver(document, batchMode);
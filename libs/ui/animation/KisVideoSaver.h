@@ -8,6 +8,7 @@
 #define VIDEO_SAVER_H_
 
 #include <QObject>
+#include <QScopedPointer>
 
 #include "kis_types.h"
 
@@ -15,6 +16,9 @@
 
 class KisDocument;
 class KisAnimationRenderingOptions;
+class KisAnimationFrameStreamWriter;
+class KisFFMpegWrapper;
+class KisTimeSpan;
 
 #include "kritaui_export.h"
 
@@ -49,10 +53,48 @@ public:
 
     static KisImportExportErrorCode convert(KisDocument *document, const QString &savedFilesMask, const KisAnimationRenderingOptions &options, bool batchMode);
 
+    /**
+     * @return true if the video of \p image can be encoded from the raw
+     *         frames streamed into ffmpeg instead of a saved image sequence
+     */
+    static bool supportsFrameStreaming(KisImageSP image, const KisAnimationRenderingOptions &options);
+
+    /**
+     * @brief starts ffmpeg reading the raw frames from its standard input.
+     * Feed the frames with frameStream() and call finishFrameStream() when
+     * the rendering is over.
+     */
+    KisImportExportErrorCode startFrameStream(const KisAnimationRenderingOptions &options);
+
+    /**
+     * @return the writer feeding the frames into ffmpeg, when the stream is started
+     */
+    KisAnimationFrameStreamWriter* frameStream() const;
+
+    /**
+     * @brief waits until ffmpeg encodes all the frames, the events
+     * are processed meanwhile
+     * @param renderingComplete false if the rendering has been cancelled or
+     *        has failed, ffmpeg is stopped right away then
+     */
+    KisImportExportErrorCode finishFrameStream(bool renderingComplete);
+
+private:
+    void appendEncoderArgs(QStringList &args,
+                           const QStringList &complexFilterArgs,
+                           const QStringList &additionalOptionsList,
+                           const KisTimeSpan &clipRange,
+                           const KisAnimationRenderingOptions &options);
+
 private:
     KisImageSP m_image;
     KisDocument* m_doc;
     bool m_batchMode;
+
+    QScopedPointer<KisFFMpegWrapper> m_encoder;
+    QScopedPointer<KisAnimationFrameStreamWriter> m_frameStream;
+    bool m_encoderFinished = false;
+    bool m_encoderFailed = false;
 };
 
 #endif
@@ -36,6 +36,7 @@
 #include <KisUsageLogger.h>
 
 #include <kis_lod_transform.h>
+#include <KisTimelineTracer.h>
 #include "kis_tool_proxy.h"
 #include "kis_coordinates_converter.h"
 #include "kis_prescaled_projection.h"
@@ -824,6 +825,9 @@ void KisCanvas2::finishResizingImage(qint32 w, qint32 h)
 
 void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 {
+    KisTimelineTracer::Span span("canvas", "convert projection");
+    span.setArg("rect", rc);
+
     KisUpdateInfoSP info = m_d->canvasWidget->startUpdateCanvasProjection(rc, m_d->channelFlags);
     if (m_d->projectionUpdatesCompressor.putUpdateInfo(info)) {
         emit sigCanvasCacheUpdated();
@@ -832,6 +836,8 @@ void KisCanvas2::startUpdateCanvasProjection(const QRect & rc)
 
 void KisCanvas2::updateCanvasProjection()
 {
+    KisTimelineTracer::Span span("canvas", "upload projection");
+
     auto tryIssueCanvasUpdates = [this](const QRect &vRect) {
         if (!m_d->isBatchUpdateActive) {
             // TODO: Implement info->dirtyViewportRect() for KisOpenGLCanvas2 to avoid updating whole canvas
@@ -1152,7 +1158,11 @@ void KisCanvas2::notifyLevelOfDetailChange()
         if (m_d->lodPreferredInImage) {
             flags |= KisLodPreferences::LodPreferred;
         }
-        image->setLodPreferences(KisLodPreferences(flags, lod));
+
+        if (KisImageConfig(true).adaptiveLevelOfDetail()) {
+            flags |= KisLodPreferences::LodAdaptive;
+        }
+        image->setLodPreferences(KisLodPreferences(flags, lod, maxLod));
     }
 }
 
@@ -50,6 +50,8 @@ struct KisAsyncAnimationFramesSaveDialog::Private {
     QString filenameSuffix;
     QByteArray outputMimeType;
     bool onlyNeedsUniqueFrames;
+    bool linkIdenticalFrames = false;
+    KisAnimationFrameStreamWriter *frameStream = nullptr;
 
     int sequenceNumberingOffset;
     KisPropertiesConfigurationSP exportConfiguration;
@@ -74,6 +76,11 @@ KisAsyncAnimationFramesSaveDialog::~KisAsyncAnimationFramesSaveDialog()
 
 KisAsyncAnimationRenderDialogBase::Result KisAsyncAnimationFramesSaveDialog::regenerateRange(KisViewManager *viewManager)
 {
+    // nothing is saved into the files
+    if (m_d->frameStream) {
+        return KisAsyncAnimationRenderDialogBase::regenerateRange(viewManager);
+    }
+
     QFileInfo info(savedFilesMaskWildcard());
 
     QDir dir(info.absolutePath());
@@ -171,16 +178,31 @@ QList<int> KisAsyncAnimationFramesSaveDialog::calcDirtyFrames() const
     return result;
 }
 
+int KisAsyncAnimationFramesSaveDialog::calcReusedFramesCount(const QList<int> &dirtyFrames) const
+{
+    return qMax(0, m_d->range.duration() - dirtyFrames.size());
+}
+
 KisAsyncAnimationRendererBase *KisAsyncAnimationFramesSaveDialog::createRenderer(KisImageSP image)
 {
-    return new KisAsyncAnimationFramesSavingRenderer(image,
-                                                     m_d->filenamePrefix,
-                                                     m_d->filenameSuffix,
-                                                     m_d->outputMimeType,
-                                                     m_d->range,
-                                                     m_d->sequenceNumberingOffset,
-                                                     m_d->onlyNeedsUniqueFrames,
-                                                     m_d->exportConfiguration);
+    KisAsyncAnimationFramesSavingRenderer *renderer =
+        new KisAsyncAnimationFramesSavingRenderer(image,
+                                                  m_d->filenamePrefix,
+                                                  m_d->filenameSuffix,
+                                                  m_d->outputMimeType,
+                                                  m_d->range,
+                                                  m_d->sequenceNumberingOffset,
+                                                  m_d->onlyNeedsUniqueFrames,
+                                                  m_d->linkIdenticalFrames,
+                                                  m_d->exportConfiguration);
+    renderer->setFrameStream(m_d->frameStream);
+
+    return renderer;
+}
+
+void KisAsyncAnimationFramesSaveDialog::setFrameStream(KisAnimationFrameStreamWriter *frameStream)
+{
+    m_d->frameStream = frameStream;
 }
 
 void KisAsyncAnimationFramesSaveDialog::initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer, KisImageSP image, int frame)
@@ -204,3 +226,8 @@ QList<int> KisAsyncAnimationFramesSaveDialog::getUniqueFrames() const
 {
     return this->calcDirtyFrames();
 }
+
+void KisAsyncAnimationFramesSaveDialog::setLinkIdenticalFrames(bool value)
+{
+    m_d->linkIdenticalFrames = value;
+}
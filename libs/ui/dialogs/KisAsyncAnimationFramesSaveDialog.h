@@ -10,6 +10,7 @@
 #include "KisAsyncAnimationRenderDialogBase.h"
 #include "kis_types.h"
 
+class KisAnimationFrameStreamWriter;
 
 class KRITAUI_EXPORT KisAsyncAnimationFramesSaveDialog : public KisAsyncAnimationRenderDialogBase
 {
@@ -30,8 +31,23 @@ public:
 
     QList<int> getUniqueFrames() const;
 
+    /**
+     * Save the frames identical to the rendered ones as hard links instead
+     * of copies, when the file system allows that. Use it only when the
+     * frames are removed right after encoding, since the linked frames
+     * share their contents.
+     */
+    void setLinkIdenticalFrames(bool value);
+
+    /**
+     * Pass the rendered frames to \p frameStream instead of saving them
+     * into the files, e.g. to feed them directly into the video encoder
+     */
+    void setFrameStream(KisAnimationFrameStreamWriter *frameStream);
+
 protected:
     QList<int> calcDirtyFrames() const override;
+    int calcReusedFramesCount(const QList<int> &dirtyFrames) const override;
     KisAsyncAnimationRendererBase* createRenderer(KisImageSP image) override;
     void initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer,
                                     KisImageSP image, int frame) override;
@@ -91,6 +91,7 @@ struct KisAsyncAnimationRenderDialogBase::Private
     QList<int> stillDirtyFrames;
     QList<int> framesInProgress;
     int dirtyFramesCount = 0;
+    int reusedFramesCount = 0;
     Result result = RenderComplete;
     KisRegion regionOfInterest;
 
@@ -148,6 +149,7 @@ KisAsyncAnimationRenderDialogBase::regenerateRange(KisViewManager *viewManager)
     m_d->framesInProgress.clear();
     m_d->result = RenderComplete;
     m_d->dirtyFramesCount = m_d->stillDirtyFrames.size();
+    m_d->reusedFramesCount = calcReusedFramesCount(m_d->stillDirtyFrames);
 
     if (!m_d->isBatchMode) {
         QWidget *parentWidget = viewManager ? viewManager->mainWindowAsQWidget() : 0;
@@ -316,10 +318,15 @@ void KisAsyncAnimationRenderDialogBase::updateProgressLabel()
              m_d->asyncRenderers.size()));
 
 
-    const QString progressLabel(i18n("%1\n\nElapsed: %2\nEstimated: %3\n\n%4",
+    const QString reusedFramesMessage(
+        i18np("One identical frame reused\n", "%1 identical frames reused\n",
+              m_d->reusedFramesCount));
+
+    const QString progressLabel(i18n("%1\n\nElapsed: %2\nEstimated: %3\n%4\n%5",
                                      m_d->actionTitle,
                                      elapsedTimeString,
                                      estimatedTimeString,
+                                     m_d->reusedFramesCount > 0 ? reusedFramesMessage : QString(),
                                      m_d->memoryLimitReached ? memoryLimitMessage : QString()));
     if (m_d->progressDialog) {
         /**
@@ -372,3 +379,14 @@ bool KisAsyncAnimationRenderDialogBase::batchMode() const
 {
     return m_d->isBatchMode;
 }
+
+int KisAsyncAnimationRenderDialogBase::reusedFramesCount() const
+{
+    return m_d->reusedFramesCount;
+}
+
+int KisAsyncAnimationRenderDialogBase::calcReusedFramesCount(const QList<int> &dirtyFrames) const
+{
+    Q_UNUSED(dirtyFrames);
+    return 0;
+}
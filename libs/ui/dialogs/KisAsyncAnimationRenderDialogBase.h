@@ -102,6 +102,12 @@ public:
      */
     bool batchMode() const;
 
+    /**
+     * @return the number of frames in the range that were not rendered,
+     *         because they are identical to some other rendered frame
+     */
+    int reusedFramesCount() const;
+
 private Q_SLOTS:
     void slotFrameCompleted(int frame);
     void slotFrameCancelled(int frame, KisAsyncAnimationRendererBase::CancelReason cancelReason);
@@ -135,6 +141,12 @@ protected:
     virtual void initializeRendererForFrame(KisAsyncAnimationRendererBase *renderer,
                                             KisImageSP image, int frame) = 0;
 
+    /**
+     * @brief returns the number of frames that are covered by the frames
+     *        returned by calcDirtyFrames(), reported to the user in the dialog
+     */
+    virtual int calcReusedFramesCount(const QList<int> &dirtyFrames) const;
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
@@ -2027,6 +2027,16 @@ void KisConfig::setEnableBrushSpeedLogging(bool value) const
     m_cfg.writeEntry("enableBrushSpeedLogging", value);
 }
 
+QString KisConfig::strokeEventsRecordingFile(bool defaultValue) const
+{
+    return (defaultValue ? QString() : m_cfg.readEntry("strokeEventsRecordingFile", QString()));
+}
+
+void KisConfig::setStrokeEventsRecordingFile(const QString &value) const
+{
+    m_cfg.writeEntry("strokeEventsRecordingFile", value);
+}
+
 void KisConfig::setDisableVectorOptimizations(bool value)
 {
     // use the old key name for compatibility
@@ -562,6 +562,13 @@ public:
     void setEnableBrushSpeedLogging(bool value) const;
     bool enableBrushSpeedLogging(bool defaultValue = false) const;
 
+    /**
+     * When not empty, the painting events of the freehand strokes are
+     * appended to this file (see KisStrokeEventsRecorder)
+     */
+    void setStrokeEventsRecordingFile(const QString &value) const;
+    QString strokeEventsRecordingFile(bool defaultValue = false) const;
+
     void setDisableVectorOptimizations(bool value);
     bool disableVectorOptimizations(bool defaultValue = false) const;
 
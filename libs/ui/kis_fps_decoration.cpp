@@ -113,6 +113,8 @@ QString KisFpsDecoration::getText() const
                 .arg(monitor->lastStrokeSaturated() ? " (!)" : "");
         lines << QString("Last brush framerate: %1 fps")
                 .arg(monitor->lastFps(), 0, 'f', 1);
+        lines << QString("Last dab cache hit rate: %1%")
+                .arg(monitor->lastDabCacheHitRate() * 100.0, 0, 'f', 1);
 
         lines << QString("Average cursor/brush speed (px/ms): %1/%2")
                 .arg(monitor->avgCursorSpeed(), 0, 'f', 1)
@@ -1090,6 +1090,19 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
                  color_type, interlacetype,
                  PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
 
+    /**
+     * libpng doesn't filter palette and low bit depth images, since
+     * the filters work on whole bytes and don't help there
+     */
+    KisPNGParallelEncoder::FilterStrategy filterStrategy = options.filterStrategy;
+    if (color_type == PNG_COLOR_TYPE_PALETTE || color_nb_bits < 8) {
+        filterStrategy = KisPNGParallelEncoder::FilterNone;
+    }
+
+    if (filterStrategy != KisPNGParallelEncoder::FilterAdaptive) {
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, KisPNGParallelEncoder::pngFilterFlags(filterStrategy));
+    }
+
     // set sRGB only if the profile is sRGB  -- http://www.w3.org/TR/PNG/#11sRGB says sRGB and iCCP should not both be present
 
     const bool sRGB = *device->colorSpace()->profile() == *KoColorSpaceRegistry::instance()->p709SRGBProfile();
@@ -1287,11 +1300,16 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     png_write_flush(png_ptr);
 
     // swap byteorder on little endian machines.
+    bool swapBytes = false;
 #ifndef WORDS_BIGENDIAN
-    if (color_nb_bits > 8)
-        png_set_swap(png_ptr);
+    swapBytes = color_nb_bits > 8;
 #endif
 
+    const bool useParallelEncoder = options.parallelEncoding && !options.interlace;
+
+    if (swapBytes && !useParallelEncoder)
+        png_set_swap(png_ptr);
+
     // Write the PNG
     //     png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, 0);
 
@@ -1388,6 +1406,22 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         }
     }
 
+    if (useParallelEncoder) {
+        KisPNGParallelEncoder encoder(imageRect.width(),
+                                      color_nb_bits * png_get_channels(png_ptr, info_ptr),
+                                      options.compression,
+                                      filterStrategy,
+                                      swapBytes);
+
+        const QByteArray imageData = encoder.encode(rowPointers.rows, rowPointers.numRows);
+
+        // all the other chunks have already been written by png_write_info()
+        const bool result = KisPNGParallelEncoder::writeImageData(iodevice, imageData);
+
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        return result ? ImportExportCodes::OK : ImportExportCodes::ErrorWhileWriting;
+    }
+
     png_write_image(png_ptr, rowPointers.rows);
 
     // Writing is over
@@ -17,6 +17,7 @@
 #include "kis_annotation.h"
 #include <kritaui_export.h>
 #include <KisImportExportErrorCode.h>
+#include "KisPNGParallelEncoder.h"
 
 class KoStore;
 class KisDocument;
@@ -43,6 +44,8 @@ struct KisPNGOptions {
         , storeMetaData(false)
         , storeAuthor(false)
         , saveAsHDR(false)
+        , filterStrategy(KisPNGParallelEncoder::FilterAdaptive)
+        , parallelEncoding(false)
         , transparencyFillColor(Qt::white)
     {}
 
@@ -58,6 +61,8 @@ struct KisPNGOptions {
     bool storeMetaData;
     bool storeAuthor;
     bool saveAsHDR;
+    KisPNGParallelEncoder::FilterStrategy filterStrategy;
+    bool parallelEncoding; ///< filter and deflate the rows on all the cores
     QList<const KisMetaData::Filter*> filters;
     QColor transparencyFillColor;
 
@@ -35,6 +35,7 @@
 #include <kis_paint_device.h>
 #include <kis_selection_manager.h>
 #include "kis_memory_statistics_server.h"
+#include <KisResourceLocator.h>
 
 #include "KisView.h"
 #include "KisDocument.h"
@@ -288,9 +289,9 @@ void KisStatusBar::updateMemoryStatus()
                   "Memory used:\t %1 / %2\n"
                   "  image data:\t %3 / %4\n"
                   "  pool:\t\t %5 / %6\n"
-                  "  undo data:\t %7\n"
+                  "  undo data:\t %7 / %8\n"
                   "\n"
-                  "Swap used:\t %8",
+                  "Swap used:\t %9",
                   format.formatByteSize(stats.totalMemorySize),
                   format.formatByteSize(stats.totalMemoryLimit),
 
@@ -301,9 +302,19 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.tilesPoolLimit),
 
                   format.formatByteSize(stats.historicalMemorySize),
+                  format.formatByteSize(stats.historicalMemoryLimit),
                   format.formatByteSize(stats.swapSize));
 
-    QString longStats = imageStatsMsg + "\n" + memoryStatsMsg;
+    const KisResourceLruCache::Statistics resourceStats =
+            KisResourceLocator::instance()->resourceCacheStatistics();
+
+    const QString resourceStatsMsg =
+            i18nc("tooltip on statusbar memory reporting button (resource stats)",
+                  "Resources:\t %1 / %2",
+                  format.formatByteSize(resourceStats.memorySize),
+                  format.formatByteSize(resourceStats.memoryLimit));
+
+    QString longStats = imageStatsMsg + "\n" + memoryStatsMsg + "\n" + resourceStatsMsg;
 
     QString shortStats = format.formatByteSize(stats.imageSize);
     QIcon icon;
@@ -0,0 +1,158 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisAnimationFrameStreamWriterTest.h"
+
+#include <simpletest.h>
+
+#include <chrono>
+#include <future>
+
+#include <QBuffer>
+#include <QSignalSpy>
+
+#include "kis_time_span.h"
+#include "animation/KisAnimationFrameStreamWriter.h"
+
+namespace {
+
+/**
+ * Keeps everything written in its write buffer until drained,
+ * the way QProcess does while the encoder is busy
+ */
+class SlowEncoderDevice : public QBuffer
+{
+public:
+    qint64 bytesToWrite() const override {
+        return m_pendingBytes;
+    }
+
+    void drain() {
+        const qint64 bytes = m_pendingBytes;
+        m_pendingBytes = 0;
+        emit bytesWritten(bytes);
+    }
+
+protected:
+    qint64 writeData(const char *data, qint64 len) override {
+        m_pendingBytes += len;
+        return QBuffer::writeData(data, len);
+    }
+
+private:
+    qint64 m_pendingBytes = 0;
+};
+
+}
+
+void KisAnimationFrameStreamWriterTest::testFramesOrder()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    KisAnimationFrameStreamWriter writer(&buffer, KisTimeSpan::fromTimeToTime(0, 5), 16);
+
+    // the frames are completed in random order, frames 0, 2 and 4 are held
+    QVERIFY(writer.addFrame(2, KisTimeSpan::fromTimeToTime(2, 3), "cc"));
+    QVERIFY(writer.addFrame(4, KisTimeSpan::fromTimeToTime(4, 7), "ee"));
+
+    writer.flush();
+    QCOMPARE(writer.writtenFramesCount(), 0);
+    QVERIFY(!writer.isComplete());
+
+    QVERIFY(writer.addFrame(0, KisTimeSpan::fromTimeToTime(0, 1), "aa"));
+
+    writer.flush();
+    QCOMPARE(writer.writtenFramesCount(), 6);
+    QVERIFY(writer.isComplete());
+    QVERIFY(!writer.hasFailed());
+
+    // the hold of the last frame is cut at the end of the range
+    QCOMPARE(buffer.data(), QByteArray("aaaacccceeee"));
+}
+
+void KisAnimationFrameStreamWriterTest::testBufferLimit()
+{
+    using namespace std::chrono_literals;
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    KisAnimationFrameStreamWriter writer(&buffer, KisTimeSpan::fromTimeToTime(0, 2), 1);
+
+    QVERIFY(writer.addFrame(1, KisTimeSpan::fromTimeToTime(1, 1), "b"));
+
+    std::future<bool> blockedFrame = std::async(std::launch::async, [&writer] () {
+        return writer.addFrame(2, KisTimeSpan::fromTimeToTime(2, 2), "c");
+    });
+
+    QVERIFY(blockedFrame.wait_for(100ms) == std::future_status::timeout);
+
+    // the frame the encoder waits for is accepted even when the buffer is full
+    QVERIFY(writer.addFrame(0, KisTimeSpan::fromTimeToTime(0, 0), "a"));
+    writer.flush();
+
+    QVERIFY(blockedFrame.get());
+
+    writer.flush();
+    QVERIFY(writer.isComplete());
+    QCOMPARE(buffer.data(), QByteArray("abc"));
+}
+
+void KisAnimationFrameStreamWriterTest::testCancel()
+{
+    using namespace std::chrono_literals;
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    KisAnimationFrameStreamWriter writer(&buffer, KisTimeSpan::fromTimeToTime(0, 2), 1);
+
+    QVERIFY(writer.addFrame(1, KisTimeSpan::fromTimeToTime(1, 1), "b"));
+
+    std::future<bool> blockedFrame = std::async(std::launch::async, [&writer] () {
+        return writer.addFrame(2, KisTimeSpan::fromTimeToTime(2, 2), "c");
+    });
+
+    QVERIFY(blockedFrame.wait_for(100ms) == std::future_status::timeout);
+
+    writer.cancel();
+
+    QVERIFY(!blockedFrame.get());
+    QVERIFY(!writer.addFrame(0, KisTimeSpan::fromTimeToTime(0, 0), "a"));
+
+    writer.flush();
+    QVERIFY(!writer.isComplete());
+    QCOMPARE(writer.writtenFramesCount(), 0);
+    QVERIFY(buffer.data().isEmpty());
+}
+
+void KisAnimationFrameStreamWriterTest::testSlowEncoder()
+{
+    SlowEncoderDevice device;
+    device.open(QIODevice::WriteOnly);
+
+    KisAnimationFrameStreamWriter writer(&device, KisTimeSpan::fromTimeToTime(0, 4), 1);
+    QSignalSpy finishedSpy(&writer, SIGNAL(sigFinished()));
+
+    QVERIFY(writer.addFrame(0, KisTimeSpan::fromTimeToTime(0, 4), "a"));
+
+    // the writer doesn't wait for the encoder, it stops when the pipe is full
+    writer.flush();
+    QCOMPARE(writer.writtenFramesCount(), 3);
+    QVERIFY(!writer.isComplete());
+    QVERIFY(!writer.hasFailed());
+    QCOMPARE(finishedSpy.count(), 0);
+
+    // ...and continues when the encoder has taken the data
+    device.drain();
+    QCOMPARE(writer.writtenFramesCount(), 5);
+    QVERIFY(writer.isComplete());
+    QCOMPARE(finishedSpy.count(), 1);
+
+    QCOMPARE(device.data(), QByteArray("aaaaa"));
+}
+
+SIMPLE_TEST_MAIN(KisAnimationFrameStreamWriterTest)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISANIMATIONFRAMESTREAMWRITERTEST_H
+#define KISANIMATIONFRAMESTREAMWRITERTEST_H
+
+#include <QObject>
+
+class KisAnimationFrameStreamWriterTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFramesOrder();
+    void testBufferLimit();
+    void testCancel();
+    void testSlowEncoder();
+};
+
+#endif // KISANIMATIONFRAMESTREAMWRITERTEST_H
@@ -0,0 +1,344 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "StrokeReplayBenchmark.h"
+
+#include <simpletest.h>
+#include <sdk/tests/testui.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTemporaryDir>
+
+#include <KoCanvasResourceProvider.h>
+#include <KisResourceLocator.h>
+#include <KisResourceModel.h>
+#include <KisResourceStorage.h>
+#include <KisGlobalResourcesInterface.h>
+#include <brushengine/kis_paintop_preset.h>
+
+#include "stroke_testing_utils.h"
+#include "testutil.h"
+#include "KisPart.h"
+#include "KisDocument.h"
+#include "KisTimelineTracer.h"
+#include "kis_distance_information.h"
+#include "kis_image.h"
+#include "kis_layer_utils.h"
+#include "kis_paint_layer.h"
+#include "kis_painting_information_builder.h"
+#include "tool/kis_tool_freehand_helper.h"
+#include "tool/KisStrokeEventsRecorder.h"
+
+namespace {
+
+class ReplayFreehandHelper : public KisToolFreehandHelper
+{
+public:
+    ReplayFreehandHelper(KisPaintingInformationBuilder *infoBuilder,
+                         KoCanvasResourceProvider *resourceManager)
+        : KisToolFreehandHelper(infoBuilder, resourceManager, kundo2_noi18n("Replayed Stroke"))
+    {
+    }
+
+    void startStroke(const KisPaintInformation &pi, KisImageSP image, KisNodeSP node) {
+        initPaintImpl(0.0, pi, resourceManager(), image, node, image.data());
+    }
+
+    using KisToolFreehandHelper::paint;
+};
+
+/**
+ * Measures the time between feeding an event into the stroke and
+ * the moment the image reports the area under the event as updated
+ */
+class UpdateLatencyTracker
+{
+public:
+    UpdateLatencyTracker() {
+        m_timer.start();
+    }
+
+    void addEvent(const QPointF &pos) {
+        QMutexLocker l(&m_mutex);
+        m_pendingEvents.append({pos.toPoint(), m_timer.nsecsElapsed()});
+    }
+
+    void notifyImageUpdated(const QRect &rc) {
+        const qint64 time = m_timer.nsecsElapsed();
+
+        QMutexLocker l(&m_mutex);
+
+        for (auto it = m_pendingEvents.begin(); it != m_pendingEvents.end();) {
+            if (rc.contains(it->pos)) {
+                m_latencies.append(time - it->time);
+                it = m_pendingEvents.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    QVector<qint64> takeLatencies() {
+        QMutexLocker l(&m_mutex);
+        QVector<qint64> result = m_latencies;
+        std::sort(result.begin(), result.end());
+        m_latencies.clear();
+        return result;
+    }
+
+    int takeNumLostEvents() {
+        QMutexLocker l(&m_mutex);
+        const int result = m_pendingEvents.size();
+        m_pendingEvents.clear();
+        return result;
+    }
+
+private:
+    struct PendingEvent {
+        QPoint pos;
+        qint64 time;
+    };
+
+    QElapsedTimer m_timer;
+    QMutex m_mutex;
+    QVector<PendingEvent> m_pendingEvents;
+    QVector<qint64> m_latencies;
+};
+
+qreal percentileMs(const QVector<qint64> &sortedNs, qreal percentile)
+{
+    if (sortedNs.isEmpty()) return 0.0;
+
+    const int index = qBound(0, qRound(percentile * (sortedNs.size() - 1)), sortedNs.size() - 1);
+    return sortedNs[index] / 1e6;
+}
+
+qreal totalSpansDurationMs(const QByteArray &trace, const QString &category, const QString &namePrefix)
+{
+    qreal result = 0.0;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(trace);
+    Q_FOREACH (const QJsonValue &value, doc.object()["traceEvents"].toArray()) {
+        const QJsonObject event = value.toObject();
+        if (event["cat"].toString() == category && event["name"].toString().startsWith(namePrefix)) {
+            result += event["dur"].toDouble();
+        }
+    }
+
+    return result / 1000.0;
+}
+
+KisStrokeEventsRecorder::Stroke syntheticStroke()
+{
+    KisStrokeEventsRecorder::Stroke stroke;
+
+    // a wavy line sampled at 200 Hz, as a regular tablet does
+    for (int i = 0; i < 600; i++) {
+        const qreal t = 5.0 * i;
+        const QPointF pos(200 + 5.0 * i, 2000 + 800 * std::sin(i / 60.0));
+        const qreal pressure = 0.3 + 0.7 * std::abs(std::sin(i / 100.0));
+
+        stroke.append(KisPaintInformation(pos, pressure, 0.0, 0.0, 0.0, 0.0, 1.0, t, 1.0));
+    }
+
+    return stroke;
+}
+
+KisPaintOpPresetSP loadPreset(const QString &presetName)
+{
+    KisPaintOpPresetSP preset;
+
+    if (QFileInfo(presetName).isAbsolute() || QFileInfo(presetName).exists()) {
+        preset = new KisPaintOpPreset(presetName);
+    } else {
+        KisResourceModel model(ResourceType::PaintOpPresets);
+        QVector<KoResourceSP> resources = model.resourcesForName(presetName);
+
+        if (!resources.isEmpty()) {
+            return resources.first().dynamicCast<KisPaintOpPreset>();
+        }
+
+        preset = new KisPaintOpPreset(TestUtil::fetchDataFileLazy(presetName));
+    }
+
+    return preset->load(KisGlobalResourcesInterface::instance()) ? preset : KisPaintOpPresetSP();
+}
+
+}
+
+void StrokeReplayBenchmark::testEventsSerialization()
+{
+    KisStrokeEventsRecorder::Stroke stroke;
+    stroke << KisPaintInformation(QPointF(10.5, 20.25), 0.3, 10.0, -20.0, 45.0, 0.5, 1.0, 0.0, 0.1);
+    stroke << KisPaintInformation(QPointF(15.0, 25.0), 0.7, 12.0, -18.0, 46.0, 0.25, 1.0, 8.0, 0.2);
+
+    KisStrokeEventsRecorder::Stroke restored;
+    QVERIFY(KisStrokeEventsRecorder::deserializeStroke(KisStrokeEventsRecorder::serializeStroke(stroke), &restored));
+    QCOMPARE(restored.size(), stroke.size());
+
+    for (int i = 0; i < stroke.size(); i++) {
+        QCOMPARE(restored[i].pos(), stroke[i].pos());
+        QCOMPARE(restored[i].pressure(), stroke[i].pressure());
+        QCOMPARE(restored[i].xTilt(), stroke[i].xTilt());
+        QCOMPARE(restored[i].yTilt(), stroke[i].yTilt());
+        QCOMPARE(restored[i].rotation(), stroke[i].rotation());
+        QCOMPARE(restored[i].tangentialPressure(), stroke[i].tangentialPressure());
+        QCOMPARE(restored[i].currentTime(), stroke[i].currentTime());
+    }
+
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath("strokes.json");
+
+    KisStrokeEventsRecorder recorder(fileName);
+    QVERIFY(recorder.isEnabled());
+
+    Q_FOREACH (const KisPaintInformation &pi, stroke) {
+        recorder.addEvent(pi);
+    }
+    recorder.endStroke();
+
+    recorder.addEvent(stroke.first());
+    recorder.cancelStroke();
+
+    recorder.addEvent(stroke.last());
+    recorder.endStroke();
+
+    const QVector<KisStrokeEventsRecorder::Stroke> strokes = KisStrokeEventsRecorder::loadStrokes(fileName);
+    QCOMPARE(strokes.size(), 2);
+    QCOMPARE(strokes[0].size(), 2);
+    QCOMPARE(strokes[1].size(), 1);
+    QCOMPARE(strokes[1].first().pos(), stroke.last().pos());
+}
+
+void StrokeReplayBenchmark::benchmarkReplay()
+{
+    const QString eventsFile = qEnvironmentVariable("KRITA_REPLAY_EVENTS");
+    const QString documentFile = qEnvironmentVariable("KRITA_REPLAY_DOCUMENT");
+    const QString bundleFile = qEnvironmentVariable("KRITA_REPLAY_BUNDLE");
+    const QString traceFile = qEnvironmentVariable("KRITA_REPLAY_TRACE");
+    const QString presetName = qEnvironmentVariable("KRITA_REPLAY_PRESET", "autobrush_300px.kpp");
+    const bool usePacing = !qEnvironmentVariableIsSet("KRITA_REPLAY_NO_PACING");
+
+    QVector<KisStrokeEventsRecorder::Stroke> strokes;
+    if (!eventsFile.isEmpty()) {
+        strokes = KisStrokeEventsRecorder::loadStrokes(eventsFile);
+    } else {
+        strokes << syntheticStroke();
+    }
+    QVERIFY(!strokes.isEmpty());
+
+    if (!bundleFile.isEmpty()) {
+        QVERIFY(KisResourceLocator::instance()->addStorage(bundleFile, KisResourceStorageSP(new KisResourceStorage(bundleFile))));
+    }
+
+    KisPaintOpPresetSP preset = loadPreset(presetName);
+    QVERIFY(preset);
+
+    QScopedPointer<KisDocument> doc;
+    KisImageSP image;
+
+    if (!documentFile.isEmpty()) {
+        doc.reset(KisPart::instance()->createDocument());
+        QVERIFY(doc->loadNativeFormat(documentFile));
+        image = doc->image();
+    } else {
+        image = utils::createImage(0, QSize(4000, 4000));
+    }
+    image->waitForDone();
+
+    KisNodeSP node = KisLayerUtils::findNodeByType<KisPaintLayer>(image->root());
+    QVERIFY(node);
+
+    QScopedPointer<KoCanvasResourceProvider> manager(utils::createResourceManager(image, node, QString()));
+    manager->setResource(KoCanvasResource::CurrentPaintOpPreset, QVariant::fromValue(preset));
+
+    KisPaintingInformationBuilder infoBuilder;
+    ReplayFreehandHelper helper(&infoBuilder, manager.data());
+
+    UpdateLatencyTracker latencyTracker;
+    QObject::connect(image.data(), &KisImage::sigImageUpdated,
+                     [&latencyTracker] (const QRect &rc) {
+                         latencyTracker.notifyImageUpdated(rc);
+                     });
+
+    KisTimelineTracer *tracer = KisTimelineTracer::instance();
+    tracer->clear();
+    tracer->setEnabled(true);
+
+    KisDistanceInformation::takeNumPaintedDabs();
+
+    QElapsedTimer totalTime;
+    totalTime.start();
+
+    int numEvents = 0;
+
+    Q_FOREACH (const KisStrokeEventsRecorder::Stroke &stroke, strokes) {
+        QElapsedTimer strokeTime;
+        strokeTime.start();
+
+        const qreal startTime = stroke.first().currentTime();
+
+        latencyTracker.addEvent(stroke.first().pos());
+        helper.startStroke(stroke.first(), image, node);
+
+        for (int i = 1; i < stroke.size(); i++) {
+            KisPaintInformation pi = stroke[i];
+
+            if (usePacing) {
+                const int delay = qRound(pi.currentTime() - startTime) - strokeTime.elapsed();
+                if (delay > 0) {
+                    QTest::qWait(delay);
+                }
+            }
+
+            latencyTracker.addEvent(pi.pos());
+            helper.paint(pi);
+        }
+
+        helper.endPaint();
+        numEvents += stroke.size();
+    }
+
+    image->waitForDone();
+
+    const qint64 elapsed = totalTime.elapsed();
+    const qint64 numDabs = KisDistanceInformation::takeNumPaintedDabs();
+
+    tracer->setEnabled(false);
+    const QByteArray trace = tracer->toChromeTrace();
+
+    if (!traceFile.isEmpty()) {
+        tracer->saveChromeTrace(traceFile);
+    }
+
+    const QVector<qint64> latencies = latencyTracker.takeLatencies();
+    const int numLostEvents = latencyTracker.takeNumLostEvents();
+
+    qDebug() << qPrintable(QString("Strokes: %1 Events: %2 Time: %3 (ms)")
+                           .arg(strokes.size()).arg(numEvents).arg(elapsed));
+    qDebug() << qPrintable(QString("Dabs: %1 Throughput: %2 (dabs/s)")
+                           .arg(numDabs).arg(numDabs * 1000.0 / qMax(elapsed, qint64(1)), 0, 'f', 1));
+    qDebug() << qPrintable(QString("Stroke jobs: %1 (ms) Merge: %2 (ms)")
+                           .arg(totalSpansDurationMs(trace, "stroke", "FREEHAND_STROKE"), 0, 'f', 1)
+                           .arg(totalSpansDurationMs(trace, "merge", "merge walker"), 0, 'f', 1));
+    qDebug() << qPrintable(QString("Latency p50: %1 p90: %2 p99: %3 max: %4 (ms) Events without update: %5")
+                           .arg(percentileMs(latencies, 0.5), 0, 'f', 2)
+                           .arg(percentileMs(latencies, 0.9), 0, 'f', 2)
+                           .arg(percentileMs(latencies, 0.99), 0, 'f', 2)
+                           .arg(percentileMs(latencies, 1.0), 0, 'f', 2)
+                           .arg(numLostEvents));
+}
+
+KISTEST_MAIN(StrokeReplayBenchmark)
@@ -0,0 +1,38 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef STROKEREPLAYBENCHMARK_H
+#define STROKEREPLAYBENCHMARK_H
+
+#include <simpletest.h>
+
+/**
+ * Replays the strokes recorded by KisStrokeEventsRecorder through the full
+ * freehand stroke pipeline (smoothing, stroke strategy, update scheduler)
+ * and reports the dab throughput, the time spent in merging and the
+ * latency of the image updates.
+ *
+ * The replay is configured with the environment variables:
+ *
+ * KRITA_REPLAY_EVENTS   the file with the recorded strokes; a synthetic
+ *                       stroke is used when not set
+ * KRITA_REPLAY_DOCUMENT the .kra file to paint on; a blank image is used
+ *                       when not set
+ * KRITA_REPLAY_PRESET   the .kpp file or the name of the preset
+ * KRITA_REPLAY_BUNDLE   the bundle to load the preset from
+ * KRITA_REPLAY_NO_PACING when set, the events are fed as fast as possible
+ *                       instead of following the recorded timing
+ * KRITA_REPLAY_TRACE    the file to save the Chrome trace of the replay to
+ */
+class StrokeReplayBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEventsSerialization();
+    void benchmarkReplay();
+};
+
+#endif // STROKEREPLAYBENCHMARK_H
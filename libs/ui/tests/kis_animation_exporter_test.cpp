@@ -8,6 +8,8 @@
 
 #include "dialogs/KisAsyncAnimationFramesSaveDialog.h"
 
+#include <QFile>
+
 #include <simpletest.h>
 #include <testutil.h>
 #include "KisPart.h"
@@ -20,6 +22,48 @@
 #include "kis_keyframe_channel.h"
 #include <testui.h>
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool isSameFile(const QString &lhs, const QString &rhs)
+{
+    struct stat lhsStat;
+    struct stat rhsStat;
+
+    if (::stat(QFile::encodeName(lhs).constData(), &lhsStat) ||
+        ::stat(QFile::encodeName(rhs).constData(), &rhsStat)) {
+        return false;
+    }
+
+    return lhsStat.st_dev == rhsStat.st_dev && lhsStat.st_ino == rhsStat.st_ino;
+}
+
+bool canHardLinkFiles()
+{
+    const QString probe("export-held-test-probe.tmp");
+    const QString probeLink("export-held-test-probe-link.tmp");
+
+    QFile::remove(probeLink);
+
+    QFile file(probe);
+    if (!file.open(QFile::WriteOnly)) return false;
+    file.close();
+
+    const bool result = !::link(QFile::encodeName(probe).constData(),
+                                QFile::encodeName(probeLink).constData());
+
+    QFile::remove(probe);
+    QFile::remove(probeLink);
+
+    return result;
+}
+
+}
+#endif
+
 void KisAnimationExporterTest::testAnimationExport()
 {
     KisDocument *document = KisPart::instance()->createDocument();
@@ -87,4 +131,83 @@ void KisAnimationExporterTest::testAnimationExport()
     }
 }
 
+void KisAnimationExporterTest::testHeldFramesExport()
+{
+    KisDocument *document = KisPart::instance()->createDocument();
+    QRect rect(0,0,512,512);
+    QRect fillRect(10,0,502,512);
+    TestUtil::MaskParent p(rect);
+    document->setCurrentImage(p.image);
+    const KoColorSpace *cs = p.image->colorSpace();
+
+    KUndo2Command parentCommand;
+
+    p.layer->enableAnimation();
+    KisKeyframeChannel *rasterChannel = p.layer->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+
+    // the frames are held for two frames each, "on twos"
+    rasterChannel->addKeyframe(2, &parentCommand);
+    p.image->animationInterface()->setFullClipRange(KisTimeSpan::fromTimeToTime(0, 3));
+
+    KisPaintDeviceSP dev = p.layer->paintDevice();
+
+    dev->fill(fillRect, KoColor(Qt::red, cs));
+    QImage frame0 = dev->convertToQImage(0, rect);
+
+    p.image->animationInterface()->switchCurrentTimeAsync(2);
+    p.image->waitForDone();
+    dev->fill(fillRect, KoColor(Qt::blue, cs));
+    QImage frame2 = dev->convertToQImage(0, rect);
+
+    KisAsyncAnimationFramesSaveDialog exporter(document->image(),
+                                               KisTimeSpan::fromTimeToTime(0,3),
+                                               "export-held-test.png",
+                                               0,
+                                               false,
+                                               0);
+    exporter.setLinkIdenticalFrames(true);
+    exporter.setBatchMode(true);
+
+    QCOMPARE(exporter.getUniqueFrames(), QList<int>({0, 2}));
+
+    const QVector<QPair<QString, QImage>> expectedFrames = {
+        {"export-held-test0000.png", frame0},
+        {"export-held-test0001.png", frame0},
+        {"export-held-test0002.png", frame2},
+        {"export-held-test0003.png", frame2}
+    };
+
+    // the files left by a previous run would block the links
+    for (const auto &expected : expectedFrames) {
+        QFile::remove(expected.first);
+    }
+
+    exporter.regenerateRange(0);
+
+    QTest::qWait(1000);
+
+    QCOMPARE(exporter.reusedFramesCount(), 2);
+
+    for (const auto &expected : expectedFrames) {
+        QImage exported;
+        QPoint errpoint;
+
+        QVERIFY(exported.load(expected.first));
+        if (!TestUtil::compareQImages(errpoint, exported, expected.second)) {
+            QFAIL(QString("Failed to export held frame %1, first different pixel: %2,%3 \n")
+                  .arg(expected.first).arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+        }
+    }
+
+#ifdef Q_OS_UNIX
+    // the held frames are links to the rendered ones, and become
+    // copies only when the file system cannot link
+    const bool canLink = canHardLinkFiles();
+
+    QCOMPARE(isSameFile("export-held-test0000.png", "export-held-test0001.png"), canLink);
+    QCOMPARE(isSameFile("export-held-test0002.png", "export-held-test0003.png"), canLink);
+    QVERIFY(!isSameFile("export-held-test0000.png", "export-held-test0002.png"));
+#endif
+}
+
 KISTEST_MAIN(KisAnimationExporterTest)
@@ -15,6 +15,7 @@ class KisAnimationExporterTest : public QObject
 
 private Q_SLOTS:
     void testAnimationExport();
+    void testHeldFramesExport();
 
 };
 #endif
@@ -0,0 +1,143 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisStrokeEventsRecorder.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "kis_config.h"
+#include "kis_debug.h"
+
+namespace {
+
+/**
+ * Every event is stored as an array of
+ * [time, x, y, pressure, xTilt, yTilt, rotation, tangentialPressure, perspective, speed]
+ */
+const int formatVersion = 1;
+const int numEventFields = 10;
+
+}
+
+KisStrokeEventsRecorder::KisStrokeEventsRecorder()
+    : m_fileName(KisConfig(true).strokeEventsRecordingFile())
+{
+}
+
+KisStrokeEventsRecorder::KisStrokeEventsRecorder(const QString &fileName)
+    : m_fileName(fileName)
+{
+}
+
+bool KisStrokeEventsRecorder::isEnabled() const
+{
+    return !m_fileName.isEmpty();
+}
+
+void KisStrokeEventsRecorder::addEvent(const KisPaintInformation &pi)
+{
+    if (!isEnabled()) return;
+
+    m_currentStroke.append(pi);
+}
+
+void KisStrokeEventsRecorder::endStroke()
+{
+    if (!isEnabled() || m_currentStroke.isEmpty()) return;
+
+    QFile file(m_fileName);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        file.write(serializeStroke(m_currentStroke));
+        file.write("\n");
+    } else {
+        warnKrita << "KisStrokeEventsRecorder: failed to open the recording file" << m_fileName;
+    }
+
+    m_currentStroke.clear();
+}
+
+void KisStrokeEventsRecorder::cancelStroke()
+{
+    m_currentStroke.clear();
+}
+
+QByteArray KisStrokeEventsRecorder::serializeStroke(const Stroke &stroke)
+{
+    QJsonArray events;
+
+    Q_FOREACH (const KisPaintInformation &pi, stroke) {
+        events.append(QJsonArray{pi.currentTime(),
+                                 pi.pos().x(), pi.pos().y(),
+                                 pi.pressure(),
+                                 pi.xTilt(), pi.yTilt(),
+                                 pi.rotation(),
+                                 pi.tangentialPressure(),
+                                 pi.perspective(),
+                                 pi.drawingSpeed()});
+    }
+
+    QJsonObject root;
+    root["version"] = formatVersion;
+    root["events"] = events;
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool KisStrokeEventsRecorder::deserializeStroke(const QByteArray &data, Stroke *stroke)
+{
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) return false;
+
+    const QJsonObject root = doc.object();
+    if (root["version"].toInt() != formatVersion) return false;
+
+    stroke->clear();
+
+    Q_FOREACH (const QJsonValue &value, root["events"].toArray()) {
+        const QJsonArray e = value.toArray();
+        if (e.size() != numEventFields) return false;
+
+        stroke->append(KisPaintInformation(QPointF(e[1].toDouble(), e[2].toDouble()),
+                                           e[3].toDouble(),
+                                           e[4].toDouble(), e[5].toDouble(),
+                                           e[6].toDouble(),
+                                           e[7].toDouble(),
+                                           e[8].toDouble(),
+                                           e[0].toDouble(),
+                                           e[9].toDouble()));
+    }
+
+    return !stroke->isEmpty();
+}
+
+QVector<KisStrokeEventsRecorder::Stroke> KisStrokeEventsRecorder::loadStrokes(const QString &fileName)
+{
+    QVector<Stroke> strokes;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        warnKrita << "KisStrokeEventsRecorder: failed to open the recording file" << fileName;
+        return strokes;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        Stroke stroke;
+        if (deserializeStroke(line, &stroke)) {
+            strokes.append(stroke);
+        } else {
+            warnKrita << "KisStrokeEventsRecorder: skipping a malformed stroke in" << fileName;
+        }
+    }
+
+    return strokes;
+}
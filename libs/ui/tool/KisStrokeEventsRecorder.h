@@ -0,0 +1,78 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita contributors
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKEEVENTSRECORDER_H
+#define KISSTROKEEVENTSRECORDER_H
+
+#include "kritaui_export.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <brushengine/kis_paint_information.h>
+
+/**
+ * Records the painting events of the freehand strokes (position, pressure,
+ * tilt, rotation and timing) into a file, so that the strokes can later be
+ * replayed in a headless benchmark to reproduce the slowness reported by
+ * the users.
+ *
+ * The events are recorded as they come out of KisPaintingInformationBuilder,
+ * that is, before the smoothing is applied. The file contains one stroke
+ * per line, each stroke is a JSON object.
+ *
+ * The recording is enabled by setting "strokeEventsRecordingFile" in the
+ * config.
+ */
+class KRITAUI_EXPORT KisStrokeEventsRecorder
+{
+public:
+    typedef QVector<KisPaintInformation> Stroke;
+
+public:
+    /**
+     * Creates a recorder writing into the file set in the config
+     */
+    KisStrokeEventsRecorder();
+
+    /**
+     * Creates a recorder writing into \p fileName. The recorder is
+     * disabled if \p fileName is empty.
+     */
+    KisStrokeEventsRecorder(const QString &fileName);
+
+    bool isEnabled() const;
+
+    void addEvent(const KisPaintInformation &pi);
+
+    /**
+     * Appends the events collected since the previous call to
+     * endStroke() or cancelStroke() to the file
+     */
+    void endStroke();
+
+    /**
+     * Drops the events collected since the previous call to
+     * endStroke() or cancelStroke()
+     */
+    void cancelStroke();
+
+    static QByteArray serializeStroke(const Stroke &stroke);
+    static bool deserializeStroke(const QByteArray &data, Stroke *stroke);
+
+    /**
+     * Loads all the strokes stored in \p fileName. Malformed strokes
+     * are skipped.
+     */
+    static QVector<Stroke> loadStrokes(const QString &fileName);
+
+private:
+    QString m_fileName;
+    Stroke m_currentStroke;
+};
+
+#endif // KISSTROKEEVENTSRECORDER_H
@@ -17,6 +17,7 @@
 #include "kis_config.h"
 #include "kis_config_notifier.h"
 #include "KisImageConfigNotifier.h"
+#include <brushengine/KisDabMaskCache.h>
 
 
 Q_GLOBAL_STATIC(KisStrokeSpeedMonitor, s_instance)
@@ -45,6 +46,7 @@ struct KisStrokeSpeedMonitor::Private
     qreal lastRenderingSpeed = 0;
     qreal lastFps = 0;
     bool lastStrokeSaturated = false;
+    qreal lastDabCacheHitRate = 0;
 
     QByteArray lastPresetMd5;
     QString lastPresetName;
@@ -120,6 +122,7 @@ void KisStrokeSpeedMonitor::notifyStrokeFinished(qreal cursorSpeed, qreal render
     m_d->lastCursorSpeed = cursorSpeed;
     m_d->lastRenderingSpeed = renderingSpeed;
     m_d->lastFps = fps;
+    m_d->lastDabCacheHitRate = KisDabMaskCache::instance()->takeStatistics().hitRate();
 
 
     static const qreal saturationSpeedThreshold = 0.30; // cursor speed should be at least 30% higher
@@ -140,10 +143,11 @@ void KisStrokeSpeedMonitor::notifyStrokeFinished(qreal cursorSpeed, qreal render
 
 
     ENTER_FUNCTION() <<
-        QString(" CS: %1  RS: %2  FPS: %3 %4")
+        QString(" CS: %1  RS: %2  FPS: %3 DCH: %4 %5")
             .arg(m_d->lastCursorSpeed, 5)
             .arg(m_d->lastRenderingSpeed, 5)
             .arg(m_d->lastFps, 5)
+            .arg(m_d->lastDabCacheHitRate, 5)
             .arg(m_d->lastStrokeSaturated ? "(saturated)" : "");
     ENTER_FUNCTION() <<
         QString("ACS: %1 ARS: %2 AFPS: %3")
@@ -182,6 +186,11 @@ bool KisStrokeSpeedMonitor::lastStrokeSaturated() const
     return m_d->lastStrokeSaturated;
 }
 
+qreal KisStrokeSpeedMonitor::lastDabCacheHitRate() const
+{
+    return m_d->lastDabCacheHitRate;
+}
+
 qreal KisStrokeSpeedMonitor::avgCursorSpeed() const
 {
     return m_d->cachedAvgCursorSpeed;
@@ -24,6 +24,7 @@ class KRITAUI_EXPORT KisStrokeSpeedMonitor : public QObject
     Q_PROPERTY(qreal lastFps READ lastFps NOTIFY sigStatsUpdated)
 
     Q_PROPERTY(bool lastStrokeSaturated READ lastCursorSpeed NOTIFY sigStatsUpdated)
+    Q_PROPERTY(qreal lastDabCacheHitRate READ lastDabCacheHitRate NOTIFY sigStatsUpdated)
 
     Q_PROPERTY(qreal avgCursorSpeed READ avgCursorSpeed NOTIFY sigStatsUpdated)
     Q_PROPERTY(qreal avgRenderingSpeed READ avgRenderingSpeed NOTIFY sigStatsUpdated)
@@ -48,6 +49,12 @@ public:
     qreal lastFps() const;
     bool lastStrokeSaturated() const;
 
+    /**
+     * The hit rate of the dab cache shared between the strokes
+     * (KisDabMaskCache) measured during the last stroke
+     */
+    qreal lastDabCacheHitRate() const;
+
     qreal avgCursorSpeed() const;
     qreal avgRenderingSpeed() const;
     qreal avgFps() const;
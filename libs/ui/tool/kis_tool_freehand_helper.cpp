@@ -34,6 +34,7 @@
 #include "strokes/freehand_stroke.h"
 #include "strokes/KisFreehandStrokeInfo.h"
 #include "KisAsyncronousStrokeUpdateHelper.h"
+#include "KisStrokeEventsRecorder.h"
 #include "kis_canvas_resource_provider.h"
 
 #include <math.h>
@@ -59,6 +60,7 @@ struct KisToolFreehandHelper::Private
     KisPaintingInformationBuilder *infoBuilder;
     KisStrokesFacade *strokesFacade;
     KisAsyncronousStrokeUpdateHelper asyncUpdateHelper;
+    KisStrokeEventsRecorder eventsRecorder;
 
     KUndo2MagicString transactionText;
 
@@ -239,6 +241,7 @@ void KisToolFreehandHelper::initPaint(KoPointerEvent *event,
     m_d->strokeTime.start();
     KisPaintInformation pi =
         m_d->infoBuilder->startStroke(event, elapsedStrokeTime(), m_d->resourceManager);
+    m_d->eventsRecorder.addEvent(pi);
     qreal startAngle = KisAlgebra2D::directionBetweenPoints(prevPoint, pixelCoords, 0.0);
 
     initPaintImpl(startAngle,
@@ -443,6 +446,7 @@ void KisToolFreehandHelper::paintEvent(KoPointerEvent *event)
             m_d->infoBuilder->continueStroke(event,
                                              elapsedStrokeTime());
     KisUpdateTimeMonitor::instance()->reportMouseMove(info.pos());
+    m_d->eventsRecorder.addEvent(info);
 
     paint(info);
 }
@@ -642,6 +646,7 @@ void KisToolFreehandHelper::endPaint()
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
     m_d->infoBuilder->reset();
+    m_d->eventsRecorder.endStroke();
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -671,6 +676,7 @@ void KisToolFreehandHelper::cancelPaint()
 
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
+    m_d->eventsRecorder.cancelStroke();
 
 }
 
@@ -96,6 +96,12 @@ protected:
 
     KoCanvasResourceProvider *resourceManager() const;
 
+    /**
+     * Paints the event as if it came from paintEvent(). Used for
+     * replaying the strokes recorded by KisStrokeEventsRecorder.
+     */
+    void paint(KisPaintInformation &info);
+
 protected:
 
     virtual void createPainters(QVector<KisFreehandStrokeInfo*> &strokeInfos,
@@ -128,7 +134,6 @@ protected:
                                   const KisPaintInformation &pi2);
 
 private:
-    void paint(KisPaintInformation &info);
     void paintBezierSegment(KisPaintInformation pi1, KisPaintInformation pi2,
                                                    QPointF tangent1, QPointF tangent2);
 
@@ -27,6 +27,7 @@
 #include <KisResourceItemChooserSync.h>
 #include <KisResourceItemListView.h>
 #include <KisResourceLocator.h>
+#include <KisResourceThumbnailLoader.h>
 #include <KisResourceTypes.h>
 
 #include <brushengine/kis_paintop_settings.h>
@@ -87,11 +88,16 @@ void KisPresetDelegate::paint(QPainter * painter, const QStyleOptionViewItem & o
 
     bool dirty = index.data(Qt::UserRole + KisAbstractResourceModel::Dirty).toBool();
 
-    QImage preview = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
+    QImage preview;
+    {
+        KisResourceThumbnailLoader::AsynchronousScope asynchronousThumbnails;
+        preview = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
+    }
 
     if (preview.isNull()) {
-        preview = QImage(512, 512, QImage::Format_RGB32);
-        preview.fill(Qt::red);
+        // the thumbnail is still being decoded, the view will be updated soon
+        preview = QImage(1, 1, QImage::Format_ARGB32);
+        preview.fill(Qt::transparent);
     }
 
     QMap<QString, QVariant> metaData = index.data(Qt::UserRole + KisAbstractResourceModel::MetaData).value<QMap<QString, QVariant>>();
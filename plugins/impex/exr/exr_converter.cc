@@ -11,10 +11,12 @@
 
 #include <ImfAttribute.h>
 #include <ImfChannelList.h>
+#include <ImfCompression.h>
 #include <ImfFrameBuffer.h>
 #include <ImfHeader.h>
 #include <ImfInputFile.h>
 #include <ImfOutputFile.h>
+#include <ImfTileDescription.h>
 
 #include <ImfStringAttribute.h>
 #include "exr_extra_tags.h"
@@ -23,6 +25,10 @@
 #include <QMessageBox>
 #include <QDomDocument>
 #include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
 
 #include <QFileInfo>
 
@@ -115,6 +121,12 @@ void ExrPaintLayerInfo::updateImageType(ImageType channelType)
     }
 }
 
+struct ExrPaintLayerDecodingJob {
+    ExrPaintLayerInfo *info = 0;
+    KisPaintLayerSP layer;
+    bool failed = false;
+};
+
 struct ExrPaintLayerSaveInfo {
     QString name; ///< name of the layer with a "." at the end (ie "group1.group2.layer1.")
     KisPaintDeviceSP layerDevice;
@@ -133,14 +145,21 @@ struct EXRConverter::Private {
     KisImageSP image;
     KisDocument *doc;
 
-    bool alphaWasModified;
+    std::atomic<bool> alphaWasModified;
     bool showNotifications;
 
+    std::atomic<qint64> decodingBufferSize {0};
+    std::atomic<qint64> peakDecodingBufferSize {0};
+
     QString errorMessage;
 
     template <class WrapperType>
     void unmultiplyAlpha(typename WrapperType::pixel_type *pixel);
 
+    void addDecodingBufferSize(qint64 delta);
+
+    void decodeLayer(const QString &filename, ExrPaintLayerDecodingJob &job, int width, int xstart, int ystart, int height);
+
     template<typename _T_>
     void decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
 
@@ -171,6 +190,45 @@ EXRConverter::~EXRConverter()
 {
 }
 
+/**
+ * The number of rows decoded at once. The pixels are compressed in blocks
+ * of 1 to 256 rows or in tiles, so we always read whole blocks to avoid
+ * decompressing them twice.
+ */
+const int preferredRowsPerDecodingBlock = 64;
+
+int nativeRowsPerBlock(const Imf::Header &header)
+{
+    if (header.hasTileDescription()) {
+        return qMax(1, int(header.tileDescription().ySize));
+    }
+
+    switch (header.compression()) {
+    case Imf::NO_COMPRESSION:
+    case Imf::RLE_COMPRESSION:
+    case Imf::ZIPS_COMPRESSION:
+        return 1;
+    case Imf::ZIP_COMPRESSION:
+    case Imf::PXR24_COMPRESSION:
+        return 16;
+    case Imf::PIZ_COMPRESSION:
+    case Imf::B44_COMPRESSION:
+    case Imf::B44A_COMPRESSION:
+    case Imf::DWAA_COMPRESSION:
+        return 32;
+    case Imf::DWAB_COMPRESSION:
+        return 256;
+    default:
+        return preferredRowsPerDecodingBlock;
+    }
+}
+
+int rowsPerDecodingBlock(const Imf::Header &header)
+{
+    const int nativeRows = nativeRowsPerBlock(header);
+    return nativeRows * ((preferredRowsPerDecodingBlock + nativeRows - 1) / nativeRows);
+}
+
 ImageType imfTypeToKisType(Imf::PixelType type)
 {
     switch (type) {
@@ -343,6 +401,14 @@ void EXRConverter::Private::unmultiplyAlpha(typename WrapperType::pixel_type *pi
     }
 }
 
+void EXRConverter::Private::addDecodingBufferSize(qint64 delta)
+{
+    const qint64 size = decodingBufferSize.fetch_add(delta) + delta;
+
+    qint64 peak = peakDecodingBufferSize.load();
+    while (size > peak && !peakDecodingBufferSize.compare_exchange_weak(peak, size));
+}
+
 template <typename T, typename Pixel, int size, int alphaPos>
 void multiplyAlpha(Pixel *pixel)
 {
@@ -366,55 +432,65 @@ void EXRConverter::Private::decodeData4(Imf::InputFile& file, ExrPaintLayerInfo&
 {
     typedef Rgba<_T_> Rgba;
 
-    QVector<Rgba> pixels(width * height);
+    const int rowsPerBlock = qMin(rowsPerDecodingBlock(file.header()), height);
+
+    QVector<Rgba> pixels(width * rowsPerBlock);
+    const qint64 bufferSize = pixels.size() * sizeof(Rgba);
+    addDecodingBufferSize(bufferSize);
 
     bool hasAlpha = info.channelMap.contains("A");
 
-    Imf::FrameBuffer frameBuffer;
-    Rgba* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->r,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->g,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->b,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->a,
+    for (int y = ystart; y < ystart + height; y += rowsPerBlock) {
+        const int numRows = qMin(rowsPerBlock, ystart + height - y);
+
+        Imf::FrameBuffer frameBuffer;
+        Rgba* frameBufferData = (pixels.data()) - xstart - y * width;
+        frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->r,
+                           sizeof(Rgba) * 1,
+                           sizeof(Rgba) * width));
+        frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->g,
+                           sizeof(Rgba) * 1,
+                           sizeof(Rgba) * width));
+        frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->b,
                            sizeof(Rgba) * 1,
                            sizeof(Rgba) * width));
-    }
-
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
-    Rgba *rgba = pixels.data();
-
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
         if (hasAlpha) {
-            unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
+            frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
+                    Imf::Slice(ptype, (char *) &frameBufferData->a,
+                               sizeof(Rgba) * 1,
+                               sizeof(Rgba) * width));
         }
 
-        typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(y, y + numRows - 1);
+        Rgba *rgba = pixels.data();
+
+        QRect paintRegion(xstart, y, width, numRows);
+        KisSequentialIterator it(layer->paintDevice(), paintRegion);
+        while (it.nextPixel()) {
+            if (hasAlpha) {
+                unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
+            }
 
-        dst->red = rgba->r;
-        dst->green = rgba->g;
-        dst->blue = rgba->b;
-        if (hasAlpha) {
-            dst->alpha = rgba->a;
-        } else {
-            dst->alpha = 1.0;
-        }
+            typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
 
-        ++rgba;
+            dst->red = rgba->r;
+            dst->green = rgba->g;
+            dst->blue = rgba->b;
+            if (hasAlpha) {
+                dst->alpha = rgba->a;
+            } else {
+                dst->alpha = 1.0;
+            }
+
+            ++rgba;
+        }
     }
+
+    addDecodingBufferSize(-bufferSize);
 }
 
 template<typename _T_>
@@ -426,7 +502,11 @@ void EXRConverter::Private::decodeData1(Imf::InputFile& file, ExrPaintLayerInfo&
     KIS_ASSERT_RECOVER_RETURN(
                 layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID);
 
-    QVector<pixel_type> pixels(width * height);
+    const int rowsPerBlock = qMin(rowsPerDecodingBlock(file.header()), height);
+
+    QVector<pixel_type> pixels(width * rowsPerBlock);
+    const qint64 bufferSize = pixels.size() * sizeof(pixel_type);
+    addDecodingBufferSize(bufferSize);
 
     Q_ASSERT(info.channelMap.contains("G"));
     dbgFile << "G -> " << info.channelMap["G"];
@@ -434,40 +514,96 @@ void EXRConverter::Private::decodeData1(Imf::InputFile& file, ExrPaintLayerInfo&
     bool hasAlpha = info.channelMap.contains("A");
     dbgFile << "Has Alpha:" << hasAlpha;
 
+    for (int y = ystart; y < ystart + height; y += rowsPerBlock) {
+        const int numRows = qMin(rowsPerBlock, ystart + height - y);
 
-    Imf::FrameBuffer frameBuffer;
-    pixel_type* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->gray,
-                       sizeof(pixel_type) * 1,
-                       sizeof(pixel_type) * width));
-
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->alpha,
+        Imf::FrameBuffer frameBuffer;
+        pixel_type* frameBufferData = (pixels.data()) - xstart - y * width;
+        frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->gray,
                            sizeof(pixel_type) * 1,
                            sizeof(pixel_type) * width));
-    }
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
+        if (hasAlpha) {
+            frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
+                    Imf::Slice(ptype, (char *) &frameBufferData->alpha,
+                               sizeof(pixel_type) * 1,
+                               sizeof(pixel_type) * width));
+        }
+
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(y, y + numRows - 1);
 
-    pixel_type *srcPtr = pixels.data();
+        pixel_type *srcPtr = pixels.data();
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+        QRect paintRegion(xstart, y, width, numRows);
+        KisSequentialIterator it(layer->paintDevice(), paintRegion);
+        while (it.nextPixel()) {
+            if (hasAlpha) {
+                unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+            }
+
+            pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
+
+            dstPtr->gray = srcPtr->gray;
+            dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+
+            ++srcPtr;
         }
+    }
+
+    addDecodingBufferSize(-bufferSize);
+}
 
-        pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
+void EXRConverter::Private::decodeLayer(const QString &filename, ExrPaintLayerDecodingJob &job, int width, int xstart, int ystart, int height)
+{
+    ExrPaintLayerInfo &info = *job.info;
 
-        dstPtr->gray = srcPtr->gray;
-        dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+    try {
+        /**
+         * Every layer gets its own file, so that the layers could be
+         * decoded in parallel. The frame buffer is a state of the file.
+         */
+        Imf::InputFile file(filename.toUtf8());
 
-        ++srcPtr;
-    } ;
+        switch (info.channelMap.size()) {
+        case 1:
+        case 2:
+            // Decode the data
+            switch (info.imageType) {
+            case IT_FLOAT16:
+                decodeData1<half>(file, info, job.layer, width, xstart, ystart, height, Imf::HALF);
+                break;
+            case IT_FLOAT32:
+                decodeData1<float>(file, info, job.layer, width, xstart, ystart, height, Imf::FLOAT);
+                break;
+            case IT_UNKNOWN:
+            case IT_UNSUPPORTED:
+                qFatal("Impossible error");
+            }
+            break;
+        case 3:
+        case 4:
+            // Decode the data
+            switch (info.imageType) {
+            case IT_FLOAT16:
+                decodeData4<half>(file, info, job.layer, width, xstart, ystart, height, Imf::HALF);
+                break;
+            case IT_FLOAT32:
+                decodeData4<float>(file, info, job.layer, width, xstart, ystart, height, Imf::FLOAT);
+                break;
+            case IT_UNKNOWN:
+            case IT_UNSUPPORTED:
+                qFatal("Impossible error");
+            }
+            break;
+        default:
+            qFatal("Invalid number of channels: %i", info.channelMap.size());
+        }
+    } catch (std::exception &e) {
+        dbgFile << "Error while decoding layer" << info.name << ":" << e.what();
+        job.failed = true;
+    }
 }
 
 bool recCheckGroup(const ExrGroupLayerInfo& group, QStringList list, int idx1, int idx2)
@@ -812,7 +948,9 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
             d->image->addNode(info.groupLayer, groupLayerParent);
         }
 
-        // Load the layers
+        // Create the layers
+        QVector<ExrPaintLayerDecodingJob> jobs;
+
         for (int i = informationObjects.size() - 1; i >= 0; --i) {
             ExrPaintLayerInfo& info = informationObjects[i];
             if (info.colorSpace) {
@@ -825,40 +963,6 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
 
                 layer->setCompositeOpId(COMPOSITE_OVER);
 
-                switch (info.channelMap.size()) {
-                case 1:
-                case 2:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData1<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData1<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
-                    break;
-                case 3:
-                case 4:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData4<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData4<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
-                    break;
-                default:
-                    qFatal("Invalid number of channels: %i", info.channelMap.size());
-                }
                 // Check if should set the channels
                 if (!info.remappedChannels.isEmpty()) {
                     QList<KisMetaData::Value> values;
@@ -870,14 +974,40 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
                     }
                     layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
                 }
-                // Add the layer
-                KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
-                d->image->addNode(layer, groupLayerParent);
+
+                ExrPaintLayerDecodingJob job;
+                job.info = &info;
+                job.layer = layer;
+                jobs.append(job);
             } else {
                 dbgFile << "No decoding " << info.name << " with " << info.channelMap.size() << " channels, and lack of a color space";
             }
         }
 
+        // Decode the layers, they are read in blocks of rows directly into the layers' devices
+        d->decodingBufferSize = 0;
+        d->peakDecodingBufferSize = 0;
+
+        auto decodeLayer = [this, &filename, width, dx, dy, height] (ExrPaintLayerDecodingJob &job) {
+            d->decodeLayer(filename, job, width, dx, dy, height);
+        };
+
+        if (jobs.size() > 1) {
+            QtConcurrent::blockingMap(jobs, decodeLayer);
+        } else {
+            std::for_each(jobs.begin(), jobs.end(), decodeLayer);
+        }
+
+        // Add the layers
+        Q_FOREACH (const ExrPaintLayerDecodingJob &job, jobs) {
+            if (job.failed) {
+                return ImportExportCodes::ErrorWhileReading;
+            }
+
+            KisGroupLayerSP groupLayerParent = (job.info->parent) ? job.info->parent->groupLayer : d->image->rootLayer();
+            d->image->addNode(job.layer, groupLayerParent);
+        }
+
         // After reading the image, notify the user about changed alpha.
         if (d->alphaWasModified) {
             QString msg =
@@ -928,6 +1058,11 @@ KisImageSP EXRConverter::image()
     return d->image;
 }
 
+qint64 EXRConverter::peakDecodingBufferSize() const
+{
+    return d->peakDecodingBufferSize;
+}
+
 QString EXRConverter::errorMessage() const
 {
     return d->errorMessage;
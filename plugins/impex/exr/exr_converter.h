@@ -30,6 +30,12 @@ public:
      * Retrieve the constructed image
      */
     KisImageSP image();
+    /**
+     * The peak amount of memory taken by the intermediate pixel buffers
+     * while loading the image. The layers are decoded in blocks of rows,
+     * so it doesn't depend on the height of the image.
+     */
+    qint64 peakDecodingBufferSize() const;
     QString errorMessage() const;
 private:
     KisImportExportErrorCode decode(const QString &filename);
@@ -13,8 +13,12 @@
 
 #include <half.h>
 #include <KisMimeDatabase.h>
+#include <KoColorModelStandardIds.h>
+#include <kis_paint_layer.h>
 #include "filestest.h"
 
+#include "exr_converter.h"
+
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
 #endif
@@ -93,6 +97,68 @@ void KisExrTest::testRoundTrip()
 
 }
 
+void KisExrTest::testDecodingMemoryCeiling()
+{
+    const int width = 96;
+    const int height = 3000;
+    const int numLayers = 3;
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), 0);
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    doc1->setFileBatchMode(true);
+
+    KisImageSP image = new KisImage(0, width, height, cs, "exr test");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i), OPACITY_OPAQUE_U8);
+        layer->paintDevice()->fill(QRect(i * 20, i * 700, width - i * 20, height - i * 700),
+                                   KoColor(QColor(50 * i, 100, 255 - 50 * i), cs));
+        image->addNode(layer, image->root());
+    }
+
+    doc1->setCurrentImage(image);
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".exr"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    const QString savedFileName(savedFile.fileName());
+    const QByteArray mimeType(KisMimeDatabase::mimeTypeForFile(savedFileName, false).toLatin1());
+
+    QVERIFY(doc1->exportDocumentSync(savedFileName, mimeType));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    EXRConverter converter(doc2.data(), false);
+
+    QVERIFY(converter.buildImage(savedFileName).isOk());
+    QVERIFY(converter.image());
+
+    for (int i = 0; i < numLayers; i++) {
+        const QString name = QString("paint%1").arg(i);
+
+        KisNodeSP srcNode = image->root()->findChildByName(name);
+        KisNodeSP dstNode = converter.image()->root()->findChildByName(name);
+
+        QVERIFY(srcNode);
+        QVERIFY(dstNode);
+
+        QVERIFY(TestUtil::comparePaintDevicesClever<half>(srcNode->paintDevice(), dstNode->paintDevice()));
+    }
+
+    /**
+     * The layers are decoded in blocks of at most 256 rows, every
+     * layer has at most one block in flight at a time
+     */
+    const qint64 frameSize = qint64(width) * height * cs->pixelSize();
+    const qint64 maxBlockSize = qint64(width) * 256 * cs->pixelSize();
+
+    QVERIFY(converter.peakDecodingBufferSize() > 0);
+    QVERIFY(converter.peakDecodingBufferSize() <= numLayers * maxBlockSize);
+    QVERIFY(converter.peakDecodingBufferSize() < frameSize);
+}
+
 KISTEST_MAIN(KisExrTest)
 
 
@@ -9,6 +9,7 @@
 #include <QCheckBox>
 #include <QSlider>
 #include <QApplication>
+#include <QThread>
 
 #include <kpluginfactory.h>
 
@@ -62,6 +63,11 @@ KisImportExportErrorCode KisPNGExport::convert(KisDocument *document, QIODevice
     options.storeAuthor = configuration->getBool("storeAuthor", false);
     options.storeMetaData = configuration->getBool("storeMetaData", false);
     options.saveAsHDR = configuration->getBool("saveAsHDR", false);
+    options.filterStrategy = KisPNGParallelEncoder::FilterStrategy(
+        qBound(int(KisPNGParallelEncoder::FilterAdaptive),
+               configuration->getInt("filterStrategy", KisPNGParallelEncoder::FilterAdaptive),
+               int(KisPNGParallelEncoder::FilterNone)));
+    options.parallelEncoding = configuration->getBool("parallelEncoding", true) && QThread::idealThreadCount() > 1;
 
     vKisAnnotationSP_it beginIt = image->beginAnnotations();
     vKisAnnotationSP_it endIt = image->endAnnotations();
@@ -92,6 +98,8 @@ KisPropertiesConfigurationSP KisPNGExport::defaultConfiguration(const QByteArray
     cfg->setProperty("indexed", false);
     cfg->setProperty("compression", 3);
     cfg->setProperty("interlaced", false);
+    cfg->setProperty("filterStrategy", KisPNGParallelEncoder::FilterAdaptive);
+    cfg->setProperty("parallelEncoding", true);
 
     KoColor fill_color(KoColorSpaceRegistry::instance()->rgb8());
     fill_color = KoColor();
@@ -132,6 +140,7 @@ KisWdgOptionsPNG::KisWdgOptionsPNG(QWidget *parent)
     setupUi(this);
 
     connect(chkSaveAsHDR, SIGNAL(toggled(bool)), this, SLOT(slotUseHDRChanged(bool)));
+    connect(interlacing, SIGNAL(toggled(bool)), chkParallelEncoding, SLOT(setDisabled(bool)));
 }
 
 void KisWdgOptionsPNG::setConfiguration(const KisPropertiesConfigurationSP cfg)
@@ -162,6 +171,9 @@ void KisWdgOptionsPNG::setConfiguration(const KisPropertiesConfigurationSP cfg)
     interlacing->setChecked(cfg->getBool("interlaced", false));
     compressionLevel->setValue(cfg->getInt("compression", 3));
     compressionLevel->setRange(1, 9, 0);
+    cmbFilterStrategy->setCurrentIndex(cfg->getInt("filterStrategy", KisPNGParallelEncoder::FilterAdaptive));
+    chkParallelEncoding->setChecked(cfg->getBool("parallelEncoding", true));
+    chkParallelEncoding->setDisabled(interlacing->isChecked());
 
     tryToSaveAsIndexed->setVisible(!isThereAlpha);
 
@@ -193,6 +205,8 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     bool alpha = this->alpha->isChecked();
     bool interlace = interlacing->isChecked();
     int compression = (int)compressionLevel->value();
+    int filterStrategy = cmbFilterStrategy->currentIndex();
+    bool parallelEncoding = chkParallelEncoding->isChecked();
     bool saveAsHDR = chkSaveAsHDR->isChecked();
     bool tryToSaveAsIndexed = !saveAsHDR && this->tryToSaveAsIndexed->isChecked();
     bool saveSRGB = !saveAsHDR && chkSRGB->isChecked();
@@ -208,6 +222,8 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     cfg->setProperty("indexed", tryToSaveAsIndexed);
     cfg->setProperty("compression", compression);
     cfg->setProperty("interlaced", interlace);
+    cfg->setProperty("filterStrategy", filterStrategy);
+    cfg->setProperty("parallelEncoding", parallelEncoding);
     cfg->setProperty("transparencyFillcolor", transparencyFillcolor);
     cfg->setProperty("saveAsHDR", saveAsHDR);
     cfg->setProperty("saveSRGBProfile", saveSRGB);
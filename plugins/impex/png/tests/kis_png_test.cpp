@@ -14,6 +14,12 @@
 
 #include  <sdk/tests/testui.h>
 
+#include <QBuffer>
+
+#include <kis_paint_device.h>
+#include <kis_png_converter.h>
+#include <kis_sequential_iterator.h>
+
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
 #endif
@@ -163,5 +169,101 @@ void KisPngTest::testSaveHDR()
                     KoColorSpaceRegistry::instance()->p2020PQProfile()));
 }
 
+namespace {
+
+KisPaintDeviceSP createNoisyDevice(const KoColorSpace *cs, const QRect &rc)
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *ptr = it.rawData();
+        for (quint32 i = 0; i < cs->pixelSize(); i++) {
+            // smooth gradients with some noise, so that every filter wins somewhere
+            ptr[i] = quint8(it.x() / 3 + it.y() / 2 + 37 * i + (it.x() * it.y() + i) % 7);
+        }
+    }
+
+    return dev;
+}
+
+QByteArray savePng(KisPaintDeviceSP dev, const QRect &rc, bool parallelEncoding, int filterStrategy)
+{
+    KisPNGOptions options;
+    options.compression = 6;
+    options.tryToSaveAsIndexed = false;
+    options.parallelEncoding = parallelEncoding;
+    options.filterStrategy = KisPNGParallelEncoder::FilterStrategy(filterStrategy);
+
+    vKisAnnotationSP annotations;
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    KisPNGConverter converter(0, true);
+    const KisImportExportErrorCode result =
+        converter.buildFile(&buffer, rc, 1.0, 1.0, dev,
+                            annotations.begin(), annotations.end(),
+                            options, 0);
+
+    return result.isOk() ? buffer.data() : QByteArray();
+}
+
+QByteArray loadPngPixels(const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    KisPNGConverter converter(0, true);
+    if (!converter.buildImage(&buffer).isOk()) return QByteArray();
+
+    KisImageSP image = converter.image();
+    image->initialRefreshGraph();
+
+    const QRect rc = image->bounds();
+    QByteArray pixels(rc.width() * rc.height() * image->colorSpace()->pixelSize(), 0);
+    image->projection()->readBytes(reinterpret_cast<quint8*>(pixels.data()), rc);
+
+    return pixels;
+}
+
+}
+
+void KisPngTest::testParallelEncoding()
+{
+    // tall enough for the encoder to split the rows into several chunks
+    const QRect rc(0, 0, 301, 1200);
+
+    QVector<const KoColorSpace*> colorSpaces;
+    colorSpaces << KoColorSpaceRegistry::instance()->rgb8();
+    colorSpaces << KoColorSpaceRegistry::instance()->rgb16();
+    colorSpaces << KoColorSpaceRegistry::instance()->graya8();
+
+    Q_FOREACH (const KoColorSpace *cs, colorSpaces) {
+        KisPaintDeviceSP dev = createNoisyDevice(cs, rc);
+
+        for (int filterStrategy = KisPNGParallelEncoder::FilterAdaptive;
+             filterStrategy <= KisPNGParallelEncoder::FilterNone;
+             filterStrategy++) {
+
+            const QByteArray serialFile = savePng(dev, rc, false, filterStrategy);
+            const QByteArray parallelFile = savePng(dev, rc, true, filterStrategy);
+
+            QVERIFY(!serialFile.isEmpty());
+            QVERIFY(!parallelFile.isEmpty());
+
+            const QByteArray serialPixels = loadPngPixels(serialFile);
+            const QByteArray parallelPixels = loadPngPixels(parallelFile);
+
+            QVERIFY(!serialPixels.isEmpty());
+            QCOMPARE(parallelPixels, serialPixels);
+
+            // the dictionary of the previous chunk keeps the size close to libpng's
+            QVERIFY(parallelFile.size() < serialFile.size() * 1.01);
+        }
+    }
+}
+
 KISTEST_MAIN(KisPngTest)
 
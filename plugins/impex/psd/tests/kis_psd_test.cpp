@@ -26,6 +26,9 @@
 #include <kis_generator_layer.h>
 #include <kis_filter_configuration.h>
 #include <KisGlobalResourcesInterface.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_paint_layer.h>
+#include <kis_sequential_iterator.h>
 
 
 
@@ -508,6 +511,44 @@ void KisPSDTest::testSavingAllFormats()
 
 
 
+void KisPSDTest::testSavingTallLayer()
+{
+    // the channels are written in strips of rows, the layer should span a few of them
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    const QRect imageRect(0, 0, 97, 600);
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "tall image");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8);
+
+    KisSequentialIterator it(layer->paintDevice(), imageRect);
+    while (it.nextPixel()) {
+        quint16 *pixel = reinterpret_cast<quint16 *>(it.rawData());
+        pixel[0] = static_cast<quint16>(it.x() * 600);
+        pixel[1] = static_cast<quint16>(it.y() * 100);
+        pixel[2] = (it.x() / 8) % 2 ? 0xffff : 0;
+        pixel[3] = static_cast<quint16>(0xffff - it.y() * 50);
+    }
+
+    image->addNode(layer, image->root());
+    image->initialRefreshGraph();
+
+    doc->setFileBatchMode(true);
+    doc->setCurrentImage(image);
+
+    QFileInfo dstFileInfo(QDir::currentPath() + '/' + "test_tall_layer.psd");
+    QVERIFY(doc->exportDocumentSync(dstFileInfo.absoluteFilePath(), PSDMimetype.toUtf8()));
+
+    QSharedPointer<KisDocument> resultDoc = openPsdDocument(dstFileInfo);
+    QVERIFY(resultDoc->image());
+
+    KisLayerSP resultLayer = qobject_cast<KisLayer*>(resultDoc->image()->root()->lastChild().data());
+    QVERIFY(resultLayer);
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint16>(layer->paintDevice(), resultLayer->paintDevice()));
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint16>(image->projection(), resultDoc->image()->projection()));
+}
+
 void KisPSDTest::testImportFromWriteonly()
 {
     TestUtil::testImportFromWriteonly(QString(FILES_DATA_DIR), PSDMimetype);
@@ -528,5 +569,46 @@ void KisPSDTest::testImportIncorrectFormat()
 
 
 
+void KisPSDTest::benchmarkLoadSaveMultilayered()
+{
+    /**
+     * The file can be overridden with KRITA_PSD_BENCHMARK_FILE to measure
+     * the codec on a big real-world document
+     */
+    QString fileName = qEnvironmentVariable("KRITA_PSD_BENCHMARK_FILE");
+    if (fileName.isEmpty()) {
+        fileName = QString(FILES_DATA_DIR) + '/' + "sources/masks.psd";
+    }
+
+    QFileInfo sourceFileInfo(fileName);
+    QVERIFY(sourceFileInfo.exists());
+
+    QSharedPointer<KisDocument> doc = openPsdDocument(sourceFileInfo);
+    QVERIFY(doc->image());
+
+    doc->setFileBatchMode(true);
+    doc->setMimeType(PSDMimetype);
+
+    // the channels are packed in parallel, but the file must not depend on that
+    QFileInfo firstFileInfo(QDir::currentPath() + '/' + "benchmark_first.psd");
+    QFileInfo secondFileInfo(QDir::currentPath() + '/' + "benchmark_second.psd");
+    QVERIFY(doc->exportDocumentSync(firstFileInfo.absoluteFilePath(), PSDMimetype.toUtf8()));
+    QVERIFY(doc->exportDocumentSync(secondFileInfo.absoluteFilePath(), PSDMimetype.toUtf8()));
+
+    QFile firstFile(firstFileInfo.absoluteFilePath());
+    QFile secondFile(secondFileInfo.absoluteFilePath());
+    QVERIFY(firstFile.open(QIODevice::ReadOnly));
+    QVERIFY(secondFile.open(QIODevice::ReadOnly));
+    QVERIFY(firstFile.readAll() == secondFile.readAll());
+
+    QBENCHMARK {
+        QSharedPointer<KisDocument> doc = openPsdDocument(firstFileInfo);
+        QVERIFY(doc->image());
+
+        doc->setFileBatchMode(true);
+        QVERIFY(doc->exportDocumentSync(secondFileInfo.absoluteFilePath(), PSDMimetype.toUtf8()));
+    }
+}
+
 KISTEST_MAIN(KisPSDTest)
 
@@ -30,11 +30,14 @@ private Q_SLOTS:
     void testOpeningFromOpenCanvas();
     void testOpeningAllFormats();
     void testSavingAllFormats();
+    void testSavingTallLayer();
 
 
     void testImportFromWriteonly();
     void testExportToReadonly();
     void testImportIncorrectFormat();
+
+    void benchmarkLoadSaveMultilayered();
 };
 
 #endif
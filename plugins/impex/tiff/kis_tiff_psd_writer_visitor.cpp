@@ -103,32 +103,37 @@ KisTiffPsdWriter::~KisTiffPsdWriter()
 {
 }
 
-bool KisTiffPsdWriter::copyDataToStrips(KisHLineConstIteratorSP it,
+bool KisTiffPsdWriter::copyDataToStrips(const quint8 *src,
+                                        qint32 numPixels,
+                                        qint32 pixelSize,
                                         tdata_t buff,
                                         uint32_t depth,
                                         uint16_t sample_format,
                                         uint8_t nbcolorssamples,
                                         quint8 *poses)
 {
+    const quint8 *end = src + numPixels * pixelSize;
+
     if (depth == 32) {
         Q_ASSERT(sample_format == SAMPLEFORMAT_IEEEFP);
         float *dst = reinterpret_cast<float *>(buff);
         do {
-            const float *d = reinterpret_cast<const float *>(it->oldRawData());
+            const float *d = reinterpret_cast<const float *>(src);
             int i;
             for (i = 0; i < nbcolorssamples; i++) {
                 *(dst++) = d[poses[i]];
             }
             if (m_options->alpha)
                 *(dst++) = d[poses[i]];
-        } while (it->nextPixel());
+            src += pixelSize;
+        } while (src < end);
         return true;
     } else if (depth == 16) {
         if (sample_format == SAMPLEFORMAT_IEEEFP) {
 #ifdef HAVE_OPENEXR
             half *dst = reinterpret_cast<half *>(buff);
             do {
-                const half *d = reinterpret_cast<const half *>(it->oldRawData());
+                const half *d = reinterpret_cast<const half *>(src);
                 int i;
                 for (i = 0; i < nbcolorssamples; i++) {
                     *(dst++) = d[poses[i]];
@@ -136,13 +141,14 @@ bool KisTiffPsdWriter::copyDataToStrips(KisHLineConstIteratorSP it,
                 if (m_options->alpha)
                     *(dst++) = d[poses[i]];
 
-            } while (it->nextPixel());
+                src += pixelSize;
+            } while (src < end);
             return true;
 #endif
         } else {
             quint16 *dst = reinterpret_cast<quint16 *>(buff);
             do {
-                const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
+                const quint16 *d = reinterpret_cast<const quint16 *>(src);
                 int i;
                 for (i = 0; i < nbcolorssamples; i++) {
                     *(dst++) = d[poses[i]];
@@ -150,13 +156,14 @@ bool KisTiffPsdWriter::copyDataToStrips(KisHLineConstIteratorSP it,
                 if (m_options->alpha)
                     *(dst++) = d[poses[i]];
 
-            } while (it->nextPixel());
+                src += pixelSize;
+            } while (src < end);
             return true;
         }
     } else if (depth == 8) {
         quint8 *dst = reinterpret_cast<quint8 *>(buff);
         do {
-            const quint8 *d = it->oldRawData();
+            const quint8 *d = src;
             int i;
             for (i = 0; i < nbcolorssamples; i++) {
                 *(dst++) = d[poses[i]];
@@ -164,7 +171,8 @@ bool KisTiffPsdWriter::copyDataToStrips(KisHLineConstIteratorSP it,
             if (m_options->alpha)
                 *(dst++) = d[poses[i]];
 
-        } while (it->nextPixel());
+            src += pixelSize;
+        } while (src < end);
         return true;
     }
     return false;
@@ -196,22 +204,25 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
             dbgFile << "Unsupported colorspace" << pd->colorSpace()->name();
             return ImportExportCodes::FormatColorSpaceUnsupported;
         }
-        pd.attach(new KisPaintDevice(*pd));
-        pd->convertTo(destColorSpace);
     }
 
+    // the pixels are converted row by row when writing, so that
+    // we don't need a converted copy of the whole projection
+    const KoColorSpace *srcColorSpace = pd->colorSpace();
+    const KoColorSpace *dstColorSpace = destColorSpace ? destColorSpace : srcColorSpace;
+
     // Save depth
-    quint16 depth = static_cast<quint16>(8 * pd->pixelSize() / pd->channelCount());
+    quint16 depth = static_cast<quint16>(8 * dstColorSpace->pixelSize() / dstColorSpace->channelCount());
     TIFFSetField(image(), TIFFTAG_BITSPERSAMPLE, depth);
     // Save number of samples
     quint16 nbchannels;
     if (m_options->alpha) {
-        nbchannels = static_cast<quint16>(pd->channelCount());
+        nbchannels = static_cast<quint16>(dstColorSpace->channelCount());
         TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, nbchannels);
         uint16_t sampleinfo[1] = {EXTRASAMPLE_UNASSALPHA};
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 1, sampleinfo);
     } else {
-        nbchannels = static_cast<quint16>(pd->channelCount() - 1);
+        nbchannels = static_cast<quint16>(dstColorSpace->channelCount() - 1);
         TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, nbchannels);
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 0);
     }
@@ -238,7 +249,7 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
 
     // Save profile
     if (m_options->saveProfile) {
-        const KoColorProfile *profile = pd->colorSpace()->profile();
+        const KoColorProfile *profile = dstColorSpace->profile();
         if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
             QByteArray ba = profile->rawData();
             TIFFSetField(image(), TIFFTAG_ICCPROFILE, ba.size(), ba.constData());
@@ -249,12 +260,29 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
     qint32 height = layer->image()->height();
     qint32 width = layer->image()->width();
     bool r = true;
+
+    QVector<quint8> srcRow(width * static_cast<int>(srcColorSpace->pixelSize()));
+    QVector<quint8> dstRow(destColorSpace ? width * static_cast<int>(dstColorSpace->pixelSize()) : 0);
+    const qint32 pixelSize = static_cast<qint32>(dstColorSpace->pixelSize());
+
     for (qint32 y = 0; y < height; y++) {
-        KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
+        pd->readBytes(srcRow.data(), 0, y, width, 1);
+        const quint8 *row = srcRow.constData();
+
+        if (destColorSpace) {
+            srcColorSpace->convertPixelsTo(srcRow.constData(),
+                                           dstRow.data(),
+                                           destColorSpace,
+                                           static_cast<quint32>(width),
+                                           KoColorConversionTransformation::internalRenderingIntent(),
+                                           KoColorConversionTransformation::internalConversionFlags());
+            row = dstRow.constData();
+        }
+
         switch (color_type) {
         case PHOTOMETRIC_MINISBLACK: {
             quint8 poses[] = {0, 1};
-            r = copyDataToStrips(it, buff, depth, sample_format, 1, poses);
+            r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 1, poses);
         } break;
         case PHOTOMETRIC_RGB: {
             quint8 poses[4];
@@ -269,15 +297,15 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
                 poses[2] = 0;
                 poses[3] = 3;
             }
-            r = copyDataToStrips(it, buff, depth, sample_format, 3, poses);
+            r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 3, poses);
         } break;
         case PHOTOMETRIC_SEPARATED: {
             quint8 poses[] = {0, 1, 2, 3, 4};
-            r = copyDataToStrips(it, buff, depth, sample_format, 4, poses);
+            r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 4, poses);
         } break;
         case PHOTOMETRIC_ICCLAB: {
             quint8 poses[] = {0, 1, 2, 3};
-            r = copyDataToStrips(it, buff, depth, sample_format, 3, poses);
+            r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 3, poses);
         } break;
             return ImportExportCodes::FormatColorSpaceUnsupported;
         }
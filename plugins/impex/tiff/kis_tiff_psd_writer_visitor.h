@@ -29,7 +29,7 @@ private:
         return m_image;
     }
 
-    bool copyDataToStrips(KisHLineConstIteratorSP it, tdata_t buff, uint32_t depth, uint16_t sample_format, uint8_t nbcolorssamples, quint8 *poses);
+    bool copyDataToStrips(const quint8 *src, qint32 numPixels, qint32 pixelSize, tdata_t buff, uint32_t depth, uint16_t sample_format, uint8_t nbcolorssamples, quint8 *poses);
     bool saveLayerProjection(KisLayer *);
 
 private:
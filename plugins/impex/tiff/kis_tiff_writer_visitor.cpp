@@ -93,19 +93,22 @@ KisTIFFWriterVisitor::~KisTIFFWriterVisitor()
 {
 }
 
-bool KisTIFFWriterVisitor::copyDataToStrips(KisHLineConstIteratorSP it, tdata_t buff, uint8_t depth, uint16_t sample_format, uint8_t nbcolorssamples, quint8* poses)
+bool KisTIFFWriterVisitor::copyDataToStrips(const quint8 *src, qint32 numPixels, qint32 pixelSize, tdata_t buff, uint8_t depth, uint16_t sample_format, uint8_t nbcolorssamples, quint8* poses)
 {
+    const quint8 *end = src + numPixels * pixelSize;
+
     if (depth == 32) {
         Q_ASSERT(sample_format == SAMPLEFORMAT_IEEEFP);
         float *dst = reinterpret_cast<float *>(buff);
         do {
-            const float *d = reinterpret_cast<const float *>(it->oldRawData());
+            const float *d = reinterpret_cast<const float *>(src);
             int i;
             for (i = 0; i < nbcolorssamples; i++) {
                 *(dst++) = d[poses[i]];
             }
             if (m_options->alpha) *(dst++) = d[poses[i]];
-        } while (it->nextPixel());
+            src += pixelSize;
+        } while (src < end);
         return true;
     }
     else if (depth == 16 ) {
@@ -113,42 +116,45 @@ bool KisTIFFWriterVisitor::copyDataToStrips(KisHLineConstIteratorSP it, tdata_t
 #ifdef HAVE_OPENEXR
             half *dst = reinterpret_cast<half *>(buff);
             do {
-                const half *d = reinterpret_cast<const half *>(it->oldRawData());
+                const half *d = reinterpret_cast<const half *>(src);
                 int i;
                 for (i = 0; i < nbcolorssamples; i++) {
                     *(dst++) = d[poses[i]];
                 }
                 if (m_options->alpha) *(dst++) = d[poses[i]];
 
-            } while (it->nextPixel());
+                src += pixelSize;
+            } while (src < end);
             return true;
 #endif
         }
         else {
             quint16 *dst = reinterpret_cast<quint16 *>(buff);
             do {
-                const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
+                const quint16 *d = reinterpret_cast<const quint16 *>(src);
                 int i;
                 for (i = 0; i < nbcolorssamples; i++) {
                     *(dst++) = d[poses[i]];
                 }
                 if (m_options->alpha) *(dst++) = d[poses[i]];
 
-            } while (it->nextPixel());
+                src += pixelSize;
+            } while (src < end);
             return true;
         }
     }
     else if (depth == 8) {
         quint8 *dst = reinterpret_cast<quint8 *>(buff);
         do {
-            const quint8 *d = it->oldRawData();
+            const quint8 *d = src;
             int i;
             for (i = 0; i < nbcolorssamples; i++) {
                 *(dst++) = d[poses[i]];
             }
             if (m_options->alpha) *(dst++) = d[poses[i]];
 
-        } while (it->nextPixel());
+            src += pixelSize;
+        } while (src < end);
         return true;
     }
     return false;
@@ -167,20 +173,23 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
         if (!destColorSpace) {
             return false;
         }
-        pd.attach(new KisPaintDevice(*pd));
-        pd->convertTo(destColorSpace);
     }
 
+    // the pixels are converted row by row when writing, so that
+    // we don't need a converted copy of the whole layer
+    const KoColorSpace *srcColorSpace = pd->colorSpace();
+    const KoColorSpace *dstColorSpace = destColorSpace ? destColorSpace : srcColorSpace;
+
     // Save depth
-    int depth = 8 * pd->pixelSize() / pd->channelCount();
+    int depth = 8 * dstColorSpace->pixelSize() / dstColorSpace->channelCount();
     TIFFSetField(image(), TIFFTAG_BITSPERSAMPLE, depth);
     // Save number of samples
     if (m_options->alpha) {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount());
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, dstColorSpace->channelCount());
         uint16_t sampleinfo[1] = { EXTRASAMPLE_UNASSALPHA };
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 1, sampleinfo);
     } else {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount() - 1);
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, dstColorSpace->channelCount() - 1);
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 0);
     }
 
@@ -206,7 +215,7 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
 
     // Save profile
     if (m_options->saveProfile) {
-        const KoColorProfile* profile = pd->colorSpace()->profile();
+        const KoColorProfile* profile = dstColorSpace->profile();
         if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
             QByteArray ba = profile->rawData();
             TIFFSetField(image(), TIFFTAG_ICCPROFILE, ba.size(), ba.constData());
@@ -217,12 +226,26 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
     qint32 height = layer->image()->height();
     qint32 width = layer->image()->width();
     bool r = true;
+
+    QVector<quint8> srcRow(width * srcColorSpace->pixelSize());
+    QVector<quint8> dstRow(destColorSpace ? width * dstColorSpace->pixelSize() : 0);
+    const qint32 pixelSize = dstColorSpace->pixelSize();
+
     for (int y = 0; y < height; y++) {
-        KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
+        pd->readBytes(srcRow.data(), 0, y, width, 1);
+        const quint8 *row = srcRow.constData();
+
+        if (destColorSpace) {
+            srcColorSpace->convertPixelsTo(srcRow.constData(), dstRow.data(), destColorSpace, width,
+                                           KoColorConversionTransformation::internalRenderingIntent(),
+                                           KoColorConversionTransformation::internalConversionFlags());
+            row = dstRow.constData();
+        }
+
         switch (color_type) {
         case PHOTOMETRIC_MINISBLACK: {
                 quint8 poses[] = { 0, 1 };
-                r = copyDataToStrips(it, buff, depth, sample_format, 1, poses);
+                r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 1, poses);
             }
             break;
         case PHOTOMETRIC_RGB: {
@@ -232,17 +255,17 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
                 } else {
                     poses[0] = 2; poses[1] = 1; poses[2] = 0; poses[3] = 3;
                 }
-                r = copyDataToStrips(it, buff, depth, sample_format, 3, poses);
+                r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 3, poses);
             }
             break;
         case PHOTOMETRIC_SEPARATED: {
                 quint8 poses[] = { 0, 1, 2, 3, 4 };
-                r = copyDataToStrips(it, buff, depth, sample_format, 4, poses);
+                r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 4, poses);
             }
             break;
         case PHOTOMETRIC_ICCLAB: {
                 quint8 poses[] = { 0, 1, 2, 3 };
-                r = copyDataToStrips(it, buff, depth, sample_format, 3, poses);
+                r = copyDataToStrips(row, width, pixelSize, buff, depth, sample_format, 3, poses);
             }
             break;
             return false;
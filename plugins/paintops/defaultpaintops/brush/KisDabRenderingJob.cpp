@@ -99,7 +99,7 @@ int KisDabRenderingJobRunner::executeOneJob(KisDabRenderingJob *job,
         // TODO: thing about better interface for the reverse queue link
         job->originalDevice = parentQueue->fetchCachedPaintDevce();
 
-        generateDab(job->generationInfo, resources, &job->originalDevice);
+        generateDabWithSharedCache(job->generationInfo, resources, &job->originalDevice);
     }
 
     // by now the original device should be already prepared
@@ -10,6 +10,7 @@
 #include "kis_paint_device.h"
 #include "kis_fixed_paint_device.h"
 #include "kis_color_source.h"
+#include <brushengine/KisDabMaskCache.h>
 
 #include <kis_pressure_sharpness_option.h>
 #include <kis_texture_option.h>
@@ -90,6 +91,23 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
     }
 }
 
+void generateDabWithSharedCache(const DabGenerationInfo &di, DabRenderingResources *resources, KisFixedPaintDeviceSP *dab, bool forceNormalizedRGBAImageStamp)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
+
+    if (di.sharedCacheKey.isEmpty() || forceNormalizedRGBAImageStamp) {
+        generateDab(di, resources, dab, forceNormalizedRGBAImageStamp);
+        return;
+    }
+
+    if (KisDabMaskCache::instance()->fetch(di.sharedCacheKey, (*dab)->colorSpace(), *dab)) {
+        return;
+    }
+
+    generateDab(di, resources, dab);
+    KisDabMaskCache::instance()->insert(di.sharedCacheKey, *dab);
+}
+
 void postProcessDab(KisFixedPaintDeviceSP dab,
                     const QPoint &dabTopLeft,
                     const KisPaintInformation& info,
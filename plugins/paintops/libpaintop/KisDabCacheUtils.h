@@ -7,6 +7,7 @@
 #ifndef KISDABCACHEUTILS_H
 #define KISDABCACHEUTILS_H
 
+#include <QByteArray>
 #include <QRect>
 #include <QSize>
 
@@ -91,6 +92,12 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    /**
+     * The key of the dab in KisDabMaskCache. It is empty when the dab
+     * cannot be shared between the strokes.
+     */
+    QByteArray sharedCacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
@@ -101,6 +108,16 @@ PAINTOP_EXPORT void generateDab(const DabGenerationInfo &di,
                                 KisFixedPaintDeviceSP *dab,
                                 bool forceImageStamp = false);
 
+/**
+ * Same as generateDab(), but tries to fetch the dab from the cache shared
+ * between the strokes first (if di.sharedCacheKey is set). The rendered dab
+ * is added to the shared cache.
+ */
+PAINTOP_EXPORT void generateDabWithSharedCache(const DabGenerationInfo &di,
+                                               DabRenderingResources *resources,
+                                               KisFixedPaintDeviceSP *dab,
+                                               bool forceNormalizedRGBAImageStamp = false);
+
 PAINTOP_EXPORT void postProcessDab(KisFixedPaintDeviceSP dab,
                                    const QPoint &dabTopLeft,
                                    const KisPaintInformation& info,
@@ -217,7 +217,7 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
 
     // 3. Generate new dab
 
-    generateDab(di, &resources, &m_d->dab, forceNormalizedRGBAImageStamp);
+    generateDabWithSharedCache(di, &resources, &m_d->dab, forceNormalizedRGBAImageStamp);
 
     // 4. Do postprocessing
     if (di.needsPostprocessing) {
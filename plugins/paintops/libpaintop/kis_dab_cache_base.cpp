@@ -7,6 +7,7 @@
 #include "kis_dab_cache_base.h"
 
 #include <KoColor.h>
+#include <KoColorSpace.h>
 #include "kis_color_source.h"
 #include "kis_paint_device.h"
 #include "kis_brush.h"
@@ -19,6 +20,11 @@
 
 #include <kundo2command.h>
 
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QHash>
+#include <QtMath>
+
 struct PrecisionValues {
     qreal angle;
     qreal sizeFrac;
@@ -82,9 +88,90 @@ struct KisDabCacheBase::Private {
 
     SavedDabParameters lastSavedDabParameters;
 
+    QHash<const KisBrush*, QByteArray> brushIdentities;
+
     static qreal positiveFraction(qreal x);
+
+    QByteArray brushIdentity(KisBrushSP brush);
+    QByteArray sharedCacheKey(KisBrushSP brush, const SavedDabParameters &params, int precisionLevel);
 };
 
+QByteArray KisDabCacheBase::Private::brushIdentity(KisBrushSP brush)
+{
+    auto it = brushIdentities.constFind(brush.data());
+    if (it != brushIdentities.constEnd()) {
+        return *it;
+    }
+
+    /**
+     * The serialized brush contains all the properties the mask depends
+     * on, including the md5 of the resource for the predefined brushes.
+     */
+    QDomDocument doc;
+    QDomElement e = doc.createElement("brush");
+    brush->toXML(doc, e);
+    doc.appendChild(e);
+
+    const QByteArray identity = QCryptographicHash::hash(doc.toByteArray(), QCryptographicHash::Md5);
+    brushIdentities.insert(brush.data(), identity);
+
+    return identity;
+}
+
+QByteArray KisDabCacheBase::Private::sharedCacheKey(KisBrushSP brush,
+                                                    const SavedDabParameters &params,
+                                                    int precisionLevel)
+{
+    const PrecisionValues &prec = precisionLevels[precisionLevel];
+
+    /**
+     * The parameters are quantized with the same tolerance as the one
+     * used for the reuse of the dabs inside the stroke, so the shared cache
+     * doesn't make the painting less precise than the precision level
+     * selected by the user.
+     *
+     * The steps differ between the levels, so the level is a part of the
+     * key, otherwise e.g. ratio 1.0 with step 0.05 and ratio 0.2 with
+     * step 0.01 would both become 20.
+     */
+    struct KeyData {
+        qint32 precisionLevel;
+        qint64 angle;
+        qint64 subPixelX;
+        qint64 subPixelY;
+        qint64 softnessFactor;
+        qint64 lightnessStrength;
+        qint64 ratio;
+        qint32 width;
+        qint32 height;
+        qint32 index;
+        qint32 mirror;
+    } data;
+
+    memset(&data, 0, sizeof(data));
+
+    data.precisionLevel = precisionLevel;
+    data.angle = qRound64(params.angle / prec.angle);
+    data.subPixelX = qFloor(params.subPixelX / prec.subPixel);
+    data.subPixelY = qFloor(params.subPixelY / prec.subPixel);
+    data.softnessFactor = qRound64(params.softnessFactor / prec.softnessFactor);
+    data.lightnessStrength = qRound64(params.lightnessStrength / prec.lightnessStrength);
+    data.ratio = qRound64(params.ratio / prec.ratio);
+    data.width = params.width;
+    data.height = params.height;
+    data.index = params.index;
+    data.mirror =
+        (params.mirrorProperties.horizontalMirror ? 0x1 : 0x0) |
+        (params.mirrorProperties.verticalMirror ? 0x2 : 0x0);
+
+    QByteArray key = brushIdentity(brush);
+    key.append(reinterpret_cast<const char*>(&data), sizeof(data));
+    key.append(params.color.colorSpace()->id().toLatin1());
+    key.append(reinterpret_cast<const char*>(params.color.data()), params.color.colorSpace()->pixelSize());
+
+    return key;
+}
+
 
 
 KisDabCacheBase::KisDabCacheBase()
@@ -277,6 +364,14 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
 
     if (!*shouldUseCache) {
         m_d->lastSavedDabParameters = newParams;
+
+        /**
+         * The highest precision level doesn't tolerate any difference
+         * in the dabs, so they cannot be shared between the strokes
+         */
+        if (supportsCaching && di->solidColorFill && precisionLevel < 4) {
+            di->sharedCacheKey = m_d->sharedCacheKey(resources->brush, newParams, precisionLevel);
+        }
     }
 
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
@@ -27,6 +27,7 @@
 #include <KisResourceItemView.h>
 #include <KisResourceItemChooser.h>
 #include <KisResourceModel.h>
+#include <KisResourceThumbnailLoader.h>
 
 #include <kis_icon.h>
 #include "KisBrushServerProvider.h"
@@ -71,7 +72,12 @@ void KisBrushDelegate::paint(QPainter * painter, const QStyleOptionViewItem & op
     if (! index.isValid())
         return;
 
-    QImage thumbnail = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
+    QImage thumbnail;
+    {
+        // a null thumbnail is drawn as nothing until it's decoded
+        KisResourceThumbnailLoader::AsynchronousScope asynchronousThumbnails;
+        thumbnail = index.data(Qt::UserRole + KisAbstractResourceModel::Thumbnail).value<QImage>();
+    }
 
     QRect itemRect = option.rect;
 
@@ -184,8 +184,6 @@ void KisToolFill::beginFilling(const QPoint &seedPoint)
     KisImageWSP currentImageWSP = image();
     KisNodeSP currentRoot = currentImageWSP->root();
 
-    KisImageSP refImage = KisMergeLabeledLayersCommand::createRefImage(image(), "Fill Tool Reference Image");
-
     if (m_reference == AllLayers) {
         m_referencePaintDevice = currentImage()->projection();
     } else if (m_reference == CurrentLayer) {
@@ -195,7 +193,7 @@ void KisToolFill::beginFilling(const QPoint &seedPoint)
         image()->addJob(
             m_fillStrokeId,
             new KisStrokeStrategyUndoCommandBased::Data(
-                KUndo2CommandSP(new KisMergeLabeledLayersCommand(refImage, m_referencePaintDevice,
+                KUndo2CommandSP(new KisMergeLabeledLayersCommand(m_referencePaintDevice,
                                                                  currentRoot, m_selectedColorLabels,
                                                                  KisMergeLabeledLayersCommand::GroupSelectionPolicy_SelectIfColorLabeled)),
                 false,
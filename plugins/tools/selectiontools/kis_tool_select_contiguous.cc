@@ -106,11 +106,10 @@ void KisToolSelectContiguous::beginPrimaryAction(KoPointerEvent *event)
     if (sampleLayersMode() == SampleAllLayers) {
         sourceDevice = image->projection();
     } else if (sampleLayersMode() == SampleColorLabeledLayers) {
-        KisImageSP refImage = KisMergeLabeledLayersCommand::createRefImage(image, "Contiguous Selection Tool Reference Image");
         sourceDevice = KisMergeLabeledLayersCommand::createRefPaintDevice(
                     image, "Contiguous Selection Tool Reference Result Paint Device");
 
-        KisMergeLabeledLayersCommand* command = new KisMergeLabeledLayersCommand(refImage, sourceDevice,
+        KisMergeLabeledLayersCommand* command = new KisMergeLabeledLayersCommand(sourceDevice,
                                                                                  image->root(), colorLabelsSelected(),
                                                                                  KisMergeLabeledLayersCommand::GroupSelectionPolicy_SelectIfColorLabeled);
         applicator.applyCommand(command,
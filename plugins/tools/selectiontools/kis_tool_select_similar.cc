@@ -138,11 +138,10 @@ void KisToolSelectSimilar::beginPrimaryAction(KoPointerEvent *event)
     if (sampleLayersMode() == SampleAllLayers) {
         sourceDevice = imageSP->projection();
     } else if (sampleLayersMode() == SampleColorLabeledLayers) {
-        KisImageSP refImage = KisMergeLabeledLayersCommand::createRefImage(imageSP, "Similar Colors Selection Tool Reference Image");
         sourceDevice = KisMergeLabeledLayersCommand::createRefPaintDevice(
                     imageSP, "Similar Colors Selection Tool Reference Result Paint Device");
 
-        KisMergeLabeledLayersCommand* command = new KisMergeLabeledLayersCommand(refImage, sourceDevice,
+        KisMergeLabeledLayersCommand* command = new KisMergeLabeledLayersCommand(sourceDevice,
                                                                                  imageSP->root(), colorLabelsSelected(),
                                                                                  KisMergeLabeledLayersCommand::GroupSelectionPolicy_SelectIfColorLabeled);
         applicator.applyCommand(command,
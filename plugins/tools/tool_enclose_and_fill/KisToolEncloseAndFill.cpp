@@ -251,10 +251,9 @@ void KisToolEncloseAndFill::slot_delegateTool_enclosingMaskProduced(KisPixelSele
     } else if (m_reference == ColorLabeledLayers) {
         KisImageWSP currentImageWSP = currentImage();
         KisNodeSP currentRoot = currentImageWSP->root();
-        KisImageSP referenceImage = KisMergeLabeledLayersCommand::createRefImage(image(), "Enclose and Fill Tool Reference Image");
         referenceDevice = KisMergeLabeledLayersCommand::createRefPaintDevice(image(), "Enclose and Fill Tool Reference Result Paint Device");
 
-        applicator.applyCommand(new KisMergeLabeledLayersCommand(referenceImage, referenceDevice, currentRoot, m_selectedColorLabels),
+        applicator.applyCommand(new KisMergeLabeledLayersCommand(referenceDevice, currentRoot, m_selectedColorLabels),
                                 KisStrokeJobData::SEQUENTIAL, KisStrokeJobData::EXCLUSIVE);
     }
 